@@ -0,0 +1,290 @@
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <graphics/LutCache.h>
+#include <graphics/Renderer.h>
+#include <graphics/Scene.h>
+#include <graphics/SceneView.h>
+#include <system/BenchmarkReport.h>
+#include <system/CpuProfiler.h>
+#include <system/GpuContext.h>
+#include <system/OffscreenTarget.h>
+
+namespace {
+  constexpr auto TARGET_WIDTH = 1920u;
+  constexpr auto TARGET_HEIGHT = 1080u;
+  constexpr auto ALTITUDES = std::array{64.0f, 256.0f, 1024.0f, 4096.0f};
+  constexpr auto SUN_ELEVATIONS = std::array{-2.0f, 5.0f, 30.0f, 80.0f};
+  constexpr auto EXTENTS = std::array{
+      imp::Extent2u{960, 540},
+      imp::Extent2u{1920, 1080},
+      imp::Extent2u{2560, 1440}};
+  constexpr auto VIEW_COUNTS = std::array{1, 4, 16};
+
+  struct Configuration {
+    float altitude;
+    float sunElevation;
+    imp::Extent2u extent;
+    int viewCount;
+    bool bloomEnabled;
+    bool antiAliasingEnabled;
+  };
+
+  std::string getName(Configuration const &configuration) {
+    return "altitude=" +
+           std::to_string(static_cast<int>(configuration.altitude)) +
+           " sun=" +
+           std::to_string(static_cast<int>(configuration.sunElevation)) +
+           " extent=" + std::to_string(configuration.extent.width) + "x" +
+           std::to_string(configuration.extent.height) +
+           " views=" + std::to_string(configuration.viewCount) +
+           " bloom=" + (configuration.bloomEnabled ? "on" : "off") +
+           " aa=" + (configuration.antiAliasingEnabled ? "on" : "off");
+  }
+
+  std::vector<Configuration> getConfigurations(bool fullSweep) {
+    auto base = Configuration{
+        ALTITUDES[0], SUN_ELEVATIONS[2], EXTENTS[1], 1, false, false};
+    auto configurations = std::vector<Configuration>{};
+    if (fullSweep) {
+      for (auto altitude : ALTITUDES) {
+        for (auto sunElevation : SUN_ELEVATIONS) {
+          for (auto extent : EXTENTS) {
+            for (auto viewCount : VIEW_COUNTS) {
+              for (auto bloomEnabled : {false, true}) {
+                for (auto antiAliasingEnabled : {false, true}) {
+                  configurations.emplace_back(Configuration{
+                      altitude,
+                      sunElevation,
+                      extent,
+                      viewCount,
+                      bloomEnabled,
+                      antiAliasingEnabled});
+                }
+              }
+            }
+          }
+        }
+      }
+      return configurations;
+    }
+    configurations.emplace_back(base);
+    for (auto altitude : ALTITUDES) {
+      if (altitude != base.altitude) {
+        configurations.emplace_back(base).altitude = altitude;
+      }
+    }
+    for (auto sunElevation : SUN_ELEVATIONS) {
+      if (sunElevation != base.sunElevation) {
+        configurations.emplace_back(base).sunElevation = sunElevation;
+      }
+    }
+    for (auto extent : EXTENTS) {
+      if (extent.width != base.extent.width) {
+        configurations.emplace_back(base).extent = extent;
+      }
+    }
+    for (auto viewCount : VIEW_COUNTS) {
+      if (viewCount != base.viewCount) {
+        configurations.emplace_back(base).viewCount = viewCount;
+      }
+    }
+    configurations.emplace_back(base).bloomEnabled = true;
+    configurations.emplace_back(base).antiAliasingEnabled = true;
+    return configurations;
+  }
+
+  Eigen::Matrix4f getProjectionMatrix(imp::Extent2u const &extent) {
+    auto tanHalfFovY = 1.0f;
+    auto focalLength = 1.0f / tanHalfFovY;
+    auto aspectRatio = float(extent.width) / float(extent.height);
+    auto n = 0.01f;
+    auto f = 100.0f;
+    auto projectionMatrix = Eigen::Matrix4f::Zero().eval();
+    projectionMatrix(0, 0) = focalLength / aspectRatio;
+    projectionMatrix(1, 1) = -focalLength;
+    projectionMatrix(2, 2) = n / (f - n);
+    projectionMatrix(2, 3) = n * f / (f - n);
+    projectionMatrix(3, 2) = -1;
+    return projectionMatrix;
+  }
+} // namespace
+
+int main(int argc, char **argv) {
+  auto warmupFrameCount = 30;
+  auto measuredFrameCount = 120;
+  auto fullSweep = false;
+  auto dynamicRendering = true;
+  auto outputPath = std::string{"benchmark.csv"};
+  auto baselinePath = std::optional<std::string>{};
+  auto tolerance = 0.1;
+  auto minDifference = 0.05;
+  auto frameCount = std::size_t{3};
+  auto recordingThreadCount = std::size_t{};
+  for (auto i = 1; i < argc; ++i) {
+    if (std::string_view{argv[i]} == "--full-sweep") {
+      fullSweep = true;
+    } else if (std::string_view{argv[i]} == "--render-passes") {
+      dynamicRendering = false;
+    } else if (std::string_view{argv[i]} == "--warmup" && i + 1 < argc) {
+      warmupFrameCount = std::stoi(argv[++i]);
+    } else if (std::string_view{argv[i]} == "--frames" && i + 1 < argc) {
+      measuredFrameCount = std::stoi(argv[++i]);
+    } else if (std::string_view{argv[i]} == "--output" && i + 1 < argc) {
+      outputPath = argv[++i];
+    } else if (std::string_view{argv[i]} == "--baseline" && i + 1 < argc) {
+      baselinePath = argv[++i];
+    } else if (std::string_view{argv[i]} == "--tolerance" && i + 1 < argc) {
+      tolerance = std::stod(argv[++i]);
+    } else if (
+        std::string_view{argv[i]} == "--min-difference" && i + 1 < argc) {
+      minDifference = std::stod(argv[++i]);
+    } else if (std::string_view{argv[i]} == "--frame-count" && i + 1 < argc) {
+      frameCount = std::stoul(argv[++i]);
+    } else if (
+        std::string_view{argv[i]} == "--recording-threads" && i + 1 < argc) {
+      recordingThreadCount = std::stoul(argv[++i]);
+    }
+  }
+  imp::CpuProfiler::setEnabled(true);
+  imp::CpuProfiler::setThreadName("main");
+  try {
+    auto gpuContextCreateInfo = imp::GpuContextCreateInfo{};
+    gpuContextCreateInfo.validation = false;
+    gpuContextCreateInfo.presentation = false;
+    gpuContextCreateInfo.dynamicRendering = dynamicRendering;
+    auto gpuContext = imp::GpuContext{gpuContextCreateInfo};
+    auto target = imp::OffscreenTarget{
+        imp::gsl::not_null{&gpuContext}, TARGET_WIDTH, TARGET_HEIGHT};
+    auto renderer = imp::Renderer{
+        imp::gsl::not_null{&target},
+        frameCount,
+        imp::ImageFormats{
+            imp::ImageFormat::RGBA16F,
+            imp::ImageFormat::RGBA16F,
+            imp::ImageFormat::RGBA16F}};
+    renderer.setRecordingThreadCount(recordingThreadCount);
+    renderer.setProfilingEnabled(true);
+    if (!renderer.getProfiler().isSupported()) {
+      std::cerr << "gpu timestamps are not supported, reporting cpu only\n";
+    }
+    auto scene = imp::gsl::not_null{
+        std::make_shared<imp::Scene>(renderer.getSceneFlyweight())};
+    auto earth = imp::gsl::not_null{std::make_shared<imp::Planet>()};
+    earth->setPosition({0.0f, -earth->getGroundRadius(), 0.0f});
+    auto sun = imp::gsl::not_null{std::make_shared<imp::DirectionalLight>(
+        imp::Spectrum{191.4f},
+        Eigen::Vector3f{0.0f, -1.0f, 1.0f}.normalized())};
+    scene->setPlanet(earth);
+    scene->setSunLight(sun);
+    scene->setLutCache(std::make_shared<imp::LutCache>("./cache"));
+    auto views =
+        std::vector<imp::gsl::not_null<std::shared_ptr<imp::SceneView>>>{};
+    for (auto i = 0; i < VIEW_COUNTS.back(); ++i) {
+      views.emplace_back(std::make_shared<imp::SceneView>(
+          renderer.getSceneViewFlyweight(), scene, EXTENTS[1]));
+      views.back()->setName("view " + std::to_string(i));
+      views.back()->setExposure(1.0f / 10.0f);
+    }
+    auto report = imp::BenchmarkReport{};
+    for (auto &configuration : getConfigurations(fullSweep)) {
+      auto name = getName(configuration);
+      auto theta = configuration.sunElevation * 0.017453293f;
+      sun->setDirection({0.0f, std::sin(theta), -std::cos(theta)});
+      auto viewMatrix = Eigen::Matrix4f::Identity().eval();
+      viewMatrix(1, 3) = -configuration.altitude;
+      for (auto &view : views) {
+        view->setViewMatrix(viewMatrix);
+        view->setProjectionMatrix(getProjectionMatrix(configuration.extent));
+        view->setExtent(configuration.extent);
+        view->setBloomEnabled(configuration.bloomEnabled);
+        view->setAntiAliasingEnabled(configuration.antiAliasingEnabled);
+      }
+      auto columns = static_cast<int>(
+          std::sqrt(float(configuration.viewCount)));
+      auto width = static_cast<int>(TARGET_WIDTH) / columns;
+      auto height = static_cast<int>(TARGET_HEIGHT) / columns;
+      for (auto frame = 0; frame < warmupFrameCount + measuredFrameCount;
+           ++frame) {
+        if (frame == warmupFrameCount) {
+          imp::CpuProfiler::clear();
+          renderer.getProfiler().clearHistory();
+        }
+        imp::CpuProfiler::markFrame();
+        renderer.begin();
+        for (auto i = 0; i < configuration.viewCount; ++i) {
+          renderer.draw(
+              views[i],
+              i % columns * width,
+              i / columns * height,
+              width,
+              height);
+        }
+        renderer.end();
+      }
+      imp::CpuProfiler::markFrame();
+      gpuContext.getDevice().waitIdle();
+      auto frameTimes = imp::CpuProfiler::getFrameTimes();
+      report.add(imp::BenchmarkResult{
+          name,
+          "cpu/frame",
+          frameTimes.getCount(),
+          frameTimes.getAverage(),
+          frameTimes.getPercentile(0.95),
+          frameTimes.getPercentile(0.99)});
+      auto events = imp::CpuProfiler::getEvents();
+      auto cpuHistory = imp::TimingHistory{events.size() + 1};
+      for (auto &event : events) {
+        cpuHistory.record("cpu", event.name, (event.end - event.begin) * 1e-6);
+      }
+      for (auto &stats : cpuHistory.getStats()) {
+        report.add(name, "cpu/" + stats.pass, stats);
+      }
+      for (auto &stats : renderer.getProfiler().getHistory().getStats()) {
+        if (stats.owner == "all") {
+          report.add(name, "gpu/" + stats.pass, stats);
+        }
+      }
+      std::cout << name << ": " << frameTimes.getAverage()
+                << " ms cpu frame";
+      if (auto total = renderer.getProfiler().getHistory().getStats(
+              "all", "total")) {
+        std::cout << ", " << total->average << " ms gpu";
+      }
+      std::cout << "\n";
+    }
+    auto output = std::ofstream{outputPath};
+    report.writeCsv(output);
+    if (baselinePath) {
+      auto input = std::ifstream{*baselinePath};
+      if (!input) {
+        throw std::runtime_error{"failed to open baseline."};
+      }
+      auto baseline = imp::BenchmarkReport::readCsv(input);
+      auto regressions =
+          report.findRegressions(baseline, tolerance, minDifference);
+      for (auto &regression : regressions) {
+        std::cout << "regression: " << regression.configuration << " "
+                  << regression.metric << ": " << regression.baseline
+                  << " ms -> " << regression.current << " ms\n";
+      }
+      if (!regressions.empty()) {
+        return 1;
+      }
+    }
+  } catch (std::exception &e) {
+    std::cerr << e.what() << "\n";
+    return 1;
+  }
+  return 0;
+}
\ No newline at end of file
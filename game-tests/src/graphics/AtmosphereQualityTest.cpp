@@ -0,0 +1,161 @@
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+#include <graphics/AtmosphereQuality.h>
+
+#include "AtmosphereTestUtil.h"
+
+namespace {
+  constexpr auto QUALITIES = std::array{
+      imp::AtmosphereQuality::LOW,
+      imp::AtmosphereQuality::MEDIUM,
+      imp::AtmosphereQuality::HIGH,
+      imp::AtmosphereQuality::ULTRA};
+  constexpr auto QUALITY_NAMES = std::array{"low", "medium", "high", "ultra"};
+  constexpr auto SKY_VIEW_GRID =
+      imp::SkyViewGrid{4, 7, 0.1963495f, 0.1963495f};
+
+  class TransmittanceLut {
+  public:
+    TransmittanceLut(
+        imp::Planet const &planet,
+        imp::Extent3u const &extent,
+        std::uint32_t steps):
+        planet_{planet},
+        extent_{extent},
+        texels_{imp::createTransmittanceTexels(planet, extent, steps)} {}
+
+    Eigen::Vector3f sample(float altitude, float mu) const {
+      auto textureCoord = imp::getTransmittanceLutCoord(planet_, altitude, mu);
+      auto x = std::clamp(
+          textureCoord.x() * float(extent_.width) - 0.5f,
+          0.0f,
+          float(extent_.width - 1));
+      auto y = std::clamp(
+          textureCoord.y() * float(extent_.height) - 0.5f,
+          0.0f,
+          float(extent_.height - 1));
+      auto x0 = std::min(unsigned(x), extent_.width - 2);
+      auto y0 = std::min(unsigned(y), extent_.height - 2);
+      auto fx = x - float(x0);
+      auto fy = y - float(y0);
+      auto texel = [this](unsigned x, unsigned y) -> Eigen::Vector3f const & {
+        return texels_[y * extent_.width + x];
+      };
+      return (1.0f - fy) *
+                 ((1.0f - fx) * texel(x0, y0) + fx * texel(x0 + 1, y0)) +
+             fy * ((1.0f - fx) * texel(x0, y0 + 1) +
+                   fx * texel(x0 + 1, y0 + 1));
+    }
+
+  private:
+    imp::Planet planet_;
+    imp::Extent3u extent_;
+    std::vector<Eigen::Vector3f> texels_;
+  };
+
+  float measureLutError(
+      imp::Planet const &planet,
+      imp::AtmosphereQualitySettings const &settings) {
+    auto lut = TransmittanceLut{
+        planet, settings.transmittanceExtent, settings.transmittanceSteps};
+    return imp::measureTransmittanceError(
+        planet, [&](float altitude, float mu) {
+          return lut.sample(altitude, mu);
+        });
+  }
+
+  template <typename F>
+  double measureThroughput(imp::Planet const &planet, F &&f) {
+    constexpr auto count = 1 << 16;
+    auto atmosphereHeight =
+        planet.getAtmosphereRadius() - planet.getGroundRadius();
+    auto sum = Eigen::Vector3f{Eigen::Vector3f::Zero()};
+    auto start = std::chrono::steady_clock::now();
+    for (auto i = 0; i < count; ++i) {
+      auto altitude = atmosphereHeight * float(i % 256) / 256.0f;
+      auto mu = float(i / 256) / 128.0f - 1.0f;
+      sum += f(altitude, mu);
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    EXPECT_TRUE(sum.allFinite());
+    return double(count) / std::chrono::duration<double>{elapsed}.count();
+  }
+} // namespace
+
+TEST(AtmosphereQualityTest, errorVersusCost) {
+  auto planet = imp::Planet{};
+  auto skyViewReferences = imp::createSkyViewSamples(
+      planet,
+      SKY_VIEW_GRID,
+      imp::REFERENCE_SKY_VIEW_STEPS,
+      imp::REFERENCE_TRANSMITTANCE_STEPS,
+      imp::AtmosphereSampling::UNIFORM);
+  auto transmittanceErrors = std::array<float, QUALITIES.size()>{};
+  auto skyViewErrors = std::array<float, QUALITIES.size()>{};
+  for (auto i = std::size_t{}; i < QUALITIES.size(); ++i) {
+    auto settings = imp::getAtmosphereQualitySettings(QUALITIES[i]);
+    auto transmittanceCost = std::uint64_t{settings.transmittanceSteps} *
+                             settings.transmittanceExtent.width *
+                             settings.transmittanceExtent.height;
+    auto skyViewCost = std::uint64_t{settings.skyViewSteps} *
+                       settings.skyViewExtent.width *
+                       settings.skyViewExtent.height;
+    transmittanceErrors[i] = measureLutError(planet, settings);
+    skyViewErrors[i] = imp::measureSkyViewError(
+        planet,
+        skyViewReferences,
+        settings.skyViewSteps,
+        settings.transmittanceSteps,
+        imp::AtmosphereSampling::UNIFORM);
+    std::cout << QUALITY_NAMES[i] << ": transmittance " << transmittanceCost
+              << " samples, max abs error " << transmittanceErrors[i]
+              << "; sky view " << skyViewCost
+              << " samples, max rel error " << skyViewErrors[i] << "\n";
+  }
+  for (auto i = std::size_t{1}; i < QUALITIES.size(); ++i) {
+    EXPECT_LE(transmittanceErrors[i], transmittanceErrors[i - 1]);
+    EXPECT_LE(skyViewErrors[i], skyViewErrors[i - 1]);
+  }
+  EXPECT_LT(transmittanceErrors[2], 0.05f);
+}
+
+TEST(AtmosphereQualityTest, analyticTransmittance) {
+  auto planet = imp::Planet{};
+  auto settings =
+      imp::getAtmosphereQualitySettings(imp::AtmosphereQuality::HIGH);
+  auto lut = TransmittanceLut{
+      planet, settings.transmittanceExtent, settings.transmittanceSteps};
+  auto sampleLut = [&](float altitude, float mu) {
+    return lut.sample(altitude, mu);
+  };
+  auto calcAnalytic = [&](float altitude, float mu) {
+    return imp::calcAnalyticTransmittance(planet, altitude, mu);
+  };
+  auto calcMarched = [&](float altitude, float mu) {
+    return imp::calcTransmittance(
+        planet,
+        altitude,
+        mu,
+        settings.transmittanceSteps,
+        imp::AtmosphereSampling::UNIFORM);
+  };
+  auto lutError = imp::measureTransmittanceError(planet, sampleLut);
+  auto analyticError = imp::measureTransmittanceError(planet, calcAnalytic);
+  auto lutThroughput = measureThroughput(planet, sampleLut);
+  auto analyticThroughput = measureThroughput(planet, calcAnalytic);
+  auto marchedThroughput = measureThroughput(planet, calcMarched);
+  std::cout << "lut: max abs error " << lutError << ", " << lutThroughput
+            << " samples/s, "
+            << settings.transmittanceExtent.width *
+                   settings.transmittanceExtent.height
+            << " texels at " << marchedThroughput << " texels/s\n";
+  std::cout << "analytic: max abs error " << analyticError << ", "
+            << analyticThroughput << " samples/s\n";
+  EXPECT_LT(analyticError, lutError);
+}
\ No newline at end of file
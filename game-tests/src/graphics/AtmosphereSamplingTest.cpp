@@ -0,0 +1,70 @@
+#include "gtest/gtest.h"
+
+#include <array>
+#include <iostream>
+
+#include <graphics/AtmosphereQuality.h>
+
+#include "AtmosphereTestUtil.h"
+
+namespace {
+  constexpr auto SAMPLINGS = std::array{
+      imp::AtmosphereSampling::UNIFORM,
+      imp::AtmosphereSampling::IMPORTANCE,
+      imp::AtmosphereSampling::EXPONENTIAL};
+  constexpr auto SAMPLING_NAMES =
+      std::array{"uniform", "importance", "exponential"};
+  constexpr auto STEP_COUNTS = std::array{4u, 8u, 16u, 40u};
+  constexpr auto SKY_VIEW_GRID =
+      imp::SkyViewGrid{4, 9, -0.1863495f, 0.1963495f};
+} // namespace
+
+TEST(AtmosphereSamplingTest, transmittanceErrorVersusSteps) {
+  auto planet = imp::Planet{};
+  auto errors = std::array<std::array<float, STEP_COUNTS.size()>,
+                           SAMPLINGS.size()>{};
+  for (auto i = std::size_t{}; i < SAMPLINGS.size(); ++i) {
+    for (auto j = std::size_t{}; j < STEP_COUNTS.size(); ++j) {
+      errors[i][j] = imp::measureTransmittanceError(
+          planet, STEP_COUNTS[j], SAMPLINGS[i]);
+      std::cout << SAMPLING_NAMES[i] << ": " << STEP_COUNTS[j]
+                << " steps, max abs error " << errors[i][j] << "\n";
+    }
+  }
+  for (auto i = std::size_t{}; i < SAMPLINGS.size(); ++i) {
+    for (auto j = std::size_t{1}; j < STEP_COUNTS.size(); ++j) {
+      EXPECT_LE(errors[i][j], errors[i][j - 1]);
+    }
+  }
+  EXPECT_LE(errors[1][2], errors[0][3]);
+  EXPECT_LE(errors[2][2], errors[0][3]);
+}
+
+TEST(AtmosphereSamplingTest, skyViewErrorVersusSteps) {
+  auto planet = imp::Planet{};
+  auto transmittanceSteps =
+      imp::getAtmosphereQualitySettings(imp::AtmosphereQuality::HIGH)
+          .transmittanceSteps;
+  auto references = imp::createSkyViewSamples(
+      planet,
+      SKY_VIEW_GRID,
+      imp::REFERENCE_SKY_VIEW_STEPS,
+      imp::REFERENCE_TRANSMITTANCE_STEPS,
+      imp::AtmosphereSampling::UNIFORM);
+  auto errors = std::array<std::array<float, STEP_COUNTS.size()>,
+                           SAMPLINGS.size()>{};
+  for (auto i = std::size_t{}; i < SAMPLINGS.size(); ++i) {
+    for (auto j = std::size_t{}; j < STEP_COUNTS.size(); ++j) {
+      errors[i][j] = imp::measureSkyViewError(
+          planet,
+          references,
+          STEP_COUNTS[j],
+          transmittanceSteps,
+          SAMPLINGS[i]);
+      std::cout << SAMPLING_NAMES[i] << ": " << STEP_COUNTS[j]
+                << " steps, max rel error " << errors[i][j] << "\n";
+    }
+  }
+  EXPECT_LE(errors[1][2], errors[0][3]);
+  EXPECT_LE(errors[2][1], errors[0][3]);
+}
\ No newline at end of file
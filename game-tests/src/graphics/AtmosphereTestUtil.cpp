@@ -0,0 +1,87 @@
+#include "AtmosphereTestUtil.h"
+
+#include <cmath>
+
+namespace imp {
+  std::vector<Eigen::Vector3f> createTransmittanceTexels(
+      Planet const &planet, Extent3u const &extent, std::uint32_t steps) {
+    auto texels = std::vector<Eigen::Vector3f>{};
+    texels.reserve(extent.width * extent.height);
+    for (auto y = 0u; y < extent.height; ++y) {
+      for (auto x = 0u; x < extent.width; ++x) {
+        auto textureCoord = Eigen::Vector2f{
+            (float(x) + 0.5f) / float(extent.width),
+            (float(y) + 0.5f) / float(extent.height)};
+        texels.emplace_back(calcTransmittanceLut(
+            planet, textureCoord, steps, AtmosphereSampling::UNIFORM));
+      }
+    }
+    return texels;
+  }
+
+  std::vector<SkyViewSample> createSkyViewSamples(
+      Planet const &planet,
+      SkyViewGrid const &grid,
+      std::uint32_t steps,
+      std::uint32_t transmittanceSteps,
+      AtmosphereSampling sampling) {
+    auto samples = std::vector<SkyViewSample>{};
+    for (auto altitude : {100.0f, 10000.0f}) {
+      for (auto i = 0u; i < grid.longitudeCount; ++i) {
+        for (auto j = 0u; j < grid.latitudeCount; ++j) {
+          auto longitude =
+              float(i) * 6.2831853f / float(grid.longitudeCount);
+          auto latitude = grid.minLatitude + float(j) * grid.latitudeStep;
+          auto viewDirection = Eigen::Vector3f{
+              std::cos(latitude) * std::cos(longitude),
+              std::cos(latitude) * std::sin(longitude),
+              std::sin(latitude)};
+          samples.push_back(
+              {altitude,
+               viewDirection,
+               calcSkyRadiance(
+                   planet,
+                   altitude,
+                   viewDirection,
+                   TEST_SUN_DIRECTION,
+                   steps,
+                   transmittanceSteps,
+                   sampling)});
+        }
+      }
+    }
+    return samples;
+  }
+
+  float measureTransmittanceError(
+      Planet const &planet, std::uint32_t steps, AtmosphereSampling sampling) {
+    return measureTransmittanceError(planet, [&](float altitude, float mu) {
+      return calcTransmittance(planet, altitude, mu, steps, sampling);
+    });
+  }
+
+  float measureSkyViewError(
+      Planet const &planet,
+      std::vector<SkyViewSample> const &references,
+      std::uint32_t steps,
+      std::uint32_t transmittanceSteps,
+      AtmosphereSampling sampling) {
+    auto error = 0.0f;
+    for (auto const &reference : references) {
+      auto value = calcSkyRadiance(
+          planet,
+          reference.altitude,
+          reference.viewDirection,
+          TEST_SUN_DIRECTION,
+          steps,
+          transmittanceSteps,
+          sampling);
+      error = std::max(
+          error,
+          ((value - reference.radiance).array().abs() /
+           reference.radiance.array())
+              .maxCoeff());
+    }
+    return error;
+  }
+} // namespace imp
\ No newline at end of file
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include <graphics/AtmosphereModel.h>
+#include <graphics/Planet.h>
+#include <util/Extent.h>
+
+namespace imp {
+  constexpr auto REFERENCE_TRANSMITTANCE_STEPS = std::uint32_t{1024};
+  constexpr auto REFERENCE_SKY_VIEW_STEPS = std::uint32_t{256};
+
+  inline Eigen::Vector3f const TEST_SUN_DIRECTION =
+      Eigen::Vector3f{0.0f, 0.9848f, 0.1736f}.normalized();
+
+  struct SkyViewGrid {
+    unsigned longitudeCount;
+    unsigned latitudeCount;
+    float minLatitude;
+    float latitudeStep;
+  };
+
+  struct SkyViewSample {
+    float altitude;
+    Eigen::Vector3f viewDirection;
+    Eigen::Vector3f radiance;
+  };
+
+  std::vector<Eigen::Vector3f> createTransmittanceTexels(
+      Planet const &planet, Extent3u const &extent, std::uint32_t steps);
+
+  std::vector<SkyViewSample> createSkyViewSamples(
+      Planet const &planet,
+      SkyViewGrid const &grid,
+      std::uint32_t steps,
+      std::uint32_t transmittanceSteps,
+      AtmosphereSampling sampling);
+
+  template<typename F>
+  float measureTransmittanceError(Planet const &planet, F &&f) {
+    auto atmosphereHeight =
+        planet.getAtmosphereRadius() - planet.getGroundRadius();
+    auto error = 0.0f;
+    for (auto i = 0; i < 16; ++i) {
+      auto altitude = atmosphereHeight * float(i * i) / 256.0f;
+      for (auto j = 0; j <= 32; ++j) {
+        auto mu = float(j) / 16.0f - 1.0f;
+        auto reference = calcTransmittance(
+            planet,
+            altitude,
+            mu,
+            REFERENCE_TRANSMITTANCE_STEPS,
+            AtmosphereSampling::UNIFORM);
+        error = std::max(
+            error, (f(altitude, mu) - reference).cwiseAbs().maxCoeff());
+      }
+    }
+    return error;
+  }
+
+  float measureTransmittanceError(
+      Planet const &planet, std::uint32_t steps, AtmosphereSampling sampling);
+
+  float measureSkyViewError(
+      Planet const &planet,
+      std::vector<SkyViewSample> const &references,
+      std::uint32_t steps,
+      std::uint32_t transmittanceSteps,
+      AtmosphereSampling sampling);
+} // namespace imp
\ No newline at end of file
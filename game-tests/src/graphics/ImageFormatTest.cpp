@@ -0,0 +1,234 @@
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+#include <graphics/AtmosphereQuality.h>
+#include <graphics/ImageFormat.h>
+
+#include "AtmosphereTestUtil.h"
+
+namespace {
+  using Format = imp::ImageFormat;
+
+  constexpr auto FORMATS =
+      std::array{Format::RGBA16F, Format::B10G11R11, Format::E5B9G9R9};
+  constexpr auto FORMAT_NAMES =
+      std::array{"rgba16f", "b10g11r11", "e5b9g9r9"};
+  constexpr auto TEXEL_SIZES = std::array{8u, 4u, 4u};
+  constexpr auto PRIMARY_WIDTH = 1920u;
+  constexpr auto PRIMARY_HEIGHT = 1080u;
+  constexpr auto STORAGE_FEATURES =
+      vk::FormatFeatureFlagBits::eSampledImage |
+      vk::FormatFeatureFlagBits::eColorAttachment |
+      vk::FormatFeatureFlagBits::eStorageImage;
+  constexpr auto SAMPLED_FEATURES =
+      vk::FormatFeatureFlagBits::eSampledImage |
+      vk::FormatFeatureFlagBits::eColorAttachment;
+  constexpr auto SKY_VIEW_GRID =
+      imp::SkyViewGrid{16, 32, -0.7853982f, 0.0490874f};
+
+  float quantizeFloat(float x, int mantissaBits, float maxValue) {
+    if (!(x > 0.0f)) {
+      return 0.0f;
+    }
+    auto exponent = 0;
+    std::frexp(x, &exponent);
+    auto step = std::ldexp(1.0f, std::max(exponent - 1, -14) - mantissaBits);
+    return std::min(std::round(x / step) * step, maxValue);
+  }
+
+  Eigen::Vector3f quantizeSharedExponent(Eigen::Vector3f const &x) {
+    constexpr auto bias = 15;
+    constexpr auto mantissaBits = 9;
+    auto maxValue = 511.0f / 512.0f * 65536.0f;
+    auto clamped = x.cwiseMax(0.0f).cwiseMin(maxValue).eval();
+    auto maxChannel = clamped.maxCoeff();
+    auto exponent =
+        std::max(-bias - 1, int(std::floor(std::log2(maxChannel)))) + 1 +
+        bias;
+    if (std::floor(
+            maxChannel / std::ldexp(1.0f, exponent - bias - mantissaBits) +
+            0.5f) == float(1 << mantissaBits)) {
+      ++exponent;
+    }
+    auto step = std::ldexp(1.0f, exponent - bias - mantissaBits);
+    return ((clamped / step).array() + 0.5f).floor().matrix() * step;
+  }
+
+  Eigen::Vector3f quantize(Format format, Eigen::Vector3f const &x) {
+    switch (format) {
+    case Format::B10G11R11:
+      return {
+          quantizeFloat(x.x(), 6, 65024.0f),
+          quantizeFloat(x.y(), 6, 65024.0f),
+          quantizeFloat(x.z(), 5, 64512.0f)};
+    case Format::E5B9G9R9:
+      return quantizeSharedExponent(x);
+    default:
+      return {
+          quantizeFloat(x.x(), 10, 65504.0f),
+          quantizeFloat(x.y(), 10, 65504.0f),
+          quantizeFloat(x.z(), 10, 65504.0f)};
+    }
+  }
+
+  struct ImageDifference {
+    float maxError;
+    float meanError;
+  };
+
+  ImageDifference compareImages(
+      Format format,
+      std::vector<Eigen::Vector3f> const &image,
+      float minScale) {
+    auto difference = ImageDifference{};
+    for (auto const &texel : image) {
+      auto error = ((quantize(format, texel) - texel).array().abs() /
+                    std::max(texel.maxCoeff(), minScale))
+                       .maxCoeff();
+      difference.maxError = std::max(difference.maxError, error);
+      difference.meanError += error / float(image.size());
+    }
+    return difference;
+  }
+
+  vk::Format selectFormat(
+      Format format,
+      vk::FormatFeatureFlags features,
+      vk::FormatFeatureFlags supportedFeatures,
+      bool storageImageWriteWithoutFormatSupported,
+      std::vector<vk::Format> *queries = nullptr) {
+    return imp::selectImageFormat(
+        format,
+        features,
+        [&](vk::Format vkFormat) {
+          if (queries) {
+            queries->push_back(vkFormat);
+          }
+          auto properties = vk::FormatProperties{};
+          properties.optimalTilingFeatures = supportedFeatures;
+          return properties;
+        },
+        storageImageWriteWithoutFormatSupported);
+  }
+} // namespace
+
+TEST(ImageFormatTest, keepsRgba16f) {
+  auto queries = std::vector<vk::Format>{};
+  EXPECT_EQ(
+      selectFormat(Format::RGBA16F, STORAGE_FEATURES, {}, false, &queries),
+      vk::Format::eR16G16B16A16Sfloat);
+  EXPECT_TRUE(queries.empty());
+}
+
+TEST(ImageFormatTest, selectsSupportedPackedFormats) {
+  auto queries = std::vector<vk::Format>{};
+  EXPECT_EQ(
+      selectFormat(
+          Format::B10G11R11,
+          STORAGE_FEATURES,
+          STORAGE_FEATURES,
+          true,
+          &queries),
+      vk::Format::eB10G11R11UfloatPack32);
+  EXPECT_EQ(
+      selectFormat(
+          Format::E5B9G9R9,
+          STORAGE_FEATURES,
+          STORAGE_FEATURES,
+          true,
+          &queries),
+      vk::Format::eE5B9G9R9UfloatPack32);
+  EXPECT_EQ(
+      queries,
+      (std::vector<vk::Format>{
+          vk::Format::eB10G11R11UfloatPack32,
+          vk::Format::eE5B9G9R9UfloatPack32}));
+}
+
+TEST(ImageFormatTest, fallsBackWithoutFeatures) {
+  EXPECT_EQ(
+      selectFormat(Format::B10G11R11, SAMPLED_FEATURES, {}, true),
+      vk::Format::eR16G16B16A16Sfloat);
+  EXPECT_EQ(
+      selectFormat(
+          Format::E5B9G9R9, STORAGE_FEATURES, SAMPLED_FEATURES, true),
+      vk::Format::eR16G16B16A16Sfloat);
+}
+
+TEST(ImageFormatTest, fallsBackWithoutStorageWriteWithoutFormat) {
+  EXPECT_EQ(
+      selectFormat(
+          Format::B10G11R11, STORAGE_FEATURES, STORAGE_FEATURES, false),
+      vk::Format::eR16G16B16A16Sfloat);
+  EXPECT_EQ(
+      selectFormat(
+          Format::B10G11R11, SAMPLED_FEATURES, STORAGE_FEATURES, false),
+      vk::Format::eB10G11R11UfloatPack32);
+}
+
+TEST(ImageFormatTest, transmittanceDifference) {
+  auto planet = imp::Planet{};
+  auto settings =
+      imp::getAtmosphereQualitySettings(imp::AtmosphereQuality::HIGH);
+  auto image = imp::createTransmittanceTexels(
+      planet, settings.transmittanceExtent, settings.transmittanceSteps);
+  auto differences = std::array<ImageDifference, FORMATS.size()>{};
+  for (auto i = std::size_t{}; i < FORMATS.size(); ++i) {
+    differences[i] = compareImages(FORMATS[i], image, 1.0f);
+    std::cout << FORMAT_NAMES[i] << ": max abs error "
+              << differences[i].maxError << ", mean abs error "
+              << differences[i].meanError << ", "
+              << image.size() * TEXEL_SIZES[i] << " bytes\n";
+  }
+  EXPECT_LE(differences[0].maxError, 1.0f / 4096.0f);
+  EXPECT_LE(differences[1].maxError, 1.0f / 128.0f);
+  EXPECT_LE(differences[2].maxError, 1.0f / 256.0f);
+}
+
+TEST(ImageFormatTest, skyViewDifference) {
+  auto planet = imp::Planet{};
+  auto settings =
+      imp::getAtmosphereQualitySettings(imp::AtmosphereQuality::LOW);
+  auto image = std::vector<Eigen::Vector3f>{};
+  for (auto const &sample : imp::createSkyViewSamples(
+           planet,
+           SKY_VIEW_GRID,
+           settings.skyViewSteps,
+           settings.transmittanceSteps,
+           imp::AtmosphereSampling::UNIFORM)) {
+    image.push_back(sample.radiance);
+  }
+  auto differences = std::array<ImageDifference, FORMATS.size()>{};
+  for (auto i = std::size_t{}; i < FORMATS.size(); ++i) {
+    differences[i] = compareImages(FORMATS[i], image, 0.0f);
+    std::cout << FORMAT_NAMES[i] << ": max rel error "
+              << differences[i].maxError << ", mean rel error "
+              << differences[i].meanError << "\n";
+  }
+  EXPECT_LE(differences[0].maxError, 1.0f / 1024.0f);
+  EXPECT_LE(differences[1].maxError, 1.0f / 32.0f);
+  EXPECT_LE(differences[2].maxError, 1.0f / 256.0f);
+}
+
+TEST(ImageFormatTest, bandwidth) {
+  auto high = imp::getAtmosphereQualitySettings(imp::AtmosphereQuality::HIGH);
+  auto lutTexels = high.transmittanceExtent.width *
+                       high.transmittanceExtent.height +
+                   high.skyViewExtent.width * high.skyViewExtent.height;
+  auto primaryTexels = 0u;
+  for (auto i = 0u; i < 5; ++i) {
+    primaryTexels += (PRIMARY_WIDTH >> i) * (PRIMARY_HEIGHT >> i);
+  }
+  for (auto i = std::size_t{}; i < FORMATS.size(); ++i) {
+    std::cout << FORMAT_NAMES[i] << ": " << lutTexels * TEXEL_SIZES[i]
+              << " lut bytes, " << primaryTexels * TEXEL_SIZES[i]
+              << " primary chain bytes\n";
+  }
+  EXPECT_EQ(2 * TEXEL_SIZES[1], TEXEL_SIZES[0]);
+  EXPECT_EQ(2 * TEXEL_SIZES[2], TEXEL_SIZES[0]);
+}
\ No newline at end of file
@@ -0,0 +1,47 @@
+#include "AllocationCounter.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace {
+  auto armed = std::atomic<bool>{};
+  auto allocationCount = std::atomic<std::size_t>{};
+} // namespace
+
+void *operator new(std::size_t size) {
+  if (armed.load(std::memory_order_relaxed)) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+  }
+  if (auto p = std::malloc(size ? size : 1)) {
+    return p;
+  }
+  throw std::bad_alloc{};
+}
+
+void operator delete(void *p) noexcept {
+  std::free(p);
+}
+
+void operator delete(void *p, std::size_t) noexcept {
+  std::free(p);
+}
+
+namespace imp {
+  AllocationCounter::AllocationCounter() noexcept {
+    allocationCount = 0;
+    armed = true;
+  }
+
+  AllocationCounter::~AllocationCounter() {
+    armed = false;
+  }
+
+  std::size_t AllocationCounter::getCount() const noexcept {
+    return allocationCount;
+  }
+
+  void AllocationCounter::reset() noexcept {
+    allocationCount = 0;
+  }
+} // namespace imp
\ No newline at end of file
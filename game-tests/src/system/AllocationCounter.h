@@ -0,0 +1,17 @@
+#pragma once
+
+#include <cstddef>
+
+namespace imp {
+  class AllocationCounter {
+  public:
+    AllocationCounter() noexcept;
+    ~AllocationCounter();
+
+    AllocationCounter(AllocationCounter const &) = delete;
+    AllocationCounter &operator=(AllocationCounter const &) = delete;
+
+    std::size_t getCount() const noexcept;
+    void reset() noexcept;
+  };
+} // namespace imp
\ No newline at end of file
@@ -0,0 +1,55 @@
+#include "gtest/gtest.h"
+
+#include <sstream>
+#include <stdexcept>
+
+#include <system/BenchmarkReport.h>
+
+TEST(BenchmarkReportTest, roundTripsCsv) {
+  auto report = imp::BenchmarkReport{};
+  report.add({"altitude=64 views=1", "gpu/primary", 120, 1.5, 2.0, 2.5});
+  report.add(
+      "altitude=64 views=1",
+      "cpu/Renderer::end",
+      imp::TimingStats{"cpu", "Renderer::end", 120, 0.1, 0.25, 0.5, 0.75});
+  auto os = std::stringstream{};
+  report.writeCsv(os);
+  auto read = imp::BenchmarkReport::readCsv(os);
+  ASSERT_EQ(read.getResults().size(), 2);
+  auto result = read.find("altitude=64 views=1", "cpu/Renderer::end");
+  ASSERT_TRUE(result);
+  EXPECT_EQ(result->sampleCount, 120);
+  EXPECT_DOUBLE_EQ(result->average, 0.25);
+  EXPECT_DOUBLE_EQ(result->p95, 0.5);
+  EXPECT_DOUBLE_EQ(result->p99, 0.75);
+  EXPECT_FALSE(read.find("altitude=256 views=1", "gpu/primary"));
+}
+
+TEST(BenchmarkReportTest, rejectsSeparatorsAndBadRows) {
+  auto report = imp::BenchmarkReport{};
+  EXPECT_THROW(
+      report.add({"a,b", "gpu/primary", 1, 1.0, 1.0, 1.0}),
+      std::runtime_error);
+  auto badHeader = std::istringstream{"a,b,c\n"};
+  EXPECT_THROW(imp::BenchmarkReport::readCsv(badHeader), std::runtime_error);
+  auto badRow = std::istringstream{
+      "configuration,metric,samples,average,p95,p99\nx,y,1,fast,1,1\n"};
+  EXPECT_THROW(imp::BenchmarkReport::readCsv(badRow), std::runtime_error);
+}
+
+TEST(BenchmarkReportTest, flagsRegressions) {
+  auto baseline = imp::BenchmarkReport{};
+  baseline.add({"base", "gpu/primary", 1, 2.0, 2.0, 2.0});
+  baseline.add({"base", "gpu/composite", 1, 0.01, 0.01, 0.01});
+  baseline.add({"base", "gpu/sky view", 1, 1.0, 1.0, 1.0});
+  auto current = imp::BenchmarkReport{};
+  current.add({"base", "gpu/primary", 1, 2.5, 2.5, 2.5});
+  current.add({"base", "gpu/composite", 1, 0.02, 0.02, 0.02});
+  current.add({"base", "gpu/sky view", 1, 1.05, 1.05, 1.05});
+  current.add({"base", "gpu/bloom", 1, 9.0, 9.0, 9.0});
+  auto regressions = current.findRegressions(baseline, 0.1, 0.05);
+  ASSERT_EQ(regressions.size(), 1);
+  EXPECT_EQ(regressions[0].metric, "gpu/primary");
+  EXPECT_DOUBLE_EQ(regressions[0].baseline, 2.0);
+  EXPECT_DOUBLE_EQ(regressions[0].current, 2.5);
+}
\ No newline at end of file
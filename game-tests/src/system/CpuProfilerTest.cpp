@@ -0,0 +1,142 @@
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <atomic>
+#include <latch>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <system/CpuProfiler.h>
+
+namespace {
+  std::size_t countEvents(std::string const &name) {
+    auto events = imp::CpuProfiler::getEvents();
+    return std::count_if(events.begin(), events.end(), [&](auto &event) {
+      return event.name == name;
+    });
+  }
+
+  std::size_t countThreads() {
+    auto os = std::ostringstream{};
+    imp::CpuProfiler::writeChromeTrace(os);
+    auto trace = os.str();
+    auto count = std::size_t{};
+    for (auto i = trace.find("thread_name"); i != std::string::npos;
+         i = trace.find("thread_name", i + 1)) {
+      ++count;
+    }
+    return count;
+  }
+} // namespace
+
+TEST(CpuProfilerTest, recordsZonesWhenEnabled) {
+  imp::CpuProfiler::clear();
+  imp::CpuProfiler::setEnabled(true);
+  {
+    IMP_CPU_ZONE("outer");
+    IMP_CPU_ZONE("inner");
+  }
+  imp::CpuProfiler::setEnabled(false);
+  auto events = imp::CpuProfiler::getEvents();
+  EXPECT_EQ(countEvents("outer"), 1);
+  EXPECT_EQ(countEvents("inner"), 1);
+  for (auto &event : events) {
+    EXPECT_LE(event.begin, event.end);
+  }
+}
+
+TEST(CpuProfilerTest, ignoresZonesWhenDisabled) {
+  imp::CpuProfiler::clear();
+  imp::CpuProfiler::setEnabled(false);
+  {
+    IMP_CPU_ZONE("disabled");
+  }
+  EXPECT_EQ(countEvents("disabled"), 0);
+}
+
+TEST(CpuProfilerTest, keepsLatestEventsPerThread) {
+  imp::CpuProfiler::clear();
+  imp::CpuProfiler::setEnabled(true);
+  auto threads = std::vector<std::thread>{};
+  auto recorded = std::latch{4};
+  for (auto i = 0; i < 4; ++i) {
+    threads.emplace_back([&recorded]() {
+      for (auto j = std::size_t{}; j < imp::CpuProfiler::BUFFER_CAPACITY + 10;
+           ++j) {
+        IMP_CPU_ZONE("worker");
+      }
+      recorded.arrive_and_wait();
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  imp::CpuProfiler::setEnabled(false);
+  EXPECT_EQ(countEvents("worker"), 4 * imp::CpuProfiler::BUFFER_CAPACITY);
+}
+
+TEST(CpuProfilerTest, reusesBuffersOfExitedThreads) {
+  imp::CpuProfiler::clear();
+  imp::CpuProfiler::setEnabled(true);
+  std::thread{[]() { IMP_CPU_ZONE("first"); }}.join();
+  auto threadCount = countThreads();
+  for (auto i = 0; i < 8; ++i) {
+    std::thread{[]() { IMP_CPU_ZONE("next"); }}.join();
+  }
+  imp::CpuProfiler::setEnabled(false);
+  EXPECT_EQ(countThreads(), threadCount);
+  EXPECT_EQ(countEvents("next"), 1);
+}
+
+TEST(CpuProfilerTest, exportsWhileThreadsRecord) {
+  imp::CpuProfiler::clear();
+  imp::CpuProfiler::setEnabled(true);
+  auto running = std::atomic<bool>{true};
+  auto thread = std::thread{[&running]() {
+    while (running) {
+      IMP_CPU_ZONE("busy");
+    }
+  }};
+  for (auto i = 0; i < 64; ++i) {
+    for (auto &event : imp::CpuProfiler::getEvents()) {
+      EXPECT_LE(event.begin, event.end);
+    }
+    imp::CpuProfiler::clear();
+  }
+  running = false;
+  thread.join();
+  imp::CpuProfiler::setEnabled(false);
+}
+
+TEST(CpuProfilerTest, recordsFrameTimes) {
+  imp::CpuProfiler::clear();
+  imp::CpuProfiler::setEnabled(true);
+  for (auto i = 0; i < 4; ++i) {
+    imp::CpuProfiler::markFrame();
+  }
+  imp::CpuProfiler::setEnabled(false);
+  EXPECT_EQ(imp::CpuProfiler::getFrameTimes().getCount(), 3);
+  EXPECT_EQ(countEvents("frame"), 3);
+}
+
+TEST(CpuProfilerTest, writesChromeTrace) {
+  imp::CpuProfiler::clear();
+  imp::CpuProfiler::setEnabled(true);
+  imp::CpuProfiler::setThreadName("main");
+  {
+    IMP_CPU_ZONE("poll");
+  }
+  imp::CpuProfiler::setEnabled(false);
+  auto os = std::ostringstream{};
+  imp::CpuProfiler::writeChromeTrace(os);
+  auto trace = os.str();
+  EXPECT_EQ(
+      trace.rfind("{\"displayTimeUnit\": \"ms\", \"traceEvents\": [", 0),
+      0);
+  EXPECT_NE(trace.find("\"args\": {\"name\": \"main\"}"), std::string::npos);
+  EXPECT_NE(
+      trace.find("{\"name\": \"poll\", \"ph\": \"X\", \"pid\": 1"),
+      std::string::npos);
+}
\ No newline at end of file
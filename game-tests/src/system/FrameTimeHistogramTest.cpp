@@ -0,0 +1,41 @@
+#include "gtest/gtest.h"
+
+#include <sstream>
+
+#include <system/FrameTimeHistogram.h>
+
+TEST(FrameTimeHistogramTest, computesPercentiles) {
+  auto histogram = imp::FrameTimeHistogram{1.0, 100};
+  for (auto i = 0; i < 100; ++i) {
+    histogram.record(i + 0.5);
+  }
+  EXPECT_EQ(histogram.getCount(), 100);
+  EXPECT_DOUBLE_EQ(histogram.getAverage(), 50.0);
+  EXPECT_DOUBLE_EQ(histogram.getPercentile(0.5), 50.0);
+  EXPECT_DOUBLE_EQ(histogram.getPercentile(0.95), 95.0);
+  EXPECT_DOUBLE_EQ(histogram.getPercentile(0.99), 99.0);
+  EXPECT_DOUBLE_EQ(histogram.getPercentile(1.0), 99.5);
+}
+
+TEST(FrameTimeHistogramTest, clampsToLastBucket) {
+  auto histogram = imp::FrameTimeHistogram{1.0, 10};
+  histogram.record(2.5);
+  histogram.record(250.0);
+  EXPECT_EQ(histogram.getBuckets()[2], 1);
+  EXPECT_EQ(histogram.getBuckets()[9], 1);
+  EXPECT_DOUBLE_EQ(histogram.getMax(), 250.0);
+  EXPECT_DOUBLE_EQ(histogram.getPercentile(1.0), 250.0);
+  histogram.clear();
+  EXPECT_EQ(histogram.getCount(), 0);
+  EXPECT_DOUBLE_EQ(histogram.getPercentile(0.5), 0.0);
+}
+
+TEST(FrameTimeHistogramTest, writesCsv) {
+  auto histogram = imp::FrameTimeHistogram{0.5, 4};
+  histogram.record(0.75);
+  histogram.record(0.8);
+  histogram.record(9.0);
+  auto os = std::ostringstream{};
+  histogram.writeCsv(os);
+  EXPECT_EQ(os.str(), "min,max,count\n0.5,1,2\n1.5,,1\n");
+}
\ No newline at end of file
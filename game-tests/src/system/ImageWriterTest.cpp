@@ -0,0 +1,27 @@
+#include "gtest/gtest.h"
+
+#include <cstdint>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+#include <system/ImageWriter.h>
+
+TEST(ImageWriterTest, writesPpm) {
+  auto rgba = std::vector<std::uint8_t>{
+      1, 2, 3, 255, 4, 5, 6, 255, 0, 0, 0, 0,
+      7, 8, 9, 255, 10, 11, 12, 255, 0, 0, 0, 0};
+  auto os = std::ostringstream{};
+  imp::writePpm(os, 2, 2, 12, rgba);
+  auto expected = std::string{"P6\n2 2\n255\n"};
+  for (auto c : {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12}) {
+    expected.push_back(static_cast<char>(c));
+  }
+  EXPECT_EQ(os.str(), expected);
+}
+
+TEST(ImageWriterTest, rejectsShortData) {
+  auto rgba = std::vector<std::uint8_t>(15);
+  auto os = std::ostringstream{};
+  EXPECT_THROW(imp::writePpm(os, 2, 2, 8, rgba), std::runtime_error);
+}
\ No newline at end of file
@@ -0,0 +1,173 @@
+#include "gtest/gtest.h"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+#include <system/JobSystem.h>
+#include <system/WorkerThread.h>
+
+#include "AllocationCounter.h"
+
+namespace {
+  constexpr auto TILE_COUNT = 16384;
+  constexpr auto TILE_SIZE = 64;
+  constexpr auto VIEW_COUNT = 64;
+  constexpr auto VIEW_ITERATIONS = 20000;
+
+  float shadeTile(int tile) {
+    auto sum = 0.0f;
+    for (auto i = 0; i < TILE_SIZE; ++i) {
+      sum += std::sqrt(float(tile * TILE_SIZE + i));
+    }
+    return sum;
+  }
+
+  float recordView(int view) {
+    auto sum = 0.0f;
+    for (auto i = 0; i < VIEW_ITERATIONS; ++i) {
+      sum += std::sin(float(view + i));
+    }
+    return sum;
+  }
+
+  template<typename Queue, typename F>
+  double measure(Queue &queue, int count, std::vector<float> &results, F f) {
+    auto startTime = std::chrono::steady_clock::now();
+    for (auto i = 0; i < count; ++i) {
+      queue.emplace([&results, f, i]() { results[i] = f(i); });
+    }
+    queue.wait();
+    return std::chrono::duration<double, std::milli>{
+        std::chrono::steady_clock::now() - startTime}
+        .count();
+  }
+} // namespace
+
+TEST(JobSystemTest, runsEveryJob) {
+  auto jobs = imp::JobSystem{4};
+  auto count = std::atomic<int>{};
+  for (auto i = 0; i < 1000; ++i) {
+    jobs.emplace([&count]() { ++count; });
+  }
+  jobs.wait();
+  EXPECT_EQ(count, 1000);
+}
+
+TEST(JobSystemTest, waitsForHandle) {
+  auto jobs = imp::JobSystem{2};
+  auto value = 0;
+  auto handle = jobs.emplace([&value]() { value = 42; });
+  jobs.wait(handle);
+  EXPECT_TRUE(handle.isFinished());
+  EXPECT_EQ(value, 42);
+}
+
+TEST(JobSystemTest, runsAfterDependencies) {
+  auto jobs = imp::JobSystem{4};
+  for (auto i = 0; i < 100; ++i) {
+    auto a = 0;
+    auto b = 0;
+    auto sum = 0;
+    auto handles = std::vector<imp::JobSystem::Handle>{};
+    handles.emplace_back(jobs.emplace([&a]() { a = 1; }));
+    handles.emplace_back(jobs.emplace([&b]() { b = 2; }));
+    auto handle = jobs.emplaceAfter(handles, [&]() { sum = a + b; });
+    jobs.wait(handle);
+    EXPECT_EQ(sum, 3);
+  }
+}
+
+TEST(JobSystemTest, runsContinuationOfFinishedJob) {
+  auto jobs = imp::JobSystem{1};
+  auto order = std::vector<int>{};
+  auto first = jobs.emplace([&order]() { order.push_back(0); });
+  jobs.wait(first);
+  auto second = jobs.then(first, [&order]() { order.push_back(1); });
+  auto third = jobs.then(second, [&order]() { order.push_back(2); });
+  jobs.wait(third);
+  EXPECT_EQ(order, (std::vector<int>{0, 1, 2}));
+}
+
+TEST(JobSystemTest, runsNestedJobs) {
+  auto jobs = imp::JobSystem{4};
+  auto count = std::atomic<int>{};
+  for (auto i = 0; i < 16; ++i) {
+    jobs.emplace([&jobs, &count]() {
+      for (auto j = 0; j < 16; ++j) {
+        jobs.emplace([&count]() { ++count; });
+      }
+    });
+  }
+  jobs.wait();
+  EXPECT_EQ(count, 256);
+}
+
+TEST(JobSystemTest, emplacesWithoutAllocating) {
+  constexpr auto JOB_COUNT = 10000;
+  auto jobs = imp::JobSystem{4};
+  auto results = std::vector<int>(JOB_COUNT);
+  auto emplace = [&]() {
+    for (auto i = 0; i < JOB_COUNT; i += 2) {
+      auto handle = imp::JobSystem::Handle{};
+      if (i % 32 == 0) {
+        auto padding = std::array<int, 32>{};
+        padding[0] = i;
+        handle = jobs.emplace(
+            [&results, i, padding]() { results[i] = padding[0]; });
+      } else {
+        handle = jobs.emplace([&results, i]() { results[i] = i; });
+      }
+      jobs.then(handle, [&results, i]() { results[i + 1] = results[i] + 1; });
+    }
+    jobs.wait();
+  };
+  jobs.reserve(JOB_COUNT);
+  emplace();
+  {
+    auto allocations = imp::AllocationCounter{};
+    emplace();
+    EXPECT_EQ(allocations.getCount(), 0);
+  }
+  for (auto i = 0; i < JOB_COUNT; ++i) {
+    EXPECT_EQ(results[i], i);
+  }
+}
+
+TEST(JobSystemTest, fineGrainedThroughput) {
+  auto expectedTiles = std::vector<float>(TILE_COUNT);
+  auto expectedViews = std::vector<float>(VIEW_COUNT);
+  for (auto i = 0; i < TILE_COUNT; ++i) {
+    expectedTiles[i] = shadeTile(i);
+  }
+  for (auto i = 0; i < VIEW_COUNT; ++i) {
+    expectedViews[i] = recordView(i);
+  }
+  auto tiles = std::vector<float>(TILE_COUNT);
+  auto views = std::vector<float>(VIEW_COUNT);
+  {
+    auto worker = imp::WorkerThread{};
+    auto tileTime = measure(worker, TILE_COUNT, tiles, shadeTile);
+    EXPECT_EQ(tiles, expectedTiles);
+    auto viewTime = measure(worker, VIEW_COUNT, views, recordView);
+    EXPECT_EQ(views, expectedViews);
+    worker.join();
+    std::cout << "worker thread: " << tileTime << " ms for " << TILE_COUNT
+              << " tiles, " << viewTime << " ms for " << VIEW_COUNT
+              << " views\n";
+  }
+  {
+    auto jobs = imp::JobSystem{};
+    auto tileTime = measure(jobs, TILE_COUNT, tiles, shadeTile);
+    EXPECT_EQ(tiles, expectedTiles);
+    auto viewTime = measure(jobs, VIEW_COUNT, views, recordView);
+    EXPECT_EQ(views, expectedViews);
+    std::cout << "job system (" << jobs.getWorkerCount()
+              << " workers): " << tileTime << " ms for " << TILE_COUNT
+              << " tiles, " << viewTime << " ms for " << VIEW_COUNT
+              << " views\n";
+  }
+}
\ No newline at end of file
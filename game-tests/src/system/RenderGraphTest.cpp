@@ -0,0 +1,208 @@
+#include "gtest/gtest.h"
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <system/RenderGraph.h>
+
+namespace {
+  using Usage = imp::RenderGraph::Usage;
+  using Layout = imp::RenderGraph::Layout;
+} // namespace
+
+TEST(RenderGraphTest, cullsPassesWithUnusedOutputs) {
+  auto graph = imp::RenderGraph{};
+  auto order = std::vector<std::string>{};
+  auto primary = graph.importImage("primary", 1, 1);
+  auto bloom = graph.addTransientImage("bloom", 1, 1, 256);
+  auto render = graph.addPass("render", [&]() { order.push_back("render"); });
+  graph.write(render, primary, {0, 1, 0, 1}, Usage::COLOR_ATTACHMENT);
+  auto blur = graph.addPass("blur", [&]() { order.push_back("blur"); });
+  graph.read(blur, primary, {0, 1, 0, 1}, Usage::FRAGMENT_SAMPLED);
+  graph.write(blur, bloom, {0, 1, 0, 1}, Usage::COLOR_ATTACHMENT);
+  graph.exportImage(primary, Usage::FRAGMENT_SAMPLED);
+  graph.execute([](auto) {});
+  EXPECT_FALSE(graph.isPassCulled(render));
+  EXPECT_TRUE(graph.isPassCulled(blur));
+  EXPECT_EQ(graph.getCulledPassCount(), 1);
+  EXPECT_FALSE(graph.getImageSlot(bloom));
+  EXPECT_EQ(order, (std::vector<std::string>{"render"}));
+}
+
+TEST(RenderGraphTest, keepsPassesFeedingOutputs) {
+  auto graph = imp::RenderGraph{};
+  auto primary = graph.importImage("primary", 1, 1);
+  auto bloom = graph.addTransientImage("bloom", 1, 1, 256);
+  auto render = graph.addPass("render", {});
+  graph.write(render, primary, {0, 1, 0, 1}, Usage::COLOR_ATTACHMENT);
+  auto overwritten = graph.addPass("overwritten", {});
+  graph.write(overwritten, bloom, {0, 1, 0, 1}, Usage::COLOR_ATTACHMENT);
+  auto blur = graph.addPass("blur", {});
+  graph.read(blur, primary, {0, 1, 0, 1}, Usage::FRAGMENT_SAMPLED);
+  graph.write(blur, bloom, {0, 1, 0, 1}, Usage::COLOR_ATTACHMENT);
+  auto apply = graph.addPass("apply", {});
+  graph.read(apply, bloom, {0, 1, 0, 1}, Usage::FRAGMENT_SAMPLED);
+  graph.read(apply, primary, {0, 1, 0, 1}, Usage::COLOR_ATTACHMENT);
+  graph.write(apply, primary, {0, 1, 0, 1}, Usage::COLOR_ATTACHMENT);
+  auto present = graph.addPass("present", {});
+  graph.markOutput(present);
+  graph.exportImage(primary, Usage::FRAGMENT_SAMPLED);
+  graph.compile();
+  EXPECT_FALSE(graph.isPassCulled(render));
+  EXPECT_TRUE(graph.isPassCulled(overwritten));
+  EXPECT_FALSE(graph.isPassCulled(blur));
+  EXPECT_FALSE(graph.isPassCulled(apply));
+  EXPECT_FALSE(graph.isPassCulled(present));
+}
+
+TEST(RenderGraphTest, emitsMinimalBarriers) {
+  auto graph = imp::RenderGraph{};
+  auto image = graph.importImage("primary", 5, 1);
+  auto render = graph.addPass("render", {});
+  graph.write(render, image, {0, 1, 0, 1}, Usage::COLOR_ATTACHMENT);
+  auto mips = graph.addPass("mips", {});
+  graph.read(mips, image, {0, 1, 0, 1}, Usage::COMPUTE_SAMPLED);
+  graph.write(mips, image, {1, 4, 0, 1}, Usage::COMPUTE_STORAGE);
+  auto first = graph.addPass("first", {});
+  graph.read(first, image, {1, 1, 0, 1}, Usage::FRAGMENT_SAMPLED);
+  auto second = graph.addPass("second", {});
+  graph.read(second, image, {1, 1, 0, 1}, Usage::FRAGMENT_SAMPLED);
+  graph.markOutput(first);
+  graph.markOutput(second);
+  graph.exportImage(image, Usage::FRAGMENT_SAMPLED);
+  graph.compile();
+  auto barriers = graph.getBarriers(render);
+  ASSERT_EQ(barriers.size(), 1);
+  EXPECT_EQ(barriers[0].srcUsages, 0);
+  EXPECT_EQ(barriers[0].oldLayout, Layout::UNDEFINED);
+  EXPECT_EQ(barriers[0].newLayout, Layout::COLOR_ATTACHMENT);
+  barriers = graph.getBarriers(mips);
+  ASSERT_EQ(barriers.size(), 2);
+  EXPECT_EQ(
+      barriers[0].srcWriteUsages,
+      imp::RenderGraph::getFlag(Usage::COLOR_ATTACHMENT));
+  EXPECT_EQ(barriers[0].newLayout, Layout::SHADER_READ_ONLY);
+  EXPECT_EQ(barriers[1].range.baseLevel, 1);
+  EXPECT_EQ(barriers[1].range.levelCount, 4);
+  EXPECT_EQ(barriers[1].newLayout, Layout::GENERAL);
+  barriers = graph.getBarriers(first);
+  ASSERT_EQ(barriers.size(), 1);
+  EXPECT_EQ(barriers[0].oldLayout, Layout::GENERAL);
+  EXPECT_TRUE(graph.getBarriers(second).empty());
+  barriers = graph.getFinalBarriers();
+  ASSERT_EQ(barriers.size(), 2);
+  EXPECT_EQ(barriers[0].range.baseLevel, 0);
+  EXPECT_EQ(barriers[0].range.levelCount, 1);
+  EXPECT_EQ(
+      barriers[0].srcUsages, imp::RenderGraph::getFlag(Usage::COMPUTE_SAMPLED));
+  EXPECT_EQ(barriers[0].srcWriteUsages, 0);
+  EXPECT_EQ(barriers[1].range.baseLevel, 2);
+  EXPECT_EQ(barriers[1].range.levelCount, 3);
+  EXPECT_EQ(barriers[1].oldLayout, Layout::GENERAL);
+}
+
+TEST(RenderGraphTest, transitionsPresentedImages) {
+  auto graph = imp::RenderGraph{};
+  auto swapchain = graph.importImage("swapchain", 1, 1, Usage::PRESENT);
+  auto composite = graph.addPass("composite", {});
+  graph.write(composite, swapchain, {0, 1, 0, 1}, Usage::COLOR_ATTACHMENT);
+  graph.markOutput(composite);
+  graph.exportImage(swapchain, Usage::PRESENT);
+  graph.compile();
+  auto barriers = graph.getBarriers(composite);
+  ASSERT_EQ(barriers.size(), 1);
+  EXPECT_EQ(barriers[0].srcUsages, imp::RenderGraph::getFlag(Usage::PRESENT));
+  EXPECT_EQ(barriers[0].oldLayout, Layout::UNDEFINED);
+  EXPECT_EQ(barriers[0].newLayout, Layout::COLOR_ATTACHMENT);
+  barriers = graph.getFinalBarriers();
+  ASSERT_EQ(barriers.size(), 1);
+  EXPECT_EQ(
+      barriers[0].srcWriteUsages,
+      imp::RenderGraph::getFlag(Usage::COLOR_ATTACHMENT));
+  EXPECT_EQ(barriers[0].dstUsage, Usage::PRESENT);
+  EXPECT_EQ(barriers[0].oldLayout, Layout::COLOR_ATTACHMENT);
+  EXPECT_EQ(barriers[0].newLayout, Layout::PRESENT);
+}
+
+TEST(RenderGraphTest, aliasesTransientsWithDisjointLifetimes) {
+  auto graph = imp::RenderGraph{};
+  auto output = graph.importImage("output", 1, 1);
+  auto images = std::vector<imp::RenderGraph::ImageHandle>{};
+  for (auto i = 0; i < 4; ++i) {
+    images.push_back(graph.addTransientImage(
+        "bloom " + std::to_string(i), 1, 2, std::size_t{4096} >> (2 * i)));
+  }
+  for (auto i = 3; i >= 0; --i) {
+    auto blur = graph.addPass("blur " + std::to_string(i), {});
+    graph.write(blur, images[i], {0, 1, 0, 1}, Usage::COLOR_ATTACHMENT);
+    auto combine = graph.addPass("combine " + std::to_string(i), {});
+    graph.read(combine, images[i], {0, 1, 0, 1}, Usage::FRAGMENT_SAMPLED);
+    if (i != 3) {
+      graph.read(combine, images[i + 1], {0, 1, 1, 1}, Usage::FRAGMENT_SAMPLED);
+    }
+    graph.write(combine, images[i], {0, 1, 1, 1}, Usage::COLOR_ATTACHMENT);
+  }
+  auto apply = graph.addPass("apply", {});
+  graph.read(apply, images[0], {0, 1, 1, 1}, Usage::FRAGMENT_SAMPLED);
+  graph.write(apply, output, {0, 1, 0, 1}, Usage::COLOR_ATTACHMENT);
+  graph.exportImage(output, Usage::FRAGMENT_SAMPLED);
+  graph.compile();
+  EXPECT_EQ(graph.getSlotCount(), 2);
+  EXPECT_EQ(graph.getImageSlot(images[0]), graph.getImageSlot(images[2]));
+  EXPECT_EQ(graph.getImageSlot(images[1]), graph.getImageSlot(images[3]));
+  EXPECT_NE(graph.getImageSlot(images[0]), graph.getImageSlot(images[1]));
+  EXPECT_EQ(graph.getTransientSize(), 4096 + 1024 + 256 + 64);
+  EXPECT_EQ(graph.getAliasedTransientSize(), 4096 + 1024);
+  auto barriers = graph.getBarriers({6});
+  ASSERT_EQ(barriers.size(), 1);
+  EXPECT_EQ(barriers[0].oldLayout, Layout::UNDEFINED);
+  EXPECT_NE(barriers[0].srcUsages, 0);
+}
+
+TEST(RenderGraphTest, synchronizesTransientsWithExternalUsages) {
+  auto graph = imp::RenderGraph{};
+  auto output = graph.importImage("output", 1, 1);
+  auto bloom = graph.addTransientImage("bloom", 1, 1, 256);
+  auto blur = graph.addPass("blur", {});
+  graph.write(blur, bloom, {0, 1, 0, 1}, Usage::COLOR_ATTACHMENT);
+  auto apply = graph.addPass("apply", {});
+  graph.read(apply, bloom, {0, 1, 0, 1}, Usage::FRAGMENT_SAMPLED);
+  graph.write(apply, output, {0, 1, 0, 1}, Usage::COLOR_ATTACHMENT);
+  graph.exportImage(output, Usage::FRAGMENT_SAMPLED);
+  graph.compile();
+  auto barriers = graph.getBarriers(blur);
+  ASSERT_EQ(barriers.size(), 1);
+  EXPECT_EQ(barriers[0].srcUsages, 0);
+  auto usages = imp::RenderGraph::getFlag(Usage::COLOR_ATTACHMENT) |
+                imp::RenderGraph::getFlag(Usage::FRAGMENT_SAMPLED);
+  graph.setExternalTransientUsages(usages);
+  graph.compile();
+  barriers = graph.getBarriers(blur);
+  ASSERT_EQ(barriers.size(), 1);
+  EXPECT_EQ(barriers[0].srcUsages, usages);
+  EXPECT_EQ(
+      barriers[0].srcWriteUsages,
+      imp::RenderGraph::getFlag(Usage::COLOR_ATTACHMENT));
+  EXPECT_EQ(barriers[0].oldLayout, Layout::UNDEFINED);
+  EXPECT_EQ(graph.getBarriers(apply).size(), 2);
+}
+
+TEST(RenderGraphTest, rejectsInvalidAccesses) {
+  auto graph = imp::RenderGraph{};
+  auto image = graph.importImage("image", 2, 1);
+  auto transient = graph.addTransientImage("transient", 1, 1, 16);
+  auto pass = graph.addPass("pass", {});
+  EXPECT_THROW(
+      graph.read(pass, image, {1, 2, 0, 1}, Usage::FRAGMENT_SAMPLED),
+      std::runtime_error);
+  EXPECT_THROW(
+      graph.write(pass, image, {0, 1, 0, 1}, Usage::NONE), std::runtime_error);
+  EXPECT_THROW(
+      graph.exportImage(transient, Usage::FRAGMENT_SAMPLED),
+      std::runtime_error);
+  graph.read(pass, image, {0, 1, 0, 1}, Usage::FRAGMENT_SAMPLED);
+  graph.write(pass, image, {0, 1, 0, 1}, Usage::COLOR_ATTACHMENT);
+  graph.markOutput(pass);
+  EXPECT_THROW(graph.compile(), std::runtime_error);
+}
\ No newline at end of file
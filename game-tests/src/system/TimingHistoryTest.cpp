@@ -0,0 +1,63 @@
+#include "gtest/gtest.h"
+
+#include <sstream>
+
+#include <system/TimingHistory.h>
+
+TEST(TimingHistoryTest, computesRollingStats) {
+  auto history = imp::TimingHistory{100};
+  for (auto i = 1; i <= 100; ++i) {
+    history.record("view 0", "primary", double(i));
+  }
+  auto stats = history.getStats("view 0", "primary");
+  ASSERT_TRUE(stats);
+  EXPECT_EQ(stats->sampleCount, 100);
+  EXPECT_DOUBLE_EQ(stats->min, 1.0);
+  EXPECT_DOUBLE_EQ(stats->average, 50.5);
+  EXPECT_DOUBLE_EQ(stats->p95, 95.0);
+  EXPECT_DOUBLE_EQ(stats->p99, 99.0);
+}
+
+TEST(TimingHistoryTest, discardsSamplesOutsideWindow) {
+  auto history = imp::TimingHistory{4};
+  for (auto i = 1; i <= 8; ++i) {
+    history.record("scene", "sky view", double(i));
+  }
+  auto stats = history.getStats("scene", "sky view");
+  ASSERT_TRUE(stats);
+  EXPECT_EQ(stats->sampleCount, 4);
+  EXPECT_DOUBLE_EQ(stats->min, 5.0);
+  EXPECT_DOUBLE_EQ(stats->average, 6.5);
+  EXPECT_DOUBLE_EQ(stats->p99, 8.0);
+}
+
+TEST(TimingHistoryTest, separatesOwnersAndPasses) {
+  auto history = imp::TimingHistory{};
+  history.record("view 0", "primary", 1.0);
+  history.record("view 1", "primary", 2.0);
+  history.record("view 1", "mip 1", 3.0);
+  EXPECT_FALSE(history.getStats("view 0", "mip 1"));
+  auto stats = history.getStats();
+  ASSERT_EQ(stats.size(), 3);
+  EXPECT_EQ(stats[0].owner, "view 0");
+  EXPECT_EQ(stats[1].owner, "view 1");
+  EXPECT_EQ(stats[1].pass, "mip 1");
+  EXPECT_EQ(stats[2].pass, "primary");
+  EXPECT_DOUBLE_EQ(stats[2].average, 2.0);
+}
+
+TEST(TimingHistoryTest, writesJsonAndCsv) {
+  auto history = imp::TimingHistory{};
+  history.record("view \"a\"", "primary", 2.0);
+  auto json = std::ostringstream{};
+  history.writeJson(json);
+  EXPECT_EQ(
+      json.str(),
+      "[\n  {\"owner\": \"view \\\"a\\\"\", \"pass\": \"primary\", "
+      "\"samples\": 1, \"min\": 2, \"avg\": 2, \"p95\": 2, \"p99\": 2}\n]\n");
+  auto csv = std::ostringstream{};
+  history.writeCsv(csv);
+  EXPECT_EQ(
+      csv.str(),
+      "owner,pass,samples,min,avg,p95,p99\nview \"a\",primary,1,2,2,2,2\n");
+}
\ No newline at end of file
@@ -0,0 +1,53 @@
+#include "gtest/gtest.h"
+
+#include <cstdint>
+#include <thread>
+
+#include <system/TripleBuffer.h>
+
+namespace {
+  struct Snapshot {
+    std::uint64_t tick;
+    std::uint64_t value;
+  };
+} // namespace
+
+TEST(TripleBufferTest, acquiresLatestPublishedValue) {
+  auto buffer = imp::TripleBuffer<int>{};
+  EXPECT_FALSE(buffer.acquire());
+  buffer.getWriteBuffer() = 1;
+  buffer.publish();
+  buffer.getWriteBuffer() = 2;
+  buffer.publish();
+  EXPECT_TRUE(buffer.acquire());
+  EXPECT_EQ(buffer.getReadBuffer(), 2);
+  EXPECT_FALSE(buffer.acquire());
+  EXPECT_EQ(buffer.getReadBuffer(), 2);
+  buffer.getWriteBuffer() = 3;
+  buffer.publish();
+  EXPECT_TRUE(buffer.acquire());
+  EXPECT_EQ(buffer.getReadBuffer(), 3);
+}
+
+TEST(TripleBufferTest, readsConsistentSnapshots) {
+  constexpr auto TICK_COUNT = std::uint64_t{100000};
+  auto buffer = imp::TripleBuffer<Snapshot>{};
+  auto writer = std::thread{[&buffer]() {
+    for (auto tick = std::uint64_t{1}; tick <= TICK_COUNT; ++tick) {
+      auto &snapshot = buffer.getWriteBuffer();
+      snapshot.tick = tick;
+      snapshot.value = tick * 3;
+      buffer.publish();
+    }
+  }};
+  auto lastTick = std::uint64_t{};
+  while (lastTick != TICK_COUNT) {
+    if (buffer.acquire()) {
+      auto const &snapshot = buffer.getReadBuffer();
+      ASSERT_GT(snapshot.tick, lastTick);
+      ASSERT_EQ(snapshot.value, snapshot.tick * 3);
+      lastTick = snapshot.tick;
+    }
+  }
+  writer.join();
+}
\ No newline at end of file
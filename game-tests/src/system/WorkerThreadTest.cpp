@@ -0,0 +1,119 @@
+#include "gtest/gtest.h"
+
+#include <array>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include <system/MpmcQueue.h>
+#include <system/Task.h>
+#include <system/WorkerThread.h>
+
+#include "AllocationCounter.h"
+
+TEST(WorkerThreadTest, storesSmallTasksInline) {
+  auto value = 0;
+  auto small = [&value]() { value += 1; };
+  auto large = [&value, padding = std::array<char, 128>{}]() {
+    value += 2 + padding[0];
+  };
+  EXPECT_TRUE(imp::Task::isInline<decltype(small)>());
+  EXPECT_FALSE(imp::Task::isInline<decltype(large)>());
+  auto a = imp::Task{small};
+  auto b = imp::Task{large};
+  auto c = std::move(a);
+  EXPECT_FALSE(a);
+  c();
+  b();
+  a = std::move(b);
+  a();
+  EXPECT_EQ(value, 5);
+}
+
+TEST(WorkerThreadTest, destroysCaptures) {
+  auto counter = std::make_shared<int>();
+  {
+    auto task = imp::Task{[counter]() {}};
+    auto large = imp::Task{[counter, padding = std::array<char, 128>{}]() {}};
+    EXPECT_EQ(counter.use_count(), 3);
+    auto moved = std::move(large);
+    EXPECT_EQ(counter.use_count(), 3);
+  }
+  EXPECT_EQ(counter.use_count(), 1);
+}
+
+TEST(WorkerThreadTest, queueRejectsWhenFull) {
+  auto queue = imp::MpmcQueue<int>{4};
+  for (auto i = 0; i < 4; ++i) {
+    EXPECT_TRUE(queue.tryPush(int{i}));
+  }
+  EXPECT_FALSE(queue.tryPush(4));
+  auto value = 0;
+  for (auto i = 0; i < 4; ++i) {
+    EXPECT_TRUE(queue.tryPop(value));
+    EXPECT_EQ(value, i);
+  }
+  EXPECT_FALSE(queue.tryPop(value));
+}
+
+TEST(WorkerThreadTest, queueDeliversEveryValueOnce) {
+  constexpr auto THREAD_COUNT = 4;
+  constexpr auto VALUE_COUNT = 10000;
+  auto queue = imp::MpmcQueue<int>{256};
+  auto sum = std::atomic<long long>{};
+  auto popped = std::atomic<int>{};
+  auto threads = std::vector<std::thread>{};
+  for (auto i = 0; i < THREAD_COUNT; ++i) {
+    threads.emplace_back([&queue, i]() {
+      for (auto j = 0; j < VALUE_COUNT; ++j) {
+        while (!queue.tryPush(i * VALUE_COUNT + j)) {
+          std::this_thread::yield();
+        }
+      }
+    });
+    threads.emplace_back([&queue, &sum, &popped]() {
+      auto value = 0;
+      while (popped < THREAD_COUNT * VALUE_COUNT) {
+        if (queue.tryPop(value)) {
+          sum += value;
+          ++popped;
+        } else {
+          std::this_thread::yield();
+        }
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  auto n = static_cast<long long>(THREAD_COUNT) * VALUE_COUNT;
+  EXPECT_EQ(sum, n * (n - 1) / 2);
+}
+
+TEST(WorkerThreadTest, enqueuesWithoutAllocating) {
+  constexpr auto TASK_COUNT = 10000;
+  auto worker = imp::WorkerThread{};
+  auto results = std::vector<int>(TASK_COUNT);
+  auto enqueue = [&]() {
+    for (auto i = 0; i < TASK_COUNT; ++i) {
+      if (i % 16 == 0) {
+        auto padding = std::array<int, 32>{};
+        padding[0] = i;
+        worker.emplace([&results, i, padding]() { results[i] = padding[0]; });
+      } else {
+        worker.emplace([&results, i]() { results[i] = i; });
+      }
+    }
+    worker.wait();
+  };
+  enqueue();
+  {
+    auto allocations = imp::AllocationCounter{};
+    enqueue();
+    EXPECT_EQ(allocations.getCount(), 0);
+  }
+  worker.join();
+  for (auto i = 0; i < TASK_COUNT; ++i) {
+    EXPECT_EQ(results[i], i);
+  }
+}
\ No newline at end of file
@@ -0,0 +1,92 @@
+#ifndef ANALYTIC_TRANSMITTANCE_GLSL
+#define ANALYTIC_TRANSMITTANCE_GLSL
+
+#include "Constants.glsl"
+#include "Scene.glsl"
+
+layout(constant_id = 4) const bool analyticTransmittance = false;
+
+float calcChapman(float x, float mu) {
+  float y = sqrt(0.5f * x) * mu;
+  float erfcx = (1.0f + y * (0.88386f + y * 0.31715f)) /
+                (1.0f + y * (2.01564f + y * (1.56954f + y * 0.56214f)));
+  return sqrt(0.5f * PI * x) * erfcx;
+}
+
+float calcExponentialDepth(float r, float mu, float scaleHeight) {
+  if (mu >= 0.0f) {
+    return scaleHeight * exp((scene.planet.groundRadius - r) / scaleHeight) *
+           calcChapman(r / scaleHeight, mu);
+  }
+  float rPerigee = r * sqrt(1.0f - mu * mu);
+  return 2.0f * scaleHeight *
+             exp((scene.planet.groundRadius - rPerigee) / scaleHeight) *
+             calcChapman(rPerigee / scaleHeight, 0.0f) -
+         scaleHeight * exp((scene.planet.groundRadius - r) / scaleHeight) *
+             calcChapman(r / scaleHeight, -mu);
+}
+
+float integrateOzone(
+    float h0, float h1, float hPerigee, float density, float slope) {
+  if (h0 >= h1) {
+    return 0.0f;
+  }
+  vec2 z = max(vec2(h0, h1) - hPerigee, 0.0f);
+  vec2 sqrtZ = sqrt(z);
+  vec2 primitive = 2.0f * density * sqrtZ + 2.0f / 3.0f * slope * z * sqrtZ;
+  return primitive.y - primitive.x;
+}
+
+float calcOzoneColumn(float h, float hPerigee) {
+  float halfThickness = 0.5f * scene.planet.ozoneLayerThickness;
+  float center = scene.planet.ozoneLayerHeight;
+  float bottom = center - halfThickness;
+  float top = center + halfThickness;
+  return integrateOzone(
+             max(h, bottom),
+             center,
+             hPerigee,
+             (hPerigee - bottom) / halfThickness,
+             1.0f / halfThickness) +
+         integrateOzone(
+             max(h, center),
+             top,
+             hPerigee,
+             (top - hPerigee) / halfThickness,
+             -1.0f / halfThickness);
+}
+
+float calcOzoneDepth(float r, float mu) {
+  float hPerigee =
+      r * sqrt(max(1.0f - mu * mu, 0.0f)) - scene.planet.groundRadius;
+  float scale =
+      (scene.planet.groundRadius + scene.planet.ozoneLayerHeight) /
+      sqrt(2.0f * scene.planet.groundRadius + scene.planet.ozoneLayerHeight +
+           hPerigee);
+  float h = r - scene.planet.groundRadius;
+  float column = mu >= 0.0f ? calcOzoneColumn(h, hPerigee)
+                            : 2.0f * calcOzoneColumn(hPerigee, hPerigee) -
+                                  calcOzoneColumn(h, hPerigee);
+  return scale * column;
+}
+
+vec3 calcAnalyticTransmittance(float h, float mu) {
+  float r = scene.planet.groundRadius + h;
+  float horizonMu = -sqrt(max(
+      1.0f - scene.planet.groundRadius * scene.planet.groundRadius / (r * r),
+      0.0f));
+  if (mu < horizonMu) {
+    return vec3(0.0f);
+  }
+  vec3 opticalDepth = vec3(
+      calcExponentialDepth(r, mu, scene.planet.rayleighScaleHeight),
+      calcExponentialDepth(r, mu, scene.planet.mieScaleHeight),
+      calcOzoneDepth(r, mu));
+  mat3 extinctionMat = mat3(
+      scene.planet.rayleighScattering,
+      vec3(scene.planet.mieScattering + scene.planet.mieAbsorption),
+      scene.planet.ozoneAbsorption);
+  return exp(-(extinctionMat * opticalDepth));
+}
+
+#endif
@@ -0,0 +1,36 @@
+#ifndef ATMOSPHERE_SAMPLING_GLSL
+#define ATMOSPHERE_SAMPLING_GLSL
+
+const int SAMPLING_UNIFORM = 0;
+const int SAMPLING_IMPORTANCE = 1;
+const int SAMPLING_EXPONENTIAL = 2;
+
+layout(constant_id = 3) const int atmosphereSampling = 0;
+
+float getSampleDistance(float u, float tMin, float tPerigee, float tMax) {
+  if (atmosphereSampling == SAMPLING_UNIFORM || tMax <= tMin) {
+    return mix(tMin, tMax, u);
+  }
+  float a = sqrt(tPerigee - tMin);
+  float b = sqrt(tMax - tPerigee);
+  float uPerigee = a / (a + b);
+  if (u < uPerigee) {
+    float w = 1.0f - u / uPerigee;
+    return tPerigee - (tPerigee - tMin) * w * w;
+  }
+  float w = (u - uPerigee) / max(1.0f - uPerigee, 1e-6f);
+  return tPerigee + (tMax - tPerigee) * w * w;
+}
+
+vec3 integrateInterval(vec3 f0, vec3 f1, float dt) {
+  vec3 trapezoid = 0.5f * (f0 + f1) * dt;
+  if (atmosphereSampling != SAMPLING_EXPONENTIAL) {
+    return trapezoid;
+  }
+  bvec3 positive = greaterThan(min(f0, f1), vec3(0.0f));
+  bvec3 distinct = greaterThan(abs(f1 - f0), 1e-3f * (f0 + f1));
+  vec3 exponential = (f1 - f0) / log(f1 / f0) * dt;
+  return mix(trapezoid, exponential, bvec3(ivec3(positive) & ivec3(distinct)));
+}
+
+#endif
@@ -0,0 +1,65 @@
+#version 450 core
+
+layout(local_size_x = 16, local_size_y = 16) in;
+
+#include "StorageFormat.glsl"
+
+layout(set = 0, binding = 0) uniform sampler2D src;
+STORAGE_LAYOUT(0, 1) uniform writeonly image2D dst1;
+STORAGE_LAYOUT(0, 2) uniform writeonly image2D dst2;
+STORAGE_LAYOUT(0, 3) uniform writeonly image2D dst3;
+STORAGE_LAYOUT(0, 4) uniform writeonly image2D dst4;
+
+shared vec4 tile2[16][16];
+shared vec4 tile3[8][8];
+
+vec4 average(vec4 a, vec4 b, vec4 c, vec4 d) {
+  return 0.25f * (a + b + c + d);
+}
+
+void main() {
+  ivec2 local = ivec2(gl_LocalInvocationID.xy);
+  ivec2 group = ivec2(gl_WorkGroupID.xy);
+  vec2 invSrcSize = 1.0f / vec2(textureSize(src, 0));
+  vec4 color1[4];
+  for (int i = 0; i < 4; ++i) {
+    ivec2 texel = group * 32 + local * 2 + ivec2(i & 1, i >> 1);
+    color1[i] = textureLod(src, vec2(2 * texel + 1) * invSrcSize, 0.0f);
+    if (all(lessThan(texel, imageSize(dst1)))) {
+      imageStore(dst1, texel, color1[i]);
+    }
+  }
+  vec4 color2 = average(color1[0], color1[1], color1[2], color1[3]);
+  ivec2 texel2 = group * 16 + local;
+  if (all(lessThan(texel2, imageSize(dst2)))) {
+    imageStore(dst2, texel2, color2);
+  }
+  tile2[local.y][local.x] = color2;
+  barrier();
+  if (all(lessThan(local, ivec2(8)))) {
+    ivec2 i = local * 2;
+    vec4 color3 = average(
+        tile2[i.y][i.x],
+        tile2[i.y][i.x + 1],
+        tile2[i.y + 1][i.x],
+        tile2[i.y + 1][i.x + 1]);
+    ivec2 texel3 = group * 8 + local;
+    if (all(lessThan(texel3, imageSize(dst3)))) {
+      imageStore(dst3, texel3, color3);
+    }
+    tile3[local.y][local.x] = color3;
+  }
+  barrier();
+  if (all(lessThan(local, ivec2(4)))) {
+    ivec2 i = local * 2;
+    vec4 color4 = average(
+        tile3[i.y][i.x],
+        tile3[i.y][i.x + 1],
+        tile3[i.y + 1][i.x],
+        tile3[i.y + 1][i.x + 1]);
+    ivec2 texel4 = group * 4 + local;
+    if (all(lessThan(texel4, imageSize(dst4)))) {
+      imageStore(dst4, texel4, color4);
+    }
+  }
+}
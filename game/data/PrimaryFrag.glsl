@@ -16,10 +16,15 @@ layout(location = 0) out vec4 color;
 #define SCENE_VIEW_BINDING 1
 #include "SceneView.glsl"
 
+#include "AnalyticTransmittance.glsl"
+
 layout(set = 0, binding = 2) uniform sampler2D transmittanceLut;
 layout(set = 0, binding = 3) uniform sampler2D skyViewLut;
 
 vec3 loadTransmittance(float h, float mu) {
+  if (analyticTransmittance) {
+    return calcAnalyticTransmittance(h, mu);
+  }
   vec2 params;
   params.x =
       sqrt(h / (scene.planet.atmosphereRadius - scene.planet.groundRadius));
@@ -27,7 +32,7 @@ vec3 loadTransmittance(float h, float mu) {
   return texture(transmittanceLut, params).rgb;
 }
 
-vec4 loadSkyView(vec3 v) {
+vec3 loadSkyView(vec3 v) {
   float longitude = atan(v.y, v.x);
   float latitude = asin(v.z);
   float t2 = abs(latitude) / (0.5 * PI);
@@ -35,7 +40,13 @@ vec4 loadSkyView(vec3 v) {
   vec2 params;
   params.x = 0.5f * longitude / PI + 0.5f;
   params.y = 0.5 * t + 0.5;
-  return texture(skyViewLut, params);
+  return texture(skyViewLut, params).rgb;
+}
+
+float calcHorizonCosine() {
+  float r = scene.planet.groundRadius + max(sceneView.altitude, 0.0f);
+  float sinHorizon = scene.planet.groundRadius / r;
+  return -sqrt(max(1.0f - sinHorizon * sinHorizon, 0.0f));
 }
 
 vec3 expose(vec3 x) {
@@ -51,10 +62,9 @@ void main() {
               sceneView.skyViewEyeDirections[3],
               textureCoord.x),
           textureCoord.y));
-  vec4 skyView = loadSkyView(v);
-  vec3 skyRadiance = skyView.rgb;
+  vec3 skyRadiance = loadSkyView(v);
   vec3 sunTransmittance =
-      (1.0 - skyView.a) *
+      step(calcHorizonCosine(), v.z) *
       step(scene.sun.cosAngularRadius, dot(v, sceneView.skyViewSunDirection)) *
       loadTransmittance(sceneView.altitude, v.z);
   vec3 sunRadiance =
@@ -0,0 +1,140 @@
+#ifndef SKY_VIEW_GLSL
+#define SKY_VIEW_GLSL
+
+#include "AnalyticTransmittance.glsl"
+#include "AtmosphereSampling.glsl"
+#include "Constants.glsl"
+#include "Intersections.glsl"
+#include "Scene.glsl"
+
+layout(push_constant) uniform SkyViewParameters {
+  vec3 sunDirection;
+  float altitude;
+}
+skyViewParameters;
+
+layout(constant_id = 2) const int skyViewSteps = 30;
+
+vec3 planetPosition = vec3(0.0f, 0.0f, -scene.planet.groundRadius);
+
+float radius(vec3 x) {
+  return distance(x, planetPosition);
+}
+
+float phaseR(float mu) {
+  float numer = 3.0f * (1.0f + mu * mu);
+  float denom = 16.0f * PI;
+  return numer / denom;
+}
+
+float phaseM(float mu) {
+  float g = scene.planet.mieG;
+  float g2 = g * g;
+  float numer = 3.0f * (1.0f - g2) * (1.0f + mu * mu);
+  float denom = 8.0f * PI * (2.0f + g2) * pow(1.0f + g2 - 2.0f * g * mu, 1.5f);
+  return numer / denom;
+}
+
+vec2 rayGround(vec3 ro, vec3 rd) {
+  return raySphere(ro, rd, planetPosition, scene.planet.groundRadius);
+}
+
+vec2 rayAtmosphere(vec3 ro, vec3 rd) {
+  return raySphere(ro, rd, planetPosition, scene.planet.atmosphereRadius);
+}
+
+vec3 rayScene(vec3 ro, vec3 rd) {
+  vec2 t = rayAtmosphere(ro, rd);
+  if (t == vec2(-1.0)) {
+    return vec3(-1.0);
+  }
+  vec2 t2 = rayGround(ro, rd);
+  t.x = max(t.x, 0.0);
+  t.y = t2.x > 0.0 ? min(t2.x, t.y) : t.y;
+  float z = t2.x > 0.0 ? 1.0 : 0.0;
+  return vec3(t, z);
+}
+
+vec2 calcDensity(float h) {
+  return min(
+      exp(vec2(-h) /
+          vec2(scene.planet.rayleighScaleHeight, scene.planet.mieScaleHeight)),
+      vec2(1.0f));
+}
+
+vec3 loadTransmittance(float h, float mu) {
+  if (analyticTransmittance) {
+    return calcAnalyticTransmittance(h, mu);
+  }
+  vec2 params;
+  params.x =
+      sqrt(h / (scene.planet.atmosphereRadius - scene.planet.groundRadius));
+  params.y = 0.5f * sign(mu) * sqrt(abs(mu)) + 0.5f;
+  return texture(transmittanceLut, params).rgb;
+}
+
+vec4 calcSkyView(vec3 x, vec3 v) {
+  vec3 t = rayScene(x, v);
+  if (t == vec3(-1.0)) {
+    return vec4(0.0);
+  }
+  float steps = float(skyViewSteps);
+  float tPerigee = clamp(-dot(x - planetPosition, v), t.x, t.y);
+  vec3 p = x + t.x * v - planetPosition;
+  float r = length(p);
+  float h = r - scene.planet.groundRadius;
+  vec3 n = p / r;
+  vec3 eyeTransmittanceDir = t.z != 0.0 ? -v : v;
+  vec3 eyeTransmittance = loadTransmittance(h, dot(n, eyeTransmittanceDir));
+  vec3 transmittance = loadTransmittance(h, dot(n, skyViewParameters.sunDirection));
+  vec2 density = calcDensity(h);
+  vec3 rayleigh0 = density.r * transmittance;
+  vec3 mie0 = density.g * transmittance;
+  float t0 = t.x;
+  vec3 rayleighSum = vec3(0.0f);
+  vec3 mieSum = vec3(0.0f);
+  for (float i = 1.0f; i <= steps; i += 1.0f) {
+    float t1 = getSampleDistance(i / steps, t.x, tPerigee, t.y);
+    p = x + t1 * v - planetPosition;
+    r = length(p);
+    h = r - scene.planet.groundRadius;
+    n = p / r;
+    vec3 sunTransmittance = loadTransmittance(h, dot(n, skyViewParameters.sunDirection));
+    transmittance = loadTransmittance(h, dot(n, eyeTransmittanceDir));
+    transmittance = t.z == 0.0 ? sunTransmittance * eyeTransmittance / transmittance
+                        : sunTransmittance * transmittance / eyeTransmittance;
+    density = calcDensity(h);
+    vec3 rayleigh1 = density.r * transmittance;
+    vec3 mie1 = density.g * transmittance;
+    rayleighSum += integrateInterval(rayleigh0, rayleigh1, t1 - t0);
+    mieSum += integrateInterval(mie0, mie1, t1 - t0);
+    rayleigh0 = rayleigh1;
+    mie0 = mie1;
+    t0 = t1;
+  }
+  float mu = dot(v, skyViewParameters.sunDirection);
+  rayleighSum *= scene.planet.rayleighScattering * phaseR(mu);
+  mieSum *= scene.planet.mieScattering * phaseM(mu);
+  vec3 indirect = rayleighSum + mieSum;
+  vec3 direct = t.z == 0.0 ? vec3(0.0f)
+                    : transmittance * scene.planet.albedo * INV_PI *
+                          max(dot(n, skyViewParameters.sunDirection), 0.0f);
+  vec3 total = (indirect + direct) * scene.sun.irradiance;
+  return vec4(total, t.z);
+}
+
+vec4 calcSkyViewLut(vec2 textureCoord) {
+  float t = 2.0 * textureCoord.y - 1.0;
+  float t2 = t * t;
+  float longitude = 2.0f * PI * textureCoord.x - PI;
+  float latitude = 0.5 * PI * sign(t) * t2;
+  float cosLat = cos(latitude);
+  float sinLat = sin(latitude);
+  float cosLong = cos(longitude);
+  float sinLong = sin(longitude);
+  vec3 x = vec3(0.0f, 0.0f, skyViewParameters.altitude);
+  vec3 v = vec3(cosLat * cosLong, cosLat * sinLong, sinLat);
+  return calcSkyView(x, v);
+}
+
+#endif
@@ -0,0 +1,24 @@
+#version 450 core
+
+layout(local_size_x_id = 0, local_size_y_id = 1) in;
+
+#define SCENE_SET     0
+#define SCENE_BINDING 0
+#include "Scene.glsl"
+
+#include "StorageFormat.glsl"
+
+layout(set = 0, binding = 1) uniform sampler2D transmittanceLut;
+STORAGE_LAYOUT(0, 2) uniform writeonly image2D skyView;
+
+#include "SkyView.glsl"
+
+void main() {
+  ivec2 size = imageSize(skyView);
+  ivec2 texel = ivec2(gl_GlobalInvocationID.xy);
+  if (any(greaterThanEqual(texel, size))) {
+    return;
+  }
+  vec2 textureCoord = (vec2(texel) + 0.5f) / vec2(size);
+  imageStore(skyView, texel, calcSkyViewLut(textureCoord));
+}
@@ -0,0 +1,11 @@
+#ifndef STORAGE_FORMAT_GLSL
+#define STORAGE_FORMAT_GLSL
+
+#ifdef FORMATLESS_STORAGE
+#define STORAGE_LAYOUT(SET, BINDING) layout(set = SET, binding = BINDING)
+#else
+#define STORAGE_LAYOUT(SET, BINDING) \
+  layout(set = SET, binding = BINDING, rgba16f)
+#endif
+
+#endif
@@ -0,0 +1,81 @@
+#ifndef TRANSMITTANCE_GLSL
+#define TRANSMITTANCE_GLSL
+
+#include "AtmosphereSampling.glsl"
+#include "Constants.glsl"
+#include "Scene.glsl"
+
+layout(constant_id = 2) const int transmittanceSteps = 40;
+
+float rayAtmosphere(vec2 o, vec2 d) {
+  o.y += scene.planet.groundRadius;
+  float b = -dot(o, d);
+  float discriminant =
+      scene.planet.atmosphereRadius * scene.planet.atmosphereRadius -
+      dot(o + b * d, o + b * d);
+  float c =
+      dot(o, o) - scene.planet.atmosphereRadius * scene.planet.atmosphereRadius;
+  float q = b + sign(b) * sqrt(discriminant);
+  float t0 = c / q;
+  float t1 = q;
+  return max(t0, t1);
+}
+
+float altitude(vec2 x) {
+  return length(x + vec2(0.0f, scene.planet.groundRadius)) -
+         scene.planet.groundRadius;
+}
+
+vec3 density(float h) {
+  vec3 d;
+  d.xy = min(
+      exp(vec2(-h) /
+          vec2(scene.planet.rayleighScaleHeight, scene.planet.mieScaleHeight)),
+      1.0f);
+  d.z =
+      max(1.0f - abs(h - scene.planet.ozoneLayerHeight) /
+                     (0.5f * scene.planet.ozoneLayerThickness),
+          0.0f);
+  return d;
+}
+
+vec3 integrateDensity(vec3 d0, vec3 d1, float dt) {
+  vec3 integral = integrateInterval(d0, d1, dt);
+  integral.z = 0.5f * (d0.z + d1.z) * dt;
+  return integral;
+}
+
+vec3 calcTransmittance(vec2 x, vec2 v) {
+  float t = rayAtmosphere(x, v);
+  float tPerigee =
+      clamp(-dot(x + vec2(0.0f, scene.planet.groundRadius), v), 0.0f, t);
+  float steps = float(transmittanceSteps);
+  vec3 opticalDepth = vec3(0.0f);
+  vec3 d0 = density(altitude(x));
+  float t0 = 0.0f;
+  for (float i = 1.0f; i <= steps; i += 1.0f) {
+    float t1 = getSampleDistance(i / steps, 0.0f, tPerigee, t);
+    vec3 d1 = density(altitude(x + t1 * v));
+    opticalDepth += integrateDensity(d0, d1, t1 - t0);
+    d0 = d1;
+    t0 = t1;
+  }
+  mat3 extinctionMat = mat3(
+      scene.planet.rayleighScattering,
+      vec3(scene.planet.mieScattering + scene.planet.mieAbsorption),
+      scene.planet.ozoneAbsorption);
+  vec3 extinctionVec = extinctionMat * opticalDepth;
+  return exp(-extinctionVec);
+}
+
+vec3 calcTransmittanceLut(vec2 textureCoord) {
+  float h = (scene.planet.atmosphereRadius - scene.planet.groundRadius) *
+            textureCoord.x * textureCoord.x;
+  float mu = 2.0f * textureCoord.y - 1.0f;
+  mu = sign(mu) * mu * mu;
+  vec2 x = vec2(0.0f, h);
+  vec2 v = vec2(sqrt(1.0f - mu * mu), mu);
+  return calcTransmittance(x, v);
+}
+
+#endif
@@ -0,0 +1,23 @@
+#version 450 core
+
+layout(local_size_x_id = 0, local_size_y_id = 1) in;
+
+#define SCENE_SET     0
+#define SCENE_BINDING 0
+#include "Scene.glsl"
+
+#include "StorageFormat.glsl"
+#include "Transmittance.glsl"
+
+STORAGE_LAYOUT(0, 1) uniform writeonly image2D transmittance;
+
+void main() {
+  ivec2 size = imageSize(transmittance);
+  ivec2 texel = ivec2(gl_GlobalInvocationID.xy);
+  if (any(greaterThanEqual(texel, size))) {
+    return;
+  }
+  vec2 textureCoord = (vec2(texel) + 0.5f) / vec2(size);
+  imageStore(
+      transmittance, texel, vec4(calcTransmittanceLut(textureCoord), 0.0f));
+}
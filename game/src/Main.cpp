@@ -1,29 +1,142 @@
+#include <algorithm>
+#include <array>
 #include <chrono>
+#include <cmath>
+#include <cstdint>
 #include <exception>
+#include <fstream>
 #include <iostream>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
 
+#include "graphics/FramePacket.h"
+#include "graphics/LutCache.h"
 #include "graphics/Renderer.h"
 #include "graphics/Scene.h"
 #include "graphics/SceneView.h"
+#include "system/CpuProfiler.h"
 #include "system/Display.h"
 #include "system/GpuContext.h"
+#include "system/OffscreenTarget.h"
+#include "system/TripleBuffer.h"
 
 // clang-format off
 import mobula.gpu;
 // clang-format on
 
-int main() {
+int main(int argc, char **argv) {
   using namespace std::chrono_literals;
 
+  auto startTime = std::chrono::high_resolution_clock::now();
+  auto coldStart = false;
+  auto computeEnabled = false;
+  auto asyncComputeEnabled = false;
+  auto skyViewUpdateFraction = 1.0f;
+  auto atmosphereQuality = imp::AtmosphereQuality::HIGH;
+  auto atmosphereSampling = imp::AtmosphereSampling::UNIFORM;
+  auto analyticTransmittanceEnabled = false;
+  auto stressEnabled = false;
+  auto profilingEnabled = false;
+  auto cpuProfilingEnabled = false;
+  auto headless = false;
+  auto dynamicRendering = true;
+  auto readbackDirectory = std::optional<std::string>{};
+  auto maxFrames = std::optional<std::size_t>{};
+  auto frameCount = std::size_t{3};
+  auto recordingThreadCount = std::size_t{};
+  auto imageFormats = imp::ImageFormats{
+      imp::ImageFormat::RGBA16F,
+      imp::ImageFormat::RGBA16F,
+      imp::ImageFormat::RGBA16F};
+  for (auto i = 1; i < argc; ++i) {
+    if (std::string_view{argv[i]} == "--cold-start") {
+      coldStart = true;
+    } else if (std::string_view{argv[i]} == "--compute") {
+      computeEnabled = true;
+    } else if (std::string_view{argv[i]} == "--async-compute") {
+      asyncComputeEnabled = true;
+    } else if (std::string_view{argv[i]} == "--amortize-sky-view") {
+      skyViewUpdateFraction = 0.125f;
+    } else if (std::string_view{argv[i]} == "--low-quality") {
+      atmosphereQuality = imp::AtmosphereQuality::LOW;
+    } else if (std::string_view{argv[i]} == "--medium-quality") {
+      atmosphereQuality = imp::AtmosphereQuality::MEDIUM;
+    } else if (std::string_view{argv[i]} == "--ultra-quality") {
+      atmosphereQuality = imp::AtmosphereQuality::ULTRA;
+    } else if (std::string_view{argv[i]} == "--importance-sampling") {
+      atmosphereSampling = imp::AtmosphereSampling::IMPORTANCE;
+    } else if (std::string_view{argv[i]} == "--exponential-sampling") {
+      atmosphereSampling = imp::AtmosphereSampling::EXPONENTIAL;
+    } else if (std::string_view{argv[i]} == "--analytic-transmittance") {
+      analyticTransmittanceEnabled = true;
+    } else if (std::string_view{argv[i]} == "--packed-luts") {
+      imageFormats.transmittance = imp::ImageFormat::B10G11R11;
+      imageFormats.skyView = imp::ImageFormat::B10G11R11;
+    } else if (std::string_view{argv[i]} == "--shared-exponent-luts") {
+      imageFormats.transmittance = imp::ImageFormat::E5B9G9R9;
+      imageFormats.skyView = imp::ImageFormat::E5B9G9R9;
+    } else if (std::string_view{argv[i]} == "--packed-scene-view") {
+      imageFormats.primary = imp::ImageFormat::B10G11R11;
+    } else if (std::string_view{argv[i]} == "--stress") {
+      stressEnabled = true;
+    } else if (std::string_view{argv[i]} == "--profile-gpu") {
+      profilingEnabled = true;
+    } else if (std::string_view{argv[i]} == "--profile-cpu") {
+      cpuProfilingEnabled = true;
+    } else if (std::string_view{argv[i]} == "--headless") {
+      headless = true;
+    } else if (std::string_view{argv[i]} == "--render-passes") {
+      dynamicRendering = false;
+    } else if (std::string_view{argv[i]} == "--readback" && i + 1 < argc) {
+      readbackDirectory = argv[++i];
+    } else if (std::string_view{argv[i]} == "--max-frames" && i + 1 < argc) {
+      maxFrames = std::stoul(argv[++i]);
+    } else if (std::string_view{argv[i]} == "--frame-count" && i + 1 < argc) {
+      frameCount = std::stoul(argv[++i]);
+    } else if (
+        std::string_view{argv[i]} == "--recording-threads" && i + 1 < argc) {
+      recordingThreadCount = std::stoul(argv[++i]);
+    }
+  }
+  imp::CpuProfiler::setEnabled(cpuProfilingEnabled);
+  if (cpuProfilingEnabled) {
+    imp::CpuProfiler::setThreadName("main");
+  }
+  if (headless && !maxFrames) {
+    maxFrames = 100;
+  }
   try {
-    imp::Display::init();
+    if (!headless) {
+      imp::Display::init();
+    }
     auto gpuContextCreateInfo = imp::GpuContextCreateInfo{};
     gpuContextCreateInfo.validation = false;
-    gpuContextCreateInfo.presentation = true;
+    gpuContextCreateInfo.presentation = !headless;
+    gpuContextCreateInfo.dynamicRendering = dynamicRendering;
     auto gpuContext = imp::GpuContext{gpuContextCreateInfo};
-    auto window =
-        imp::Display{imp::gsl::not_null{&gpuContext}, 1920, 1080, "imp", true};
-    auto renderer = imp::Renderer{imp::gsl::not_null{&window}, 3};
+    auto window = std::unique_ptr<imp::Display>{};
+    auto offscreenTarget = std::unique_ptr<imp::OffscreenTarget>{};
+    auto target = static_cast<imp::RenderTarget *>(nullptr);
+    if (headless) {
+      offscreenTarget = std::make_unique<imp::OffscreenTarget>(
+          imp::gsl::not_null{&gpuContext}, 1920, 1080);
+      if (readbackDirectory) {
+        offscreenTarget->setReadbackDirectory(*readbackDirectory);
+        offscreenTarget->setReadbackEnabled(true);
+      }
+      target = offscreenTarget.get();
+    } else {
+      window = std::make_unique<imp::Display>(
+          imp::gsl::not_null{&gpuContext}, 1920, 1080, "imp", true);
+      target = window.get();
+    }
+    auto renderer =
+        imp::Renderer{imp::gsl::not_null{target}, frameCount, imageFormats};
+    renderer.setRecordingThreadCount(recordingThreadCount);
+    renderer.setProfilingEnabled(profilingEnabled);
     auto scene = imp::gsl::not_null{
         std::make_shared<imp::Scene>(renderer.getSceneFlyweight())};
     auto earth = imp::gsl::not_null{std::make_shared<imp::Planet>()};
@@ -31,15 +144,32 @@ int main() {
     auto sun = imp::gsl::not_null{std::make_shared<imp::DirectionalLight>(
         imp::Spectrum{191.4f},
         Eigen::Vector3f{0.0f, -1.0f, 1.0f}.normalized())};
+    auto lutCache = std::make_shared<imp::LutCache>("./cache");
+    if (coldStart) {
+      lutCache->clear();
+    }
     scene->setPlanet(earth);
     scene->setSunLight(sun);
+    scene->setLutCache(lutCache);
+    scene->setComputeEnabled(computeEnabled);
+    scene->setAsyncComputeEnabled(asyncComputeEnabled);
+    scene->setSkyViewUpdateFraction(skyViewUpdateFraction);
+    scene->setAtmosphereQuality(atmosphereQuality);
+    scene->setAtmosphereSampling(atmosphereSampling);
+    scene->setAnalyticTransmittanceEnabled(analyticTransmittanceEnabled);
+    constexpr auto STRESS_VIEW_COUNTS = std::array{1, 4, 16, 64};
+    constexpr auto STRESS_REPORT_COUNT = 5;
+    auto stressIndex = std::size_t{};
+    auto stressReportCount = 0;
     auto views =
         std::vector<imp::gsl::not_null<std::shared_ptr<imp::SceneView>>>{};
-    for (auto i = 0; i < 1; ++i) {
+    for (auto i = 0; i < (stressEnabled ? STRESS_VIEW_COUNTS.back() : 1); ++i) {
       views.emplace_back(std::make_shared<imp::SceneView>(
           renderer.getSceneViewFlyweight(), scene, imp::Extent2u{1920, 1080}));
+      views.back()->setName("view " + std::to_string(i));
+      views.back()->setComputeEnabled(computeEnabled);
+      views.back()->setExposure(1.0f / 10.0f);
     }
-    views[0]->setExposure(1.0f / 10.0f);
     // views[1]->setExposure(1.0f / 12.0f);
     // views[2]->setExposure(1.0f / 12.0f);
     // views[3]->setExposure(1.0f / 12.0f);
@@ -50,7 +180,9 @@ int main() {
     {
       auto viewMatrix = Eigen::Matrix4f::Identity().eval();
       viewMatrix(1, 3) = -64.0f;
-      views[0]->setViewMatrix(viewMatrix);
+      for (auto &view : views) {
+        view->setViewMatrix(viewMatrix);
+      }
       /*viewMatrix(1, 3) = -256.0f;
       views[1]->setViewMatrix(viewMatrix);
       viewMatrix(1, 3) = -1024.0f;
@@ -71,7 +203,9 @@ int main() {
       projectionMatrix(2, 2) = n / (f - n);
       projectionMatrix(2, 3) = n * f / (f - n);
       projectionMatrix(3, 2) = -1;
-      views[0]->setProjectionMatrix(projectionMatrix);
+      for (auto &view : views) {
+        view->setProjectionMatrix(projectionMatrix);
+      }
       // views[1]->setProjectionMatrix(projectionMatrix);
       // views[2]->setProjectionMatrix(projectionMatrix);
       // views[3]->setProjectionMatrix(projectionMatrix);
@@ -89,33 +223,185 @@ int main() {
     //  //  m(3, 2) = -1;
     //  //  return m;
     //  //}
-    auto frame_time = std::chrono::high_resolution_clock::now();
-    auto frame_count = 0;
-    while (!window.shouldClose()) {
-      imp::Display::poll();
-      auto theta = float(glfwGetTime()) * 0.0034906585f * 4.5f - 0.1f;
+    auto initialPacket = imp::FramePacket{};
+    initialPacket.planetPosition = earth->getPosition();
+    initialPacket.sunIrradiance = sun->getIrradiance();
+    initialPacket.sunDirection = sun->getDirection();
+    initialPacket.viewCount = views.size();
+    for (auto i = std::size_t{}; i < views.size(); ++i) {
+      initialPacket.views[i].viewMatrix = views[i]->getViewMatrix();
+      initialPacket.views[i].projectionMatrix = views[i]->getProjectionMatrix();
+      initialPacket.views[i].exposure = views[i]->getExposure();
+    }
+    constexpr auto TICK_DURATION = std::chrono::nanoseconds{8333333};
+    auto simulate = [initialPacket](
+                        imp::FramePacket &packet, std::uint64_t tick) {
+      IMP_CPU_ZONE("simulate");
+      packet = initialPacket;
+      packet.tick = tick;
+      auto time =
+          std::chrono::duration<float>{tick * TICK_DURATION}.count();
+      auto theta = time * 0.0034906585f * 4.5f - 0.1f;
       auto cosTheta = std::cos(theta);
       auto sinTheta = std::sin(theta);
       Eigen::Vector3f cosAxis = {0.0f, 0.0f, -1.0f};
       Eigen::Vector3f sinAxis = Eigen::Vector3f{0.0f, 1.0f, 0.0f}.normalized();
-      sun->setDirection(cosAxis * cosTheta + sinAxis * sinTheta);
-      if (window.getFramebufferWidth() != 0 &&
-          window.getFramebufferHeight() != 0) {
+      packet.sunDirection = cosAxis * cosTheta + sinAxis * sinTheta;
+    };
+    auto framePackets = imp::TripleBuffer<imp::FramePacket>{};
+    auto simulationThread = std::jthread{};
+    if (!headless) {
+      simulationThread = std::jthread{
+          [&framePackets, simulate](std::stop_token stopToken) {
+            auto tickTime = std::chrono::steady_clock::now();
+            for (auto tick = std::uint64_t{}; !stopToken.stop_requested();
+                 ++tick) {
+              simulate(framePackets.getWriteBuffer(), tick);
+              framePackets.publish();
+              tickTime += TICK_DURATION;
+              std::this_thread::sleep_until(tickTime);
+            }
+          }};
+    }
+    auto frame_time = std::chrono::high_resolution_clock::now();
+    auto frame_count = 0;
+    auto cpuTime = std::chrono::duration<double, std::milli>{};
+    auto recordingTime = std::chrono::duration<double, std::milli>{};
+    auto maxRecordingThreadCount = std::max(
+        std::size_t{std::thread::hardware_concurrency()}, std::size_t{1});
+    auto firstFrame = true;
+    auto totalFrameCount = std::size_t{};
+    auto headlessPacket = imp::FramePacket{};
+    while (!(window && window->shouldClose()) &&
+           !(maxFrames && totalFrameCount == *maxFrames)) {
+      imp::CpuProfiler::markFrame();
+      if (window) {
+        imp::Display::poll();
+        if (framePackets.acquire()) {
+          framePackets.getReadBuffer().apply(*scene, views);
+        }
+      } else {
+        simulate(headlessPacket, totalFrameCount);
+        headlessPacket.apply(*scene, views);
+      }
+      if (!window || (window->getFramebufferWidth() != 0 &&
+                      window->getFramebufferHeight() != 0)) {
+        auto cpuStartTime = std::chrono::high_resolution_clock::now();
+        auto viewCount = stressEnabled ? STRESS_VIEW_COUNTS[stressIndex] : 1;
+        auto columns = static_cast<int>(std::sqrt(float(viewCount)));
+        auto width = 1920 / columns;
+        auto height = 1080 / columns;
         renderer.begin();
-        for (auto i = 0; i < 1; ++i) {
-          renderer.draw(views[i], 0, 0, 1920, 1080);
+        for (auto i = 0; i < viewCount; ++i) {
+          views[i]->setExtent(imp::Extent2u{
+              static_cast<std::uint32_t>(width),
+              static_cast<std::uint32_t>(height)});
+          renderer.draw(
+              views[i],
+              i % columns * width,
+              i / columns * height,
+              width,
+              height);
         }
         // renderer.draw(groundView, 0, 0, 1920, 1080);
         renderer.end();
+        cpuTime += std::chrono::high_resolution_clock::now() - cpuStartTime;
+        auto slowestRecordingTime = std::chrono::steady_clock::duration{};
+        for (auto i = std::size_t{}; i < renderer.getRecordingThreadCount();
+             ++i) {
+          slowestRecordingTime =
+              std::max(slowestRecordingTime, renderer.getRecordingTime(i));
+        }
+        recordingTime += slowestRecordingTime;
         ++frame_count;
+        ++totalFrameCount;
+        if (firstFrame) {
+          gpuContext.getDevice().waitIdle();
+          auto duration = std::chrono::duration<double, std::milli>{
+              std::chrono::high_resolution_clock::now() - startTime};
+          std::cout << "time to first frame: " << duration.count() << " ms ("
+                    << (coldStart ? "cold" : "warm") << " start, "
+                    << lutCache->getHitCount() << " lut cache hits, "
+                    << lutCache->getMissCount() << " misses)\n";
+          auto bloomSize = vk::DeviceSize{};
+          for (auto &view : views) {
+            bloomSize += view->getUnaliasedBloomSize();
+          }
+          auto heapSize =
+              renderer.getSceneViewFlyweight()->getTransientHeap()->getSize();
+          std::cout << "bloom memory: " << heapSize / 1048576.0
+                    << " MB shared by " << views.size() << " views, "
+                    << (bloomSize - heapSize) / 1048576.0 / views.size()
+                    << " MB saved per view\n";
+          firstFrame = false;
+        }
       }
       if (std::chrono::high_resolution_clock::now() - frame_time > 1s) {
-        std::cout << frame_count << " fps\n";
+        if (stressEnabled) {
+          std::cout << STRESS_VIEW_COUNTS[stressIndex] << " views, "
+                    << renderer.getRecordingThreadCount()
+                    << " recording threads: ";
+        }
+        std::cout << frame_count << " fps, "
+                  << cpuTime.count() / std::max(frame_count, 1)
+                  << " ms cpu per frame";
+        if (renderer.getRecordingThreadCount() != 0) {
+          std::cout << ", " << recordingTime.count() / std::max(frame_count, 1)
+                    << " ms recording on slowest thread";
+        }
+        std::cout << "\n";
+        if (imp::CpuProfiler::isEnabled()) {
+          auto frameTimes = imp::CpuProfiler::getFrameTimes();
+          std::cout << "  frame time: " << frameTimes.getPercentile(0.5)
+                    << " ms p50, " << frameTimes.getPercentile(0.95)
+                    << " ms p95, " << frameTimes.getPercentile(0.99)
+                    << " ms p99\n";
+        }
+        if (renderer.isProfilingEnabled()) {
+          for (auto &stats : renderer.getProfiler().getHistory().getStats()) {
+            if (stats.owner == "all") {
+              std::cout << "  " << stats.pass << ": " << stats.average
+                        << " ms avg, " << stats.p99 << " ms p99\n";
+            }
+          }
+        }
         frame_time = std::chrono::high_resolution_clock::now();
         frame_count = 0;
+        cpuTime = {};
+        recordingTime = {};
+        if (stressEnabled && ++stressReportCount == STRESS_REPORT_COUNT) {
+          stressReportCount = 0;
+          if (stressIndex + 1 < STRESS_VIEW_COUNTS.size()) {
+            ++stressIndex;
+          } else if (recordingThreadCount < maxRecordingThreadCount) {
+            recordingThreadCount = std::min(
+                std::max(recordingThreadCount * 2, std::size_t{1}),
+                maxRecordingThreadCount);
+            renderer.setRecordingThreadCount(recordingThreadCount);
+          } else {
+            break;
+          }
+        }
       }
     }
+    if (simulationThread.joinable()) {
+      simulationThread.request_stop();
+      simulationThread.join();
+    }
     gpuContext.getDevice().waitIdle();
+    if (renderer.isProfilingEnabled()) {
+      auto json = std::ofstream{"gpu-profile.json"};
+      renderer.getProfiler().getHistory().writeJson(json);
+      auto csv = std::ofstream{"gpu-profile.csv"};
+      renderer.getProfiler().getHistory().writeCsv(csv);
+    }
+    if (imp::CpuProfiler::isEnabled()) {
+      imp::CpuProfiler::setEnabled(false);
+      auto trace = std::ofstream{"cpu-trace.json"};
+      imp::CpuProfiler::writeChromeTrace(trace);
+      auto csv = std::ofstream{"frame-times.csv"};
+      imp::CpuProfiler::getFrameTimes().writeCsv(csv);
+    }
   } catch (std::exception &e) {
     std::cerr << e.what() << "\n";
   }
@@ -0,0 +1,327 @@
+#include "AtmosphereModel.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+
+namespace imp {
+  namespace {
+    Eigen::Vector3f toVector(Spectrum const &spectrum) noexcept {
+      return {spectrum.r(), spectrum.g(), spectrum.b()};
+    }
+
+    float rayAtmosphere(
+        Planet const &planet,
+        Eigen::Vector2f o,
+        Eigen::Vector2f const &d) noexcept {
+      o.y() += planet.getGroundRadius();
+      auto atmosphereRadius2 =
+          planet.getAtmosphereRadius() * planet.getAtmosphereRadius();
+      auto b = -o.dot(d);
+      auto discriminant = atmosphereRadius2 - (o + b * d).squaredNorm();
+      auto c = o.squaredNorm() - atmosphereRadius2;
+      auto q = b + std::copysign(std::sqrt(discriminant), b);
+      return std::max(c / q, q);
+    }
+
+    float getAltitude(
+        Planet const &planet, Eigen::Vector2f const &x) noexcept {
+      return (x + Eigen::Vector2f{0.0f, planet.getGroundRadius()}).norm() -
+             planet.getGroundRadius();
+    }
+
+    Eigen::Vector3f getDensity(Planet const &planet, float h) noexcept {
+      return {
+          std::min(std::exp(-h / planet.getRayleighScaleHeight()), 1.0f),
+          std::min(std::exp(-h / planet.getMieScaleHeight()), 1.0f),
+          std::max(
+              1.0f - std::abs(h - planet.getOzoneLayerHeight()) /
+                         (0.5f * planet.getOzoneLayerThickness()),
+              0.0f)};
+    }
+
+    Eigen::Vector2f raySphere(
+        Eigen::Vector3f const &ro,
+        Eigen::Vector3f const &rd,
+        Eigen::Vector3f const &ce,
+        float ra) noexcept {
+      Eigen::Vector3f oc = ro - ce;
+      auto b = oc.dot(rd);
+      auto c = oc.squaredNorm() - ra * ra;
+      auto h = b * b - c;
+      if (h < 0.0f) {
+        return {-1.0f, -1.0f};
+      }
+      h = std::sqrt(h);
+      return {-b - h, -b + h};
+    }
+
+    float getSampleDistance(
+        float u,
+        float tMin,
+        float tPerigee,
+        float tMax,
+        AtmosphereSampling sampling) noexcept {
+      if (sampling == AtmosphereSampling::UNIFORM || tMax <= tMin) {
+        return tMin + u * (tMax - tMin);
+      }
+      auto a = std::sqrt(tPerigee - tMin);
+      auto b = std::sqrt(tMax - tPerigee);
+      auto uPerigee = a / (a + b);
+      if (u < uPerigee) {
+        auto w = 1.0f - u / uPerigee;
+        return tPerigee - (tPerigee - tMin) * w * w;
+      }
+      auto w = (u - uPerigee) / std::max(1.0f - uPerigee, 1e-6f);
+      return tPerigee + (tMax - tPerigee) * w * w;
+    }
+
+    float integrateInterval(
+        float f0, float f1, float dt, AtmosphereSampling sampling) noexcept {
+      if (sampling == AtmosphereSampling::EXPONENTIAL && f0 > 0.0f &&
+          f1 > 0.0f && std::abs(f1 - f0) > 1e-3f * (f0 + f1)) {
+        return (f1 - f0) / std::log(f1 / f0) * dt;
+      }
+      return 0.5f * (f0 + f1) * dt;
+    }
+
+    Eigen::Vector3f integrateInterval(
+        Eigen::Vector3f const &f0,
+        Eigen::Vector3f const &f1,
+        float dt,
+        AtmosphereSampling sampling) noexcept {
+      return {
+          integrateInterval(f0.x(), f1.x(), dt, sampling),
+          integrateInterval(f0.y(), f1.y(), dt, sampling),
+          integrateInterval(f0.z(), f1.z(), dt, sampling)};
+    }
+
+    Eigen::Vector3f integrateDensity(
+        Eigen::Vector3f const &density0,
+        Eigen::Vector3f const &density1,
+        float dt,
+        AtmosphereSampling sampling) noexcept {
+      return {
+          integrateInterval(density0.x(), density1.x(), dt, sampling),
+          integrateInterval(density0.y(), density1.y(), dt, sampling),
+          0.5f * (density0.z() + density1.z()) * dt};
+    }
+
+    float calcChapman(float x, float mu) noexcept {
+      auto y = std::sqrt(0.5f * x) * mu;
+      auto erfcx = (1.0f + y * (0.88386f + y * 0.31715f)) /
+                   (1.0f + y * (2.01564f + y * (1.56954f + y * 0.56214f)));
+      return std::sqrt(0.5f * std::numbers::pi_v<float> * x) * erfcx;
+    }
+
+    float calcExponentialDepth(
+        float groundRadius, float r, float mu, float scaleHeight) noexcept {
+      auto depth = [&](float r, float mu) {
+        return scaleHeight * std::exp((groundRadius - r) / scaleHeight) *
+               calcChapman(r / scaleHeight, mu);
+      };
+      if (mu >= 0.0f) {
+        return depth(r, mu);
+      }
+      auto rPerigee = r * std::sqrt(1.0f - mu * mu);
+      return 2.0f * depth(rPerigee, 0.0f) - depth(r, -mu);
+    }
+
+    float calcOzoneDepth(Planet const &planet, float r, float mu) noexcept {
+      auto hPerigee = r * std::sqrt(std::max(1.0f - mu * mu, 0.0f)) -
+                      planet.getGroundRadius();
+      auto halfThickness = 0.5f * planet.getOzoneLayerThickness();
+      auto center = planet.getOzoneLayerHeight();
+      auto bottom = center - halfThickness;
+      auto top = center + halfThickness;
+      auto scale =
+          (planet.getGroundRadius() + center) /
+          std::sqrt(2.0f * planet.getGroundRadius() + center + hPerigee);
+      auto integrate = [&](float h0, float h1, float density, float slope) {
+        if (h0 >= h1) {
+          return 0.0f;
+        }
+        auto primitive = [&](float h) {
+          auto z = std::max(h - hPerigee, 0.0f);
+          auto sqrtZ = std::sqrt(z);
+          return 2.0f * density * sqrtZ + 2.0f / 3.0f * slope * z * sqrtZ;
+        };
+        return primitive(h1) - primitive(h0);
+      };
+      auto depth = [&](float h) {
+        return scale *
+               (integrate(
+                    std::max(h, bottom),
+                    center,
+                    (hPerigee - bottom) / halfThickness,
+                    1.0f / halfThickness) +
+                integrate(
+                    std::max(h, center),
+                    top,
+                    (top - hPerigee) / halfThickness,
+                    -1.0f / halfThickness));
+      };
+      auto h = r - planet.getGroundRadius();
+      return mu >= 0.0f ? depth(h) : 2.0f * depth(hPerigee) - depth(h);
+    }
+
+    float phaseR(float mu) noexcept {
+      return 3.0f * (1.0f + mu * mu) / (16.0f * std::numbers::pi_v<float>);
+    }
+
+    float phaseM(float g, float mu) noexcept {
+      auto g2 = g * g;
+      return 3.0f * (1.0f - g2) * (1.0f + mu * mu) /
+             (8.0f * std::numbers::pi_v<float> * (2.0f + g2) *
+              std::pow(1.0f + g2 - 2.0f * g * mu, 1.5f));
+    }
+  } // namespace
+
+  Eigen::Vector3f calcTransmittance(
+      Planet const &planet,
+      float altitude,
+      float mu,
+      std::uint32_t steps,
+      AtmosphereSampling sampling) noexcept {
+    auto x = Eigen::Vector2f{0.0f, altitude};
+    auto v = Eigen::Vector2f{std::sqrt(std::max(1.0f - mu * mu, 0.0f)), mu};
+    auto t = rayAtmosphere(planet, x, v);
+    auto tPerigee = std::clamp(
+        -(x + Eigen::Vector2f{0.0f, planet.getGroundRadius()}).dot(v),
+        0.0f,
+        t);
+    auto opticalDepth = Eigen::Vector3f{Eigen::Vector3f::Zero()};
+    auto previousDensity = getDensity(planet, altitude);
+    auto previousDistance = 0.0f;
+    for (auto i = std::uint32_t{1}; i <= steps; ++i) {
+      auto distance = getSampleDistance(
+          float(i) / float(steps), 0.0f, tPerigee, t, sampling);
+      Eigen::Vector2f p = x + distance * v;
+      auto density = getDensity(planet, getAltitude(planet, p));
+      opticalDepth += integrateDensity(
+          previousDensity, density, distance - previousDistance, sampling);
+      previousDensity = density;
+      previousDistance = distance;
+    }
+    auto extinction = Eigen::Matrix3f{};
+    extinction.col(0) = toVector(planet.getRayleighScattering());
+    extinction.col(1).setConstant(
+        planet.getMieScattering() + planet.getMieAbsorption());
+    extinction.col(2) = toVector(planet.getOzoneAbsorption());
+    return (-(extinction * opticalDepth)).array().exp();
+  }
+
+  Eigen::Vector3f calcAnalyticTransmittance(
+      Planet const &planet, float altitude, float mu) noexcept {
+    auto r = planet.getGroundRadius() + altitude;
+    auto horizonMu = -std::sqrt(std::max(
+        1.0f - planet.getGroundRadius() * planet.getGroundRadius() / (r * r),
+        0.0f));
+    if (mu < horizonMu) {
+      return Eigen::Vector3f::Zero();
+    }
+    auto opticalDepth = Eigen::Vector3f{
+        calcExponentialDepth(
+            planet.getGroundRadius(), r, mu, planet.getRayleighScaleHeight()),
+        calcExponentialDepth(
+            planet.getGroundRadius(), r, mu, planet.getMieScaleHeight()),
+        calcOzoneDepth(planet, r, mu)};
+    auto extinction = Eigen::Matrix3f{};
+    extinction.col(0) = toVector(planet.getRayleighScattering());
+    extinction.col(1).setConstant(
+        planet.getMieScattering() + planet.getMieAbsorption());
+    extinction.col(2) = toVector(planet.getOzoneAbsorption());
+    return (-(extinction * opticalDepth)).array().exp();
+  }
+
+  Eigen::Vector3f calcTransmittanceLut(
+      Planet const &planet,
+      Eigen::Vector2f const &textureCoord,
+      std::uint32_t steps,
+      AtmosphereSampling sampling) noexcept {
+    auto h = (planet.getAtmosphereRadius() - planet.getGroundRadius()) *
+             textureCoord.x() * textureCoord.x();
+    auto mu = 2.0f * textureCoord.y() - 1.0f;
+    mu = std::copysign(mu * mu, mu);
+    return calcTransmittance(planet, h, mu, steps, sampling);
+  }
+
+  Eigen::Vector2f getTransmittanceLutCoord(
+      Planet const &planet, float altitude, float mu) noexcept {
+    return {
+        std::sqrt(
+            altitude /
+            (planet.getAtmosphereRadius() - planet.getGroundRadius())),
+        0.5f * std::copysign(std::sqrt(std::abs(mu)), mu) + 0.5f};
+  }
+
+  Eigen::Vector3f calcSkyRadiance(
+      Planet const &planet,
+      float altitude,
+      Eigen::Vector3f const &viewDirection,
+      Eigen::Vector3f const &sunDirection,
+      std::uint32_t steps,
+      std::uint32_t transmittanceSteps,
+      AtmosphereSampling sampling) noexcept {
+    auto center = Eigen::Vector3f{0.0f, 0.0f, -planet.getGroundRadius()};
+    auto x = Eigen::Vector3f{0.0f, 0.0f, altitude};
+    auto const &v = viewDirection;
+    auto t = raySphere(x, v, center, planet.getAtmosphereRadius());
+    if (t.y() < 0.0f) {
+      return Eigen::Vector3f::Zero();
+    }
+    auto tGround = raySphere(x, v, center, planet.getGroundRadius());
+    auto ground = tGround.x() > 0.0f;
+    t.x() = std::max(t.x(), 0.0f);
+    t.y() = ground ? std::min(tGround.x(), t.y()) : t.y();
+    auto tPerigee = std::clamp(-(x - center).dot(v), t.x(), t.y());
+    Eigen::Vector3f eyeDirection = ground ? Eigen::Vector3f{-v} : v;
+    auto transmittanceAt = [&](Eigen::Vector3f const &p,
+                               Eigen::Vector3f const &direction) {
+      Eigen::Vector3f n = (p - center).normalized();
+      auto h = std::max((p - center).norm() - planet.getGroundRadius(), 0.0f);
+      return calcTransmittance(
+          planet, h, n.dot(direction), transmittanceSteps, sampling);
+    };
+    Eigen::Vector3f p0 = x + t.x() * v;
+    Eigen::Vector3f eyeTransmittance = transmittanceAt(p0, eyeDirection);
+    auto rayleighSum = Eigen::Vector3f{Eigen::Vector3f::Zero()};
+    auto mieSum = Eigen::Vector3f{Eigen::Vector3f::Zero()};
+    auto previousRayleigh = Eigen::Vector3f{};
+    auto previousMie = Eigen::Vector3f{};
+    auto previousDistance = t.x();
+    for (auto i = std::uint32_t{}; i <= steps; ++i) {
+      auto distance = getSampleDistance(
+          float(i) / float(steps), t.x(), tPerigee, t.y(), sampling);
+      Eigen::Vector3f p = x + distance * v;
+      auto h = std::max((p - center).norm() - planet.getGroundRadius(), 0.0f);
+      Eigen::Vector3f sunTransmittance = transmittanceAt(p, sunDirection);
+      Eigen::Vector3f transmittance = transmittanceAt(p, eyeDirection);
+      transmittance =
+          ground
+              ? Eigen::Vector3f{sunTransmittance.cwiseProduct(transmittance)
+                                    .cwiseQuotient(eyeTransmittance)}
+              : Eigen::Vector3f{sunTransmittance.cwiseProduct(eyeTransmittance)
+                                    .cwiseQuotient(transmittance)};
+      Eigen::Vector3f rayleigh =
+          std::min(std::exp(-h / planet.getRayleighScaleHeight()), 1.0f) *
+          transmittance;
+      Eigen::Vector3f mie =
+          std::min(std::exp(-h / planet.getMieScaleHeight()), 1.0f) *
+          transmittance;
+      if (i != 0) {
+        rayleighSum += integrateInterval(
+            previousRayleigh, rayleigh, distance - previousDistance, sampling);
+        mieSum += integrateInterval(
+            previousMie, mie, distance - previousDistance, sampling);
+      }
+      previousRayleigh = rayleigh;
+      previousMie = mie;
+      previousDistance = distance;
+    }
+    auto mu = v.dot(sunDirection);
+    return rayleighSum.cwiseProduct(toVector(planet.getRayleighScattering())) *
+               phaseR(mu) +
+           mieSum * planet.getMieScattering() * phaseM(planet.getMieG(), mu);
+  }
+} // namespace imp
\ No newline at end of file
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstdint>
+
+#include <Eigen/Dense>
+
+#include "AtmosphereQuality.h"
+#include "Planet.h"
+
+namespace imp {
+  Eigen::Vector3f calcTransmittance(
+      Planet const &planet,
+      float altitude,
+      float mu,
+      std::uint32_t steps,
+      AtmosphereSampling sampling) noexcept;
+
+  Eigen::Vector3f calcAnalyticTransmittance(
+      Planet const &planet, float altitude, float mu) noexcept;
+
+  Eigen::Vector3f calcTransmittanceLut(
+      Planet const &planet,
+      Eigen::Vector2f const &textureCoord,
+      std::uint32_t steps,
+      AtmosphereSampling sampling) noexcept;
+
+  Eigen::Vector2f getTransmittanceLutCoord(
+      Planet const &planet, float altitude, float mu) noexcept;
+
+  Eigen::Vector3f calcSkyRadiance(
+      Planet const &planet,
+      float altitude,
+      Eigen::Vector3f const &viewDirection,
+      Eigen::Vector3f const &sunDirection,
+      std::uint32_t steps,
+      std::uint32_t transmittanceSteps,
+      AtmosphereSampling sampling) noexcept;
+} // namespace imp
\ No newline at end of file
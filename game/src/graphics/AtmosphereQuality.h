@@ -0,0 +1,30 @@
+#pragma once
+
+#include "../util/Extent.h"
+
+namespace imp {
+  enum class AtmosphereQuality { LOW, MEDIUM, HIGH, ULTRA };
+
+  enum class AtmosphereSampling { UNIFORM, IMPORTANCE, EXPONENTIAL };
+
+  struct AtmosphereQualitySettings {
+    std::uint32_t transmittanceSteps;
+    std::uint32_t skyViewSteps;
+    Extent3u transmittanceExtent;
+    Extent3u skyViewExtent;
+  };
+
+  constexpr AtmosphereQualitySettings
+  getAtmosphereQualitySettings(AtmosphereQuality quality) noexcept {
+    switch (quality) {
+    case AtmosphereQuality::LOW:
+      return {10, 8, {32, 128, 1}, {64, 128, 1}};
+    case AtmosphereQuality::MEDIUM:
+      return {20, 16, {64, 128, 1}, {96, 192, 1}};
+    case AtmosphereQuality::ULTRA:
+      return {80, 60, {128, 512, 1}, {256, 512, 1}};
+    default:
+      return {40, 30, {64, 256, 1}, {128, 256, 1}};
+    }
+  }
+} // namespace imp
\ No newline at end of file
@@ -0,0 +1,27 @@
+#include "FramePacket.h"
+
+#include <algorithm>
+
+#include "Scene.h"
+#include "SceneView.h"
+
+namespace imp {
+  void FramePacket::apply(
+      Scene &scene,
+      gsl::span<gsl::not_null<std::shared_ptr<SceneView>> const> sceneViews)
+      const {
+    if (auto planet = scene.getPlanet()) {
+      planet->setPosition(planetPosition);
+    }
+    if (auto sunLight = scene.getSunLight()) {
+      sunLight->setIrradiance(sunIrradiance);
+      sunLight->setDirection(sunDirection);
+    }
+    auto count = std::min(viewCount, sceneViews.size());
+    for (auto i = std::size_t{}; i < count; ++i) {
+      sceneViews[i]->setViewMatrix(views[i].viewMatrix);
+      sceneViews[i]->setProjectionMatrix(views[i].projectionMatrix);
+      sceneViews[i]->setExposure(views[i].exposure);
+    }
+  }
+} // namespace imp
\ No newline at end of file
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <memory>
+
+#include <Eigen/Dense>
+
+#include "../util/Gsl.h"
+#include "Spectrum.h"
+
+namespace imp {
+  class Scene;
+  class SceneView;
+
+  struct ViewPacket {
+    Eigen::Matrix4f viewMatrix;
+    Eigen::Matrix4f projectionMatrix;
+    float exposure;
+  };
+
+  struct FramePacket {
+    static constexpr auto MAX_VIEW_COUNT = std::size_t{64};
+
+    std::uint64_t tick;
+    Eigen::Vector3f planetPosition;
+    Spectrum sunIrradiance;
+    Eigen::Vector3f sunDirection;
+    std::size_t viewCount;
+    std::array<ViewPacket, MAX_VIEW_COUNT> views;
+
+    void apply(
+        Scene &scene,
+        gsl::span<gsl::not_null<std::shared_ptr<SceneView>> const> sceneViews)
+        const;
+  };
+} // namespace imp
\ No newline at end of file
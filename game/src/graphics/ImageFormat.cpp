@@ -0,0 +1,24 @@
+#include "ImageFormat.h"
+
+namespace imp {
+  vk::Format selectImageFormat(
+      ImageFormat format,
+      vk::FormatFeatureFlags features,
+      std::function<vk::FormatProperties(vk::Format)> const
+          &getFormatProperties,
+      bool storageImageWriteWithoutFormatSupported) {
+    auto vkFormat = getVkFormat(format);
+    if (format == ImageFormat::RGBA16F) {
+      return vkFormat;
+    }
+    auto properties = getFormatProperties(vkFormat);
+    if ((properties.optimalTilingFeatures & features) != features) {
+      return getVkFormat(ImageFormat::RGBA16F);
+    }
+    if ((features & vk::FormatFeatureFlagBits::eStorageImage) &&
+        !storageImageWriteWithoutFormatSupported) {
+      return getVkFormat(ImageFormat::RGBA16F);
+    }
+    return vkFormat;
+  }
+} // namespace imp
\ No newline at end of file
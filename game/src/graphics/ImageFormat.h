@@ -0,0 +1,33 @@
+#pragma once
+
+#include <functional>
+
+#include <vulkan/vulkan.hpp>
+
+namespace imp {
+  enum class ImageFormat { RGBA16F, B10G11R11, E5B9G9R9 };
+
+  struct ImageFormats {
+    ImageFormat transmittance;
+    ImageFormat skyView;
+    ImageFormat primary;
+  };
+
+  constexpr vk::Format getVkFormat(ImageFormat format) noexcept {
+    switch (format) {
+    case ImageFormat::B10G11R11:
+      return vk::Format::eB10G11R11UfloatPack32;
+    case ImageFormat::E5B9G9R9:
+      return vk::Format::eE5B9G9R9UfloatPack32;
+    default:
+      return vk::Format::eR16G16B16A16Sfloat;
+    }
+  }
+
+  vk::Format selectImageFormat(
+      ImageFormat format,
+      vk::FormatFeatureFlags features,
+      std::function<vk::FormatProperties(vk::Format)> const
+          &getFormatProperties,
+      bool storageImageWriteWithoutFormatSupported);
+} // namespace imp
\ No newline at end of file
@@ -0,0 +1,167 @@
+#include "LutCache.h"
+
+#include <array>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+#include <boost/container_hash/hash.hpp>
+
+namespace imp {
+  namespace {
+    constexpr auto LUT_CACHE_MAGIC = std::array{'I', 'L', 'U', 'T'};
+    constexpr auto LUT_CACHE_VERSION = std::uint32_t{1};
+
+    struct LutCacheHeader {
+      std::array<char, 4> magic;
+      std::uint32_t version;
+      std::uint32_t format;
+      std::uint32_t width;
+      std::uint32_t height;
+      std::uint32_t depth;
+      std::uint64_t size;
+      std::array<char, Planet::UNIFORM_SIZE> planet;
+    };
+
+    std::array<char, Planet::UNIFORM_SIZE>
+    storePlanet(Planet const &planet) noexcept {
+      auto canonical = planet;
+      canonical.setPosition({0.0f, 0.0f, 0.0f});
+      auto data = std::array<char, Planet::UNIFORM_SIZE>{};
+      canonical.store(data.data());
+      return data;
+    }
+
+    LutCacheHeader createHeader(
+        Planet const &planet,
+        vk::Format format,
+        Extent3u const &extent,
+        std::size_t size) noexcept {
+      auto header = LutCacheHeader{};
+      header.magic = LUT_CACHE_MAGIC;
+      header.version = LUT_CACHE_VERSION;
+      header.format = static_cast<std::uint32_t>(format);
+      header.width = extent.width;
+      header.height = extent.height;
+      header.depth = extent.depth;
+      header.size = size;
+      header.planet = storePlanet(planet);
+      return header;
+    }
+
+    bool operator==(
+        LutCacheHeader const &lhs, LutCacheHeader const &rhs) noexcept {
+      return lhs.magic == rhs.magic && lhs.version == rhs.version &&
+             lhs.format == rhs.format && lhs.width == rhs.width &&
+             lhs.height == rhs.height && lhs.depth == rhs.depth &&
+             lhs.size == rhs.size && lhs.planet == rhs.planet;
+    }
+  } // namespace
+
+  LutCache::LutCache(std::filesystem::path directory):
+      directory_{std::move(directory)}, hitCount_{}, missCount_{} {}
+
+  bool LutCache::load(
+      std::string_view name,
+      Planet const &planet,
+      vk::Format format,
+      Extent3u const &extent,
+      gsl::span<char> dst) {
+    auto in = std::ifstream{
+        getPath(name, planet, format, extent), std::ios::binary};
+    auto expected = createHeader(planet, format, extent, dst.size());
+    auto header = LutCacheHeader{};
+    if (!in.read(reinterpret_cast<char *>(&header), sizeof(header)) ||
+        !(header == expected) ||
+        !in.read(dst.data(), static_cast<std::streamsize>(dst.size()))) {
+      ++missCount_;
+      return false;
+    }
+    ++hitCount_;
+    return true;
+  }
+
+  void LutCache::store(
+      std::string_view name,
+      Planet const &planet,
+      vk::Format format,
+      Extent3u const &extent,
+      gsl::span<char const> src) {
+    auto error = std::error_code{};
+    std::filesystem::create_directories(directory_, error);
+    if (error) {
+      return;
+    }
+    auto path = getPath(name, planet, format, extent);
+    auto temporaryPath = path;
+    temporaryPath += ".tmp";
+    {
+      auto out = std::ofstream{temporaryPath, std::ios::binary};
+      auto header = createHeader(planet, format, extent, src.size());
+      out.write(reinterpret_cast<char const *>(&header), sizeof(header));
+      out.write(src.data(), static_cast<std::streamsize>(src.size()));
+      if (!out) {
+        out.close();
+        std::filesystem::remove(temporaryPath, error);
+        return;
+      }
+    }
+    std::filesystem::rename(temporaryPath, path, error);
+  }
+
+  void LutCache::clear() {
+    auto error = std::error_code{};
+    for (auto const &entry :
+         std::filesystem::directory_iterator{directory_, error}) {
+      if (entry.path().extension() == ".lut") {
+        std::filesystem::remove(entry.path(), error);
+      }
+    }
+  }
+
+  std::filesystem::path const &LutCache::getDirectory() const noexcept {
+    return directory_;
+  }
+
+  std::size_t LutCache::getHitCount() const noexcept {
+    return hitCount_;
+  }
+
+  std::size_t LutCache::getMissCount() const noexcept {
+    return missCount_;
+  }
+
+  std::size_t LutCache::getTexelSize(vk::Format format) {
+    switch (format) {
+    case vk::Format::eR8Unorm:
+      return 1;
+    case vk::Format::eR16G16Sfloat:
+    case vk::Format::eB10G11R11UfloatPack32:
+    case vk::Format::eE5B9G9R9UfloatPack32:
+    case vk::Format::eR8G8B8A8Unorm:
+      return 4;
+    case vk::Format::eR16G16B16A16Sfloat:
+      return 8;
+    case vk::Format::eR32G32B32A32Sfloat:
+      return 16;
+    default:
+      throw std::runtime_error{"unsupported lut format."};
+    }
+  }
+
+  std::filesystem::path LutCache::getPath(
+      std::string_view name,
+      Planet const &planet,
+      vk::Format format,
+      Extent3u const &extent) const {
+    auto planetData = storePlanet(planet);
+    auto seed = boost::hash_range(planetData.begin(), planetData.end());
+    boost::hash_combine(seed, static_cast<std::uint32_t>(format));
+    boost::hash_combine(seed, extent.width);
+    boost::hash_combine(seed, extent.height);
+    boost::hash_combine(seed, extent.depth);
+    auto oss = std::ostringstream{};
+    oss << name << "-" << std::hex << seed << ".lut";
+    return directory_ / oss.str();
+  }
+} // namespace imp
\ No newline at end of file
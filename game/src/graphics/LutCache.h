@@ -0,0 +1,48 @@
+#pragma once
+
+#include <filesystem>
+#include <string_view>
+
+#include <vulkan/vulkan.hpp>
+
+#include "../util/Extent.h"
+#include "../util/Gsl.h"
+#include "Planet.h"
+
+namespace imp {
+  class LutCache {
+  public:
+    explicit LutCache(std::filesystem::path directory);
+
+    bool load(
+        std::string_view name,
+        Planet const &planet,
+        vk::Format format,
+        Extent3u const &extent,
+        gsl::span<char> dst);
+    void store(
+        std::string_view name,
+        Planet const &planet,
+        vk::Format format,
+        Extent3u const &extent,
+        gsl::span<char const> src);
+    void clear();
+
+    std::filesystem::path const &getDirectory() const noexcept;
+    std::size_t getHitCount() const noexcept;
+    std::size_t getMissCount() const noexcept;
+
+    static std::size_t getTexelSize(vk::Format format);
+
+  private:
+    std::filesystem::path getPath(
+        std::string_view name,
+        Planet const &planet,
+        vk::Format format,
+        Extent3u const &extent) const;
+
+    std::filesystem::path directory_;
+    std::size_t hitCount_;
+    std::size_t missCount_;
+  };
+} // namespace imp
\ No newline at end of file
@@ -29,7 +29,8 @@ namespace imp {
       mieG_{mieG},
       ozoneAbsorption_{ozoneAbsorption},
       ozoneLayerHeight_{ozoneLayerHeight},
-      ozoneLayerThickness_{ozoneLayerThickness} {}
+      ozoneLayerThickness_{ozoneLayerThickness},
+      version_{} {}
 
   void Planet::store(char *dst) const noexcept {
     std::memcpy(dst + 0, position_.data(), 12);
@@ -47,6 +48,10 @@ namespace imp {
     std::memcpy(dst + 96, &ozoneLayerThickness_, 4);
   }
 
+  std::uint64_t Planet::getVersion() const noexcept {
+    return version_;
+  }
+
   Eigen::Vector3f const &Planet::getPosition() const noexcept {
     return position_;
   }
@@ -62,6 +67,7 @@ namespace imp {
   void Planet::setGroundRadius(float groundRadius) noexcept {
     Expects(groundRadius>= 0.0f);
     groundRadius_ = groundRadius;
+    ++version_;
   }
 
   float Planet::getAtmosphereRadius() const noexcept {
@@ -71,6 +77,7 @@ namespace imp {
   void Planet::setAtmosphereRadius(float atmosphereRadius) noexcept {
     Expects(atmosphereRadius >= 0.0f);
     atmosphereRadius_ = atmosphereRadius;
+    ++version_;
   }
 
   Spectrum const& Planet::getAlbedo() const noexcept {
@@ -79,6 +86,7 @@ namespace imp {
 
   void Planet::setAlbedo(Spectrum const& albedo) noexcept {
     albedo_ = albedo;
+    ++version_;
   }
 
   Spectrum const &Planet::getRayleighScattering() const noexcept {
@@ -90,6 +98,7 @@ namespace imp {
     Expects(scattering(1) >= 0.0f);
     Expects(scattering(2) >= 0.0f);
     rayleighScattering_ = scattering;
+    ++version_;
   }
 
   float Planet::getRayleighScaleHeight() const noexcept {
@@ -99,6 +108,7 @@ namespace imp {
   void Planet::setRayleighScaleHeight(float scaleHeight) noexcept {
     Expects(scaleHeight > 0.0f);
     rayleighScaleHeight_ = scaleHeight;
+    ++version_;
   }
 
   float Planet::getMieScattering() const noexcept {
@@ -108,6 +118,7 @@ namespace imp {
   void Planet::setMieScattering(float mieScattering) noexcept {
     Expects(mieScattering >= 0.0f);
     mieScattering_ = mieScattering;
+    ++version_;
   }
 
   float Planet::getMieAbsorption() const noexcept {
@@ -117,6 +128,7 @@ namespace imp {
   void Planet::setMieAbsorption(float mieAbsorption) noexcept {
     Expects(mieAbsorption >= 0.0f);
     mieAbsorption_ = mieAbsorption;
+    ++version_;
   }
 
   float Planet::getMieScaleHeight() const noexcept {
@@ -126,6 +138,7 @@ namespace imp {
   void Planet::setMieScaleHeight(float scaleHeight) noexcept {
     Expects(scaleHeight > 0.0f);
     mieScaleHeight_ = scaleHeight;
+    ++version_;
   }
 
   float Planet::getMieG() const noexcept {
@@ -135,6 +148,7 @@ namespace imp {
   void Planet::setMieG(float g) noexcept {
     Expects(std::abs(g) < 1.0f);
     mieG_ = g;
+    ++version_;
   }
 
   Spectrum const &Planet::getOzoneAbsorption() const noexcept {
@@ -146,6 +160,7 @@ namespace imp {
     Expects(absorption(1) >= 0.0f);
     Expects(absorption(2) >= 0.0f);
     ozoneAbsorption_ = absorption;
+    ++version_;
   }
 
   float Planet::getOzoneLayerHeight() const noexcept {
@@ -155,6 +170,7 @@ namespace imp {
   void Planet::setOzoneLayerHeight(float height) noexcept {
     Expects(height >= 0.0f);
     ozoneLayerHeight_ = height;
+    ++version_;
   }
 
   float Planet::getOzoneLayerThickness() const noexcept {
@@ -164,5 +180,6 @@ namespace imp {
   void Planet::setOzoneLayerThickness(float thickness) noexcept {
     Expects(thickness >= 0.0f);
     ozoneLayerThickness_ = thickness;
+    ++version_;
   }
 } // namespace imp
\ No newline at end of file
@@ -25,6 +25,8 @@ namespace imp {
 
     void store(char *dst) const noexcept;
 
+    std::uint64_t getVersion() const noexcept;
+
     Eigen::Vector3f const &getPosition() const noexcept;
     void setPosition(Eigen::Vector3f const &position) noexcept;
 
@@ -78,5 +80,6 @@ namespace imp {
     Spectrum ozoneAbsorption_;
     float ozoneLayerHeight_;
     float ozoneLayerThickness_;
+    std::uint64_t version_;
   };
 } // namespace imp
\ No newline at end of file
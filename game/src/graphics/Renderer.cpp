@@ -1,15 +1,26 @@
 #include "Renderer.h"
 
+#include <algorithm>
+#include <array>
 #include <fstream>
 #include <iostream>
 
-#include "../system/Display.h"
+#include "../system/CpuProfiler.h"
+#include "../system/GpuRenderGraph.h"
+#include "../system/RenderTarget.h"
 
 namespace imp {
-  Renderer::Renderer(gsl::not_null<Display *> window, std::size_t frameCount):
+  Renderer::Renderer(
+      gsl::not_null<RenderTarget *> window,
+      std::size_t frameCount,
+      ImageFormats const &formats):
       window_{window},
-      sceneFlyweight_{window->getContext(), frameCount},
-      sceneViewFlyweight_{window->getContext(), frameCount},
+      scheduler_{window->getContext(), frameCount},
+      profiler_{window->getContext(), frameCount},
+      sceneFlyweight_{
+          window->getContext(), gsl::not_null{&profiler_}, frameCount, formats},
+      sceneViewFlyweight_{
+          window->getContext(), gsl::not_null{&profiler_}, frameCount, formats},
       descriptorSetLayout_{createDescriptorSetLayout()},
       pipelineLayout_{createPipelineLayout()},
       pipeline_{createPipeline()},
@@ -26,7 +37,8 @@ namespace imp {
       indexBufferIndex_{0},
       textureIndex_{0},
       ditherSeed_{0},
-      frameIndex_{frameCount - 1} {
+      frameIndex_{scheduler_.getFrameIndex()},
+      recordingTimes_(1) {
     initDescriptorSets();
     initCommandPools();
     initCommandBuffers();
@@ -79,12 +91,12 @@ namespace imp {
             {}, vk::ShaderStageFlagBits::eFragment, *fragModule, "main"}};
     auto vertexBindingDescription = vk::VertexInputBindingDescription{};
     vertexBindingDescription.binding = 0;
-    vertexBindingDescription.stride = 16;
+    vertexBindingDescription.stride = VERTEX_SIZE;
     vertexBindingDescription.inputRate = vk::VertexInputRate::eVertex;
     auto vertexAttributionDescriptions = std::array{
         vk::VertexInputAttributeDescription{0, 0, vk::Format::eR32G32Sfloat, 0},
-        vk::VertexInputAttributeDescription{1, 0, vk::Format::eR32Uint, 8},
-        vk::VertexInputAttributeDescription{2, 0, vk::Format::eR32Uint, 12}};
+        vk::VertexInputAttributeDescription{1, 0, vk::Format::eR32G32Sfloat, 8},
+        vk::VertexInputAttributeDescription{2, 0, vk::Format::eR32Uint, 16}};
     auto vertexInputState = vk::PipelineVertexInputStateCreateInfo{};
     vertexInputState.vertexBindingDescriptionCount = 1;
     vertexInputState.pVertexBindingDescriptions = &vertexBindingDescription;
@@ -125,6 +137,13 @@ namespace imp {
     createInfo.pColorBlendState = &colorBlendState;
     createInfo.pDynamicState = &dynamicState;
     createInfo.layout = pipelineLayout_;
+    auto format = window_->getFormat();
+    auto renderingCreateInfo = vk::PipelineRenderingCreateInfoKHR{};
+    renderingCreateInfo.colorAttachmentCount = 1;
+    renderingCreateInfo.pColorAttachmentFormats = &format;
+    if (window_->getContext()->isDynamicRenderingEnabled()) {
+      createInfo.pNext = &renderingCreateInfo;
+    }
     createInfo.renderPass = window_->getRenderPass();
     createInfo.basePipelineIndex = -1;
     return window_->getContext()
@@ -261,18 +280,16 @@ namespace imp {
     for (auto &frame : frames_) {
       frame.swapchainSemaphore = device.createSemaphore({});
       frame.frameSemaphore = device.createSemaphore({});
-      frame.frameFence =
-          device.createFence({vk::FenceCreateFlagBits::eSignaled});
     }
   }
 
   Renderer::~Renderer() {
+    setRecordingThreadCount(0);
     auto device = window_->getContext()->getDevice();
     // TODO: remove
     device.waitIdle();
     device.destroy(descriptorPool_);
     for (auto &frame : frames_) {
-      device.destroy(frame.frameFence);
       device.destroy(frame.frameSemaphore);
       device.destroy(frame.swapchainSemaphore);
       device.destroy(frame.commandPool);
@@ -283,17 +300,20 @@ namespace imp {
   }
 
   void Renderer::begin() {
-    if (++frameIndex_ == frames_.size()) {
-      frameIndex_ = 0;
-    }
+    IMP_CPU_ZONE("Renderer::begin");
+    scheduler_.beginFrame();
+    frameIndex_ = scheduler_.getFrameIndex();
+    profiler_.beginFrame(frameIndex_);
     auto device = window_->getContext()->getDevice();
     auto &frame = frames_[frameIndex_];
-    device.waitForFences(
-        frame.frameFence, false, std::numeric_limits<std::uint64_t>::max());
-    device.resetFences(frame.frameFence);
     device.resetCommandPool(frame.commandPool);
     scenes_.clear();
     sceneViews_.clear();
+    commandBuffers_.clear();
+    std::fill(
+        recordingTimes_.begin(),
+        recordingTimes_.end(),
+        std::chrono::steady_clock::duration{});
     vertexBufferData_ = reinterpret_cast<Vertex *>(
         vertexBuffer_.getMappedData() + VERTEX_BUFFER_SIZE * frameIndex_);
     indexBufferData_ = reinterpret_cast<std::uint16_t *>(
@@ -304,6 +324,11 @@ namespace imp {
   }
 
   void Renderer::end() {
+    IMP_CPU_ZONE("Renderer::end");
+    if (recordingJobs_) {
+      IMP_CPU_ZONE("Renderer::waitRecording");
+      recordingJobs_->wait();
+    }
     vertexBuffer_.flush(
         VERTEX_BUFFER_SIZE * frameIndex_, sizeof(Vertex) * vertexBufferIndex_);
     indexBuffer_.flush(
@@ -313,112 +338,181 @@ namespace imp {
     auto &frame = frames_[frameIndex_];
     auto imageIndex = window_->acquireImage(frame.swapchainSemaphore, {});
     frame.commandBuffer.begin({vk::CommandBufferUsageFlagBits::eOneTimeSubmit});
-    {
-      /*auto barriers = std::vector<vk::ImageMemoryBarrier>();
-      if (context.getComputeFamily() != context.getGraphicsFamily()) {
-        barriers.reserve(sceneViews_.size() + 1);
-        for (auto &[sceneView, _] : sceneViews_) {
-          auto &barrier = barriers.emplace_back();
-          barrier.srcAccessMask = {};
-          barrier.dstAccessMask = vk::AccessFlagBits::eShaderRead;
-          barrier.oldLayout = vk::ImageLayout::eGeneral;
-          barrier.newLayout = vk::ImageLayout::eShaderReadOnlyOptimal;
-          barrier.srcQueueFamilyIndex = context.getComputeFamily();
-          barrier.dstQueueFamilyIndex = context.getGraphicsFamily();
-          barrier.image = sceneView->getRenderImage(frameIndex_).get();
-          barrier.subresourceRange.aspectMask = vk::ImageAspectFlagBits::eColor;
-          barrier.subresourceRange.baseMipLevel = 0;
-          barrier.subresourceRange.levelCount = 1;
-          barrier.subresourceRange.baseArrayLayer = 0;
-          barrier.subresourceRange.layerCount = 1;
-        }
-      }*/
-      auto barrier = vk::ImageMemoryBarrier{};
-      barrier.srcAccessMask = {};
-      barrier.dstAccessMask = vk::AccessFlagBits::eShaderRead;
-      barrier.oldLayout = vk::ImageLayout::eUndefined;
-      barrier.newLayout = vk::ImageLayout::eShaderReadOnlyOptimal;
-      barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-      barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-      barrier.image = defaultRenderImage_.get();
-      barrier.subresourceRange.aspectMask = vk::ImageAspectFlagBits::eColor;
-      barrier.subresourceRange.baseMipLevel = 0;
-      barrier.subresourceRange.levelCount = 1;
-      barrier.subresourceRange.baseArrayLayer = 0;
-      barrier.subresourceRange.layerCount = 1;
-      frame.commandBuffer.pipelineBarrier(
-          vk::PipelineStageFlagBits::eTopOfPipe,
-          vk::PipelineStageFlagBits::eFragmentShader,
-          {},
-          {},
-          {},
-          barrier);
+    auto graph = GpuRenderGraph{};
+    auto defaultImage =
+        graph.importImage("default", defaultRenderImage_.get(), 1, 1);
+    auto composite = graph.addPass("composite", [&]() {
+      auto scope =
+          profiler_.begin(frame.commandBuffer, "renderer", "composite");
+      auto clearValue = vk::ClearValue{};
+      auto extent = vk::Extent2D{
+          window_->getSwapchainWidth(), window_->getSwapchainHeight()};
+      if (context.isDynamicRenderingEnabled()) {
+        auto attachment = vk::RenderingAttachmentInfoKHR{};
+        attachment.imageView = window_->getImageView(imageIndex);
+        attachment.imageLayout = vk::ImageLayout::eColorAttachmentOptimal;
+        attachment.loadOp = vk::AttachmentLoadOp::eClear;
+        attachment.storeOp = vk::AttachmentStoreOp::eStore;
+        attachment.clearValue = clearValue;
+        auto renderingInfo = vk::RenderingInfoKHR{};
+        renderingInfo.renderArea.extent = extent;
+        renderingInfo.layerCount = 1;
+        renderingInfo.colorAttachmentCount = 1;
+        renderingInfo.pColorAttachments = &attachment;
+        context.beginRendering(frame.commandBuffer, renderingInfo);
+      } else {
+        auto renderPassBegin = vk::RenderPassBeginInfo{};
+        renderPassBegin.renderPass = window_->getRenderPass();
+        renderPassBegin.framebuffer = window_->getFramebuffer(imageIndex);
+        renderPassBegin.renderArea.extent = extent;
+        renderPassBegin.clearValueCount = 1;
+        renderPassBegin.pClearValues = &clearValue;
+        frame.commandBuffer.beginRenderPass(
+            renderPassBegin, vk::SubpassContents::eInline);
+      }
+      frame.commandBuffer.bindPipeline(
+          vk::PipelineBindPoint::eGraphics, pipeline_);
+      frame.commandBuffer.pushConstants(
+          pipelineLayout_,
+          vk::ShaderStageFlagBits::eFragment,
+          0,
+          4,
+          &ditherSeed_);
+      ++ditherSeed_;
+      auto viewport = vk::Viewport{};
+      viewport.width = window_->getSwapchainWidth();
+      viewport.height = window_->getSwapchainHeight();
+      viewport.minDepth = 0.0f;
+      viewport.maxDepth = 1.0f;
+      frame.commandBuffer.setViewport(0, viewport);
+      auto scissor = vk::Rect2D{};
+      scissor.extent.width = window_->getSwapchainWidth();
+      scissor.extent.height = window_->getSwapchainHeight();
+      frame.commandBuffer.setScissor(0, scissor);
+      frame.commandBuffer.bindDescriptorSets(
+          vk::PipelineBindPoint::eGraphics,
+          pipelineLayout_,
+          0,
+          frame.descriptorSet,
+          {});
+      frame.commandBuffer.bindVertexBuffers(
+          0, vertexBuffer_.get(), VERTEX_BUFFER_SIZE * frameIndex_);
+      frame.commandBuffer.bindIndexBuffer(
+          indexBuffer_.get(),
+          INDEX_BUFFER_SIZE * frameIndex_,
+          vk::IndexType::eUint16);
+      frame.commandBuffer.drawIndexed(indexBufferIndex_, 1, 0, 0, 0);
+      if (context.isDynamicRenderingEnabled()) {
+        context.endRendering(frame.commandBuffer);
+      } else {
+        frame.commandBuffer.endRenderPass();
+      }
+      profiler_.end(frame.commandBuffer, scope);
+    });
+    graph.read(
+        composite,
+        defaultImage,
+        {0, 1, 0, 1},
+        RenderGraph::Usage::FRAGMENT_SAMPLED);
+    if (context.isDynamicRenderingEnabled()) {
+      auto swapchainImage = graph.importImage(
+          "swapchain",
+          window_->getImage(imageIndex),
+          1,
+          1,
+          RenderGraph::Usage::PRESENT);
+      graph.write(
+          composite,
+          swapchainImage,
+          {0, 1, 0, 1},
+          RenderGraph::Usage::COLOR_ATTACHMENT);
+      graph.exportImage(swapchainImage, RenderGraph::Usage::PRESENT);
+      graph.setPresentLayout(window_->getFinalLayout());
     }
-    auto clearValue = vk::ClearValue{};
-    auto renderPassBegin = vk::RenderPassBeginInfo{};
-    renderPassBegin.renderPass = window_->getRenderPass();
-    renderPassBegin.framebuffer = window_->getFramebuffer(imageIndex);
-    renderPassBegin.renderArea.extent.width = window_->getSwapchainWidth();
-    renderPassBegin.renderArea.extent.height = window_->getSwapchainHeight();
-    renderPassBegin.clearValueCount = 1;
-    renderPassBegin.pClearValues = &clearValue;
-    frame.commandBuffer.beginRenderPass(
-        renderPassBegin, vk::SubpassContents::eInline);
-    frame.commandBuffer.bindPipeline(
-        vk::PipelineBindPoint::eGraphics, pipeline_);
-    frame.commandBuffer.pushConstants(
-        pipelineLayout_,
-        vk::ShaderStageFlagBits::eFragment,
-        0,
-        4,
-        &ditherSeed_);
-    ++ditherSeed_;
-    auto viewport = vk::Viewport{};
-    viewport.width = window_->getSwapchainWidth();
-    viewport.height = window_->getSwapchainHeight();
-    viewport.minDepth = 0.0f;
-    viewport.maxDepth = 1.0f;
-    frame.commandBuffer.setViewport(0, viewport);
-    auto scissor = vk::Rect2D{};
-    scissor.extent.width = window_->getSwapchainWidth();
-    scissor.extent.height = window_->getSwapchainHeight();
-    frame.commandBuffer.setScissor(0, scissor);
-    frame.commandBuffer.bindDescriptorSets(
-        vk::PipelineBindPoint::eGraphics,
-        pipelineLayout_,
-        0,
-        frame.descriptorSet,
-        {});
-    frame.commandBuffer.bindVertexBuffers(
-        0, vertexBuffer_.get(), VERTEX_BUFFER_SIZE * frameIndex_);
-    frame.commandBuffer.bindIndexBuffer(
-        indexBuffer_.get(),
-        INDEX_BUFFER_SIZE * frameIndex_,
-        vk::IndexType::eUint16);
-    frame.commandBuffer.drawIndexed(indexBufferIndex_, 1, 0, 0, 0);
-    frame.commandBuffer.endRenderPass();
+    graph.markOutput(composite);
+    graph.execute(frame.commandBuffer);
     frame.commandBuffer.end();
-    auto waitSemaphores = std::vector<vk::Semaphore>();
-    auto waitStages = std::vector<vk::PipelineStageFlags>();
-    waitSemaphores.reserve(sceneViews_.size() + 1);
-    waitStages.reserve(sceneViews_.size() + 1);
-    //for (auto &[sceneView, _] : sceneViews_) {
-    //  waitSemaphores.emplace_back(sceneView->getSemaphore(frameIndex_));
-    //  waitStages.emplace_back(vk::PipelineStageFlagBits::eFragmentShader);
-    //}
-    waitSemaphores.emplace_back(frame.swapchainSemaphore);
-    waitStages.emplace_back(vk::PipelineStageFlagBits::eColorAttachmentOutput);
-    auto submitInfo = vk::SubmitInfo{};
-    submitInfo.commandBufferCount = 1;
-    submitInfo.pCommandBuffers = &frame.commandBuffer;
-    submitInfo.waitSemaphoreCount =
-        static_cast<std::uint32_t>(waitSemaphores.size());
-    submitInfo.pWaitSemaphores = waitSemaphores.data();
-    submitInfo.pWaitDstStageMask = waitStages.data();
-    submitInfo.signalSemaphoreCount = 1;
-    submitInfo.pSignalSemaphores = &frame.frameSemaphore;
-    window_->getContext()->getGraphicsQueue().submit(
-        submitInfo, frame.frameFence);
+    auto frameNumber = scheduler_.getFrameNumber();
+    auto computeCommandBuffers = std::vector<vk::CommandBuffer>{};
+    for (auto &scene : scenes_) {
+      if (auto commandBuffer = scene->endAsyncCompute(frameIndex_)) {
+        computeCommandBuffers.emplace_back(*commandBuffer);
+      }
+    }
+    auto computeSemaphore = scheduler_.getComputeSemaphore();
+    auto computeValue = GpuFrameScheduler::getComputeValue(frameNumber);
+    auto graphicsSemaphore = scheduler_.getGraphicsSemaphore();
+    if (!computeCommandBuffers.empty()) {
+      auto waitValue = GpuFrameScheduler::getSceneValue(frameNumber - 1);
+      auto waitStage = vk::PipelineStageFlags{
+          vk::PipelineStageFlagBits::eComputeShader |
+          vk::PipelineStageFlagBits::eTransfer};
+      auto timelineInfo = vk::TimelineSemaphoreSubmitInfo{};
+      timelineInfo.signalSemaphoreValueCount = 1;
+      timelineInfo.pSignalSemaphoreValues = &computeValue;
+      auto submitInfo = vk::SubmitInfo{};
+      submitInfo.pNext = &timelineInfo;
+      if (frameNumber > 1) {
+        timelineInfo.waitSemaphoreValueCount = 1;
+        timelineInfo.pWaitSemaphoreValues = &waitValue;
+        submitInfo.waitSemaphoreCount = 1;
+        submitInfo.pWaitSemaphores = &graphicsSemaphore;
+        submitInfo.pWaitDstStageMask = &waitStage;
+      }
+      submitInfo.commandBufferCount =
+          static_cast<std::uint32_t>(computeCommandBuffers.size());
+      submitInfo.pCommandBuffers = computeCommandBuffers.data();
+      submitInfo.signalSemaphoreCount = 1;
+      submitInfo.pSignalSemaphores = &computeSemaphore;
+      IMP_CPU_ZONE("Renderer::submitCompute");
+      context.getComputeQueue().submit(submitInfo);
+    }
+    auto sceneStage = vk::PipelineStageFlags{
+        vk::PipelineStageFlagBits::eFragmentShader |
+        vk::PipelineStageFlagBits::eComputeShader};
+    auto sceneValue = GpuFrameScheduler::getSceneValue(frameNumber);
+    auto swapchainStage = vk::PipelineStageFlags{
+        vk::PipelineStageFlagBits::eColorAttachmentOutput};
+    auto swapchainValue = std::uint64_t{};
+    auto signalSemaphores =
+        std::array{frame.frameSemaphore, graphicsSemaphore};
+    auto signalValues = std::array{
+        std::uint64_t{}, GpuFrameScheduler::getFrameValue(frameNumber)};
+    auto timelineInfos = std::array<vk::TimelineSemaphoreSubmitInfo, 2>{};
+    auto submitInfos = std::array<vk::SubmitInfo, 2>{};
+    if (!computeCommandBuffers.empty()) {
+      timelineInfos[0].waitSemaphoreValueCount = 1;
+      timelineInfos[0].pWaitSemaphoreValues = &computeValue;
+      submitInfos[0].waitSemaphoreCount = 1;
+      submitInfos[0].pWaitSemaphores = &computeSemaphore;
+      submitInfos[0].pWaitDstStageMask = &sceneStage;
+    }
+    timelineInfos[0].signalSemaphoreValueCount = 1;
+    timelineInfos[0].pSignalSemaphoreValues = &sceneValue;
+    submitInfos[0].pNext = &timelineInfos[0];
+    submitInfos[0].commandBufferCount =
+        static_cast<std::uint32_t>(commandBuffers_.size());
+    submitInfos[0].pCommandBuffers = commandBuffers_.data();
+    submitInfos[0].signalSemaphoreCount = 1;
+    submitInfos[0].pSignalSemaphores = &graphicsSemaphore;
+    timelineInfos[1].waitSemaphoreValueCount = 1;
+    timelineInfos[1].pWaitSemaphoreValues = &swapchainValue;
+    timelineInfos[1].signalSemaphoreValueCount =
+        static_cast<std::uint32_t>(signalValues.size());
+    timelineInfos[1].pSignalSemaphoreValues = signalValues.data();
+    submitInfos[1].pNext = &timelineInfos[1];
+    submitInfos[1].waitSemaphoreCount = 1;
+    submitInfos[1].pWaitSemaphores = &frame.swapchainSemaphore;
+    submitInfos[1].pWaitDstStageMask = &swapchainStage;
+    submitInfos[1].commandBufferCount = 1;
+    submitInfos[1].pCommandBuffers = &frame.commandBuffer;
+    submitInfos[1].signalSemaphoreCount =
+        static_cast<std::uint32_t>(signalSemaphores.size());
+    submitInfos[1].pSignalSemaphores = signalSemaphores.data();
+    {
+      IMP_CPU_ZONE("Renderer::submitGraphics");
+      context.getGraphicsQueue().submit(submitInfos);
+    }
     window_->present({&frame.frameSemaphore, 1}, imageIndex);
   }
 
@@ -428,6 +522,7 @@ namespace imp {
       int y,
       int w,
       int h) {
+    IMP_CPU_ZONE("Renderer::draw");
     if (sizeof(Vertex) * (vertexBufferIndex_ + 4) > VERTEX_BUFFER_SIZE) {
       throw std::runtime_error{"max vertices reached"};
     }
@@ -438,12 +533,26 @@ namespace imp {
       throw std::runtime_error{"max textures reached"};
     }
     if (scenes_.emplace(sceneView->getScene()).second) {
-      sceneView->getScene()->render(frameIndex_);
+      if (auto commandBuffer = sceneView->getScene()->render(frameIndex_)) {
+        commandBuffers_.emplace_back(*commandBuffer);
+      }
     }
     auto textureIndex = std::uint32_t{};
     if (sceneViews_.emplace(sceneView, textureIndex_).second) {
       textureIndex = textureIndex_++;
-      sceneView->render(frameIndex_);
+      commandBuffers_.emplace_back(sceneView->beginRender(frameIndex_));
+      if (!recordingJobs_) {
+        sceneView->endRender(frameIndex_);
+      } else {
+        recordingJobs_->emplace([this, sceneView, frameIndex = frameIndex_]() {
+          auto startTime = std::chrono::steady_clock::now();
+          sceneView->endRender(frameIndex);
+          auto thread = recordingJobs_->getCurrentWorker().value_or(
+              recordingJobs_->getWorkerCount());
+          recordingTimes_[thread] +=
+              std::chrono::steady_clock::now() - startTime;
+        });
+      }
     } else {
       textureIndex = sceneViews_.at(sceneView);
     }
@@ -451,17 +560,21 @@ namespace imp {
     auto right = 2.0f / window_->getSwapchainWidth() * (x + w) - 1.0f;
     auto top = 2.0f / window_->getSwapchainHeight() * y - 1.0f;
     auto bottom = 2.0f / window_->getSwapchainHeight() * (y + h) - 1.0f;
+    auto &imageExtent = sceneView->getRenderImage(frameIndex_).getExtent();
+    auto &renderExtent = sceneView->getRenderExtent(frameIndex_);
+    auto u = float(renderExtent.width) / float(imageExtent.width);
+    auto v = float(renderExtent.height) / float(imageExtent.height);
     vertexBufferData_[vertexBufferIndex_ + 0].position = {right, top};
-    vertexBufferData_[vertexBufferIndex_ + 0].vertexIndex = 0;
+    vertexBufferData_[vertexBufferIndex_ + 0].textureCoord = {u, v};
     vertexBufferData_[vertexBufferIndex_ + 0].textureIndex = textureIndex;
     vertexBufferData_[vertexBufferIndex_ + 1].position = {left, top};
-    vertexBufferData_[vertexBufferIndex_ + 1].vertexIndex = 1;
+    vertexBufferData_[vertexBufferIndex_ + 1].textureCoord = {0.0f, v};
     vertexBufferData_[vertexBufferIndex_ + 1].textureIndex = textureIndex;
     vertexBufferData_[vertexBufferIndex_ + 2].position = {left, bottom};
-    vertexBufferData_[vertexBufferIndex_ + 2].vertexIndex = 2;
+    vertexBufferData_[vertexBufferIndex_ + 2].textureCoord = {0.0f, 0.0f};
     vertexBufferData_[vertexBufferIndex_ + 2].textureIndex = textureIndex;
     vertexBufferData_[vertexBufferIndex_ + 3].position = {right, bottom};
-    vertexBufferData_[vertexBufferIndex_ + 3].vertexIndex = 3;
+    vertexBufferData_[vertexBufferIndex_ + 3].textureCoord = {u, 0.0f};
     vertexBufferData_[vertexBufferIndex_ + 3].textureIndex = textureIndex;
     indexBufferData_[indexBufferIndex_ + 0] = vertexBufferIndex_ + 0;
     indexBufferData_[indexBufferIndex_ + 1] = vertexBufferIndex_ + 1;
@@ -485,6 +598,43 @@ namespace imp {
     indexBufferIndex_ += 6;
   }
 
+  std::size_t Renderer::getRecordingThreadCount() const noexcept {
+    return recordingJobs_ ? recordingJobs_->getWorkerCount() : 0;
+  }
+
+  void Renderer::setRecordingThreadCount(std::size_t count) {
+    recordingJobs_.reset();
+    if (count != 0) {
+      recordingJobs_ = std::make_unique<JobSystem>(count);
+    }
+    recordingTimes_.assign(count + 1, {});
+  }
+
+  std::chrono::steady_clock::duration
+  Renderer::getRecordingTime(std::size_t thread) const noexcept {
+    return recordingTimes_[thread];
+  }
+
+  GpuFrameScheduler const &Renderer::getFrameScheduler() const noexcept {
+    return scheduler_;
+  }
+
+  GpuProfiler const &Renderer::getProfiler() const noexcept {
+    return profiler_;
+  }
+
+  GpuProfiler &Renderer::getProfiler() noexcept {
+    return profiler_;
+  }
+
+  bool Renderer::isProfilingEnabled() const noexcept {
+    return profiler_.isEnabled();
+  }
+
+  void Renderer::setProfilingEnabled(bool profilingEnabled) noexcept {
+    profiler_.setEnabled(profilingEnabled);
+  }
+
   gsl::not_null<Scene::Flyweight const *>
   Renderer::getSceneFlyweight() const noexcept {
     return gsl::not_null{&sceneFlyweight_};
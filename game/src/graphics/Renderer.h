@@ -1,17 +1,23 @@
 #pragma once
 
+#include <chrono>
+#include <memory>
 #include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
+#include "../system/GpuFrameScheduler.h"
+#include "../system/GpuProfiler.h"
+#include "../system/JobSystem.h"
 #include "Scene.h"
 #include "SceneView.h"
 
 namespace imp {
-  class Display;
+  class RenderTarget;
 
   class Renderer {
   public:
-    static constexpr auto VERTEX_SIZE = vk::DeviceSize{16};
+    static constexpr auto VERTEX_SIZE = vk::DeviceSize{20};
     static constexpr auto VERTEX_BUFFER_SIZE = 65536 * VERTEX_SIZE;
     static constexpr auto INDEX_SIZE = vk::DeviceSize{2};
     static constexpr auto INDEX_BUFFER_SIZE = 98304 * INDEX_SIZE;
@@ -23,21 +29,23 @@ namespace imp {
       vk::CommandBuffer commandBuffer;
       vk::Semaphore swapchainSemaphore;
       vk::Semaphore frameSemaphore;
-      vk::Fence frameFence;
     };
 
     struct Vertex {
       Eigen::Vector2f position;
-      std::uint32_t vertexIndex;
+      Eigen::Vector2f textureCoord;
       std::uint32_t textureIndex;
     };
 
-    static_assert(sizeof(Vertex) == 16);
+    static_assert(sizeof(Vertex) == VERTEX_SIZE);
     static_assert(offsetof(Vertex, position) == 0);
-    static_assert(offsetof(Vertex, vertexIndex) == 8);
-    static_assert(offsetof(Vertex, textureIndex) == 12);
+    static_assert(offsetof(Vertex, textureCoord) == 8);
+    static_assert(offsetof(Vertex, textureIndex) == 16);
 
-    explicit Renderer(gsl::not_null<Display *> window, std::size_t frameCount);
+    explicit Renderer(
+        gsl::not_null<RenderTarget *> window,
+        std::size_t frameCount,
+        ImageFormats const &formats);
 
   private:
     // vk::RenderPass createRenderPass() const;
@@ -83,13 +91,24 @@ namespace imp {
         int w,
         int h);
 
+    std::size_t getRecordingThreadCount() const noexcept;
+    void setRecordingThreadCount(std::size_t count);
+    std::chrono::steady_clock::duration
+    getRecordingTime(std::size_t thread) const noexcept;
+    GpuFrameScheduler const &getFrameScheduler() const noexcept;
+    GpuProfiler const &getProfiler() const noexcept;
+    GpuProfiler &getProfiler() noexcept;
+    bool isProfilingEnabled() const noexcept;
+    void setProfilingEnabled(bool profilingEnabled) noexcept;
     gsl::not_null<Scene::Flyweight const *> getSceneFlyweight() const noexcept;
     gsl::not_null<SceneView::Flyweight const *>
     getSceneViewFlyweight() const noexcept;
 
   private:
 
-    gsl::not_null<Display *> window_;
+    gsl::not_null<RenderTarget *> window_;
+    GpuFrameScheduler scheduler_;
+    GpuProfiler profiler_;
     Scene::Flyweight sceneFlyweight_;
     SceneView::Flyweight sceneViewFlyweight_;
     vk::DescriptorSetLayout descriptorSetLayout_;
@@ -113,5 +132,8 @@ namespace imp {
     std::unordered_set<gsl::not_null<std::shared_ptr<Scene>>> scenes_;
     std::unordered_map<gsl::not_null<std::shared_ptr<SceneView>>, std::uint32_t>
         sceneViews_;
+    std::vector<vk::CommandBuffer> commandBuffers_;
+    std::unique_ptr<JobSystem> recordingJobs_;
+    std::vector<std::chrono::steady_clock::duration> recordingTimes_;
   };
 } // namespace imp
\ No newline at end of file
@@ -1,25 +1,64 @@
 #include "Scene.h"
 
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
 #include <fstream>
+#include <limits>
+#include <string>
 
+#include "../system/CpuProfiler.h"
 #include "../system/GpuContext.h"
+#include "../system/GpuProfiler.h"
 #include "../util/Math.h"
 
 namespace imp {
+  namespace {
+    constexpr auto LUT_FORMAT_FEATURES =
+        vk::FormatFeatureFlagBits::eSampledImage |
+        vk::FormatFeatureFlagBits::eSampledImageFilterLinear |
+        vk::FormatFeatureFlagBits::eColorAttachment |
+        vk::FormatFeatureFlagBits::eStorageImage;
+  } // namespace
+
   Scene::Flyweight::Flyweight(
-      gsl::not_null<GpuContext *> context, std::size_t frameCount):
+      gsl::not_null<GpuContext *> context,
+      gsl::not_null<GpuProfiler *> profiler,
+      std::size_t frameCount,
+      ImageFormats const &formats):
       context_{context},
+      profiler_{profiler},
       frameCount_{frameCount},
+      transmittanceFormat_{selectImageFormat(
+          formats.transmittance,
+          LUT_FORMAT_FEATURES,
+          [context](auto format) {
+            return context->getPhysicalDevice().getFormatProperties(format);
+          },
+          context->isStorageImageWriteWithoutFormatSupported())},
+      skyViewFormat_{selectImageFormat(
+          formats.skyView,
+          LUT_FORMAT_FEATURES,
+          [context](auto format) {
+            return context->getPhysicalDevice().getFormatProperties(format);
+          },
+          context->isStorageImageWriteWithoutFormatSupported())},
       transmittanceRenderPass_{createTransmittanceRenderPass()},
       transmittanceDescriptorSetLayout_{
           createTransmittanceDescriptorSetLayout()},
       transmittancePipelineLayout_{createTransmittancePipelineLayout()},
-      transmittancePipeline_{createTransmittancePipeline()},
-      transmittanceSampler_{createTransmittanceSampler()} {}
+      transmittanceSampler_{createTransmittanceSampler()},
+      skyViewRenderPass_{createSkyViewRenderPass()},
+      skyViewDescriptorSetLayout_{createSkyViewDescriptorSetLayout()},
+      skyViewPipelineLayout_{createSkyViewPipelineLayout()},
+      skyViewSampler_{createSkyViewSampler()} {}
 
   vk::RenderPass Scene::Flyweight::createTransmittanceRenderPass() const {
+    if (context_->isDynamicRenderingEnabled()) {
+      return {};
+    }
     auto attachmentDesc = GpuAttachmentDescription{};
-    attachmentDesc.format = vk::Format::eR16G16B16A16Sfloat;
+    attachmentDesc.format = transmittanceFormat_;
     attachmentDesc.samples = vk::SampleCountFlagBits::e1;
     attachmentDesc.loadOp = vk::AttachmentLoadOp::eDontCare;
     attachmentDesc.storeOp = vk::AttachmentStoreOp::eStore;
@@ -33,28 +72,41 @@ namespace imp {
     auto subpass = GpuSubpassDescription{};
     subpass.pipelineBindPoint = vk::PipelineBindPoint::eGraphics;
     subpass.colorAttachments = {&attachmentRef, 1};
-    auto dependency = GpuSubpassDependency{};
-    dependency.srcSubpass = 0;
-    dependency.dstSubpass = VK_SUBPASS_EXTERNAL;
-    dependency.srcStageMask = vk::PipelineStageFlagBits::eColorAttachmentOutput;
-    dependency.dstStageMask = vk::PipelineStageFlagBits::eFragmentShader;
-    dependency.srcAccessMask = vk::AccessFlagBits::eColorAttachmentWrite;
-    dependency.dstAccessMask = vk::AccessFlagBits::eShaderRead;
+    auto dependencies = std::array<GpuSubpassDependency, 2>{};
+    dependencies[0].srcSubpass = VK_SUBPASS_EXTERNAL;
+    dependencies[0].dstSubpass = 0;
+    dependencies[0].srcStageMask = vk::PipelineStageFlagBits::eFragmentShader |
+                                   vk::PipelineStageFlagBits::eComputeShader;
+    dependencies[0].dstStageMask =
+        vk::PipelineStageFlagBits::eColorAttachmentOutput;
+    dependencies[0].dstAccessMask = vk::AccessFlagBits::eColorAttachmentWrite;
+    dependencies[1].srcSubpass = 0;
+    dependencies[1].dstSubpass = VK_SUBPASS_EXTERNAL;
+    dependencies[1].srcStageMask =
+        vk::PipelineStageFlagBits::eColorAttachmentOutput;
+    dependencies[1].dstStageMask = vk::PipelineStageFlagBits::eFragmentShader |
+                                   vk::PipelineStageFlagBits::eComputeShader;
+    dependencies[1].srcAccessMask = vk::AccessFlagBits::eColorAttachmentWrite;
+    dependencies[1].dstAccessMask = vk::AccessFlagBits::eShaderRead;
     auto createInfo = GpuRenderPassCreateInfo{};
     createInfo.attachments = {&attachmentDesc, 1};
     createInfo.subpasses = {&subpass, 1};
-    createInfo.dependencies = {&dependency, 1};
+    createInfo.dependencies = dependencies;
     return context_->createRenderPass(createInfo);
   }
 
   vk::DescriptorSetLayout
   Scene::Flyweight::createTransmittanceDescriptorSetLayout() const {
-    auto binding = GpuDescriptorSetLayoutBinding{};
-    binding.descriptorType = vk::DescriptorType::eUniformBuffer;
-    binding.descriptorCount = 1;
-    binding.stageFlags = vk::ShaderStageFlagBits::eFragment;
+    auto bindings = std::array<GpuDescriptorSetLayoutBinding, 2>{};
+    bindings[0].descriptorType = vk::DescriptorType::eUniformBuffer;
+    bindings[0].descriptorCount = 1;
+    bindings[0].stageFlags =
+        vk::ShaderStageFlagBits::eFragment | vk::ShaderStageFlagBits::eCompute;
+    bindings[1].descriptorType = vk::DescriptorType::eStorageImage;
+    bindings[1].descriptorCount = 1;
+    bindings[1].stageFlags = vk::ShaderStageFlagBits::eCompute;
     auto createInfo = GpuDescriptorSetLayoutCreateInfo{};
-    createInfo.bindings = {&binding, 1};
+    createInfo.bindings = bindings;
     return context_->createDescriptorSetLayout(createInfo);
   }
 
@@ -65,7 +117,8 @@ namespace imp {
     return context_->createPipelineLayout(createInfo);
   }
 
-  vk::Pipeline Scene::Flyweight::createTransmittancePipeline() const {
+  vk::Pipeline Scene::Flyweight::createTransmittancePipeline(
+      std::uint32_t steps, AtmosphereSampling sampling) const {
     auto vertModule = vk::UniqueShaderModule{};
     {
       auto code = std::vector<char>{};
@@ -96,6 +149,20 @@ namespace imp {
       createInfo.pCode = reinterpret_cast<std::uint32_t *>(code.data());
       fragModule = context_->getDevice().createShaderModuleUnique(createInfo);
     }
+    auto specializationData =
+        std::array{steps, static_cast<std::uint32_t>(sampling)};
+    auto mapEntries = std::array<vk::SpecializationMapEntry, 2>{};
+    for (auto i = std::uint32_t{}; i < mapEntries.size(); ++i) {
+      mapEntries[i].constantID = i + 2;
+      mapEntries[i].offset = i * sizeof(std::uint32_t);
+      mapEntries[i].size = sizeof(std::uint32_t);
+    }
+    auto specializationInfo = vk::SpecializationInfo{};
+    specializationInfo.mapEntryCount =
+        static_cast<std::uint32_t>(mapEntries.size());
+    specializationInfo.pMapEntries = mapEntries.data();
+    specializationInfo.dataSize = sizeof(specializationData);
+    specializationInfo.pData = specializationData.data();
     auto stages = std::array<vk::PipelineShaderStageCreateInfo, 2>{};
     stages[0].stage = vk::ShaderStageFlagBits::eVertex;
     stages[0].module = *vertModule;
@@ -103,6 +170,7 @@ namespace imp {
     stages[1].stage = vk::ShaderStageFlagBits::eFragment;
     stages[1].module = *fragModule;
     stages[1].pName = "main";
+    stages[1].pSpecializationInfo = &specializationInfo;
     auto vertexInputState = vk::PipelineVertexInputStateCreateInfo{};
     auto inputAssemblyState = vk::PipelineInputAssemblyStateCreateInfo{};
     inputAssemblyState.topology = vk::PrimitiveTopology::eTriangleList;
@@ -137,12 +205,67 @@ namespace imp {
     createInfo.pColorBlendState = &colorBlendState;
     createInfo.pDynamicState = &dynamicState;
     createInfo.layout = transmittancePipelineLayout_;
+    auto renderingCreateInfo = vk::PipelineRenderingCreateInfoKHR{};
+    renderingCreateInfo.colorAttachmentCount = 1;
+    renderingCreateInfo.pColorAttachmentFormats = &transmittanceFormat_;
+    if (context_->isDynamicRenderingEnabled()) {
+      createInfo.pNext = &renderingCreateInfo;
+    }
     createInfo.renderPass = transmittanceRenderPass_;
     createInfo.subpass = 0;
     createInfo.basePipelineIndex = -1;
     return context_->getDevice().createGraphicsPipeline({}, createInfo).value;
   }
 
+  vk::Pipeline Scene::Flyweight::createTransmittanceComputePipeline(
+      std::uint32_t steps, AtmosphereSampling sampling) const {
+    auto compModule = vk::UniqueShaderModule{};
+    {
+      auto code = std::vector<char>{};
+      auto in = std::ifstream{};
+      in.exceptions(std::ios::badbit | std::ios::failbit);
+      in.open(
+          transmittanceFormat_ == getVkFormat(ImageFormat::RGBA16F)
+              ? "./data/TransmittanceComp.spv"
+              : "./data/TransmittanceFormatlessComp.spv",
+          std::ios::binary);
+      in.seekg(0, std::ios::end);
+      code.resize(in.tellg());
+      in.seekg(0, std::ios::beg);
+      in.read(code.data(), code.size());
+      auto createInfo = vk::ShaderModuleCreateInfo{};
+      createInfo.codeSize = code.size();
+      createInfo.pCode = reinterpret_cast<std::uint32_t *>(code.data());
+      compModule = context_->getDevice().createShaderModuleUnique(createInfo);
+    }
+    auto workgroupSize = getWorkgroupSize();
+    auto specializationData = std::array{
+        workgroupSize.width,
+        workgroupSize.height,
+        steps,
+        static_cast<std::uint32_t>(sampling)};
+    auto mapEntries = std::array<vk::SpecializationMapEntry, 4>{};
+    for (auto i = std::uint32_t{}; i < mapEntries.size(); ++i) {
+      mapEntries[i].constantID = i;
+      mapEntries[i].offset = i * sizeof(std::uint32_t);
+      mapEntries[i].size = sizeof(std::uint32_t);
+    }
+    auto specializationInfo = vk::SpecializationInfo{};
+    specializationInfo.mapEntryCount =
+        static_cast<std::uint32_t>(mapEntries.size());
+    specializationInfo.pMapEntries = mapEntries.data();
+    specializationInfo.dataSize = sizeof(specializationData);
+    specializationInfo.pData = specializationData.data();
+    auto createInfo = vk::ComputePipelineCreateInfo{};
+    createInfo.stage.stage = vk::ShaderStageFlagBits::eCompute;
+    createInfo.stage.module = *compModule;
+    createInfo.stage.pName = "main";
+    createInfo.stage.pSpecializationInfo = &specializationInfo;
+    createInfo.layout = transmittancePipelineLayout_;
+    createInfo.basePipelineIndex = -1;
+    return context_->getDevice().createComputePipeline({}, createInfo).value;
+  }
+
   vk::Sampler Scene::Flyweight::createTransmittanceSampler() const {
     auto createInfo = GpuSamplerCreateInfo{};
     createInfo.magFilter = vk::Filter::eLinear;
@@ -154,18 +277,280 @@ namespace imp {
     return context_->createSampler(createInfo);
   }
 
+  vk::RenderPass Scene::Flyweight::createSkyViewRenderPass() const {
+    if (context_->isDynamicRenderingEnabled()) {
+      return {};
+    }
+    auto attachmentDesc = GpuAttachmentDescription{};
+    attachmentDesc.format = skyViewFormat_;
+    attachmentDesc.samples = vk::SampleCountFlagBits::e1;
+    attachmentDesc.loadOp = vk::AttachmentLoadOp::eLoad;
+    attachmentDesc.storeOp = vk::AttachmentStoreOp::eStore;
+    attachmentDesc.stencilLoadOp = vk::AttachmentLoadOp::eDontCare;
+    attachmentDesc.stencilStoreOp = vk::AttachmentStoreOp::eDontCare;
+    attachmentDesc.initialLayout = vk::ImageLayout::eShaderReadOnlyOptimal;
+    attachmentDesc.finalLayout = vk::ImageLayout::eShaderReadOnlyOptimal;
+    auto attachmentRef = GpuAttachmentReference{};
+    attachmentRef.attachment = 0;
+    attachmentRef.layout = vk::ImageLayout::eColorAttachmentOptimal;
+    auto subpass = GpuSubpassDescription{};
+    subpass.pipelineBindPoint = vk::PipelineBindPoint::eGraphics;
+    subpass.colorAttachments = {&attachmentRef, 1};
+    auto dependencies = std::array<GpuSubpassDependency, 2>{};
+    dependencies[0].srcSubpass = VK_SUBPASS_EXTERNAL;
+    dependencies[0].dstSubpass = 0;
+    dependencies[0].srcStageMask = vk::PipelineStageFlagBits::eFragmentShader |
+                                   vk::PipelineStageFlagBits::eComputeShader;
+    dependencies[0].dstStageMask =
+        vk::PipelineStageFlagBits::eColorAttachmentOutput;
+    dependencies[0].srcAccessMask = vk::AccessFlagBits::eShaderRead;
+    dependencies[0].dstAccessMask = vk::AccessFlagBits::eColorAttachmentWrite;
+    dependencies[1].srcSubpass = 0;
+    dependencies[1].dstSubpass = VK_SUBPASS_EXTERNAL;
+    dependencies[1].srcStageMask =
+        vk::PipelineStageFlagBits::eColorAttachmentOutput;
+    dependencies[1].dstStageMask = vk::PipelineStageFlagBits::eFragmentShader;
+    dependencies[1].srcAccessMask = vk::AccessFlagBits::eColorAttachmentWrite;
+    dependencies[1].dstAccessMask = vk::AccessFlagBits::eShaderRead;
+    auto createInfo = GpuRenderPassCreateInfo{};
+    createInfo.attachments = {&attachmentDesc, 1};
+    createInfo.subpasses = {&subpass, 1};
+    createInfo.dependencies = dependencies;
+    return context_->createRenderPass(createInfo);
+  }
+
+  vk::DescriptorSetLayout
+  Scene::Flyweight::createSkyViewDescriptorSetLayout() const {
+    auto bindings = std::array<GpuDescriptorSetLayoutBinding, 3>{};
+    bindings[0].descriptorType = vk::DescriptorType::eUniformBuffer;
+    bindings[1].descriptorType = vk::DescriptorType::eCombinedImageSampler;
+    bindings[2].descriptorType = vk::DescriptorType::eStorageImage;
+    for (auto &binding : bindings) {
+      binding.descriptorCount = 1;
+      binding.stageFlags = vk::ShaderStageFlagBits::eFragment |
+                           vk::ShaderStageFlagBits::eCompute;
+    }
+    bindings[2].stageFlags = vk::ShaderStageFlagBits::eCompute;
+    auto createInfo = GpuDescriptorSetLayoutCreateInfo{};
+    createInfo.bindings = bindings;
+    return context_->createDescriptorSetLayout(createInfo);
+  }
+
+  vk::PipelineLayout Scene::Flyweight::createSkyViewPipelineLayout() const {
+    auto pushConstantRange = GpuPushConstantRange{};
+    pushConstantRange.stageFlags =
+        vk::ShaderStageFlagBits::eFragment | vk::ShaderStageFlagBits::eCompute;
+    pushConstantRange.size = 16;
+    auto createInfo = GpuPipelineLayoutCreateInfo{};
+    createInfo.setLayouts = {&skyViewDescriptorSetLayout_, 1};
+    createInfo.pushConstantRanges = {&pushConstantRange, 1};
+    return context_->createPipelineLayout(createInfo);
+  }
+
+  vk::Pipeline Scene::Flyweight::createSkyViewPipeline(
+      std::uint32_t steps,
+      AtmosphereSampling sampling,
+      bool analyticTransmittanceEnabled) const {
+    auto vertModule = vk::UniqueShaderModule{};
+    {
+      auto code = std::vector<char>{};
+      auto in = std::ifstream{};
+      in.exceptions(std::ios::badbit | std::ios::failbit);
+      in.open("./data/GenericVert.spv", std::ios::binary);
+      in.seekg(0, std::ios::end);
+      code.resize(in.tellg());
+      in.seekg(0, std::ios::beg);
+      in.read(code.data(), code.size());
+      auto createInfo = vk::ShaderModuleCreateInfo{};
+      createInfo.codeSize = code.size();
+      createInfo.pCode = reinterpret_cast<std::uint32_t *>(code.data());
+      vertModule = context_->getDevice().createShaderModuleUnique(createInfo);
+    }
+    auto fragModule = vk::UniqueShaderModule{};
+    {
+      auto code = std::vector<char>{};
+      auto in = std::ifstream{};
+      in.exceptions(std::ios::badbit | std::ios::failbit);
+      in.open("./data/SkyViewFrag.spv", std::ios::binary);
+      in.seekg(0, std::ios::end);
+      code.resize(in.tellg());
+      in.seekg(0, std::ios::beg);
+      in.read(code.data(), code.size());
+      auto createInfo = vk::ShaderModuleCreateInfo{};
+      createInfo.codeSize = code.size();
+      createInfo.pCode = reinterpret_cast<std::uint32_t *>(code.data());
+      fragModule = context_->getDevice().createShaderModuleUnique(createInfo);
+    }
+    auto specializationData = std::array{
+        steps,
+        static_cast<std::uint32_t>(sampling),
+        vk::Bool32{analyticTransmittanceEnabled}};
+    auto mapEntries = std::array<vk::SpecializationMapEntry, 3>{};
+    for (auto i = std::uint32_t{}; i < mapEntries.size(); ++i) {
+      mapEntries[i].constantID = i + 2;
+      mapEntries[i].offset = i * sizeof(std::uint32_t);
+      mapEntries[i].size = sizeof(std::uint32_t);
+    }
+    auto specializationInfo = vk::SpecializationInfo{};
+    specializationInfo.mapEntryCount =
+        static_cast<std::uint32_t>(mapEntries.size());
+    specializationInfo.pMapEntries = mapEntries.data();
+    specializationInfo.dataSize = sizeof(specializationData);
+    specializationInfo.pData = specializationData.data();
+    auto stages = std::array<vk::PipelineShaderStageCreateInfo, 2>{};
+    stages[0].stage = vk::ShaderStageFlagBits::eVertex;
+    stages[0].module = *vertModule;
+    stages[0].pName = "main";
+    stages[1].stage = vk::ShaderStageFlagBits::eFragment;
+    stages[1].module = *fragModule;
+    stages[1].pName = "main";
+    stages[1].pSpecializationInfo = &specializationInfo;
+    auto vertexInputState = vk::PipelineVertexInputStateCreateInfo{};
+    auto inputAssemblyState = vk::PipelineInputAssemblyStateCreateInfo{};
+    inputAssemblyState.topology = vk::PrimitiveTopology::eTriangleList;
+    auto viewportState = vk::PipelineViewportStateCreateInfo{};
+    viewportState.viewportCount = 1;
+    viewportState.scissorCount = 1;
+    auto rasterizationState = vk::PipelineRasterizationStateCreateInfo{};
+    rasterizationState.lineWidth = 1.0f;
+    auto multisampleState = vk::PipelineMultisampleStateCreateInfo{};
+    multisampleState.rasterizationSamples = vk::SampleCountFlagBits::e1;
+    auto attachment = vk::PipelineColorBlendAttachmentState{};
+    attachment.colorWriteMask =
+        vk::ColorComponentFlagBits::eR | vk::ColorComponentFlagBits::eG |
+        vk::ColorComponentFlagBits::eB | vk::ColorComponentFlagBits::eA;
+    auto colorBlendState = vk::PipelineColorBlendStateCreateInfo{};
+    colorBlendState.attachmentCount = 1;
+    colorBlendState.pAttachments = &attachment;
+    auto dynamicStates =
+        std::array{vk::DynamicState::eViewport, vk::DynamicState::eScissor};
+    auto dynamicState = vk::PipelineDynamicStateCreateInfo{};
+    dynamicState.dynamicStateCount =
+        static_cast<std::uint32_t>(dynamicStates.size());
+    dynamicState.pDynamicStates = dynamicStates.data();
+    auto createInfo = vk::GraphicsPipelineCreateInfo{};
+    createInfo.stageCount = static_cast<std::uint32_t>(stages.size());
+    createInfo.pStages = stages.data();
+    createInfo.pVertexInputState = &vertexInputState;
+    createInfo.pInputAssemblyState = &inputAssemblyState;
+    createInfo.pViewportState = &viewportState;
+    createInfo.pRasterizationState = &rasterizationState;
+    createInfo.pMultisampleState = &multisampleState;
+    createInfo.pColorBlendState = &colorBlendState;
+    createInfo.pDynamicState = &dynamicState;
+    createInfo.layout = skyViewPipelineLayout_;
+    auto renderingCreateInfo = vk::PipelineRenderingCreateInfoKHR{};
+    renderingCreateInfo.colorAttachmentCount = 1;
+    renderingCreateInfo.pColorAttachmentFormats = &skyViewFormat_;
+    if (context_->isDynamicRenderingEnabled()) {
+      createInfo.pNext = &renderingCreateInfo;
+    }
+    createInfo.renderPass = skyViewRenderPass_;
+    createInfo.subpass = 0;
+    createInfo.basePipelineIndex = -1;
+    return context_->getDevice().createGraphicsPipeline({}, createInfo).value;
+  }
+
+  vk::Pipeline Scene::Flyweight::createSkyViewComputePipeline(
+      std::uint32_t steps,
+      AtmosphereSampling sampling,
+      bool analyticTransmittanceEnabled) const {
+    auto compModule = vk::UniqueShaderModule{};
+    {
+      auto code = std::vector<char>{};
+      auto in = std::ifstream{};
+      in.exceptions(std::ios::badbit | std::ios::failbit);
+      in.open(
+          skyViewFormat_ == getVkFormat(ImageFormat::RGBA16F)
+              ? "./data/SkyViewComp.spv"
+              : "./data/SkyViewFormatlessComp.spv",
+          std::ios::binary);
+      in.seekg(0, std::ios::end);
+      code.resize(in.tellg());
+      in.seekg(0, std::ios::beg);
+      in.read(code.data(), code.size());
+      auto createInfo = vk::ShaderModuleCreateInfo{};
+      createInfo.codeSize = code.size();
+      createInfo.pCode = reinterpret_cast<std::uint32_t *>(code.data());
+      compModule = context_->getDevice().createShaderModuleUnique(createInfo);
+    }
+    auto workgroupSize = getWorkgroupSize();
+    auto specializationData = std::array{
+        workgroupSize.width,
+        workgroupSize.height,
+        steps,
+        static_cast<std::uint32_t>(sampling),
+        vk::Bool32{analyticTransmittanceEnabled}};
+    auto mapEntries = std::array<vk::SpecializationMapEntry, 5>{};
+    for (auto i = std::uint32_t{}; i < mapEntries.size(); ++i) {
+      mapEntries[i].constantID = i;
+      mapEntries[i].offset = i * sizeof(std::uint32_t);
+      mapEntries[i].size = sizeof(std::uint32_t);
+    }
+    auto specializationInfo = vk::SpecializationInfo{};
+    specializationInfo.mapEntryCount =
+        static_cast<std::uint32_t>(mapEntries.size());
+    specializationInfo.pMapEntries = mapEntries.data();
+    specializationInfo.dataSize = sizeof(specializationData);
+    specializationInfo.pData = specializationData.data();
+    auto createInfo = vk::ComputePipelineCreateInfo{};
+    createInfo.stage.stage = vk::ShaderStageFlagBits::eCompute;
+    createInfo.stage.module = *compModule;
+    createInfo.stage.pName = "main";
+    createInfo.stage.pSpecializationInfo = &specializationInfo;
+    createInfo.flags = vk::PipelineCreateFlagBits::eDispatchBase;
+    createInfo.layout = skyViewPipelineLayout_;
+    createInfo.basePipelineIndex = -1;
+    return context_->getDevice().createComputePipeline({}, createInfo).value;
+  }
+
+  vk::Sampler Scene::Flyweight::createSkyViewSampler() const {
+    auto createInfo = GpuSamplerCreateInfo{};
+    createInfo.magFilter = vk::Filter::eLinear;
+    createInfo.minFilter = vk::Filter::eLinear;
+    createInfo.mipmapMode = vk::SamplerMipmapMode::eNearest;
+    createInfo.addressModeU = vk::SamplerAddressMode::eRepeat;
+    createInfo.addressModeV = vk::SamplerAddressMode::eClampToEdge;
+    createInfo.addressModeW = vk::SamplerAddressMode::eClampToEdge;
+    return context_->createSampler(createInfo);
+  }
+
   Scene::Flyweight::~Flyweight() {
-    context_->getDevice().destroy(transmittancePipeline_);
+    auto device = context_->getDevice();
+    for (auto [_, pipeline] : skyViewComputePipelines_) {
+      device.destroy(pipeline);
+    }
+    for (auto [_, pipeline] : skyViewPipelines_) {
+      device.destroy(pipeline);
+    }
+    for (auto [_, pipeline] : transmittanceComputePipelines_) {
+      device.destroy(pipeline);
+    }
+    for (auto [_, pipeline] : transmittancePipelines_) {
+      device.destroy(pipeline);
+    }
   }
 
   gsl::not_null<GpuContext *> Scene::Flyweight::getContext() const noexcept {
     return context_;
   }
 
+  gsl::not_null<GpuProfiler *> Scene::Flyweight::getProfiler() const noexcept {
+    return profiler_;
+  }
+
   std::size_t Scene::Flyweight::getFrameCount() const noexcept {
     return frameCount_;
   }
 
+  vk::Format Scene::Flyweight::getTransmittanceFormat() const noexcept {
+    return transmittanceFormat_;
+  }
+
+  vk::Format Scene::Flyweight::getSkyViewFormat() const noexcept {
+    return skyViewFormat_;
+  }
+
   vk::RenderPass Scene::Flyweight::getTransmittanceRenderPass() const noexcept {
     return transmittanceRenderPass_;
   }
@@ -180,32 +565,118 @@ namespace imp {
     return transmittancePipelineLayout_;
   }
 
-  vk::Pipeline Scene::Flyweight::getTransmittancePipeline() const noexcept {
-    return transmittancePipeline_;
+  vk::Pipeline Scene::Flyweight::getTransmittancePipeline(
+      std::uint32_t steps, AtmosphereSampling sampling) const {
+    auto key = TransmittancePipelineKey{steps, sampling};
+    auto it = transmittancePipelines_.find(key);
+    if (it == transmittancePipelines_.end()) {
+      auto pipeline = createTransmittancePipeline(steps, sampling);
+      it = transmittancePipelines_.emplace(key, pipeline).first;
+    }
+    return it->second;
+  }
+
+  vk::Pipeline Scene::Flyweight::getTransmittanceComputePipeline(
+      std::uint32_t steps, AtmosphereSampling sampling) const {
+    auto key = TransmittancePipelineKey{steps, sampling};
+    auto it = transmittanceComputePipelines_.find(key);
+    if (it == transmittanceComputePipelines_.end()) {
+      auto pipeline = createTransmittanceComputePipeline(steps, sampling);
+      it = transmittanceComputePipelines_.emplace(key, pipeline).first;
+    }
+    return it->second;
   }
 
   vk::Sampler Scene::Flyweight::getTransmittanceSampler() const noexcept {
     return transmittanceSampler_;
   }
 
-  Scene::Frame::Frame(GpuImage &&transmittanceImage) noexcept:
-      transmittanceImage{std::move(transmittanceImage)} {}
+  vk::RenderPass Scene::Flyweight::getSkyViewRenderPass() const noexcept {
+    return skyViewRenderPass_;
+  }
+
+  vk::DescriptorSetLayout
+  Scene::Flyweight::getSkyViewDescriptorSetLayout() const noexcept {
+    return skyViewDescriptorSetLayout_;
+  }
+
+  vk::PipelineLayout
+  Scene::Flyweight::getSkyViewPipelineLayout() const noexcept {
+    return skyViewPipelineLayout_;
+  }
+
+  vk::Pipeline Scene::Flyweight::getSkyViewPipeline(
+      std::uint32_t steps,
+      AtmosphereSampling sampling,
+      bool analyticTransmittanceEnabled) const {
+    auto key =
+        SkyViewPipelineKey{steps, sampling, analyticTransmittanceEnabled};
+    auto it = skyViewPipelines_.find(key);
+    if (it == skyViewPipelines_.end()) {
+      auto pipeline = createSkyViewPipeline(
+          steps, sampling, analyticTransmittanceEnabled);
+      it = skyViewPipelines_.emplace(key, pipeline).first;
+    }
+    return it->second;
+  }
+
+  vk::Pipeline Scene::Flyweight::getSkyViewComputePipeline(
+      std::uint32_t steps,
+      AtmosphereSampling sampling,
+      bool analyticTransmittanceEnabled) const {
+    auto key =
+        SkyViewPipelineKey{steps, sampling, analyticTransmittanceEnabled};
+    auto it = skyViewComputePipelines_.find(key);
+    if (it == skyViewComputePipelines_.end()) {
+      auto pipeline = createSkyViewComputePipeline(
+          steps, sampling, analyticTransmittanceEnabled);
+      it = skyViewComputePipelines_.emplace(key, pipeline).first;
+    }
+    return it->second;
+  }
+
+  vk::Sampler Scene::Flyweight::getSkyViewSampler() const noexcept {
+    return skyViewSampler_;
+  }
+
+  Extent2u Scene::Flyweight::getWorkgroupSize() const noexcept {
+    auto invocationCount = std::max(context_->getSubgroupSize(), 64u);
+    return {8, invocationCount / 8};
+  }
 
   Scene::Scene(gsl::not_null<Flyweight const *> flyweight):
       flyweight_{flyweight},
+      quality_{AtmosphereQuality::HIGH},
+      sampling_{AtmosphereSampling::UNIFORM},
       descriptorPool_{createDescriptorPool()},
       uniformBuffer_{createUniformBuffer()},
+      transmittanceImage_{createTransmittanceImage()},
+      transmittanceImageView_{createTransmittanceImageView()},
+      transmittanceFramebuffer_{createTransmittanceFramebuffer()},
       frames_{createFrames()},
+      computeEnabled_{false},
+      asyncComputeEnabled_{false},
+      analyticTransmittanceEnabled_{false},
+      frameNumber_{0},
+      skyViewBuildsSaved_{0},
+      skyViewUpdateFraction_{1.0f},
+      skyViewAltitudeThreshold_{100.0f},
+      skyViewSunAngleThreshold_{0.01f},
+      skyViewAltitudeQuantum_{1.0f},
+      skyViewSunDirectionQuantum_{0.001f},
       firstFrame_{true} {}
 
   vk::DescriptorPool Scene::createDescriptorPool() const {
     auto frameCount32 = static_cast<std::uint32_t>(flyweight_->getFrameCount());
-    auto poolSize = vk::DescriptorPoolSize{
-        vk::DescriptorType::eUniformBuffer, frameCount32};
+    auto poolSizes = std::array{
+        vk::DescriptorPoolSize{
+            vk::DescriptorType::eUniformBuffer, frameCount32},
+        vk::DescriptorPoolSize{
+            vk::DescriptorType::eStorageImage, frameCount32}};
     auto createInfo = vk::DescriptorPoolCreateInfo{};
     createInfo.maxSets = frameCount32;
-    createInfo.poolSizeCount = 1;
-    createInfo.pPoolSizes = &poolSize;
+    createInfo.poolSizeCount = static_cast<std::uint32_t>(poolSizes.size());
+    createInfo.pPoolSizes = poolSizes.data();
     return flyweight_->getContext()->getDevice().createDescriptorPool(
         createInfo);
   }
@@ -216,6 +687,15 @@ namespace imp {
     buffer.size = frameCount != 1 ? UNIFORM_BUFFER_STRIDE * frameCount
                                   : UNIFORM_BUFFER_SIZE;
     buffer.usage = vk::BufferUsageFlagBits::eUniformBuffer;
+    auto queueFamilies = std::array{
+        flyweight_->getContext()->getGraphicsFamily(),
+        flyweight_->getContext()->getComputeFamily()};
+    if (queueFamilies[0] != queueFamilies[1]) {
+      buffer.sharingMode = vk::SharingMode::eConcurrent;
+      buffer.queueFamilyIndexCount =
+          static_cast<std::uint32_t>(queueFamilies.size());
+      buffer.pQueueFamilyIndices = queueFamilies.data();
+    }
     auto allocation = VmaAllocationCreateInfo{};
     allocation.flags = VMA_ALLOCATION_CREATE_MAPPED_BIT;
     allocation.usage = VMA_MEMORY_USAGE_CPU_TO_GPU;
@@ -223,35 +703,30 @@ namespace imp {
         flyweight_->getContext()->getAllocator(), buffer, allocation};
   }
 
-  std::vector<Scene::Frame> Scene::createFrames() const {
-    auto frames = std::vector<Frame>{};
-    frames.reserve(flyweight_->getFrameCount());
-    for (auto i = std::size_t{}; i < frames.capacity(); ++i) {
-      frames.emplace_back(createTransmittanceImage());
-      initTransmittanceImageView(frames.back());
-      initTransmittanceFramebuffer(frames.back());
-      initTransmittanceDescriptorSet(frames.back());
-      updateTransmittanceDescriptorSet(frames.back(), i);
-      initCommandPool(frames.back());
-      initCommandBuffer(frames.back());
-      updateCommandBuffer(frames.back());
-      initSemaphore(frames.back());
-    }
-    return frames;
-  }
-
   GpuImage Scene::createTransmittanceImage() const {
     auto image = vk::ImageCreateInfo{};
     image.imageType = vk::ImageType::e2D;
-    image.format = vk::Format::eR16G16B16A16Sfloat;
-    image.extent = TRANSMITTANCE_IMAGE_EXTENT;
+    image.format = flyweight_->getTransmittanceFormat();
+    image.extent = getAtmosphereQualitySettings(quality_).transmittanceExtent;
     image.mipLevels = 1;
     image.arrayLayers = 1;
     image.samples = vk::SampleCountFlagBits::e1;
     image.tiling = vk::ImageTiling::eOptimal;
     image.usage = vk::ImageUsageFlagBits::eSampled |
-                  vk::ImageUsageFlagBits::eColorAttachment;
+                  vk::ImageUsageFlagBits::eColorAttachment |
+                  vk::ImageUsageFlagBits::eStorage |
+                  vk::ImageUsageFlagBits::eTransferSrc |
+                  vk::ImageUsageFlagBits::eTransferDst;
     image.sharingMode = vk::SharingMode::eExclusive;
+    auto queueFamilies = std::array{
+        flyweight_->getContext()->getGraphicsFamily(),
+        flyweight_->getContext()->getComputeFamily()};
+    if (queueFamilies[0] != queueFamilies[1]) {
+      image.sharingMode = vk::SharingMode::eConcurrent;
+      image.queueFamilyIndexCount =
+          static_cast<std::uint32_t>(queueFamilies.size());
+      image.pQueueFamilyIndices = queueFamilies.data();
+    }
     image.initialLayout = vk::ImageLayout::eUndefined;
     auto allocation = VmaAllocationCreateInfo{};
     allocation.usage = VMA_MEMORY_USAGE_GPU_ONLY;
@@ -259,28 +734,42 @@ namespace imp {
         flyweight_->getContext()->getAllocator(), image, allocation};
   }
 
-  void Scene::initTransmittanceImageView(Frame &frame) const {
+  vk::ImageView Scene::createTransmittanceImageView() const {
     auto createInfo = vk::ImageViewCreateInfo{};
-    createInfo.image = frame.transmittanceImage.get();
+    createInfo.image = transmittanceImage_.get();
     createInfo.viewType = vk::ImageViewType::e2D;
-    createInfo.format = frame.transmittanceImage.getFormat();
+    createInfo.format = transmittanceImage_.getFormat();
     createInfo.subresourceRange.aspectMask = vk::ImageAspectFlagBits::eColor;
     createInfo.subresourceRange.levelCount = 1;
     createInfo.subresourceRange.layerCount = 1;
-    frame.transmittanceImageView =
-        flyweight_->getContext()->getDevice().createImageView(createInfo);
+    return flyweight_->getContext()->getDevice().createImageView(createInfo);
   }
 
-  void Scene::initTransmittanceFramebuffer(Frame &frame) const {
+  vk::Framebuffer Scene::createTransmittanceFramebuffer() const {
+    if (flyweight_->getContext()->isDynamicRenderingEnabled()) {
+      return {};
+    }
     auto createInfo = vk::FramebufferCreateInfo{};
     createInfo.renderPass = flyweight_->getTransmittanceRenderPass();
     createInfo.attachmentCount = 1;
-    createInfo.pAttachments = &frame.transmittanceImageView;
-    createInfo.width = frame.transmittanceImage.getExtent().width;
-    createInfo.height = frame.transmittanceImage.getExtent().height;
+    createInfo.pAttachments = &transmittanceImageView_;
+    createInfo.width = transmittanceImage_.getExtent().width;
+    createInfo.height = transmittanceImage_.getExtent().height;
     createInfo.layers = 1;
-    frame.transmittanceFramebuffer =
-        flyweight_->getContext()->getDevice().createFramebuffer(createInfo);
+    return flyweight_->getContext()->getDevice().createFramebuffer(createInfo);
+  }
+
+  std::vector<Scene::Frame> Scene::createFrames() const {
+    auto frames = std::vector<Frame>{};
+    frames.reserve(flyweight_->getFrameCount());
+    for (auto i = std::size_t{}; i < frames.capacity(); ++i) {
+      frames.emplace_back();
+      initTransmittanceDescriptorSet(frames.back());
+      updateTransmittanceDescriptorSet(frames.back(), i);
+      initCommandPools(frames.back());
+      initCommandBuffers(frames.back());
+    }
+    return frames;
   }
 
   void Scene::initTransmittanceDescriptorSet(Frame &frame) const {
@@ -295,94 +784,140 @@ namespace imp {
 
   void Scene::updateTransmittanceDescriptorSet(
       Frame &frame, std::size_t index) const {
-    auto info = vk::DescriptorBufferInfo{};
-    info.buffer = uniformBuffer_.get();
-    info.offset = UNIFORM_BUFFER_STRIDE * index;
-    info.range = UNIFORM_BUFFER_SIZE;
-    auto write = vk::WriteDescriptorSet{};
-    write.dstSet = frame.transmittanceDescriptorSet;
-    write.dstBinding = 0;
-    write.dstArrayElement = 0;
-    write.descriptorCount = 1;
-    write.descriptorType = vk::DescriptorType::eUniformBuffer;
-    write.pBufferInfo = &info;
-    flyweight_->getContext()->getDevice().updateDescriptorSets(write, {});
-  }
-
-  void Scene::initCommandPool(Frame &frame) const {
+    auto bufferInfo = vk::DescriptorBufferInfo{};
+    bufferInfo.buffer = uniformBuffer_.get();
+    bufferInfo.offset = UNIFORM_BUFFER_STRIDE * index;
+    bufferInfo.range = UNIFORM_BUFFER_SIZE;
+    auto imageInfo = vk::DescriptorImageInfo{};
+    imageInfo.imageView = transmittanceImageView_;
+    imageInfo.imageLayout = vk::ImageLayout::eGeneral;
+    auto writes = std::array<vk::WriteDescriptorSet, 2>{};
+    writes[0].dstSet = frame.transmittanceDescriptorSet;
+    writes[0].dstBinding = 0;
+    writes[0].dstArrayElement = 0;
+    writes[0].descriptorCount = 1;
+    writes[0].descriptorType = vk::DescriptorType::eUniformBuffer;
+    writes[0].pBufferInfo = &bufferInfo;
+    writes[1].dstSet = frame.transmittanceDescriptorSet;
+    writes[1].dstBinding = 1;
+    writes[1].dstArrayElement = 0;
+    writes[1].descriptorCount = 1;
+    writes[1].descriptorType = vk::DescriptorType::eStorageImage;
+    writes[1].pImageInfo = &imageInfo;
+    flyweight_->getContext()->getDevice().updateDescriptorSets(writes, {});
+  }
+
+  void Scene::initCommandPools(Frame &frame) const {
     auto &context = *flyweight_->getContext();
     auto createInfo = vk::CommandPoolCreateInfo{};
     createInfo.queueFamilyIndex = context.getGraphicsFamily();
     frame.commandPool = context.getDevice().createCommandPool(createInfo);
+    createInfo.queueFamilyIndex = context.getComputeFamily();
+    frame.computeCommandPool =
+        context.getDevice().createCommandPool(createInfo);
   }
 
-  void Scene::initCommandBuffer(Frame &frame) const {
+  void Scene::initCommandBuffers(Frame &frame) const {
+    auto device = flyweight_->getContext()->getDevice();
     auto allocateInfo = vk::CommandBufferAllocateInfo{};
     allocateInfo.commandPool = frame.commandPool;
     allocateInfo.commandBufferCount = 1;
-    flyweight_->getContext()->getDevice().allocateCommandBuffers(
-        &allocateInfo, &frame.commandBuffer);
-  }
-
-  void Scene::updateCommandBuffer(Frame &frame) const {
-    auto commandBufferBegin = vk::CommandBufferBeginInfo{};
-    frame.commandBuffer.begin(commandBufferBegin);
-    auto renderPassBegin = vk::RenderPassBeginInfo{};
-    renderPassBegin.renderPass = flyweight_->getTransmittanceRenderPass();
-    renderPassBegin.framebuffer = frame.transmittanceFramebuffer;
-    renderPassBegin.renderArea.extent.width =
-        frame.transmittanceImage.getExtent().width;
-    renderPassBegin.renderArea.extent.height =
-        frame.transmittanceImage.getExtent().height;
-    frame.commandBuffer.beginRenderPass(
-        renderPassBegin, vk::SubpassContents::eInline);
-    frame.commandBuffer.bindPipeline(
-        vk::PipelineBindPoint::eGraphics,
-        flyweight_->getTransmittancePipeline());
-    auto viewport = vk::Viewport{};
-    viewport.width = renderPassBegin.renderArea.extent.width;
-    viewport.height = renderPassBegin.renderArea.extent.height;
-    frame.commandBuffer.setViewport(0, viewport);
-    auto scissor = vk::Rect2D{};
-    scissor.extent.width = renderPassBegin.renderArea.extent.width;
-    scissor.extent.height = renderPassBegin.renderArea.extent.height;
-    frame.commandBuffer.setScissor(0, scissor);
-    frame.commandBuffer.bindDescriptorSets(
-        vk::PipelineBindPoint::eGraphics,
-        flyweight_->getTransmittancePipelineLayout(),
-        0,
-        frame.transmittanceDescriptorSet,
-        {});
-    frame.commandBuffer.draw(3, 1, 0, 0);
-    frame.commandBuffer.endRenderPass();
-    frame.commandBuffer.end();
-  }
-
-  void Scene::initSemaphore(Frame &frame) const {
-    frame.semaphore = flyweight_->getContext()->getDevice().createSemaphore({});
+    device.allocateCommandBuffers(&allocateInfo, &frame.commandBuffer);
+    allocateInfo.commandPool = frame.computeCommandPool;
+    device.allocateCommandBuffers(&allocateInfo, &frame.computeCommandBuffer);
   }
 
   Scene::~Scene() {
+    skyViewLuts_.clear();
     auto device = flyweight_->getContext()->getDevice();
     for (auto &frame : frames_) {
-      device.destroy(frame.semaphore);
+      device.destroy(frame.computeCommandPool);
       device.destroy(frame.commandPool);
-      device.destroy(frame.transmittanceFramebuffer);
-      device.destroy(frame.transmittanceImageView);
     }
+    device.destroy(transmittanceFramebuffer_);
+    device.destroy(transmittanceImageView_);
     device.destroyDescriptorPool(descriptorPool_);
   }
 
-  void Scene::render(std::size_t i) {
+  std::optional<vk::CommandBuffer> Scene::render(std::size_t i) {
+    IMP_CPU_ZONE("Scene::render");
     auto &frame = frames_[i];
+    storeTransmittanceImage(frame);
     updateUniformBuffer(i);
-    auto submitInfo = vk::SubmitInfo{};
-    submitInfo.commandBufferCount = 1;
-    submitInfo.pCommandBuffers = &frame.commandBuffer;
-    /*submitInfo.signalSemaphoreCount = 1;
-    submitInfo.pSignalSemaphores = &frame.semaphore;*/
-    flyweight_->getContext()->getGraphicsQueue().submit(submitInfo);
+    frame.asyncComputeEnabled = asyncComputeEnabled_;
+    if (frame.asyncComputeEnabled) {
+      beginComputeCommandBuffer(frame);
+    }
+    auto commandBuffer = std::optional<vk::CommandBuffer>{};
+    if (transmittanceVersion_ != planet_->getVersion()) {
+      if (frame.asyncComputeEnabled) {
+        updateTransmittanceImage(frame);
+      } else {
+        updateCommandBuffer(frame);
+        commandBuffer = frame.commandBuffer;
+      }
+      transmittanceVersion_ = planet_->getVersion();
+    }
+    ++frameNumber_;
+    skyViewBuildsSaved_ = 0;
+    evictSkyViewLuts();
     firstFrame_ = false;
+    return commandBuffer;
+  }
+
+  SkyViewLut const &Scene::acquireSkyViewLut(
+      vk::CommandBuffer commandBuffer,
+      std::size_t frameIndex,
+      float altitude,
+      Eigen::Vector3f const &sunDirection) {
+    auto key = getSkyViewLutKey(altitude, sunDirection);
+    auto best = skyViewLuts_.end();
+    auto bestDistance = std::numeric_limits<std::int64_t>::max();
+    for (auto it = skyViewLuts_.begin(); it != skyViewLuts_.end(); ++it) {
+      if (it->key == key && it->frameNumber == frameNumber_) {
+        ++skyViewBuildsSaved_;
+        return *it->lut;
+      }
+      if (it->frameNumber != frameNumber_) {
+        auto distance = (it->key - key).cast<std::int64_t>().squaredNorm();
+        if (distance < bestDistance) {
+          best = it;
+          bestDistance = distance;
+        }
+      }
+    }
+    if (best == skyViewLuts_.end()) {
+      skyViewLuts_.push_back({std::make_unique<SkyViewLut>(this), key, 0});
+      best = skyViewLuts_.end() - 1;
+    }
+    best->key = key;
+    best->frameNumber = frameNumber_;
+    Eigen::Vector3f quantizedSunDirection =
+        (key.tail<3>().cast<float>() * skyViewSunDirectionQuantum_)
+            .normalized();
+    auto &frame = frames_[frameIndex];
+    auto lutCommandBuffer =
+        frame.asyncComputeEnabled ? frame.computeCommandBuffer : commandBuffer;
+    auto profiler = flyweight_->getProfiler();
+    auto scope = profiler->begin(lutCommandBuffer, "scene", "sky view");
+    best->lut->update(
+        lutCommandBuffer,
+        frameIndex,
+        float(key.x()) * skyViewAltitudeQuantum_,
+        quantizedSunDirection,
+        frame.asyncComputeEnabled);
+    profiler->end(lutCommandBuffer, scope);
+    return *best->lut;
+  }
+
+  std::optional<vk::CommandBuffer>
+  Scene::endAsyncCompute(std::size_t frameIndex) {
+    auto &frame = frames_[frameIndex];
+    if (!frame.asyncComputeEnabled) {
+      return std::nullopt;
+    }
+    frame.computeCommandBuffer.end();
+    return frame.computeCommandBuffer;
   }
 
   void Scene::updateUniformBuffer(std::size_t frameIndex) {
@@ -394,6 +929,401 @@ namespace imp {
     uniformBuffer_.flush(offset, UNIFORM_BUFFER_SIZE);
   }
 
+  void Scene::updateCommandBuffer(Frame &frame) {
+    flyweight_->getContext()->getDevice().resetCommandPool(frame.commandPool);
+    auto beginInfo = vk::CommandBufferBeginInfo{};
+    beginInfo.flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit;
+    frame.commandBuffer.begin(beginInfo);
+    updateTransmittanceImage(frame);
+    frame.commandBuffer.end();
+  }
+
+  void Scene::beginComputeCommandBuffer(Frame &frame) {
+    flyweight_->getContext()->getDevice().resetCommandPool(
+        frame.computeCommandPool);
+    auto beginInfo = vk::CommandBufferBeginInfo{};
+    beginInfo.flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit;
+    frame.computeCommandBuffer.begin(beginInfo);
+  }
+
+  void Scene::updateTransmittanceImage(Frame &frame) {
+    auto profiler = flyweight_->getProfiler();
+    auto commandBuffer = getTransmittanceCommandBuffer(frame);
+    auto scope = profiler->begin(commandBuffer, "scene", "transmittance");
+    if (analyticTransmittanceEnabled_) {
+      discardTransmittanceImage(frame);
+    } else if (loadTransmittanceImage(frame)) {
+      uploadTransmittanceImage(frame);
+    } else {
+      if (computeEnabled_ || frame.asyncComputeEnabled) {
+        computeTransmittanceImage(frame);
+      } else {
+        renderTransmittanceImage(frame);
+      }
+      readTransmittanceImage(frame);
+    }
+    profiler->end(commandBuffer, scope);
+  }
+
+  vk::CommandBuffer
+  Scene::getTransmittanceCommandBuffer(Frame const &frame) const noexcept {
+    return frame.asyncComputeEnabled ? frame.computeCommandBuffer
+                                     : frame.commandBuffer;
+  }
+
+  vk::PipelineStageFlags
+  Scene::getShaderStages(Frame const &frame) const noexcept {
+    if (frame.asyncComputeEnabled) {
+      return vk::PipelineStageFlagBits::eComputeShader;
+    }
+    return vk::PipelineStageFlagBits::eFragmentShader |
+           vk::PipelineStageFlagBits::eComputeShader;
+  }
+
+  void Scene::discardTransmittanceImage(Frame &frame) {
+    auto commandBuffer = getTransmittanceCommandBuffer(frame);
+    auto shaderStages = getShaderStages(frame);
+    auto barrier = vk::ImageMemoryBarrier{};
+    barrier.srcAccessMask = {};
+    barrier.dstAccessMask = {};
+    barrier.oldLayout = vk::ImageLayout::eUndefined;
+    barrier.newLayout = vk::ImageLayout::eShaderReadOnlyOptimal;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.image = transmittanceImage_.get();
+    barrier.subresourceRange.aspectMask = vk::ImageAspectFlagBits::eColor;
+    barrier.subresourceRange.levelCount = 1;
+    barrier.subresourceRange.layerCount = 1;
+    commandBuffer.pipelineBarrier(
+        shaderStages,
+        shaderStages,
+        {},
+        {},
+        {},
+        barrier);
+  }
+
+  bool Scene::loadTransmittanceImage(Frame &frame) {
+    if (!lutCache_) {
+      return false;
+    }
+    auto extent = transmittanceImage_.getExtent();
+    auto format = transmittanceImage_.getFormat();
+    auto size = vk::DeviceSize{extent.width * extent.height * extent.depth *
+                               LutCache::getTexelSize(format)};
+    auto buffer = vk::BufferCreateInfo{};
+    buffer.size = size;
+    buffer.usage = vk::BufferUsageFlagBits::eTransferSrc;
+    auto allocation = VmaAllocationCreateInfo{};
+    allocation.flags = VMA_ALLOCATION_CREATE_MAPPED_BIT;
+    allocation.usage = VMA_MEMORY_USAGE_CPU_ONLY;
+    frame.transferBuffer.emplace(
+        flyweight_->getContext()->getAllocator(),
+        buffer,
+        allocation,
+        "transmittance staging buffer");
+    if (!lutCache_->load(
+            getTransmittanceLutName(),
+            *planet_,
+            format,
+            extent,
+            {frame.transferBuffer->getMappedData(),
+             static_cast<std::size_t>(size)})) {
+      frame.transferBuffer.reset();
+      return false;
+    }
+    frame.transferBuffer->flush();
+    return true;
+  }
+
+  void Scene::uploadTransmittanceImage(Frame &frame) {
+    auto commandBuffer = getTransmittanceCommandBuffer(frame);
+    auto shaderStages = getShaderStages(frame);
+    auto barrier = vk::ImageMemoryBarrier{};
+    barrier.srcAccessMask = {};
+    barrier.dstAccessMask = vk::AccessFlagBits::eTransferWrite;
+    barrier.oldLayout = vk::ImageLayout::eUndefined;
+    barrier.newLayout = vk::ImageLayout::eTransferDstOptimal;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.image = transmittanceImage_.get();
+    barrier.subresourceRange.aspectMask = vk::ImageAspectFlagBits::eColor;
+    barrier.subresourceRange.levelCount = 1;
+    barrier.subresourceRange.layerCount = 1;
+    commandBuffer.pipelineBarrier(
+        shaderStages,
+        vk::PipelineStageFlagBits::eTransfer,
+        {},
+        {},
+        {},
+        barrier);
+    auto region = vk::BufferImageCopy{};
+    region.imageSubresource.aspectMask = vk::ImageAspectFlagBits::eColor;
+    region.imageSubresource.layerCount = 1;
+    region.imageExtent = transmittanceImage_.getExtent();
+    commandBuffer.copyBufferToImage(
+        frame.transferBuffer->get(),
+        transmittanceImage_.get(),
+        vk::ImageLayout::eTransferDstOptimal,
+        region);
+    barrier.srcAccessMask = vk::AccessFlagBits::eTransferWrite;
+    barrier.dstAccessMask = vk::AccessFlagBits::eShaderRead;
+    barrier.oldLayout = vk::ImageLayout::eTransferDstOptimal;
+    barrier.newLayout = vk::ImageLayout::eShaderReadOnlyOptimal;
+    commandBuffer.pipelineBarrier(
+        vk::PipelineStageFlagBits::eTransfer,
+        shaderStages,
+        {},
+        {},
+        {},
+        barrier);
+  }
+
+  void Scene::renderTransmittanceImage(Frame &frame) {
+    auto context = flyweight_->getContext();
+    auto extent = vk::Extent2D{
+        transmittanceImage_.getExtent().width,
+        transmittanceImage_.getExtent().height};
+    auto barrier = vk::ImageMemoryBarrier{};
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.image = transmittanceImage_.get();
+    barrier.subresourceRange.aspectMask = vk::ImageAspectFlagBits::eColor;
+    barrier.subresourceRange.levelCount = 1;
+    barrier.subresourceRange.layerCount = 1;
+    if (context->isDynamicRenderingEnabled()) {
+      barrier.srcAccessMask = {};
+      barrier.dstAccessMask = vk::AccessFlagBits::eColorAttachmentWrite;
+      barrier.oldLayout = vk::ImageLayout::eUndefined;
+      barrier.newLayout = vk::ImageLayout::eColorAttachmentOptimal;
+      frame.commandBuffer.pipelineBarrier(
+          vk::PipelineStageFlagBits::eFragmentShader |
+              vk::PipelineStageFlagBits::eComputeShader,
+          vk::PipelineStageFlagBits::eColorAttachmentOutput,
+          {},
+          {},
+          {},
+          barrier);
+      auto attachment = vk::RenderingAttachmentInfoKHR{};
+      attachment.imageView = transmittanceImageView_;
+      attachment.imageLayout = vk::ImageLayout::eColorAttachmentOptimal;
+      attachment.loadOp = vk::AttachmentLoadOp::eDontCare;
+      attachment.storeOp = vk::AttachmentStoreOp::eStore;
+      auto renderingInfo = vk::RenderingInfoKHR{};
+      renderingInfo.renderArea.extent = extent;
+      renderingInfo.layerCount = 1;
+      renderingInfo.colorAttachmentCount = 1;
+      renderingInfo.pColorAttachments = &attachment;
+      context->beginRendering(frame.commandBuffer, renderingInfo);
+    } else {
+      auto renderPassBegin = vk::RenderPassBeginInfo{};
+      renderPassBegin.renderPass = flyweight_->getTransmittanceRenderPass();
+      renderPassBegin.framebuffer = transmittanceFramebuffer_;
+      renderPassBegin.renderArea.extent = extent;
+      frame.commandBuffer.beginRenderPass(
+          renderPassBegin, vk::SubpassContents::eInline);
+    }
+    frame.commandBuffer.bindPipeline(
+        vk::PipelineBindPoint::eGraphics,
+        flyweight_->getTransmittancePipeline(
+            getAtmosphereQualitySettings(quality_).transmittanceSteps,
+            sampling_));
+    auto viewport = vk::Viewport{};
+    viewport.width = extent.width;
+    viewport.height = extent.height;
+    frame.commandBuffer.setViewport(0, viewport);
+    auto scissor = vk::Rect2D{};
+    scissor.extent = extent;
+    frame.commandBuffer.setScissor(0, scissor);
+    frame.commandBuffer.bindDescriptorSets(
+        vk::PipelineBindPoint::eGraphics,
+        flyweight_->getTransmittancePipelineLayout(),
+        0,
+        frame.transmittanceDescriptorSet,
+        {});
+    frame.commandBuffer.draw(3, 1, 0, 0);
+    if (context->isDynamicRenderingEnabled()) {
+      context->endRendering(frame.commandBuffer);
+      barrier.srcAccessMask = vk::AccessFlagBits::eColorAttachmentWrite;
+      barrier.dstAccessMask = vk::AccessFlagBits::eShaderRead;
+      barrier.oldLayout = vk::ImageLayout::eColorAttachmentOptimal;
+      barrier.newLayout = vk::ImageLayout::eShaderReadOnlyOptimal;
+      frame.commandBuffer.pipelineBarrier(
+          vk::PipelineStageFlagBits::eColorAttachmentOutput,
+          vk::PipelineStageFlagBits::eFragmentShader |
+              vk::PipelineStageFlagBits::eComputeShader,
+          {},
+          {},
+          {},
+          barrier);
+    } else {
+      frame.commandBuffer.endRenderPass();
+    }
+  }
+
+  void Scene::computeTransmittanceImage(Frame &frame) {
+    auto commandBuffer = getTransmittanceCommandBuffer(frame);
+    auto shaderStages = getShaderStages(frame);
+    auto barrier = vk::ImageMemoryBarrier{};
+    barrier.srcAccessMask = {};
+    barrier.dstAccessMask = vk::AccessFlagBits::eShaderWrite;
+    barrier.oldLayout = vk::ImageLayout::eUndefined;
+    barrier.newLayout = vk::ImageLayout::eGeneral;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.image = transmittanceImage_.get();
+    barrier.subresourceRange.aspectMask = vk::ImageAspectFlagBits::eColor;
+    barrier.subresourceRange.levelCount = 1;
+    barrier.subresourceRange.layerCount = 1;
+    commandBuffer.pipelineBarrier(
+        shaderStages,
+        vk::PipelineStageFlagBits::eComputeShader,
+        {},
+        {},
+        {},
+        barrier);
+    commandBuffer.bindPipeline(
+        vk::PipelineBindPoint::eCompute,
+        flyweight_->getTransmittanceComputePipeline(
+            getAtmosphereQualitySettings(quality_).transmittanceSteps,
+            sampling_));
+    commandBuffer.bindDescriptorSets(
+        vk::PipelineBindPoint::eCompute,
+        flyweight_->getTransmittancePipelineLayout(),
+        0,
+        frame.transmittanceDescriptorSet,
+        {});
+    auto extent = transmittanceImage_.getExtent();
+    auto workgroupSize = flyweight_->getWorkgroupSize();
+    commandBuffer.dispatch(
+        (extent.width + workgroupSize.width - 1) / workgroupSize.width,
+        (extent.height + workgroupSize.height - 1) / workgroupSize.height,
+        1);
+    barrier.srcAccessMask = vk::AccessFlagBits::eShaderWrite;
+    barrier.dstAccessMask = vk::AccessFlagBits::eShaderRead;
+    barrier.oldLayout = vk::ImageLayout::eGeneral;
+    barrier.newLayout = vk::ImageLayout::eShaderReadOnlyOptimal;
+    commandBuffer.pipelineBarrier(
+        vk::PipelineStageFlagBits::eComputeShader,
+        shaderStages,
+        {},
+        {},
+        {},
+        barrier);
+  }
+
+  void Scene::readTransmittanceImage(Frame &frame) {
+    if (!lutCache_) {
+      return;
+    }
+    auto extent = transmittanceImage_.getExtent();
+    auto size = vk::DeviceSize{
+        extent.width * extent.height * extent.depth *
+        LutCache::getTexelSize(transmittanceImage_.getFormat())};
+    auto buffer = vk::BufferCreateInfo{};
+    buffer.size = size;
+    buffer.usage = vk::BufferUsageFlagBits::eTransferDst;
+    auto allocation = VmaAllocationCreateInfo{};
+    allocation.flags = VMA_ALLOCATION_CREATE_MAPPED_BIT;
+    allocation.usage = VMA_MEMORY_USAGE_GPU_TO_CPU;
+    frame.transferBuffer.emplace(
+        flyweight_->getContext()->getAllocator(),
+        buffer,
+        allocation,
+        "transmittance readback buffer");
+    frame.transferPlanet = *planet_;
+    frame.transferLutName = getTransmittanceLutName();
+    auto commandBuffer = getTransmittanceCommandBuffer(frame);
+    auto shaderStages = getShaderStages(frame);
+    auto imageBarrier = vk::ImageMemoryBarrier{};
+    imageBarrier.srcAccessMask = {};
+    imageBarrier.dstAccessMask = vk::AccessFlagBits::eTransferRead;
+    imageBarrier.oldLayout = vk::ImageLayout::eShaderReadOnlyOptimal;
+    imageBarrier.newLayout = vk::ImageLayout::eTransferSrcOptimal;
+    imageBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    imageBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    imageBarrier.image = transmittanceImage_.get();
+    imageBarrier.subresourceRange.aspectMask = vk::ImageAspectFlagBits::eColor;
+    imageBarrier.subresourceRange.levelCount = 1;
+    imageBarrier.subresourceRange.layerCount = 1;
+    commandBuffer.pipelineBarrier(
+        shaderStages,
+        vk::PipelineStageFlagBits::eTransfer,
+        {},
+        {},
+        {},
+        imageBarrier);
+    auto region = vk::BufferImageCopy{};
+    region.imageSubresource.aspectMask = vk::ImageAspectFlagBits::eColor;
+    region.imageSubresource.layerCount = 1;
+    region.imageExtent = extent;
+    commandBuffer.copyImageToBuffer(
+        transmittanceImage_.get(),
+        vk::ImageLayout::eTransferSrcOptimal,
+        frame.transferBuffer->get(),
+        region);
+    imageBarrier.srcAccessMask = {};
+    imageBarrier.dstAccessMask = vk::AccessFlagBits::eShaderRead;
+    imageBarrier.oldLayout = vk::ImageLayout::eTransferSrcOptimal;
+    imageBarrier.newLayout = vk::ImageLayout::eShaderReadOnlyOptimal;
+    auto bufferBarrier = vk::BufferMemoryBarrier{};
+    bufferBarrier.srcAccessMask = vk::AccessFlagBits::eTransferWrite;
+    bufferBarrier.dstAccessMask = vk::AccessFlagBits::eHostRead;
+    bufferBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    bufferBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    bufferBarrier.buffer = frame.transferBuffer->get();
+    bufferBarrier.size = VK_WHOLE_SIZE;
+    commandBuffer.pipelineBarrier(
+        vk::PipelineStageFlagBits::eTransfer,
+        shaderStages | vk::PipelineStageFlagBits::eHost,
+        {},
+        {},
+        bufferBarrier,
+        imageBarrier);
+  }
+
+  void Scene::storeTransmittanceImage(Frame &frame) {
+    if (frame.transferPlanet && lutCache_) {
+      frame.transferBuffer->invalidate();
+      lutCache_->store(
+          frame.transferLutName,
+          *frame.transferPlanet,
+          transmittanceImage_.getFormat(),
+          transmittanceImage_.getExtent(),
+          {frame.transferBuffer->getMappedData(),
+           static_cast<std::size_t>(frame.transferBuffer->getSize())});
+    }
+    frame.transferBuffer.reset();
+    frame.transferPlanet.reset();
+    frame.transferLutName.clear();
+  }
+
+  std::string Scene::getTransmittanceLutName() const {
+    return "transmittance-" +
+           std::to_string(
+               getAtmosphereQualitySettings(quality_).transmittanceSteps) +
+           "-" + std::to_string(static_cast<int>(sampling_));
+  }
+
+  void Scene::evictSkyViewLuts() {
+    auto frameCount = flyweight_->getFrameCount();
+    std::erase_if(skyViewLuts_, [&](auto const &entry) {
+      return frameNumber_ - entry.frameNumber > frameCount;
+    });
+  }
+
+  Eigen::Vector4i Scene::getSkyViewLutKey(
+      float altitude, Eigen::Vector3f const &sunDirection) const {
+    return {
+        static_cast<int>(std::round(altitude / skyViewAltitudeQuantum_)),
+        static_cast<int>(
+            std::round(sunDirection.x() / skyViewSunDirectionQuantum_)),
+        static_cast<int>(
+            std::round(sunDirection.y() / skyViewSunDirectionQuantum_)),
+        static_cast<int>(
+            std::round(sunDirection.z() / skyViewSunDirectionQuantum_))};
+  }
+
   gsl::not_null<Scene::Flyweight const *> Scene::getFlyweight() const noexcept {
     return flyweight_;
   }
@@ -402,16 +1332,12 @@ namespace imp {
     return uniformBuffer_;
   }
 
-  GpuImage const &Scene::getTransmittanceImage(std::size_t i) const noexcept {
-    return frames_[i].transmittanceImage;
+  GpuImage const &Scene::getTransmittanceImage() const noexcept {
+    return transmittanceImage_;
   }
 
-  vk::ImageView Scene::getTransmittanceImageView(std::size_t i) const noexcept {
-    return frames_[i].transmittanceImageView;
-  }
-
-  vk::Semaphore Scene::getSemaphore(std::size_t i) const noexcept {
-    return frames_[i].semaphore;
+  vk::ImageView Scene::getTransmittanceImageView() const noexcept {
+    return transmittanceImageView_;
   }
 
   std::shared_ptr<Planet> Scene::getPlanet() const noexcept {
@@ -420,6 +1346,7 @@ namespace imp {
 
   void Scene::setPlanet(std::shared_ptr<Planet> planet) noexcept {
     planet_ = std::move(planet);
+    transmittanceVersion_.reset();
   }
 
   std::shared_ptr<DirectionalLight> Scene::getSunLight() const noexcept {
@@ -437,4 +1364,127 @@ namespace imp {
   void Scene::setMoonLight(std::shared_ptr<DirectionalLight> light) noexcept {
     moonLight_ = std::move(light);
   }
+
+  std::shared_ptr<LutCache> Scene::getLutCache() const noexcept {
+    return lutCache_;
+  }
+
+  void Scene::setLutCache(std::shared_ptr<LutCache> lutCache) noexcept {
+    lutCache_ = std::move(lutCache);
+  }
+
+  AtmosphereQuality Scene::getAtmosphereQuality() const noexcept {
+    return quality_;
+  }
+
+  void Scene::setAtmosphereQuality(AtmosphereQuality quality) {
+    if (quality_ == quality) {
+      return;
+    }
+    auto device = flyweight_->getContext()->getDevice();
+    device.waitIdle();
+    for (auto &frame : frames_) {
+      storeTransmittanceImage(frame);
+    }
+    skyViewLuts_.clear();
+    device.destroy(transmittanceFramebuffer_);
+    device.destroy(transmittanceImageView_);
+    quality_ = quality;
+    transmittanceImage_ = createTransmittanceImage();
+    transmittanceImageView_ = createTransmittanceImageView();
+    transmittanceFramebuffer_ = createTransmittanceFramebuffer();
+    for (auto i = std::size_t{}; i < frames_.size(); ++i) {
+      updateTransmittanceDescriptorSet(frames_[i], i);
+    }
+    transmittanceVersion_.reset();
+  }
+
+  AtmosphereSampling Scene::getAtmosphereSampling() const noexcept {
+    return sampling_;
+  }
+
+  void Scene::setAtmosphereSampling(AtmosphereSampling sampling) noexcept {
+    if (sampling_ != sampling) {
+      sampling_ = sampling;
+      transmittanceVersion_.reset();
+    }
+  }
+
+  bool Scene::isComputeEnabled() const noexcept {
+    return computeEnabled_;
+  }
+
+  void Scene::setComputeEnabled(bool computeEnabled) noexcept {
+    if (computeEnabled_ != computeEnabled) {
+      computeEnabled_ = computeEnabled;
+      transmittanceVersion_.reset();
+    }
+  }
+
+  bool Scene::isAsyncComputeEnabled() const noexcept {
+    return asyncComputeEnabled_;
+  }
+
+  void Scene::setAsyncComputeEnabled(bool asyncComputeEnabled) noexcept {
+    asyncComputeEnabled_ = asyncComputeEnabled;
+  }
+
+  bool Scene::isAnalyticTransmittanceEnabled() const noexcept {
+    return analyticTransmittanceEnabled_;
+  }
+
+  void Scene::setAnalyticTransmittanceEnabled(bool enabled) noexcept {
+    if (analyticTransmittanceEnabled_ != enabled) {
+      analyticTransmittanceEnabled_ = enabled;
+      transmittanceVersion_.reset();
+    }
+  }
+
+  float Scene::getSkyViewUpdateFraction() const noexcept {
+    return skyViewUpdateFraction_;
+  }
+
+  void Scene::setSkyViewUpdateFraction(float fraction) noexcept {
+    skyViewUpdateFraction_ = fraction;
+  }
+
+  float Scene::getSkyViewAltitudeThreshold() const noexcept {
+    return skyViewAltitudeThreshold_;
+  }
+
+  void Scene::setSkyViewAltitudeThreshold(float threshold) noexcept {
+    skyViewAltitudeThreshold_ = threshold;
+  }
+
+  float Scene::getSkyViewSunAngleThreshold() const noexcept {
+    return skyViewSunAngleThreshold_;
+  }
+
+  void Scene::setSkyViewSunAngleThreshold(float threshold) noexcept {
+    skyViewSunAngleThreshold_ = threshold;
+  }
+
+  float Scene::getSkyViewAltitudeQuantum() const noexcept {
+    return skyViewAltitudeQuantum_;
+  }
+
+  void Scene::setSkyViewAltitudeQuantum(float quantum) noexcept {
+    skyViewAltitudeQuantum_ = quantum;
+  }
+
+  float Scene::getSkyViewSunDirectionQuantum() const noexcept {
+    return skyViewSunDirectionQuantum_;
+  }
+
+  void Scene::setSkyViewSunDirectionQuantum(float quantum) noexcept {
+    skyViewSunDirectionQuantum_ = quantum;
+  }
+
+  std::size_t Scene::getSkyViewLutCount() const noexcept {
+    return skyViewLuts_.size();
+  }
+
+  std::size_t Scene::getSkyViewBuildsSaved() const noexcept {
+    return skyViewBuildsSaved_;
+  }
 } // namespace imp
\ No newline at end of file
@@ -1,16 +1,26 @@
 #pragma once
 
+#include <map>
 #include <memory>
+#include <optional>
+#include <string>
+#include <tuple>
+#include <utility>
 #include <vector>
 
 #include "../system/GpuBuffer.h"
 #include "../system/GpuImage.h"
 #include "../util/Align.h"
+#include "AtmosphereQuality.h"
 #include "DirectionalLight.h"
+#include "ImageFormat.h"
+#include "LutCache.h"
 #include "Planet.h"
+#include "SkyViewLut.h"
 
 namespace imp {
   class GpuContext;
+  class GpuProfiler;
 
   class Scene {
   public:
@@ -19,52 +29,112 @@ namespace imp {
         DirectionalLight::UNIFORM_SIZE;
     static constexpr auto UNIFORM_BUFFER_STRIDE =
         align(std::size_t{256}, UNIFORM_BUFFER_SIZE);
-    static constexpr auto TRANSMITTANCE_IMAGE_EXTENT = Extent3u{64, 256, 1};
 
     class Flyweight {
     public:
       explicit Flyweight(
-          gsl::not_null<GpuContext *> context, std::size_t frameCount);
+          gsl::not_null<GpuContext *> context,
+          gsl::not_null<GpuProfiler *> profiler,
+          std::size_t frameCount,
+          ImageFormats const &formats);
 
     private:
+      using TransmittancePipelineKey =
+          std::pair<std::uint32_t, AtmosphereSampling>;
+      using SkyViewPipelineKey =
+          std::tuple<std::uint32_t, AtmosphereSampling, bool>;
+
       vk::RenderPass createTransmittanceRenderPass() const;
       vk::DescriptorSetLayout createTransmittanceDescriptorSetLayout() const;
       vk::PipelineLayout createTransmittancePipelineLayout() const;
-      vk::Pipeline createTransmittancePipeline() const;
+      vk::Pipeline createTransmittancePipeline(
+          std::uint32_t steps, AtmosphereSampling sampling) const;
+      vk::Pipeline createTransmittanceComputePipeline(
+          std::uint32_t steps, AtmosphereSampling sampling) const;
       vk::Sampler createTransmittanceSampler() const;
+      vk::RenderPass createSkyViewRenderPass() const;
+      vk::DescriptorSetLayout createSkyViewDescriptorSetLayout() const;
+      vk::PipelineLayout createSkyViewPipelineLayout() const;
+      vk::Pipeline createSkyViewPipeline(
+          std::uint32_t steps,
+          AtmosphereSampling sampling,
+          bool analyticTransmittanceEnabled) const;
+      vk::Pipeline createSkyViewComputePipeline(
+          std::uint32_t steps,
+          AtmosphereSampling sampling,
+          bool analyticTransmittanceEnabled) const;
+      vk::Sampler createSkyViewSampler() const;
 
     public:
       ~Flyweight();
 
       gsl::not_null<GpuContext *> getContext() const noexcept;
+      gsl::not_null<GpuProfiler *> getProfiler() const noexcept;
       std::size_t getFrameCount() const noexcept;
+      vk::Format getTransmittanceFormat() const noexcept;
+      vk::Format getSkyViewFormat() const noexcept;
       vk::RenderPass getTransmittanceRenderPass() const noexcept;
       vk::DescriptorSetLayout
       getTransmittanceDescriptorSetLayout() const noexcept;
       vk::PipelineLayout getTransmittancePipelineLayout() const noexcept;
-      vk::Pipeline getTransmittancePipeline() const noexcept;
+      vk::Pipeline getTransmittancePipeline(
+          std::uint32_t steps, AtmosphereSampling sampling) const;
+      vk::Pipeline getTransmittanceComputePipeline(
+          std::uint32_t steps, AtmosphereSampling sampling) const;
       vk::Sampler getTransmittanceSampler() const noexcept;
+      vk::RenderPass getSkyViewRenderPass() const noexcept;
+      vk::DescriptorSetLayout getSkyViewDescriptorSetLayout() const noexcept;
+      vk::PipelineLayout getSkyViewPipelineLayout() const noexcept;
+      vk::Pipeline getSkyViewPipeline(
+          std::uint32_t steps,
+          AtmosphereSampling sampling,
+          bool analyticTransmittanceEnabled) const;
+      vk::Pipeline getSkyViewComputePipeline(
+          std::uint32_t steps,
+          AtmosphereSampling sampling,
+          bool analyticTransmittanceEnabled) const;
+      vk::Sampler getSkyViewSampler() const noexcept;
+      Extent2u getWorkgroupSize() const noexcept;
 
     private:
       gsl::not_null<GpuContext *> context_;
+      gsl::not_null<GpuProfiler *> profiler_;
       std::size_t frameCount_;
+      vk::Format transmittanceFormat_;
+      vk::Format skyViewFormat_;
       vk::RenderPass transmittanceRenderPass_;
       vk::DescriptorSetLayout transmittanceDescriptorSetLayout_;
       vk::PipelineLayout transmittancePipelineLayout_;
-      vk::Pipeline transmittancePipeline_;
+      mutable std::map<TransmittancePipelineKey, vk::Pipeline>
+          transmittancePipelines_;
+      mutable std::map<TransmittancePipelineKey, vk::Pipeline>
+          transmittanceComputePipelines_;
       vk::Sampler transmittanceSampler_;
+      vk::RenderPass skyViewRenderPass_;
+      vk::DescriptorSetLayout skyViewDescriptorSetLayout_;
+      vk::PipelineLayout skyViewPipelineLayout_;
+      mutable std::map<SkyViewPipelineKey, vk::Pipeline> skyViewPipelines_;
+      mutable std::map<SkyViewPipelineKey, vk::Pipeline>
+          skyViewComputePipelines_;
+      vk::Sampler skyViewSampler_;
     };
 
     struct Frame {
-      GpuImage transmittanceImage;
-      vk::ImageView transmittanceImageView;
-      vk::Framebuffer transmittanceFramebuffer;
       vk::DescriptorSet transmittanceDescriptorSet;
       vk::CommandPool commandPool;
       vk::CommandBuffer commandBuffer;
-      vk::Semaphore semaphore;
+      vk::CommandPool computeCommandPool;
+      vk::CommandBuffer computeCommandBuffer;
+      bool asyncComputeEnabled;
+      std::optional<GpuBuffer> transferBuffer;
+      std::optional<Planet> transferPlanet;
+      std::string transferLutName;
+    };
 
-      Frame(GpuImage &&transmittanceImage) noexcept;
+    struct SkyViewLutEntry {
+      std::unique_ptr<SkyViewLut> lut;
+      Eigen::Vector4i key;
+      std::uint64_t frameNumber;
     };
 
     explicit Scene(gsl::not_null<Flyweight const *> flyweight);
@@ -72,46 +142,108 @@ namespace imp {
   private:
     vk::DescriptorPool createDescriptorPool() const;
     GpuBuffer createUniformBuffer() const;
-    std::vector<Frame> createFrames() const;
     GpuImage createTransmittanceImage() const;
-    void initTransmittanceImageView(Frame &frame) const;
-    void initTransmittanceFramebuffer(Frame &frame) const;
+    vk::ImageView createTransmittanceImageView() const;
+    vk::Framebuffer createTransmittanceFramebuffer() const;
+    std::vector<Frame> createFrames() const;
     void initTransmittanceDescriptorSet(Frame &frame) const;
     void updateTransmittanceDescriptorSet(Frame &frame, std::size_t index) const;
-    void initCommandPool(Frame &frame) const;
-    void initCommandBuffer(Frame &frame) const;
-    void updateCommandBuffer(Frame &frame) const;
-    void initSemaphore(Frame &frame) const;
+    void initCommandPools(Frame &frame) const;
+    void initCommandBuffers(Frame &frame) const;
 
   public:
     ~Scene();
 
-    void render(std::size_t frameIndex);
+    std::optional<vk::CommandBuffer> render(std::size_t frameIndex);
+    SkyViewLut const &acquireSkyViewLut(
+        vk::CommandBuffer commandBuffer,
+        std::size_t frameIndex,
+        float altitude,
+        Eigen::Vector3f const &sunDirection);
+    std::optional<vk::CommandBuffer> endAsyncCompute(std::size_t frameIndex);
 
   private:
     void updateUniformBuffer(std::size_t frameIndex);
+    void updateCommandBuffer(Frame &frame);
+    void beginComputeCommandBuffer(Frame &frame);
+    void updateTransmittanceImage(Frame &frame);
+    vk::CommandBuffer
+    getTransmittanceCommandBuffer(Frame const &frame) const noexcept;
+    vk::PipelineStageFlags getShaderStages(Frame const &frame) const noexcept;
+    void discardTransmittanceImage(Frame &frame);
+    bool loadTransmittanceImage(Frame &frame);
+    void uploadTransmittanceImage(Frame &frame);
+    void renderTransmittanceImage(Frame &frame);
+    void computeTransmittanceImage(Frame &frame);
+    void readTransmittanceImage(Frame &frame);
+    void storeTransmittanceImage(Frame &frame);
+    std::string getTransmittanceLutName() const;
+    void evictSkyViewLuts();
+    Eigen::Vector4i
+    getSkyViewLutKey(float altitude, Eigen::Vector3f const &sunDirection) const;
 
   public:
     gsl::not_null<Flyweight const *> getFlyweight() const noexcept;
     GpuBuffer const &getUniformBuffer() const noexcept;
-    GpuImage const &getTransmittanceImage(std::size_t i) const noexcept;
-    vk::ImageView getTransmittanceImageView(std::size_t i) const noexcept;
-    vk::Semaphore getSemaphore(std::size_t i) const noexcept;
+    GpuImage const &getTransmittanceImage() const noexcept;
+    vk::ImageView getTransmittanceImageView() const noexcept;
     std::shared_ptr<Planet> getPlanet() const noexcept;
     void setPlanet(std::shared_ptr<Planet> planet) noexcept;
     std::shared_ptr<DirectionalLight> getSunLight() const noexcept;
     void setSunLight(std::shared_ptr<DirectionalLight> sunLight) noexcept;
     std::shared_ptr<DirectionalLight> getMoonLight() const noexcept;
     void setMoonLight(std::shared_ptr<DirectionalLight> moonLight) noexcept;
+    std::shared_ptr<LutCache> getLutCache() const noexcept;
+    void setLutCache(std::shared_ptr<LutCache> lutCache) noexcept;
+    AtmosphereQuality getAtmosphereQuality() const noexcept;
+    void setAtmosphereQuality(AtmosphereQuality quality);
+    AtmosphereSampling getAtmosphereSampling() const noexcept;
+    void setAtmosphereSampling(AtmosphereSampling sampling) noexcept;
+    bool isAnalyticTransmittanceEnabled() const noexcept;
+    void setAnalyticTransmittanceEnabled(bool enabled) noexcept;
+    bool isComputeEnabled() const noexcept;
+    void setComputeEnabled(bool computeEnabled) noexcept;
+    bool isAsyncComputeEnabled() const noexcept;
+    void setAsyncComputeEnabled(bool asyncComputeEnabled) noexcept;
+    float getSkyViewUpdateFraction() const noexcept;
+    void setSkyViewUpdateFraction(float fraction) noexcept;
+    float getSkyViewAltitudeThreshold() const noexcept;
+    void setSkyViewAltitudeThreshold(float threshold) noexcept;
+    float getSkyViewSunAngleThreshold() const noexcept;
+    void setSkyViewSunAngleThreshold(float threshold) noexcept;
+    float getSkyViewAltitudeQuantum() const noexcept;
+    void setSkyViewAltitudeQuantum(float quantum) noexcept;
+    float getSkyViewSunDirectionQuantum() const noexcept;
+    void setSkyViewSunDirectionQuantum(float quantum) noexcept;
+    std::size_t getSkyViewLutCount() const noexcept;
+    std::size_t getSkyViewBuildsSaved() const noexcept;
 
   private:
     gsl::not_null<Flyweight const *> flyweight_;
+    AtmosphereQuality quality_;
+    AtmosphereSampling sampling_;
     vk::DescriptorPool descriptorPool_;
     GpuBuffer uniformBuffer_;
+    GpuImage transmittanceImage_;
+    vk::ImageView transmittanceImageView_;
+    vk::Framebuffer transmittanceFramebuffer_;
     std::vector<Frame> frames_;
+    std::optional<std::uint64_t> transmittanceVersion_;
     std::shared_ptr<Planet> planet_;
     std::shared_ptr<DirectionalLight> sunLight_;
     std::shared_ptr<DirectionalLight> moonLight_;
+    std::shared_ptr<LutCache> lutCache_;
+    bool computeEnabled_;
+    bool asyncComputeEnabled_;
+    bool analyticTransmittanceEnabled_;
+    std::vector<SkyViewLutEntry> skyViewLuts_;
+    std::uint64_t frameNumber_;
+    std::size_t skyViewBuildsSaved_;
+    float skyViewUpdateFraction_;
+    float skyViewAltitudeThreshold_;
+    float skyViewSunAngleThreshold_;
+    float skyViewAltitudeQuantum_;
+    float skyViewSunDirectionQuantum_;
     bool firstFrame_;
   };
 } // namespace imp
\ No newline at end of file
@@ -1,9 +1,15 @@
 #include "SceneView.h"
 
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
 #include <fstream>
 #include <iostream>
 
+#include "../system/CpuProfiler.h"
 #include "../system/GpuContext.h"
+#include "../system/GpuProfiler.h"
+#include "../system/GpuRenderGraph.h"
 #include "../util/Align.h"
 #include "../util/Math.h"
 #include "Scene.h"
@@ -13,121 +19,101 @@ namespace imp {
   using Eigen::Vector3f;
   using Eigen::Vector4f;
 
+  namespace {
+    constexpr auto PRIMARY_FORMAT_FEATURES =
+        vk::FormatFeatureFlagBits::eSampledImage |
+        vk::FormatFeatureFlagBits::eSampledImageFilterLinear |
+        vk::FormatFeatureFlagBits::eColorAttachment |
+        vk::FormatFeatureFlagBits::eColorAttachmentBlend |
+        vk::FormatFeatureFlagBits::eStorageImage;
+  } // namespace
+
   SceneView::Flyweight::Flyweight(
-      gsl::not_null<GpuContext *> context, std::size_t frameCount):
+      gsl::not_null<GpuContext *> context,
+      gsl::not_null<GpuProfiler *> profiler,
+      std::size_t frameCount,
+      ImageFormats const &formats):
       context_{context},
+      profiler_{profiler},
       frameCount_{frameCount},
+      format_{selectImageFormat(
+          formats.primary,
+          PRIMARY_FORMAT_FEATURES,
+          [context](auto format) {
+            return context->getPhysicalDevice().getFormatProperties(format);
+          },
+          context->isStorageImageWriteWithoutFormatSupported())},
       renderPass_{createRenderPass()},
       nonDestructiveRenderPass_{createNonDestructiveRenderPass()},
-      skyViewDescriptorSetLayout_{createSkyViewDescriptorSetLayout()},
       primaryDescriptorSetLayout_{createPrimaryDescriptorSetLayout()},
       identityDescriptorSetLayout_{createIdentityDescriptorSetLayout()},
+      downsampleDescriptorSetLayout_{createDownsampleDescriptorSetLayout()},
       blurDescriptorSetLayout_{createBlurDescriptorSetLayout()},
       bloomDescriptorSetLayout_{createBloomDescriptorSetLayout()},
-      skyViewPipelineLayout_{createSkyViewPipelineLayout()},
       primaryPipelineLayout_{createPrimaryPipelineLayout()},
       identityPipelineLayout_{createIdentityPipelineLayout()},
+      downsamplePipelineLayout_{createDownsamplePipelineLayout()},
       blurPipelineLayout_{createBlurPipelineLayout()},
       bloomPipelineLayout_{createBloomPipelineLayout()},
-      skyViewPipeline_{createSkyViewPipeline()},
       primaryPipelines_{createPrimaryPipelines()},
       identityPipeline_{createIdentityPipeline()},
+      downsamplePipeline_{createDownsamplePipeline()},
       blurPipelines_{createBlurPipelines()},
       bloomPipeline_{createBloomPipeline()},
       generalSampler_{createGeneralSampler()},
-      skyViewSampler_{createSkyViewSampler()} {}
+      transientHeap_{createTransientHeap()},
+      imagePool_{createImagePool()} {}
 
   vk::RenderPass SceneView::Flyweight::createRenderPass() const {
+    if (context_->isDynamicRenderingEnabled()) {
+      return {};
+    }
     auto attachmentDesc = GpuAttachmentDescription{};
-    attachmentDesc.format = vk::Format::eR16G16B16A16Sfloat;
+    attachmentDesc.format = format_;
     attachmentDesc.samples = vk::SampleCountFlagBits::e1;
-    attachmentDesc.loadOp = vk::AttachmentLoadOp::eDontCare;
+    attachmentDesc.loadOp = vk::AttachmentLoadOp::eClear;
     attachmentDesc.storeOp = vk::AttachmentStoreOp::eStore;
     attachmentDesc.stencilLoadOp = vk::AttachmentLoadOp::eDontCare;
     attachmentDesc.stencilStoreOp = vk::AttachmentStoreOp::eDontCare;
-    attachmentDesc.initialLayout = vk::ImageLayout::eUndefined;
-    attachmentDesc.finalLayout = vk::ImageLayout::eShaderReadOnlyOptimal;
+    attachmentDesc.initialLayout = vk::ImageLayout::eColorAttachmentOptimal;
+    attachmentDesc.finalLayout = vk::ImageLayout::eColorAttachmentOptimal;
     auto attachmentRef = GpuAttachmentReference{};
     attachmentRef.attachment = 0;
     attachmentRef.layout = vk::ImageLayout::eColorAttachmentOptimal;
     auto subpass = GpuSubpassDescription{};
     subpass.pipelineBindPoint = vk::PipelineBindPoint::eGraphics;
     subpass.colorAttachments = {&attachmentRef, 1};
-    auto dependencies = std::array<GpuSubpassDependency, 2>{};
-    dependencies[0].srcSubpass = VK_SUBPASS_EXTERNAL;
-    dependencies[0].dstSubpass = 0;
-    dependencies[0].srcStageMask =
-        vk::PipelineStageFlagBits::eColorAttachmentOutput;
-    dependencies[0].dstStageMask = vk::PipelineStageFlagBits::eFragmentShader;
-    dependencies[0].srcAccessMask = vk::AccessFlagBits::eColorAttachmentWrite;
-    dependencies[0].dstAccessMask = vk::AccessFlagBits::eShaderRead;
-    dependencies[1].srcSubpass = 0;
-    dependencies[1].dstSubpass = VK_SUBPASS_EXTERNAL;
-    dependencies[1].srcStageMask =
-        vk::PipelineStageFlagBits::eColorAttachmentOutput;
-    dependencies[1].dstStageMask = vk::PipelineStageFlagBits::eFragmentShader;
-    dependencies[1].srcAccessMask = vk::AccessFlagBits::eColorAttachmentWrite;
-    dependencies[1].dstAccessMask = vk::AccessFlagBits::eShaderRead;
     auto createInfo = GpuRenderPassCreateInfo{};
     createInfo.attachments = {&attachmentDesc, 1};
     createInfo.subpasses = {&subpass, 1};
-    createInfo.dependencies = dependencies;
     return context_->createRenderPass(createInfo);
   }
 
   vk::RenderPass SceneView::Flyweight::createNonDestructiveRenderPass() const {
+    if (context_->isDynamicRenderingEnabled()) {
+      return {};
+    }
     auto attachmentDesc = GpuAttachmentDescription{};
-    attachmentDesc.format = vk::Format::eR16G16B16A16Sfloat;
+    attachmentDesc.format = format_;
     attachmentDesc.samples = vk::SampleCountFlagBits::e1;
     attachmentDesc.loadOp = vk::AttachmentLoadOp::eLoad;
     attachmentDesc.storeOp = vk::AttachmentStoreOp::eStore;
     attachmentDesc.stencilLoadOp = vk::AttachmentLoadOp::eDontCare;
     attachmentDesc.stencilStoreOp = vk::AttachmentStoreOp::eDontCare;
-    attachmentDesc.initialLayout = vk::ImageLayout::eShaderReadOnlyOptimal;
-    attachmentDesc.finalLayout = vk::ImageLayout::eShaderReadOnlyOptimal;
+    attachmentDesc.initialLayout = vk::ImageLayout::eColorAttachmentOptimal;
+    attachmentDesc.finalLayout = vk::ImageLayout::eColorAttachmentOptimal;
     auto attachmentRef = GpuAttachmentReference{};
     attachmentRef.attachment = 0;
     attachmentRef.layout = vk::ImageLayout::eColorAttachmentOptimal;
     auto subpass = GpuSubpassDescription{};
     subpass.pipelineBindPoint = vk::PipelineBindPoint::eGraphics;
     subpass.colorAttachments = {&attachmentRef, 1};
-    auto dependencies = std::array<GpuSubpassDependency, 2>{};
-    dependencies[0].srcSubpass = VK_SUBPASS_EXTERNAL;
-    dependencies[0].dstSubpass = 0;
-    dependencies[0].srcStageMask = vk::PipelineStageFlagBits::eFragmentShader;
-    dependencies[0].dstStageMask =
-        vk::PipelineStageFlagBits::eColorAttachmentOutput;
-    dependencies[0].srcAccessMask = vk::AccessFlagBits::eShaderRead;
-    dependencies[0].dstAccessMask = vk::AccessFlagBits::eColorAttachmentWrite;
-    dependencies[1].srcSubpass = 0;
-    dependencies[1].dstSubpass = VK_SUBPASS_EXTERNAL;
-    dependencies[1].srcStageMask =
-        vk::PipelineStageFlagBits::eColorAttachmentOutput;
-    dependencies[1].dstStageMask = vk::PipelineStageFlagBits::eFragmentShader;
-    dependencies[1].srcAccessMask = vk::AccessFlagBits::eColorAttachmentWrite;
-    dependencies[1].dstAccessMask = vk::AccessFlagBits::eShaderRead;
     auto createInfo = GpuRenderPassCreateInfo{};
     createInfo.attachments = {&attachmentDesc, 1};
     createInfo.subpasses = {&subpass, 1};
-    createInfo.dependencies = dependencies;
     return context_->createRenderPass(createInfo);
   }
 
-  vk::DescriptorSetLayout
-  SceneView::Flyweight::createSkyViewDescriptorSetLayout() const {
-    auto bindings = std::array<GpuDescriptorSetLayoutBinding, 3>{};
-    bindings[0].descriptorType = vk::DescriptorType::eUniformBuffer;
-    bindings[1].descriptorType = vk::DescriptorType::eUniformBuffer;
-    bindings[2].descriptorType = vk::DescriptorType::eCombinedImageSampler;
-    for (auto &binding : bindings) {
-      binding.descriptorCount = 1;
-      binding.stageFlags = vk::ShaderStageFlagBits::eFragment;
-    }
-    auto createInfo = GpuDescriptorSetLayoutCreateInfo{};
-    createInfo.bindings = bindings;
-    return context_->createDescriptorSetLayout(createInfo);
-  }
-
   vk::DescriptorSetLayout
   SceneView::Flyweight::createPrimaryDescriptorSetLayout() const {
     auto bindings = std::array<GpuDescriptorSetLayoutBinding, 4>{};
@@ -155,6 +141,22 @@ namespace imp {
     return context_->createDescriptorSetLayout(createInfo);
   }
 
+  vk::DescriptorSetLayout
+  SceneView::Flyweight::createDownsampleDescriptorSetLayout() const {
+    auto bindings = std::array<GpuDescriptorSetLayoutBinding, 5>{};
+    bindings[0].descriptorType = vk::DescriptorType::eCombinedImageSampler;
+    for (auto i = 1; i < 5; ++i) {
+      bindings[i].descriptorType = vk::DescriptorType::eStorageImage;
+    }
+    for (auto &binding : bindings) {
+      binding.descriptorCount = 1;
+      binding.stageFlags = vk::ShaderStageFlagBits::eCompute;
+    }
+    auto createInfo = GpuDescriptorSetLayoutCreateInfo{};
+    createInfo.bindings = bindings;
+    return context_->createDescriptorSetLayout(createInfo);
+  }
+
   vk::DescriptorSetLayout
   SceneView::Flyweight::createBlurDescriptorSetLayout() const {
     auto binding = GpuDescriptorSetLayoutBinding{};
@@ -177,12 +179,6 @@ namespace imp {
     return context_->createDescriptorSetLayout(createInfo);
   }
 
-  vk::PipelineLayout SceneView::Flyweight::createSkyViewPipelineLayout() const {
-    auto createInfo = GpuPipelineLayoutCreateInfo{};
-    createInfo.setLayouts = {&skyViewDescriptorSetLayout_, 1};
-    return context_->createPipelineLayout(createInfo);
-  }
-
   vk::PipelineLayout SceneView::Flyweight::createPrimaryPipelineLayout() const {
     auto createInfo = GpuPipelineLayoutCreateInfo{};
     createInfo.setLayouts = {&primaryDescriptorSetLayout_, 1};
@@ -196,6 +192,13 @@ namespace imp {
     return context_->createPipelineLayout(createInfo);
   }
 
+  vk::PipelineLayout
+  SceneView::Flyweight::createDownsamplePipelineLayout() const {
+    auto createInfo = GpuPipelineLayoutCreateInfo{};
+    createInfo.setLayouts = {&downsampleDescriptorSetLayout_, 1};
+    return context_->createPipelineLayout(createInfo);
+  }
+
   vk::PipelineLayout SceneView::Flyweight::createBlurPipelineLayout() const {
     auto pushConstantRange = GpuPushConstantRange{};
     pushConstantRange.stageFlags = vk::ShaderStageFlagBits::eFragment;
@@ -212,7 +215,8 @@ namespace imp {
     return context_->createPipelineLayout(createInfo);
   }
 
-  vk::Pipeline SceneView::Flyweight::createSkyViewPipeline() const {
+  std::map<std::pair<bool, bool>, vk::Pipeline>
+  SceneView::Flyweight::createPrimaryPipelines() const {
     auto vertModule = vk::UniqueShaderModule{};
     {
       auto code = std::vector<char>{};
@@ -233,7 +237,7 @@ namespace imp {
       auto code = std::vector<char>{};
       auto in = std::ifstream{};
       in.exceptions(std::ios::badbit | std::ios::failbit);
-      in.open("./data/SkyViewFrag.spv", std::ios::binary);
+      in.open("./data/PrimaryFrag.spv", std::ios::binary);
       in.seekg(0, std::ios::end);
       code.resize(in.tellg());
       in.seekg(0, std::ios::beg);
@@ -243,6 +247,20 @@ namespace imp {
       createInfo.pCode = reinterpret_cast<std::uint32_t *>(code.data());
       fragModule = context_->getDevice().createShaderModuleUnique(createInfo);
     }
+    auto specializationData = std::array<vk::Bool32, 2>{};
+    auto mapEntries = std::array<vk::SpecializationMapEntry, 2>{};
+    mapEntries[0].constantID = 0;
+    mapEntries[0].offset = 0;
+    mapEntries[0].size = sizeof(vk::Bool32);
+    mapEntries[1].constantID = 4;
+    mapEntries[1].offset = sizeof(vk::Bool32);
+    mapEntries[1].size = sizeof(vk::Bool32);
+    auto specializationInfo = vk::SpecializationInfo{};
+    specializationInfo.mapEntryCount =
+        static_cast<std::uint32_t>(mapEntries.size());
+    specializationInfo.pMapEntries = mapEntries.data();
+    specializationInfo.dataSize = sizeof(specializationData);
+    specializationInfo.pData = specializationData.data();
     auto stages = std::array<vk::PipelineShaderStageCreateInfo, 2>{};
     stages[0].stage = vk::ShaderStageFlagBits::eVertex;
     stages[0].module = *vertModule;
@@ -250,6 +268,7 @@ namespace imp {
     stages[1].stage = vk::ShaderStageFlagBits::eFragment;
     stages[1].module = *fragModule;
     stages[1].pName = "main";
+    stages[1].pSpecializationInfo = &specializationInfo;
     auto vertexInputState = vk::PipelineVertexInputStateCreateInfo{};
     auto inputAssemblyState = vk::PipelineInputAssemblyStateCreateInfo{};
     inputAssemblyState.topology = vk::PrimitiveTopology::eTriangleList;
@@ -283,15 +302,30 @@ namespace imp {
     createInfo.pMultisampleState = &multisampleState;
     createInfo.pColorBlendState = &colorBlendState;
     createInfo.pDynamicState = &dynamicState;
-    createInfo.layout = skyViewPipelineLayout_;
+    createInfo.layout = primaryPipelineLayout_;
+    auto renderingCreateInfo = vk::PipelineRenderingCreateInfoKHR{};
+    renderingCreateInfo.colorAttachmentCount = 1;
+    renderingCreateInfo.pColorAttachmentFormats = &format_;
+    if (context_->isDynamicRenderingEnabled()) {
+      createInfo.pNext = &renderingCreateInfo;
+    }
     createInfo.renderPass = renderPass_;
     createInfo.subpass = 0;
     createInfo.basePipelineIndex = -1;
-    return context_->getDevice().createGraphicsPipeline({}, createInfo).value;
+    auto pipelines = std::map<std::pair<bool, bool>, vk::Pipeline>{};
+    for (auto antiAliasingEnabled : {false, true}) {
+      for (auto analyticTransmittanceEnabled : {false, true}) {
+        specializationData[0] = antiAliasingEnabled;
+        specializationData[1] = analyticTransmittanceEnabled;
+        pipelines.emplace(
+            std::pair{antiAliasingEnabled, analyticTransmittanceEnabled},
+            context_->getDevice().createGraphicsPipeline({}, createInfo).value);
+      }
+    }
+    return pipelines;
   }
 
-  std::unordered_map<bool, vk::Pipeline>
-  SceneView::Flyweight::createPrimaryPipelines() const {
+  vk::Pipeline SceneView::Flyweight::createIdentityPipeline() const {
     auto vertModule = vk::UniqueShaderModule{};
     {
       auto code = std::vector<char>{};
@@ -312,7 +346,7 @@ namespace imp {
       auto code = std::vector<char>{};
       auto in = std::ifstream{};
       in.exceptions(std::ios::badbit | std::ios::failbit);
-      in.open("./data/PrimaryFrag.spv", std::ios::binary);
+      in.open("./data/IdentityFrag.spv", std::ios::binary);
       in.seekg(0, std::ios::end);
       code.resize(in.tellg());
       in.seekg(0, std::ios::beg);
@@ -322,15 +356,6 @@ namespace imp {
       createInfo.pCode = reinterpret_cast<std::uint32_t *>(code.data());
       fragModule = context_->getDevice().createShaderModuleUnique(createInfo);
     }
-    auto mapEntry = vk::SpecializationMapEntry{};
-    mapEntry.constantID = 0;
-    mapEntry.offset = 0;
-    mapEntry.size = 4;
-    auto specializationInfo = vk::SpecializationInfo{};
-    specializationInfo.mapEntryCount = 1;
-    specializationInfo.pMapEntries = &mapEntry;
-    specializationInfo.dataSize = 4;
-    specializationInfo.pData = nullptr;
     auto stages = std::array<vk::PipelineShaderStageCreateInfo, 2>{};
     stages[0].stage = vk::ShaderStageFlagBits::eVertex;
     stages[0].module = *vertModule;
@@ -371,42 +396,30 @@ namespace imp {
     createInfo.pMultisampleState = &multisampleState;
     createInfo.pColorBlendState = &colorBlendState;
     createInfo.pDynamicState = &dynamicState;
-    createInfo.layout = primaryPipelineLayout_;
+    createInfo.layout = identityPipelineLayout_;
+    auto renderingCreateInfo = vk::PipelineRenderingCreateInfoKHR{};
+    renderingCreateInfo.colorAttachmentCount = 1;
+    renderingCreateInfo.pColorAttachmentFormats = &format_;
+    if (context_->isDynamicRenderingEnabled()) {
+      createInfo.pNext = &renderingCreateInfo;
+    }
     createInfo.renderPass = renderPass_;
     createInfo.subpass = 0;
     createInfo.basePipelineIndex = -1;
-    auto pipelines = std::unordered_map<bool, vk::Pipeline>{};
-    for (auto kernelSize : std::vector<std::int32_t>{0, 1}) {
-      specializationInfo.pData = &kernelSize;
-      pipelines.emplace(
-          kernelSize,
-          context_->getDevice().createGraphicsPipeline({}, createInfo).value);
-    }
-    return pipelines;
+    return context_->getDevice().createGraphicsPipeline({}, createInfo).value;
   }
 
-  vk::Pipeline SceneView::Flyweight::createIdentityPipeline() const {
-    auto vertModule = vk::UniqueShaderModule{};
-    {
-      auto code = std::vector<char>{};
-      auto in = std::ifstream{};
-      in.exceptions(std::ios::badbit | std::ios::failbit);
-      in.open("./data/GenericVert.spv", std::ios::binary);
-      in.seekg(0, std::ios::end);
-      code.resize(in.tellg());
-      in.seekg(0, std::ios::beg);
-      in.read(code.data(), code.size());
-      auto createInfo = vk::ShaderModuleCreateInfo{};
-      createInfo.codeSize = code.size();
-      createInfo.pCode = reinterpret_cast<std::uint32_t *>(code.data());
-      vertModule = context_->getDevice().createShaderModuleUnique(createInfo);
-    }
-    auto fragModule = vk::UniqueShaderModule{};
+  vk::Pipeline SceneView::Flyweight::createDownsamplePipeline() const {
+    auto compModule = vk::UniqueShaderModule{};
     {
       auto code = std::vector<char>{};
       auto in = std::ifstream{};
       in.exceptions(std::ios::badbit | std::ios::failbit);
-      in.open("./data/IdentityFrag.spv", std::ios::binary);
+      in.open(
+          format_ == getVkFormat(ImageFormat::RGBA16F)
+              ? "./data/DownsampleComp.spv"
+              : "./data/DownsampleFormatlessComp.spv",
+          std::ios::binary);
       in.seekg(0, std::ios::end);
       code.resize(in.tellg());
       in.seekg(0, std::ios::beg);
@@ -414,53 +427,15 @@ namespace imp {
       auto createInfo = vk::ShaderModuleCreateInfo{};
       createInfo.codeSize = code.size();
       createInfo.pCode = reinterpret_cast<std::uint32_t *>(code.data());
-      fragModule = context_->getDevice().createShaderModuleUnique(createInfo);
+      compModule = context_->getDevice().createShaderModuleUnique(createInfo);
     }
-    auto stages = std::array<vk::PipelineShaderStageCreateInfo, 2>{};
-    stages[0].stage = vk::ShaderStageFlagBits::eVertex;
-    stages[0].module = *vertModule;
-    stages[0].pName = "main";
-    stages[1].stage = vk::ShaderStageFlagBits::eFragment;
-    stages[1].module = *fragModule;
-    stages[1].pName = "main";
-    auto vertexInputState = vk::PipelineVertexInputStateCreateInfo{};
-    auto inputAssemblyState = vk::PipelineInputAssemblyStateCreateInfo{};
-    inputAssemblyState.topology = vk::PrimitiveTopology::eTriangleList;
-    auto viewportState = vk::PipelineViewportStateCreateInfo{};
-    viewportState.viewportCount = 1;
-    viewportState.scissorCount = 1;
-    auto rasterizationState = vk::PipelineRasterizationStateCreateInfo{};
-    rasterizationState.lineWidth = 1.0f;
-    auto multisampleState = vk::PipelineMultisampleStateCreateInfo{};
-    multisampleState.rasterizationSamples = vk::SampleCountFlagBits::e1;
-    auto attachment = vk::PipelineColorBlendAttachmentState{};
-    attachment.colorWriteMask =
-        vk::ColorComponentFlagBits::eR | vk::ColorComponentFlagBits::eG |
-        vk::ColorComponentFlagBits::eB | vk::ColorComponentFlagBits::eA;
-    auto colorBlendState = vk::PipelineColorBlendStateCreateInfo{};
-    colorBlendState.attachmentCount = 1;
-    colorBlendState.pAttachments = &attachment;
-    auto dynamicStates =
-        std::array{vk::DynamicState::eViewport, vk::DynamicState::eScissor};
-    auto dynamicState = vk::PipelineDynamicStateCreateInfo{};
-    dynamicState.dynamicStateCount =
-        static_cast<std::uint32_t>(dynamicStates.size());
-    dynamicState.pDynamicStates = dynamicStates.data();
-    auto createInfo = vk::GraphicsPipelineCreateInfo{};
-    createInfo.stageCount = static_cast<std::uint32_t>(stages.size());
-    createInfo.pStages = stages.data();
-    createInfo.pVertexInputState = &vertexInputState;
-    createInfo.pInputAssemblyState = &inputAssemblyState;
-    createInfo.pViewportState = &viewportState;
-    createInfo.pRasterizationState = &rasterizationState;
-    createInfo.pMultisampleState = &multisampleState;
-    createInfo.pColorBlendState = &colorBlendState;
-    createInfo.pDynamicState = &dynamicState;
-    createInfo.layout = identityPipelineLayout_;
-    createInfo.renderPass = renderPass_;
-    createInfo.subpass = 0;
+    auto createInfo = vk::ComputePipelineCreateInfo{};
+    createInfo.stage.stage = vk::ShaderStageFlagBits::eCompute;
+    createInfo.stage.module = *compModule;
+    createInfo.stage.pName = "main";
+    createInfo.layout = downsamplePipelineLayout_;
     createInfo.basePipelineIndex = -1;
-    return context_->getDevice().createGraphicsPipeline({}, createInfo).value;
+    return context_->getDevice().createComputePipeline({}, createInfo).value;
   }
 
   std::unordered_map<int, vk::Pipeline>
@@ -546,6 +521,12 @@ namespace imp {
     createInfo.pColorBlendState = &colorBlendState;
     createInfo.pDynamicState = &dynamicState;
     createInfo.layout = blurPipelineLayout_;
+    auto renderingCreateInfo = vk::PipelineRenderingCreateInfoKHR{};
+    renderingCreateInfo.colorAttachmentCount = 1;
+    renderingCreateInfo.pColorAttachmentFormats = &format_;
+    if (context_->isDynamicRenderingEnabled()) {
+      createInfo.pNext = &renderingCreateInfo;
+    }
     createInfo.renderPass = renderPass_;
     createInfo.subpass = 0;
     createInfo.basePipelineIndex = -1;
@@ -639,6 +620,12 @@ namespace imp {
     createInfo.pColorBlendState = &colorBlendState;
     createInfo.pDynamicState = &dynamicState;
     createInfo.layout = bloomPipelineLayout_;
+    auto renderingCreateInfo = vk::PipelineRenderingCreateInfoKHR{};
+    renderingCreateInfo.colorAttachmentCount = 1;
+    renderingCreateInfo.pColorAttachmentFormats = &format_;
+    if (context_->isDynamicRenderingEnabled()) {
+      createInfo.pNext = &renderingCreateInfo;
+    }
     createInfo.renderPass = renderPass_;
     createInfo.subpass = 0;
     createInfo.basePipelineIndex = -1;
@@ -656,15 +643,21 @@ namespace imp {
     return context_->createSampler(createInfo);
   }
 
-  vk::Sampler SceneView::Flyweight::createSkyViewSampler() const {
-    auto createInfo = GpuSamplerCreateInfo{};
-    createInfo.magFilter = vk::Filter::eLinear;
-    createInfo.minFilter = vk::Filter::eLinear;
-    createInfo.mipmapMode = vk::SamplerMipmapMode::eNearest;
-    createInfo.addressModeU = vk::SamplerAddressMode::eRepeat;
-    createInfo.addressModeV = vk::SamplerAddressMode::eClampToEdge;
-    createInfo.addressModeW = vk::SamplerAddressMode::eClampToEdge;
-    return context_->createSampler(createInfo);
+  std::unique_ptr<GpuTransientHeap>
+  SceneView::Flyweight::createTransientHeap() const {
+    auto allocation = VmaAllocationCreateInfo{};
+    allocation.usage = VMA_MEMORY_USAGE_GPU_ONLY;
+    return std::make_unique<GpuTransientHeap>(
+        context_->getAllocator(), allocation);
+  }
+
+  std::unique_ptr<GpuImagePool>
+  SceneView::Flyweight::createImagePool() const {
+    auto allocation = VmaAllocationCreateInfo{};
+    allocation.flags = VMA_ALLOCATION_CREATE_DEDICATED_MEMORY_BIT;
+    allocation.usage = VMA_MEMORY_USAGE_GPU_ONLY;
+    return std::make_unique<GpuImagePool>(
+        context_->getAllocator(), allocation, 4 * frameCount_);
   }
 
   SceneView::Flyweight::~Flyweight() {
@@ -673,11 +666,11 @@ namespace imp {
     for (auto [_, pipeline] : blurPipelines_) {
       device.destroy(pipeline);
     }
+    device.destroy(downsamplePipeline_);
     device.destroy(identityPipeline_);
     for (auto [_, pipeline] : primaryPipelines_) {
       device.destroy(pipeline);
     }
-    device.destroy(skyViewPipeline_);
   }
 
   gsl::not_null<GpuContext *>
@@ -685,10 +678,19 @@ namespace imp {
     return context_;
   }
 
+  gsl::not_null<GpuProfiler *>
+  SceneView::Flyweight::getProfiler() const noexcept {
+    return profiler_;
+  }
+
   std::size_t SceneView::Flyweight::getFrameCount() const noexcept {
     return frameCount_;
   }
 
+  vk::Format SceneView::Flyweight::getFormat() const noexcept {
+    return format_;
+  }
+
   vk::RenderPass SceneView::Flyweight::getRenderPass() const noexcept {
     return renderPass_;
   }
@@ -698,11 +700,6 @@ namespace imp {
     return nonDestructiveRenderPass_;
   }
 
-  vk::DescriptorSetLayout
-  SceneView::Flyweight::getSkyViewDescriptorSetLayout() const noexcept {
-    return skyViewDescriptorSetLayout_;
-  }
-
   vk::DescriptorSetLayout
   SceneView::Flyweight::getPrimaryDescriptorSetLayout() const noexcept {
     return primaryDescriptorSetLayout_;
@@ -713,6 +710,11 @@ namespace imp {
     return identityDescriptorSetLayout_;
   }
 
+  vk::DescriptorSetLayout
+  SceneView::Flyweight::getDownsampleDescriptorSetLayout() const noexcept {
+    return downsampleDescriptorSetLayout_;
+  }
+
   vk::DescriptorSetLayout
   SceneView::Flyweight::getBlurDescriptorSetLayout() const noexcept {
     return blurDescriptorSetLayout_;
@@ -723,11 +725,6 @@ namespace imp {
     return bloomDescriptorSetLayout_;
   }
 
-  vk::PipelineLayout
-  SceneView::Flyweight::getSkyViewPipelineLayout() const noexcept {
-    return skyViewPipelineLayout_;
-  }
-
   vk::PipelineLayout
   SceneView::Flyweight::getPrimaryPipelineLayout() const noexcept {
     return primaryPipelineLayout_;
@@ -738,6 +735,11 @@ namespace imp {
     return identityPipelineLayout_;
   }
 
+  vk::PipelineLayout
+  SceneView::Flyweight::getDownsamplePipelineLayout() const noexcept {
+    return downsamplePipelineLayout_;
+  }
+
   vk::PipelineLayout
   SceneView::Flyweight::getBlurPipelineLayout() const noexcept {
     return blurPipelineLayout_;
@@ -748,19 +750,21 @@ namespace imp {
     return bloomPipelineLayout_;
   }
 
-  vk::Pipeline SceneView::Flyweight::getSkyViewPipeline() const noexcept {
-    return skyViewPipeline_;
-  }
-
   vk::Pipeline SceneView::Flyweight::getPrimaryPipeline(
-      bool antiAliasingEnabled) const noexcept {
-    return primaryPipelines_.at(antiAliasingEnabled);
+      bool antiAliasingEnabled,
+      bool analyticTransmittanceEnabled) const noexcept {
+    return primaryPipelines_.at(
+        {antiAliasingEnabled, analyticTransmittanceEnabled});
   }
 
   vk::Pipeline SceneView::Flyweight::getIdentityPipeline() const noexcept {
     return identityPipeline_;
   }
 
+  vk::Pipeline SceneView::Flyweight::getDownsamplePipeline() const noexcept {
+    return downsamplePipeline_;
+  }
+
   vk::Pipeline
   SceneView::Flyweight::getBlurPipeline(int kernelSize) const noexcept {
     return blurPipelines_.at(kernelSize);
@@ -770,21 +774,23 @@ namespace imp {
     return bloomPipeline_;
   }
 
-  vk::Sampler SceneView::Flyweight::getSkyViewSampler() const noexcept {
-    return skyViewSampler_;
-  }
-
   vk::Sampler SceneView::Flyweight::getGeneralSampler() const noexcept {
     return generalSampler_;
   }
 
+  gsl::not_null<GpuTransientHeap *>
+  SceneView::Flyweight::getTransientHeap() const noexcept {
+    return transientHeap_.get();
+  }
+
+  gsl::not_null<GpuImagePool *>
+  SceneView::Flyweight::getImagePool() const noexcept {
+    return imagePool_.get();
+  }
+
   SceneView::Frame::Frame(
-      GpuImage &&skyViewImage,
-      GpuImage &&renderImage,
-      std::vector<GpuImage> &&bloomImages):
-      skyViewImage{std::move(skyViewImage)},
-      primaryImage{std::move(renderImage)},
-      bloomImages{std::move(bloomImages)} {}
+      std::shared_ptr<GpuImage const> renderImage, Extent2u const &extent):
+      primaryImage{std::move(renderImage)}, extent{extent} {}
 
   SceneView::SceneView(
       gsl::not_null<Flyweight const *> flyweight,
@@ -792,6 +798,7 @@ namespace imp {
       Extent2u const &extent) noexcept:
       flyweight_{flyweight},
       scene_{std::move(scene)},
+      name_{"view"},
       extent_{extent},
       descriptorPool_{createDescriptorPool()},
       uniformBuffer_{createUniformBuffer()},
@@ -801,9 +808,12 @@ namespace imp {
       prevViewMatrix_{Matrix4f::Identity()},
       prevProjectionMatrix_{Matrix4f::Identity()},
       exposure_{1.0f},
+      altitude_{0.0f},
+      skyViewSunDirection_{0.0f, 0.0f, 1.0f},
       antiAliasingEnabled_{false},
       antiAliasingAlpha_{0.25f},
       antiAliasingJitter_{0.0f, 0.0f},
+      computeEnabled_{false},
       bloomEnabled_{false},
       bloomBlurCounts_{1, 2, 3, 4},
       bloomBlurSizes_{17, 23, 27, 33},
@@ -811,34 +821,32 @@ namespace imp {
       firstFrame_{true} {
     for (auto i = std::size_t{}; i < frames_.size(); ++i) {
       auto &frame = frames_[i];
-      initSkyViewImageView(frame);
+      initBloomImages(frame);
       initPrimaryImageViews(frame);
       initBloomImageViews(frame);
-      initSkyViewFramebuffer(frame);
       initPrimaryFramebuffers(frame);
       initBloomFramebuffers(frame);
       allocateDescriptorSets(i);
-      initSkyViewDescriptorSet(i);
       initPrimaryDescriptorSet(i);
       initPrimaryImageDescriptorSets(frame);
+      initDownsampleDescriptorSet(frame);
       initBloomTextureDescriptorSets(frame);
       initCommandPool(i);
       initCommandBuffers(i);
-      initSemaphores(i);
     }
   }
 
   vk::DescriptorPool SceneView::createDescriptorPool() const {
     auto frameCount32 = static_cast<std::uint32_t>(flyweight_->getFrameCount());
     auto poolSizes = std::vector<vk::DescriptorPoolSize>{
-        // sky view
-        {vk::DescriptorType::eUniformBuffer, 2 * frameCount32},
-        {vk::DescriptorType::eCombinedImageSampler, 1 * frameCount32},
         // primary
         {vk::DescriptorType::eUniformBuffer, 2 * frameCount32},
         {vk::DescriptorType::eCombinedImageSampler, 2 * frameCount32},
         // primary texture
         {vk::DescriptorType::eCombinedImageSampler, 5 * frameCount32},
+        // downsample
+        {vk::DescriptorType::eCombinedImageSampler, 1 * frameCount32},
+        {vk::DescriptorType::eStorageImage, 4 * frameCount32},
         // bloom texture
         {vk::DescriptorType::eCombinedImageSampler, 8 * frameCount32}};
     auto createInfo = vk::DescriptorPoolCreateInfo{};
@@ -866,95 +874,101 @@ namespace imp {
     auto frames = std::vector<SceneView::Frame>{};
     frames.reserve(flyweight_->getFrameCount());
     for (auto i = std::size_t{}; i < frames.capacity(); ++i) {
-      frames.emplace_back(
-          createSkyViewImage(), createPrimaryImage(), createBloomImages());
+      frames.emplace_back(createPrimaryImage(), extent_);
     }
     return frames;
   }
 
-  GpuImage SceneView::createSkyViewImage() const {
+  std::shared_ptr<GpuImage const> SceneView::createPrimaryImage() const {
     auto image = vk::ImageCreateInfo{};
     image.imageType = vk::ImageType::e2D;
-    image.format = vk::Format::eR16G16B16A16Sfloat;
-    image.extent = SKY_VIEW_IMAGE_EXTENT;
-    image.mipLevels = 1;
-    image.arrayLayers = 1;
-    image.samples = vk::SampleCountFlagBits::e1;
-    image.tiling = vk::ImageTiling::eOptimal;
-    image.usage = vk::ImageUsageFlagBits::eSampled |
-                  vk::ImageUsageFlagBits::eColorAttachment;
-    image.sharingMode = vk::SharingMode::eExclusive;
-    image.initialLayout = vk::ImageLayout::eUndefined;
-    auto allocation = VmaAllocationCreateInfo{};
-    allocation.usage = VMA_MEMORY_USAGE_GPU_ONLY;
-    return GpuImage{
-        flyweight_->getContext()->getAllocator(), image, allocation};
-  }
-
-  GpuImage SceneView::createPrimaryImage() const {
-    auto image = vk::ImageCreateInfo{};
-    image.imageType = vk::ImageType::e2D;
-    image.format = vk::Format::eR16G16B16A16Sfloat;
+    image.format = flyweight_->getFormat();
     image.extent = vk::Extent3D{extent_.width, extent_.height, 1};
     image.mipLevels = 5;
     image.arrayLayers = 1;
     image.samples = vk::SampleCountFlagBits::e1;
     image.tiling = vk::ImageTiling::eOptimal;
     image.usage = vk::ImageUsageFlagBits::eSampled |
-                  vk::ImageUsageFlagBits::eColorAttachment;
-    auto allocation = VmaAllocationCreateInfo{};
-    allocation.flags = VMA_ALLOCATION_CREATE_DEDICATED_MEMORY_BIT;
-    allocation.usage = VMA_MEMORY_USAGE_GPU_ONLY;
-    return GpuImage{
-        flyweight_->getContext()->getAllocator(), image, allocation};
+                  vk::ImageUsageFlagBits::eColorAttachment |
+                  vk::ImageUsageFlagBits::eStorage;
+    return flyweight_->getImagePool()->acquire(image);
   }
 
-  std::vector<GpuImage> SceneView::createBloomImages() const {
+  void SceneView::initBloomImages(Frame &frame) const {
+    auto allocator = flyweight_->getContext()->getAllocator();
     auto image = vk::ImageCreateInfo{};
     image.imageType = vk::ImageType::e2D;
-    image.format = vk::Format::eR16G16B16A16Sfloat;
-    image.extent = vk::Extent3D{extent_.width / 2, extent_.height / 2, 1};
+    image.format = flyweight_->getFormat();
+    image.extent = vk::Extent3D{
+        frame.primaryImage->getExtent().width / 2,
+        frame.primaryImage->getExtent().height / 2,
+        1};
     image.mipLevels = 1;
     image.arrayLayers = 2;
     image.samples = vk::SampleCountFlagBits::e1;
     image.tiling = vk::ImageTiling::eOptimal;
     image.usage = vk::ImageUsageFlagBits::eSampled |
                   vk::ImageUsageFlagBits::eColorAttachment;
-    auto allocation = VmaAllocationCreateInfo{};
-    allocation.usage = VMA_MEMORY_USAGE_GPU_ONLY;
-    auto images = std::vector<GpuImage>{};
+    frame.bloomImages.clear();
+    frame.bloomMemory = nullptr;
     for (auto i = 0; i < 4; ++i) {
-      images.emplace_back(
-          flyweight_->getContext()->getAllocator(), image, allocation);
+      frame.bloomImages.emplace_back(allocator, image);
       image.extent.width /= 2;
       image.extent.height /= 2;
     }
-    return images;
-  }
-
-  void SceneView::initSkyViewImageView(Frame &frame) const {
-    auto createInfo = vk::ImageViewCreateInfo{};
-    createInfo.image = frame.skyViewImage.get();
-    createInfo.viewType = vk::ImageViewType::e2D;
-    createInfo.format = frame.skyViewImage.getFormat();
-    createInfo.components.r = vk::ComponentSwizzle::eIdentity;
-    createInfo.components.g = vk::ComponentSwizzle::eIdentity;
-    createInfo.components.b = vk::ComponentSwizzle::eIdentity;
-    createInfo.components.a = vk::ComponentSwizzle::eIdentity;
-    createInfo.subresourceRange.aspectMask = vk::ImageAspectFlagBits::eColor;
-    createInfo.subresourceRange.baseMipLevel = 0;
-    createInfo.subresourceRange.levelCount = 1;
-    createInfo.subresourceRange.baseArrayLayer = 0;
-    createInfo.subresourceRange.layerCount = 1;
-    frame.skyViewImageView =
-        flyweight_->getContext()->getDevice().createImageView(createInfo);
+    auto graph = GpuRenderGraph{};
+    auto primaryImage =
+        graph.importImage("primary", frame.primaryImage->get(), 5, 1);
+    auto bloomImages = importBloomImages(graph, frame);
+    addBloomPasses(graph, frame, primaryImage, bloomImages);
+    addApplyBloomPass(graph, frame, primaryImage, bloomImages);
+    graph.exportImage(primaryImage, RenderGraph::Usage::FRAGMENT_SAMPLED);
+    graph.compile();
+    auto slots = std::array<std::size_t, 4>{};
+    auto requirements =
+        std::vector<vk::MemoryRequirements>(graph.getSlotCount());
+    for (auto &slotRequirements : requirements) {
+      slotRequirements.memoryTypeBits = ~std::uint32_t{};
+    }
+    for (auto i = 0; i < 4; ++i) {
+      auto imageRequirements = frame.bloomImages[i].getMemoryRequirements();
+      slots[i] =
+          graph.getImageSlot(bloomImages[i]).value_or(requirements.size());
+      if (slots[i] == requirements.size()) {
+        requirements.emplace_back(imageRequirements);
+      } else {
+        auto &slotRequirements = requirements[slots[i]];
+        slotRequirements.size =
+            std::max(slotRequirements.size, imageRequirements.size);
+        slotRequirements.alignment =
+            std::max(slotRequirements.alignment, imageRequirements.alignment);
+        slotRequirements.memoryTypeBits &= imageRequirements.memoryTypeBits;
+      }
+    }
+    auto offsets = std::vector<vk::DeviceSize>{};
+    auto heapRequirements = vk::MemoryRequirements{};
+    heapRequirements.alignment = 1;
+    heapRequirements.memoryTypeBits = ~std::uint32_t{};
+    for (auto &slotRequirements : requirements) {
+      offsets.emplace_back(
+          align(slotRequirements.alignment, heapRequirements.size));
+      heapRequirements.size = offsets.back() + slotRequirements.size;
+      heapRequirements.alignment =
+          std::max(heapRequirements.alignment, slotRequirements.alignment);
+      heapRequirements.memoryTypeBits &= slotRequirements.memoryTypeBits;
+    }
+    frame.bloomMemory =
+        flyweight_->getTransientHeap()->acquire(heapRequirements);
+    for (auto i = 0; i < 4; ++i) {
+      frame.bloomImages[i].bind(*frame.bloomMemory, offsets[slots[i]]);
+    }
   }
 
   void SceneView::initPrimaryImageViews(Frame &frame) const {
     auto createInfo = vk::ImageViewCreateInfo{};
-    createInfo.image = frame.primaryImage.get();
+    createInfo.image = frame.primaryImage->get();
     createInfo.viewType = vk::ImageViewType::e2D;
-    createInfo.format = frame.primaryImage.getFormat();
+    createInfo.format = frame.primaryImage->getFormat();
     createInfo.subresourceRange.aspectMask = vk::ImageAspectFlagBits::eColor;
     createInfo.subresourceRange.levelCount = 1;
     createInfo.subresourceRange.baseArrayLayer = 0;
@@ -986,26 +1000,17 @@ namespace imp {
     }
   }
 
-  void SceneView::initSkyViewFramebuffer(Frame &frame) const {
-    auto createInfo = vk::FramebufferCreateInfo{};
-    createInfo.renderPass = flyweight_->getRenderPass();
-    createInfo.attachmentCount = 1;
-    createInfo.pAttachments = &frame.skyViewImageView;
-    createInfo.width = frame.skyViewImage.getExtent().width;
-    createInfo.height = frame.skyViewImage.getExtent().height;
-    createInfo.layers = 1;
-    frame.skyViewFramebuffer =
-        flyweight_->getContext()->getDevice().createFramebuffer(createInfo);
-  }
-
   void SceneView::initPrimaryFramebuffers(Frame &frame) const {
+    frame.primaryFramebuffers.clear();
+    if (flyweight_->getContext()->isDynamicRenderingEnabled()) {
+      return;
+    }
     auto createInfo = vk::FramebufferCreateInfo{};
     createInfo.renderPass = flyweight_->getRenderPass();
     createInfo.attachmentCount = 1;
-    createInfo.width = frame.primaryImage.getExtent().width;
-    createInfo.height = frame.primaryImage.getExtent().height;
+    createInfo.width = frame.primaryImage->getExtent().width;
+    createInfo.height = frame.primaryImage->getExtent().height;
     createInfo.layers = 1;
-    frame.primaryFramebuffers.clear();
     for (auto i = 0; i < 5; ++i) {
       createInfo.pAttachments = &frame.primaryImageViews[i];
       frame.primaryFramebuffers.emplace_back(
@@ -1016,13 +1021,16 @@ namespace imp {
   }
 
   void SceneView::initBloomFramebuffers(Frame &frame) const {
+    frame.bloomFramebuffers.clear();
+    if (flyweight_->getContext()->isDynamicRenderingEnabled()) {
+      return;
+    }
     auto createInfo = vk::FramebufferCreateInfo{};
     createInfo.renderPass = flyweight_->getRenderPass();
     createInfo.attachmentCount = 1;
-    createInfo.width = frame.primaryImage.getExtent().width / 2;
-    createInfo.height = frame.primaryImage.getExtent().height / 2;
+    createInfo.width = frame.primaryImage->getExtent().width / 2;
+    createInfo.height = frame.primaryImage->getExtent().height / 2;
     createInfo.layers = 1;
-    frame.bloomFramebuffers.clear();
     for (auto i = 0; i < 4; ++i) {
       for (auto j = 0; j < 2; ++j) {
         createInfo.pAttachments = &frame.bloomImageViews[2 * i + j];
@@ -1038,72 +1046,48 @@ namespace imp {
   void SceneView::allocateDescriptorSets(std::size_t i) {
     auto &frame = frames_[i];
     auto device = flyweight_->getContext()->getDevice();
-    auto skyViewSetLayout = flyweight_->getSkyViewDescriptorSetLayout();
     auto primarySetLayout = flyweight_->getPrimaryDescriptorSetLayout();
     auto postProcessSetLayout = flyweight_->getIdentityDescriptorSetLayout();
     auto allocateInfo = vk::DescriptorSetAllocateInfo{};
     allocateInfo.descriptorPool = descriptorPool_;
     allocateInfo.descriptorSetCount = 1;
-    allocateInfo.pSetLayouts = &skyViewSetLayout;
-    device.allocateDescriptorSets(&allocateInfo, &frame.skyViewDescriptorSet);
     allocateInfo.pSetLayouts = &primarySetLayout;
     device.allocateDescriptorSets(&allocateInfo, &frame.primaryDescriptorSet);
     allocateInfo.descriptorSetCount = 1;
     allocateInfo.pSetLayouts = &postProcessSetLayout;
     frame.primaryTextureDescriptorSets.resize(
-        frame.primaryImage.getMipLevels());
+        frame.primaryImage->getMipLevels());
     for (auto &set : frame.primaryTextureDescriptorSets) {
       device.allocateDescriptorSets(&allocateInfo, &set);
     }
+    auto downsampleSetLayout = flyweight_->getDownsampleDescriptorSetLayout();
+    allocateInfo.pSetLayouts = &downsampleSetLayout;
+    device.allocateDescriptorSets(
+        &allocateInfo, &frame.downsampleDescriptorSet);
+    allocateInfo.pSetLayouts = &postProcessSetLayout;
     frame.bloomTextureDescriptorSets.resize(
-        2 * frame.primaryImage.getMipLevels() - 2);
+        2 * frame.primaryImage->getMipLevels() - 2);
     for (auto &set : frame.bloomTextureDescriptorSets) {
       device.allocateDescriptorSets(&allocateInfo, &set);
     }
   }
 
-  void SceneView::initSkyViewDescriptorSet(std::size_t i) {
+  void SceneView::initPrimaryDescriptorSet(std::size_t i) {
     auto &frame = frames_[i];
-    auto info = vk::DescriptorBufferInfo{};
-    info.buffer = uniformBuffer_.get();
-    info.offset = UNIFORM_BUFFER_STRIDE * i;
-    info.range = UNIFORM_BUFFER_SIZE;
+    auto sceneViewBufferInfo = vk::DescriptorBufferInfo{};
+    sceneViewBufferInfo.buffer = uniformBuffer_.get();
+    sceneViewBufferInfo.offset = UNIFORM_BUFFER_STRIDE * i;
+    sceneViewBufferInfo.range = UNIFORM_BUFFER_SIZE;
     auto write = vk::WriteDescriptorSet{};
-    write.dstSet = frame.skyViewDescriptorSet;
+    write.dstSet = frame.primaryDescriptorSet;
     write.dstBinding = 1;
     write.dstArrayElement = 0;
     write.descriptorCount = 1;
     write.descriptorType = vk::DescriptorType::eUniformBuffer;
-    write.pBufferInfo = &info;
+    write.pBufferInfo = &sceneViewBufferInfo;
     flyweight_->getContext()->getDevice().updateDescriptorSets(write, {});
   }
 
-  void SceneView::initPrimaryDescriptorSet(std::size_t i) {
-    auto &frame = frames_[i];
-    auto sceneViewBufferInfo = vk::DescriptorBufferInfo{};
-    sceneViewBufferInfo.buffer = uniformBuffer_.get();
-    sceneViewBufferInfo.offset = UNIFORM_BUFFER_STRIDE * i;
-    sceneViewBufferInfo.range = UNIFORM_BUFFER_SIZE;
-    auto skyViewTextureInfo = vk::DescriptorImageInfo{};
-    skyViewTextureInfo.sampler = flyweight_->getSkyViewSampler();
-    skyViewTextureInfo.imageView = frame.skyViewImageView;
-    skyViewTextureInfo.imageLayout = vk::ImageLayout::eShaderReadOnlyOptimal;
-    auto writes = std::array<vk::WriteDescriptorSet, 2>{};
-    writes[0].dstSet = frame.primaryDescriptorSet;
-    writes[0].dstBinding = 1;
-    writes[0].dstArrayElement = 0;
-    writes[0].descriptorCount = 1;
-    writes[0].descriptorType = vk::DescriptorType::eUniformBuffer;
-    writes[0].pBufferInfo = &sceneViewBufferInfo;
-    writes[1].dstSet = frame.primaryDescriptorSet;
-    writes[1].dstBinding = 3;
-    writes[1].dstArrayElement = 0;
-    writes[1].descriptorCount = 1;
-    writes[1].descriptorType = vk::DescriptorType::eCombinedImageSampler;
-    writes[1].pImageInfo = &skyViewTextureInfo;
-    flyweight_->getContext()->getDevice().updateDescriptorSets(writes, {});
-  }
-
   void SceneView::initPrimaryImageDescriptorSets(Frame &frame) const {
     auto info = vk::DescriptorImageInfo{};
     info.sampler = flyweight_->getGeneralSampler();
@@ -1121,6 +1105,32 @@ namespace imp {
     }
   }
 
+  void SceneView::initDownsampleDescriptorSet(Frame &frame) const {
+    auto srcInfo = vk::DescriptorImageInfo{};
+    srcInfo.sampler = flyweight_->getGeneralSampler();
+    srcInfo.imageView = frame.primaryImageViews[0];
+    srcInfo.imageLayout = vk::ImageLayout::eShaderReadOnlyOptimal;
+    auto dstInfos = std::array<vk::DescriptorImageInfo, 4>{};
+    auto writes = std::array<vk::WriteDescriptorSet, 5>{};
+    writes[0].dstSet = frame.downsampleDescriptorSet;
+    writes[0].dstBinding = 0;
+    writes[0].dstArrayElement = 0;
+    writes[0].descriptorCount = 1;
+    writes[0].descriptorType = vk::DescriptorType::eCombinedImageSampler;
+    writes[0].pImageInfo = &srcInfo;
+    for (auto i = 0; i < 4; ++i) {
+      dstInfos[i].imageView = frame.primaryImageViews[i + 1];
+      dstInfos[i].imageLayout = vk::ImageLayout::eGeneral;
+      writes[i + 1].dstSet = frame.downsampleDescriptorSet;
+      writes[i + 1].dstBinding = i + 1;
+      writes[i + 1].dstArrayElement = 0;
+      writes[i + 1].descriptorCount = 1;
+      writes[i + 1].descriptorType = vk::DescriptorType::eStorageImage;
+      writes[i + 1].pImageInfo = &dstInfos[i];
+    }
+    flyweight_->getContext()->getDevice().updateDescriptorSets(writes, {});
+  }
+
   void SceneView::initBloomTextureDescriptorSets(Frame &frame) const {
     auto info = vk::DescriptorImageInfo{};
     info.sampler = flyweight_->getGeneralSampler();
@@ -1155,15 +1165,9 @@ namespace imp {
     device.allocateCommandBuffers(&allocateInfo, &frames_[i].commandBuffer);
   }
 
-  void SceneView::initSemaphores(std::size_t i) {
-    auto device = flyweight_->getContext()->getDevice();
-    frames_[i].semaphore = device.createSemaphore({});
-  }
-
   SceneView::~SceneView() {
     auto device = flyweight_->getContext()->getDevice();
     for (auto &frame : frames_) {
-      device.destroy(frame.semaphore);
       device.destroy(frame.commandPool);
       for (auto framebuffer : frame.bloomFramebuffers) {
         device.destroy(framebuffer);
@@ -1171,35 +1175,45 @@ namespace imp {
       for (auto framebuffer : frame.primaryFramebuffers) {
         device.destroy(framebuffer);
       }
-      device.destroy(frame.skyViewFramebuffer);
       for (auto imageView : frame.bloomImageViews) {
         device.destroy(imageView);
       }
       for (auto imageView : frame.primaryImageViews) {
         device.destroy(imageView);
       }
-      device.destroy(frame.skyViewImageView);
     }
     device.destroy(descriptorPool_);
   }
 
-  void SceneView::render(std::size_t i) {
-    auto &context = *flyweight_->getContext();
-    auto queue = context.getComputeQueue();
-    auto device = context.getDevice();
+  vk::CommandBuffer SceneView::render(std::size_t i) {
+    auto commandBuffer = beginRender(i);
+    endRender(i);
+    return commandBuffer;
+  }
+
+  vk::CommandBuffer SceneView::beginRender(std::size_t i) {
+    IMP_CPU_ZONE("SceneView::beginRender");
+    auto device = flyweight_->getContext()->getDevice();
     auto &frame = frames_[i];
     updateUniformBuffer(i);
-    if (frame.primaryImage.getExtent() !=
-        Extent3u{extent_.width, extent_.height, 1}) {
+    frame.extent = extent_;
+    if (frame.primaryImage->getExtent() !=
+        Extent3u{flyweight_->getImagePool()->getSizeClass(extent_)}) {
       updateRenderImages(i);
+    } else if (!flyweight_->getTransientHeap()->isCurrent(*frame.bloomMemory)) {
+      updateBloomImages(i);
     }
-    if (frame.scene != scene_) {
-      updateSkyViewDescriptorSet(i);
-      updatePrimaryDescriptorSet(i);
-      frame.scene = scene_;
-    }
+    updatePrimaryDescriptorSet(i);
+    frame.scene = scene_;
     device.resetCommandPool(frame.commandPool);
-    submitCommands(i);
+    frame.commandBuffer.begin({vk::CommandBufferUsageFlagBits::eOneTimeSubmit});
+    computeSkyViewImage(i);
+    return frame.commandBuffer;
+  }
+
+  void SceneView::endRender(std::size_t i) {
+    IMP_CPU_ZONE("SceneView::endRender");
+    recordCommands(i);
     prevViewMatrix_ = viewMatrix_;
     prevProjectionMatrix_ = projectionMatrix_;
     antiAliasingJitter_ = nextLds(antiAliasingJitter_);
@@ -1209,25 +1223,32 @@ namespace imp {
   void SceneView::updateRenderImages(std::size_t i) {
     auto device = flyweight_->getContext()->getDevice();
     auto &frame = frames_[i];
-    for (auto framebuffer : frame.bloomFramebuffers) {
-      device.destroy(framebuffer);
-    }
     for (auto framebuffer : frame.primaryFramebuffers) {
       device.destroy(framebuffer);
     }
-    for (auto imageView : frame.bloomImageViews) {
-      device.destroy(imageView);
-    }
     for (auto imageView : frame.primaryImageViews) {
       device.destroy(imageView);
     }
     frame.primaryImage = createPrimaryImage();
-    frame.bloomImages = createBloomImages();
     initPrimaryImageViews(frame);
-    initBloomImageViews(frame);
     initPrimaryFramebuffers(frame);
-    initBloomFramebuffers(frame);
     initPrimaryImageDescriptorSets(frame);
+    initDownsampleDescriptorSet(frame);
+    updateBloomImages(i);
+  }
+
+  void SceneView::updateBloomImages(std::size_t i) {
+    auto device = flyweight_->getContext()->getDevice();
+    auto &frame = frames_[i];
+    for (auto framebuffer : frame.bloomFramebuffers) {
+      device.destroy(framebuffer);
+    }
+    for (auto imageView : frame.bloomImageViews) {
+      device.destroy(imageView);
+    }
+    initBloomImages(frame);
+    initBloomImageViews(frame);
+    initBloomFramebuffers(frame);
     initBloomTextureDescriptorSets(frame);
   }
 
@@ -1296,33 +1317,8 @@ namespace imp {
     std::memcpy(data + 148, &altitude, 4);
     std::memcpy(data + 152, &exposure_, 4);
     uniformBuffer_.flush(offset, UNIFORM_BUFFER_SIZE);
-  }
-
-  void SceneView::updateSkyViewDescriptorSet(std::size_t i) {
-    auto sceneBufferInfo = vk::DescriptorBufferInfo{};
-    sceneBufferInfo.buffer = scene_->getUniformBuffer().get();
-    sceneBufferInfo.offset = Scene::UNIFORM_BUFFER_STRIDE * i;
-    sceneBufferInfo.range = Scene::UNIFORM_BUFFER_SIZE;
-    auto transmittanceImageInfo = vk::DescriptorImageInfo{};
-    transmittanceImageInfo.sampler =
-        scene_->getFlyweight()->getTransmittanceSampler();
-    transmittanceImageInfo.imageView = scene_->getTransmittanceImageView(i);
-    transmittanceImageInfo.imageLayout =
-        vk::ImageLayout::eShaderReadOnlyOptimal;
-    auto writes = std::array<vk::WriteDescriptorSet, 2>{};
-    writes[0].dstSet = frames_[i].skyViewDescriptorSet;
-    writes[0].dstBinding = 0;
-    writes[0].dstArrayElement = 0;
-    writes[0].descriptorCount = 1;
-    writes[0].descriptorType = vk::DescriptorType::eUniformBuffer;
-    writes[0].pBufferInfo = &sceneBufferInfo;
-    writes[1].dstSet = frames_[i].skyViewDescriptorSet;
-    writes[1].dstBinding = 2;
-    writes[1].dstArrayElement = 0;
-    writes[1].descriptorCount = 1;
-    writes[1].descriptorType = vk::DescriptorType::eCombinedImageSampler;
-    writes[1].pImageInfo = &transmittanceImageInfo;
-    flyweight_->getContext()->getDevice().updateDescriptorSets(writes, {});
+    altitude_ = altitude;
+    skyViewSunDirection_ = skyViewSunDirection;
   }
 
   void SceneView::updatePrimaryDescriptorSet(std::size_t i) {
@@ -1340,7 +1336,7 @@ namespace imp {
     auto transmittanceImageInfo = vk::DescriptorImageInfo{};
     transmittanceImageInfo.sampler =
         scene_->getFlyweight()->getTransmittanceSampler();
-    transmittanceImageInfo.imageView = scene_->getTransmittanceImageView(i);
+    transmittanceImageInfo.imageView = scene_->getTransmittanceImageView();
     transmittanceImageInfo.imageLayout =
         vk::ImageLayout::eShaderReadOnlyOptimal;
     auto transmittanceLutWrite = vk::WriteDescriptorSet{};
@@ -1355,138 +1351,276 @@ namespace imp {
         {sceneBufferWrite, transmittanceLutWrite}, {});
   }
 
-  void SceneView::submitCommands(std::size_t i) {
+  void SceneView::recordCommands(std::size_t i) {
     auto &frame = frames_[i];
-    frame.commandBuffer.begin({vk::CommandBufferUsageFlagBits::eOneTimeSubmit});
-    computeSkyViewImage(i);
-    computeRenderImage(i);
-    computeRenderImageMips(i);
+    auto graph = GpuRenderGraph{};
+    auto primaryImage =
+        graph.importImage("primary", frame.primaryImage->get(), 5, 1);
+    auto bloomImages = importBloomImages(graph, frame);
+    addPrimaryPasses(graph, frame, primaryImage);
+    addBloomPasses(graph, frame, primaryImage, bloomImages);
     if (bloomEnabled_) {
-      renderBloom(frame);
-      applyBloom(i);
+      addApplyBloomPass(graph, frame, primaryImage, bloomImages);
     }
+    graph.exportImage(primaryImage, RenderGraph::Usage::FRAGMENT_SAMPLED);
+    graph.setExternalTransientUsages(
+        RenderGraph::getFlag(RenderGraph::Usage::COLOR_ATTACHMENT) |
+        RenderGraph::getFlag(RenderGraph::Usage::FRAGMENT_SAMPLED));
+    graph.execute(frame.commandBuffer);
     frame.commandBuffer.end();
-    auto submitInfo = vk::SubmitInfo{};
-    submitInfo.commandBufferCount = 1;
-    submitInfo.pCommandBuffers = &frame.commandBuffer;
-    flyweight_->getContext()->getGraphicsQueue().submit(submitInfo);
   }
 
   void SceneView::computeSkyViewImage(std::size_t i) {
     auto &frame = frames_[i];
-    auto clearValue = vk::ClearValue{};
-    auto renderPassBegin = vk::RenderPassBeginInfo{};
-    renderPassBegin.renderPass = flyweight_->getRenderPass();
-    renderPassBegin.framebuffer = frame.skyViewFramebuffer;
-    renderPassBegin.renderArea.extent.width =
-        frame.skyViewImage.getExtent().width;
-    renderPassBegin.renderArea.extent.height =
-        frame.skyViewImage.getExtent().height;
-    renderPassBegin.clearValueCount = 1;
-    renderPassBegin.pClearValues = &clearValue;
-    frame.commandBuffer.beginRenderPass(
-        renderPassBegin, vk::SubpassContents::eInline);
+    auto &lut = scene_->acquireSkyViewLut(
+        frame.commandBuffer, i, altitude_, skyViewSunDirection_);
+    auto imageInfo = vk::DescriptorImageInfo{};
+    imageInfo.sampler = scene_->getFlyweight()->getSkyViewSampler();
+    imageInfo.imageView = lut.getImageView();
+    imageInfo.imageLayout = vk::ImageLayout::eShaderReadOnlyOptimal;
+    auto write = vk::WriteDescriptorSet{};
+    write.dstSet = frame.primaryDescriptorSet;
+    write.dstBinding = 3;
+    write.dstArrayElement = 0;
+    write.descriptorCount = 1;
+    write.descriptorType = vk::DescriptorType::eCombinedImageSampler;
+    write.pImageInfo = &imageInfo;
+    flyweight_->getContext()->getDevice().updateDescriptorSets(write, {});
+  }
+
+  RenderGraph::PassHandle SceneView::addPass(
+      GpuRenderGraph &graph,
+      Frame &frame,
+      std::string name,
+      std::function<void()> execute) const {
+    return graph.addPass(
+        name, [this, &frame, name, execute = std::move(execute)]() {
+          auto profiler = flyweight_->getProfiler();
+          auto scope = profiler->begin(frame.commandBuffer, name_, name);
+          execute();
+          profiler->end(frame.commandBuffer, scope);
+        });
+  }
+
+  SceneView::BloomImages SceneView::importBloomImages(
+      GpuRenderGraph &graph, Frame const &frame) const {
+    auto images = BloomImages{};
+    for (auto i = 0; i < 4; ++i) {
+      images[i] = graph.addTransientImage(
+          "bloom " + std::to_string(i),
+          frame.bloomImages[i].get(),
+          1,
+          2,
+          frame.bloomImages[i].getMemoryRequirements().size);
+    }
+    return images;
+  }
+
+  void SceneView::addPrimaryPasses(
+      GpuRenderGraph &graph,
+      Frame &frame,
+      RenderGraph::ImageHandle primaryImage) const {
+    using Usage = RenderGraph::Usage;
+    auto primary = addPass(graph, frame, "primary", [this, &frame]() {
+      computeRenderImage(frame);
+    });
+    graph.write(primary, primaryImage, {0, 1, 0, 1}, Usage::COLOR_ATTACHMENT);
+    if (computeEnabled_) {
+      auto mips = addPass(graph, frame, "mips", [this, &frame]() {
+        dispatchRenderImageMips(frame);
+      });
+      graph.read(mips, primaryImage, {0, 1, 0, 1}, Usage::COMPUTE_SAMPLED);
+      graph.write(mips, primaryImage, {1, 4, 0, 1}, Usage::COMPUTE_STORAGE);
+    } else {
+      for (auto level = 1u; level < 5; ++level) {
+        auto mip = addPass(
+            graph,
+            frame,
+            "mip " + std::to_string(level),
+            [this, &frame, level]() { renderRenderImageMip(frame, level); });
+        graph.read(
+            mip, primaryImage, {level - 1, 1, 0, 1}, Usage::FRAGMENT_SAMPLED);
+        graph.write(
+            mip, primaryImage, {level, 1, 0, 1}, Usage::COLOR_ATTACHMENT);
+      }
+    }
+  }
+
+  void SceneView::addBloomPasses(
+      GpuRenderGraph &graph,
+      Frame &frame,
+      RenderGraph::ImageHandle primaryImage,
+      BloomImages const &bloomImages) const {
+    using Usage = RenderGraph::Usage;
+    for (auto i = 4u; i-- > 0;) {
+      for (auto j = 0u; j < bloomBlurCounts_[i]; ++j) {
+        auto name =
+            "bloom blur " + std::to_string(i) + "." + std::to_string(j);
+        auto x = addPass(graph, frame, name + " x", [this, &frame, i, j]() {
+          renderBloomBlur(frame, i, j, false);
+        });
+        if (j == 0) {
+          graph.read(
+              x, primaryImage, {i + 1, 1, 0, 1}, Usage::FRAGMENT_SAMPLED);
+        } else {
+          graph.read(x, bloomImages[i], {0, 1, 1, 1}, Usage::FRAGMENT_SAMPLED);
+        }
+        graph.write(x, bloomImages[i], {0, 1, 0, 1}, Usage::COLOR_ATTACHMENT);
+        auto y = addPass(graph, frame, name + " y", [this, &frame, i, j]() {
+          renderBloomBlur(frame, i, j, true);
+        });
+        graph.read(y, bloomImages[i], {0, 1, 0, 1}, Usage::FRAGMENT_SAMPLED);
+        if (i != 3 && j + 1 == bloomBlurCounts_[i]) {
+          graph.read(
+              y, bloomImages[i + 1], {0, 1, 1, 1}, Usage::FRAGMENT_SAMPLED);
+        }
+        graph.write(y, bloomImages[i], {0, 1, 1, 1}, Usage::COLOR_ATTACHMENT);
+      }
+    }
+  }
+
+  void SceneView::addApplyBloomPass(
+      GpuRenderGraph &graph,
+      Frame &frame,
+      RenderGraph::ImageHandle primaryImage,
+      BloomImages const &bloomImages) const {
+    using Usage = RenderGraph::Usage;
+    auto pass = addPass(
+        graph, frame, "apply bloom", [this, &frame]() { applyBloom(frame); });
+    graph.read(pass, bloomImages[0], {0, 1, 1, 1}, Usage::FRAGMENT_SAMPLED);
+    graph.read(pass, primaryImage, {0, 1, 0, 1}, Usage::COLOR_ATTACHMENT);
+    graph.write(pass, primaryImage, {0, 1, 0, 1}, Usage::COLOR_ATTACHMENT);
+  }
+
+  void SceneView::beginRendering(
+      Frame &frame,
+      gsl::span<vk::ImageView const> imageViews,
+      gsl::span<vk::Framebuffer const> framebuffers,
+      std::size_t index,
+      vk::Extent2D const &extent,
+      bool load) const {
+    auto context = flyweight_->getContext();
+    if (context->isDynamicRenderingEnabled()) {
+      auto attachment = vk::RenderingAttachmentInfoKHR{};
+      attachment.imageView = imageViews[index];
+      attachment.imageLayout = vk::ImageLayout::eColorAttachmentOptimal;
+      attachment.loadOp =
+          load ? vk::AttachmentLoadOp::eLoad : vk::AttachmentLoadOp::eClear;
+      attachment.storeOp = vk::AttachmentStoreOp::eStore;
+      auto renderingInfo = vk::RenderingInfoKHR{};
+      renderingInfo.renderArea.extent = extent;
+      renderingInfo.layerCount = 1;
+      renderingInfo.colorAttachmentCount = 1;
+      renderingInfo.pColorAttachments = &attachment;
+      context->beginRendering(frame.commandBuffer, renderingInfo);
+    } else {
+      auto clearValue = vk::ClearValue{};
+      auto renderPassBegin = vk::RenderPassBeginInfo{};
+      renderPassBegin.renderPass =
+          load ? flyweight_->getNonDestructiveRenderPass()
+               : flyweight_->getRenderPass();
+      renderPassBegin.framebuffer = framebuffers[index];
+      renderPassBegin.renderArea.extent = extent;
+      renderPassBegin.clearValueCount = 1;
+      renderPassBegin.pClearValues = &clearValue;
+      frame.commandBuffer.beginRenderPass(
+          renderPassBegin, vk::SubpassContents::eInline);
+    }
+  }
+
+  void SceneView::endRendering(Frame &frame) const {
+    auto context = flyweight_->getContext();
+    if (context->isDynamicRenderingEnabled()) {
+      context->endRendering(frame.commandBuffer);
+    } else {
+      frame.commandBuffer.endRenderPass();
+    }
+  }
+
+  vk::Rect2D
+  SceneView::getRenderArea(Frame const &frame, unsigned level) const noexcept {
+    auto renderArea = vk::Rect2D{};
+    renderArea.extent.width = std::max(frame.extent.width >> level, 1u);
+    renderArea.extent.height = std::max(frame.extent.height >> level, 1u);
+    return renderArea;
+  }
+
+  void SceneView::computeRenderImage(Frame &frame) const {
+    auto extent = vk::Extent2D{
+        frame.primaryImage->getExtent().width,
+        frame.primaryImage->getExtent().height};
+    beginRendering(
+        frame, frame.primaryImageViews, frame.primaryFramebuffers, 0, extent);
     frame.commandBuffer.bindPipeline(
-        vk::PipelineBindPoint::eGraphics, flyweight_->getSkyViewPipeline());
+        vk::PipelineBindPoint::eGraphics,
+        flyweight_->getPrimaryPipeline(
+            !firstFrame_ && antiAliasingEnabled_,
+            scene_->isAnalyticTransmittanceEnabled()));
+    auto renderArea = getRenderArea(frame, 0);
     auto viewport = vk::Viewport{};
-    viewport.width = renderPassBegin.renderArea.extent.width;
-    viewport.height = renderPassBegin.renderArea.extent.height;
+    viewport.width = renderArea.extent.width;
+    viewport.height = renderArea.extent.height;
     frame.commandBuffer.setViewport(0, viewport);
-    auto scissor = vk::Rect2D{};
-    scissor.extent.width = renderPassBegin.renderArea.extent.width;
-    scissor.extent.height = renderPassBegin.renderArea.extent.height;
-    frame.commandBuffer.setScissor(0, scissor);
+    frame.commandBuffer.setScissor(0, renderArea);
     frame.commandBuffer.bindDescriptorSets(
         vk::PipelineBindPoint::eGraphics,
-        flyweight_->getSkyViewPipelineLayout(),
+        flyweight_->getPrimaryPipelineLayout(),
         0,
-        frame.skyViewDescriptorSet,
+        frame.primaryDescriptorSet,
         {});
     frame.commandBuffer.draw(3, 1, 0, 0);
-    frame.commandBuffer.endRenderPass();
-  }
-
-  void SceneView::computeRenderImage(std::size_t i) {
-    auto &frame = frames_[i];
-    auto clearValue = vk::ClearValue{};
-    auto renderPassBegin = vk::RenderPassBeginInfo{};
-    renderPassBegin.renderPass = flyweight_->getRenderPass();
-    renderPassBegin.framebuffer = frame.primaryFramebuffers[0];
-    renderPassBegin.renderArea.extent.width =
-        frame.primaryImage.getExtent().width;
-    renderPassBegin.renderArea.extent.height =
-        frame.primaryImage.getExtent().height;
-    renderPassBegin.clearValueCount = 1;
-    renderPassBegin.pClearValues = &clearValue;
-    frame.commandBuffer.beginRenderPass(
-        renderPassBegin, vk::SubpassContents::eInline);
+    endRendering(frame);
+  }
+
+  void SceneView::renderRenderImageMip(Frame &frame, unsigned level) const {
+    auto extent = vk::Extent2D{
+        frame.primaryImage->getExtent().width >> level,
+        frame.primaryImage->getExtent().height >> level};
+    beginRendering(
+        frame,
+        frame.primaryImageViews,
+        frame.primaryFramebuffers,
+        level,
+        extent);
     frame.commandBuffer.bindPipeline(
-        vk::PipelineBindPoint::eGraphics,
-        flyweight_->getPrimaryPipeline(!firstFrame_ && antiAliasingEnabled_));
+        vk::PipelineBindPoint::eGraphics, flyweight_->getIdentityPipeline());
     auto viewport = vk::Viewport{};
-    viewport.width = renderPassBegin.renderArea.extent.width;
-    viewport.height = renderPassBegin.renderArea.extent.height;
+    viewport.width = extent.width;
+    viewport.height = extent.height;
     frame.commandBuffer.setViewport(0, viewport);
-    auto scissor = vk::Rect2D{};
-    scissor.extent.width = renderPassBegin.renderArea.extent.width;
-    scissor.extent.height = renderPassBegin.renderArea.extent.height;
-    frame.commandBuffer.setScissor(0, scissor);
+    frame.commandBuffer.setScissor(0, getRenderArea(frame, level));
     frame.commandBuffer.bindDescriptorSets(
         vk::PipelineBindPoint::eGraphics,
-        flyweight_->getPrimaryPipelineLayout(),
+        flyweight_->getIdentityPipelineLayout(),
         0,
-        frame.primaryDescriptorSet,
+        frame.primaryTextureDescriptorSets[level - 1],
         {});
     frame.commandBuffer.draw(3, 1, 0, 0);
-    frame.commandBuffer.endRenderPass();
+    endRendering(frame);
   }
 
-  void SceneView::computeRenderImageMips(std::size_t i) {
-    auto &frame = frames_[i];
-    auto clearValue = vk::ClearValue{};
-    auto renderPassBegin = vk::RenderPassBeginInfo{};
-    renderPassBegin.renderPass = flyweight_->getRenderPass();
-    renderPassBegin.renderArea.extent.width =
-        frame.primaryImage.getExtent().width;
-    renderPassBegin.renderArea.extent.height =
-        frame.primaryImage.getExtent().height;
-    renderPassBegin.clearValueCount = 1;
-    renderPassBegin.pClearValues = &clearValue;
-    auto viewport = vk::Viewport{};
-    auto scissor = vk::Rect2D{};
-    for (auto i = 0; i < 4; ++i) {
-      renderPassBegin.framebuffer = frame.primaryFramebuffers[i + 1];
-      renderPassBegin.renderArea.extent.width /= 2;
-      renderPassBegin.renderArea.extent.height /= 2;
-      frame.commandBuffer.beginRenderPass(
-          renderPassBegin, vk::SubpassContents::eInline);
-      frame.commandBuffer.bindPipeline(
-          vk::PipelineBindPoint::eGraphics, flyweight_->getIdentityPipeline());
-      viewport.width = renderPassBegin.renderArea.extent.width;
-      viewport.height = renderPassBegin.renderArea.extent.height;
-      frame.commandBuffer.setViewport(0, viewport);
-      scissor.extent.width = renderPassBegin.renderArea.extent.width;
-      scissor.extent.height = renderPassBegin.renderArea.extent.height;
-      frame.commandBuffer.setScissor(0, scissor);
-      frame.commandBuffer.bindDescriptorSets(
-          vk::PipelineBindPoint::eGraphics,
-          flyweight_->getIdentityPipelineLayout(),
-          0,
-          frame.primaryTextureDescriptorSets[i],
-          {});
-      frame.commandBuffer.draw(3, 1, 0, 0);
-      frame.commandBuffer.endRenderPass();
-    }
+  void SceneView::dispatchRenderImageMips(Frame &frame) const {
+    frame.commandBuffer.bindPipeline(
+        vk::PipelineBindPoint::eCompute, flyweight_->getDownsamplePipeline());
+    frame.commandBuffer.bindDescriptorSets(
+        vk::PipelineBindPoint::eCompute,
+        flyweight_->getDownsamplePipelineLayout(),
+        0,
+        frame.downsampleDescriptorSet,
+        {});
+    auto width = frame.primaryImage->getExtent().width / 2;
+    auto height = frame.primaryImage->getExtent().height / 2;
+    frame.commandBuffer.dispatch((width + 31) / 32, (height + 31) / 32, 1);
   }
 
-  void SceneView::renderBloom(Frame &frame) const {
-    auto clearValue = vk::ClearValue{};
-    auto renderPassBegin = vk::RenderPassBeginInfo{};
-    renderPassBegin.renderPass = flyweight_->getRenderPass();
-    renderPassBegin.clearValueCount = 1;
-    renderPassBegin.pClearValues = &clearValue;
+  void SceneView::renderBloomBlur(
+      Frame &frame, unsigned level, unsigned iteration, bool vertical) const {
+    auto width = frame.bloomImages[level].getExtent().width;
+    auto height = frame.bloomImages[level].getExtent().height;
     auto viewport = vk::Viewport{};
-    auto scissor = vk::Rect2D{};
+    viewport.width = width;
+    viewport.height = height;
+    auto scissor = getRenderArea(frame, level + 1);
     struct {
       float factorR;
       float factorG;
@@ -1495,113 +1629,73 @@ namespace imp {
       float dx;
       float dy;
     } pushConstants;
+    auto filtered = !vertical && iteration == 0;
+    pushConstants.factorR = filtered ? bloomSpectra_[level].r() : 1.0f;
+    pushConstants.factorG = filtered ? bloomSpectra_[level].g() : 1.0f;
+    pushConstants.factorB = filtered ? bloomSpectra_[level].b() : 1.0f;
     pushConstants.factorA = 1.0f;
-    for (auto i = 3; i >= 0; --i) {
-      auto width = frame.bloomImages[i].getExtent().width;
-      auto height = frame.bloomImages[i].getExtent().height;
-      renderPassBegin.renderArea.extent.width = width;
-      renderPassBegin.renderArea.extent.height = height;
-      viewport.width = width;
-      viewport.height = height;
-      scissor.extent.width = width;
-      scissor.extent.height = height;
-      for (auto j = 0; j < bloomBlurCounts_[i]; ++j) {
-        renderPassBegin.framebuffer = frame.bloomFramebuffers[2 * i];
-        frame.commandBuffer.beginRenderPass(
-            renderPassBegin, vk::SubpassContents::eInline);
-        frame.commandBuffer.bindPipeline(
-            vk::PipelineBindPoint::eGraphics,
-            flyweight_->getBlurPipeline(bloomBlurSizes_[i]));
-        frame.commandBuffer.setViewport(0, viewport);
-        frame.commandBuffer.setScissor(0, scissor);
-        frame.commandBuffer.bindDescriptorSets(
-            vk::PipelineBindPoint::eGraphics,
-            flyweight_->getBlurPipelineLayout(),
-            0,
-            j != 0 ? frame.bloomTextureDescriptorSets[2 * i + 1]
-                   : frame.primaryTextureDescriptorSets[i + 1],
-            {});
-        pushConstants.factorR = j != 0 ? 1.0f : bloomSpectra_[i].r();
-        pushConstants.factorG = j != 0 ? 1.0f : bloomSpectra_[i].g();
-        pushConstants.factorB = j != 0 ? 1.0f : bloomSpectra_[i].b();
-        pushConstants.dx = 1.0f / width;
-        pushConstants.dy = 0.0f;
-        frame.commandBuffer.pushConstants(
-            flyweight_->getBlurPipelineLayout(),
-            vk::ShaderStageFlagBits::eFragment,
-            0,
-            sizeof(pushConstants),
-            &pushConstants);
-        frame.commandBuffer.draw(3, 1, 0, 0);
-        frame.commandBuffer.endRenderPass();
-        renderPassBegin.framebuffer = frame.bloomFramebuffers[2 * i + 1];
-        frame.commandBuffer.beginRenderPass(
-            renderPassBegin, vk::SubpassContents::eInline);
-        frame.commandBuffer.bindPipeline(
-            vk::PipelineBindPoint::eGraphics,
-            flyweight_->getBlurPipeline(bloomBlurSizes_[i]));
-        frame.commandBuffer.setViewport(0, viewport);
-        frame.commandBuffer.setScissor(0, scissor);
-        frame.commandBuffer.bindDescriptorSets(
-            vk::PipelineBindPoint::eGraphics,
-            flyweight_->getBlurPipelineLayout(),
-            0,
-            frame.bloomTextureDescriptorSets[2 * i],
-            {});
-        pushConstants.factorR = 1.0f;
-        pushConstants.factorG = 1.0f;
-        pushConstants.factorB = 1.0f;
-        pushConstants.dx = 0.0f;
-        pushConstants.dy = 1.0f / height;
-        frame.commandBuffer.pushConstants(
-            flyweight_->getBlurPipelineLayout(),
-            vk::ShaderStageFlagBits::eFragment,
-            0,
-            sizeof(pushConstants),
-            &pushConstants);
-        frame.commandBuffer.draw(3, 1, 0, 0);
-        if (i != 3 && j + 1 == bloomBlurCounts_[i]) {
-          frame.commandBuffer.bindPipeline(
-              vk::PipelineBindPoint::eGraphics, flyweight_->getBloomPipeline());
-          frame.commandBuffer.setViewport(0, viewport);
-          frame.commandBuffer.setScissor(0, scissor);
-          frame.commandBuffer.bindDescriptorSets(
-              vk::PipelineBindPoint::eGraphics,
-              flyweight_->getBloomPipelineLayout(),
-              0,
-              frame.bloomTextureDescriptorSets[2 * i + 3],
-              {});
-          frame.commandBuffer.draw(3, 1, 0, 0);
-        }
-        frame.commandBuffer.endRenderPass();
-      }
+    pushConstants.dx = vertical ? 0.0f : 1.0f / width;
+    pushConstants.dy = vertical ? 1.0f / height : 0.0f;
+    beginRendering(
+        frame,
+        frame.bloomImageViews,
+        frame.bloomFramebuffers,
+        2 * level + (vertical ? 1 : 0),
+        {width, height});
+    frame.commandBuffer.bindPipeline(
+        vk::PipelineBindPoint::eGraphics,
+        flyweight_->getBlurPipeline(bloomBlurSizes_[level]));
+    frame.commandBuffer.setViewport(0, viewport);
+    frame.commandBuffer.setScissor(0, scissor);
+    frame.commandBuffer.bindDescriptorSets(
+        vk::PipelineBindPoint::eGraphics,
+        flyweight_->getBlurPipelineLayout(),
+        0,
+        vertical         ? frame.bloomTextureDescriptorSets[2 * level]
+        : iteration != 0 ? frame.bloomTextureDescriptorSets[2 * level + 1]
+                         : frame.primaryTextureDescriptorSets[level + 1],
+        {});
+    frame.commandBuffer.pushConstants(
+        flyweight_->getBlurPipelineLayout(),
+        vk::ShaderStageFlagBits::eFragment,
+        0,
+        sizeof(pushConstants),
+        &pushConstants);
+    frame.commandBuffer.draw(3, 1, 0, 0);
+    if (vertical && level != 3 && iteration + 1 == bloomBlurCounts_[level]) {
+      frame.commandBuffer.bindPipeline(
+          vk::PipelineBindPoint::eGraphics, flyweight_->getBloomPipeline());
+      frame.commandBuffer.setViewport(0, viewport);
+      frame.commandBuffer.setScissor(0, scissor);
+      frame.commandBuffer.bindDescriptorSets(
+          vk::PipelineBindPoint::eGraphics,
+          flyweight_->getBloomPipelineLayout(),
+          0,
+          frame.bloomTextureDescriptorSets[2 * level + 3],
+          {});
+      frame.commandBuffer.draw(3, 1, 0, 0);
     }
+    endRendering(frame);
   }
 
-  void SceneView::applyBloom(std::size_t i) {
-    auto &frame = frames_[i];
-    auto clearValue = vk::ClearValue{};
-    auto renderPassBegin = vk::RenderPassBeginInfo{};
-    renderPassBegin.renderPass = flyweight_->getNonDestructiveRenderPass();
-    renderPassBegin.framebuffer = frame.primaryFramebuffers[0];
-    renderPassBegin.renderArea.extent.width =
-        frame.primaryImage.getExtent().width;
-    renderPassBegin.renderArea.extent.height =
-        frame.primaryImage.getExtent().height;
-    renderPassBegin.clearValueCount = 1;
-    renderPassBegin.pClearValues = &clearValue;
-    frame.commandBuffer.beginRenderPass(
-        renderPassBegin, vk::SubpassContents::eInline);
+  void SceneView::applyBloom(Frame &frame) const {
+    auto extent = vk::Extent2D{
+        frame.primaryImage->getExtent().width,
+        frame.primaryImage->getExtent().height};
+    beginRendering(
+        frame,
+        frame.primaryImageViews,
+        frame.primaryFramebuffers,
+        0,
+        extent,
+        true);
     frame.commandBuffer.bindPipeline(
         vk::PipelineBindPoint::eGraphics, flyweight_->getBloomPipeline());
     auto viewport = vk::Viewport{};
-    viewport.width = renderPassBegin.renderArea.extent.width;
-    viewport.height = renderPassBegin.renderArea.extent.height;
+    viewport.width = extent.width;
+    viewport.height = extent.height;
     frame.commandBuffer.setViewport(0, viewport);
-    auto scissor = vk::Rect2D{};
-    scissor.extent.width = renderPassBegin.renderArea.extent.width;
-    scissor.extent.height = renderPassBegin.renderArea.extent.height;
-    frame.commandBuffer.setScissor(0, scissor);
+    frame.commandBuffer.setScissor(0, getRenderArea(frame, 0));
     frame.commandBuffer.bindDescriptorSets(
         vk::PipelineBindPoint::eGraphics,
         flyweight_->getBloomPipelineLayout(),
@@ -1609,7 +1703,7 @@ namespace imp {
         frame.bloomTextureDescriptorSets[1],
         {});
     frame.commandBuffer.draw(3, 1, 0, 0);
-    frame.commandBuffer.endRenderPass();
+    endRendering(frame);
   }
 
   gsl::not_null<SceneView::Flyweight const *>
@@ -1626,6 +1720,14 @@ namespace imp {
     scene_ = std::move(scene);
   }
 
+  std::string const &SceneView::getName() const noexcept {
+    return name_;
+  }
+
+  void SceneView::setName(std::string name) noexcept {
+    name_ = std::move(name);
+  }
+
   Extent2u const &SceneView::getExtent() const noexcept {
     return extent_;
   }
@@ -1638,16 +1740,12 @@ namespace imp {
     return uniformBuffer_;
   }
 
-  GpuImage const &SceneView::getSkyViewImage(std::size_t i) const noexcept {
-    return frames_[i].skyViewImage;
-  }
-
   GpuImage const &SceneView::getRenderImage(std::size_t i) const noexcept {
-    return frames_[i].primaryImage;
+    return *frames_[i].primaryImage;
   }
 
-  vk::ImageView SceneView::getSkyViewImageView(std::size_t i) const noexcept {
-    return frames_[i].skyViewImageView;
+  Extent2u const &SceneView::getRenderExtent(std::size_t i) const noexcept {
+    return frames_[i].extent;
   }
 
   vk::ImageView
@@ -1655,8 +1753,14 @@ namespace imp {
     return frames_[i].primaryImageViews[0];
   }
 
-  vk::Semaphore SceneView::getSemaphore(std::size_t i) const noexcept {
-    return frames_[i].semaphore;
+  vk::DeviceSize SceneView::getUnaliasedBloomSize() const {
+    auto size = vk::DeviceSize{};
+    for (auto &frame : frames_) {
+      for (auto &image : frame.bloomImages) {
+        size += image.getMemoryRequirements().size;
+      }
+    }
+    return size;
   }
 
   Eigen::Matrix4f const &SceneView::getViewMatrix() const noexcept {
@@ -1691,6 +1795,14 @@ namespace imp {
     antiAliasingEnabled_ = antiAliasingEnabled;
   }
 
+  bool SceneView::isComputeEnabled() const noexcept {
+    return computeEnabled_;
+  }
+
+  void SceneView::setComputeEnabled(bool computeEnabled) noexcept {
+    computeEnabled_ = computeEnabled;
+  }
+
   bool SceneView::isBloomEnabled() const noexcept {
     return bloomEnabled_;
   }
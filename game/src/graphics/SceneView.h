@@ -1,17 +1,28 @@
 #pragma once
 
+#include <array>
+#include <functional>
+#include <map>
 #include <memory>
+#include <string>
+#include <utility>
 #include <vector>
 
 #include <Eigen/Dense>
 
 #include "../system/GpuBuffer.h"
 #include "../system/GpuImage.h"
+#include "../system/GpuImagePool.h"
+#include "../system/GpuTransientHeap.h"
+#include "../system/RenderGraph.h"
 #include "../util/Align.h"
+#include "ImageFormat.h"
 #include "Spectrum.h"
 
 namespace imp {
   class GpuContext;
+  class GpuProfiler;
+  class GpuRenderGraph;
 
   class Scene;
 
@@ -20,106 +31,115 @@ namespace imp {
     static constexpr auto UNIFORM_BUFFER_SIZE = std::size_t{156};
     static constexpr auto UNIFORM_BUFFER_STRIDE =
         align(std::size_t{256}, UNIFORM_BUFFER_SIZE);
-    static constexpr auto SKY_VIEW_IMAGE_EXTENT = Extent3u{128, 256, 1};
 
     class Flyweight {
     public:
       explicit Flyweight(
-          gsl::not_null<GpuContext *> context, std::size_t frameCount);
+          gsl::not_null<GpuContext *> context,
+          gsl::not_null<GpuProfiler *> profiler,
+          std::size_t frameCount,
+          ImageFormats const &formats);
 
     private:
       vk::RenderPass createRenderPass() const;
       vk::RenderPass createNonDestructiveRenderPass() const;
-      vk::DescriptorSetLayout createSkyViewDescriptorSetLayout() const;
       vk::DescriptorSetLayout createPrimaryDescriptorSetLayout() const;
       vk::DescriptorSetLayout createIdentityDescriptorSetLayout() const;
+      vk::DescriptorSetLayout createDownsampleDescriptorSetLayout() const;
       vk::DescriptorSetLayout createBlurDescriptorSetLayout() const;
       vk::DescriptorSetLayout createBloomDescriptorSetLayout() const;
-      vk::PipelineLayout createSkyViewPipelineLayout() const;
       vk::PipelineLayout createPrimaryPipelineLayout() const;
       vk::PipelineLayout createIdentityPipelineLayout() const;
+      vk::PipelineLayout createDownsamplePipelineLayout() const;
       vk::PipelineLayout createBlurPipelineLayout() const;
       vk::PipelineLayout createBloomPipelineLayout() const;
-      vk::Pipeline createSkyViewPipeline() const;
-      std::unordered_map<bool, vk::Pipeline> createPrimaryPipelines() const;
+      std::map<std::pair<bool, bool>, vk::Pipeline>
+      createPrimaryPipelines() const;
       vk::Pipeline createIdentityPipeline() const;
+      vk::Pipeline createDownsamplePipeline() const;
       std::unordered_map<int, vk::Pipeline> createBlurPipelines() const;
       vk::Pipeline createBloomPipeline() const;
-      vk::Sampler createSkyViewSampler() const;
       vk::Sampler createGeneralSampler() const;
+      std::unique_ptr<GpuTransientHeap> createTransientHeap() const;
+      std::unique_ptr<GpuImagePool> createImagePool() const;
 
     public:
       ~Flyweight();
 
       gsl::not_null<GpuContext *> getContext() const noexcept;
+      gsl::not_null<GpuProfiler *> getProfiler() const noexcept;
       std::size_t getFrameCount() const noexcept;
+      vk::Format getFormat() const noexcept;
       vk::RenderPass getRenderPass() const noexcept;
       vk::RenderPass getNonDestructiveRenderPass() const noexcept;
-      vk::DescriptorSetLayout getSkyViewDescriptorSetLayout() const noexcept;
       vk::DescriptorSetLayout getPrimaryDescriptorSetLayout() const noexcept;
       vk::DescriptorSetLayout getIdentityDescriptorSetLayout() const noexcept;
+      vk::DescriptorSetLayout
+      getDownsampleDescriptorSetLayout() const noexcept;
       vk::DescriptorSetLayout getBlurDescriptorSetLayout() const noexcept;
       vk::DescriptorSetLayout getBloomDescriptorSetLayout() const;
-      vk::PipelineLayout getSkyViewPipelineLayout() const noexcept;
       vk::PipelineLayout getPrimaryPipelineLayout() const noexcept;
       vk::PipelineLayout getIdentityPipelineLayout() const noexcept;
+      vk::PipelineLayout getDownsamplePipelineLayout() const noexcept;
       vk::PipelineLayout getBlurPipelineLayout() const noexcept;
       vk::PipelineLayout getBloomPipelineLayout() const noexcept;
-      vk::Pipeline getSkyViewPipeline() const noexcept;
-      vk::Pipeline getPrimaryPipeline(bool antiAliasingEnabled) const noexcept;
+      vk::Pipeline getPrimaryPipeline(
+          bool antiAliasingEnabled,
+          bool analyticTransmittanceEnabled) const noexcept;
       vk::Pipeline getIdentityPipeline() const noexcept;
+      vk::Pipeline getDownsamplePipeline() const noexcept;
       vk::Pipeline getBlurPipeline(int kernelSize) const noexcept;
       vk::Pipeline getBloomPipeline() const noexcept;
       vk::Sampler getGeneralSampler() const noexcept;
-      vk::Sampler getSkyViewSampler() const noexcept;
+      gsl::not_null<GpuTransientHeap *> getTransientHeap() const noexcept;
+      gsl::not_null<GpuImagePool *> getImagePool() const noexcept;
 
     private:
       gsl::not_null<GpuContext *> context_;
+      gsl::not_null<GpuProfiler *> profiler_;
       std::size_t frameCount_;
+      vk::Format format_;
       vk::RenderPass renderPass_;
       vk::RenderPass nonDestructiveRenderPass_;
-      vk::DescriptorSetLayout skyViewDescriptorSetLayout_;
       vk::DescriptorSetLayout primaryDescriptorSetLayout_;
       vk::DescriptorSetLayout identityDescriptorSetLayout_;
+      vk::DescriptorSetLayout downsampleDescriptorSetLayout_;
       vk::DescriptorSetLayout blurDescriptorSetLayout_;
       vk::DescriptorSetLayout bloomDescriptorSetLayout_;
-      vk::PipelineLayout skyViewPipelineLayout_;
       vk::PipelineLayout primaryPipelineLayout_;
       vk::PipelineLayout identityPipelineLayout_;
+      vk::PipelineLayout downsamplePipelineLayout_;
       vk::PipelineLayout blurPipelineLayout_;
       vk::PipelineLayout bloomPipelineLayout_;
-      vk::Pipeline skyViewPipeline_;
-      std::unordered_map<bool, vk::Pipeline> primaryPipelines_;
+      std::map<std::pair<bool, bool>, vk::Pipeline> primaryPipelines_;
       vk::Pipeline identityPipeline_;
+      vk::Pipeline downsamplePipeline_;
       std::unordered_map<int, vk::Pipeline> blurPipelines_;
       vk::Pipeline bloomPipeline_;
       vk::Sampler generalSampler_;
-      vk::Sampler skyViewSampler_;
+      std::unique_ptr<GpuTransientHeap> transientHeap_;
+      std::unique_ptr<GpuImagePool> imagePool_;
     };
 
     struct Frame {
-      GpuImage skyViewImage;
-      GpuImage primaryImage;
+      std::shared_ptr<GpuImage const> primaryImage;
+      Extent2u extent;
+      std::shared_ptr<GpuMemory const> bloomMemory;
       std::vector<GpuImage> bloomImages;
-      vk::ImageView skyViewImageView;
       std::vector<vk::ImageView> primaryImageViews;
       std::vector<vk::ImageView> bloomImageViews;
-      vk::Framebuffer skyViewFramebuffer;
       std::vector<vk::Framebuffer> primaryFramebuffers;
       std::vector<vk::Framebuffer> bloomFramebuffers;
-      vk::DescriptorSet skyViewDescriptorSet;
       vk::DescriptorSet primaryDescriptorSet;
       std::vector<vk::DescriptorSet> primaryTextureDescriptorSets;
+      vk::DescriptorSet downsampleDescriptorSet;
       std::vector<vk::DescriptorSet> bloomTextureDescriptorSets;
       vk::CommandPool commandPool;
       vk::CommandBuffer commandBuffer;
-      vk::Semaphore semaphore;
       std::shared_ptr<Scene> scene;
 
       explicit Frame(
-          GpuImage &&skyViewImage,
-          GpuImage &&renderImage,
-          std::vector<GpuImage> &&bloomImages);
+          std::shared_ptr<GpuImage const> renderImage, Extent2u const &extent);
     };
 
     explicit SceneView(
@@ -131,53 +151,87 @@ namespace imp {
     vk::DescriptorPool createDescriptorPool() const;
     GpuBuffer createUniformBuffer() const;
     std::vector<Frame> createFrames() const;
-    GpuImage createSkyViewImage() const;
-    GpuImage createPrimaryImage() const;
-    std::vector<GpuImage> createBloomImages() const;
-    void initSkyViewImageView(Frame &frame) const;
+    std::shared_ptr<GpuImage const> createPrimaryImage() const;
+    void initBloomImages(Frame &frame) const;
     void initPrimaryImageViews(Frame &frame) const;
     void initBloomImageViews(Frame &frame) const;
-    void initSkyViewFramebuffer(Frame &frame) const;
     void initPrimaryFramebuffers(Frame &frame) const;
     void initBloomFramebuffers(Frame &frame) const;
     void allocateDescriptorSets(std::size_t i);
-    void initSkyViewDescriptorSet(std::size_t i);
     void initPrimaryDescriptorSet(std::size_t i);
     void initPrimaryImageDescriptorSets(Frame &frame) const;
+    void initDownsampleDescriptorSet(Frame &frame) const;
     void initBloomTextureDescriptorSets(Frame &frame) const;
     void initCommandPool(std::size_t i);
     void initCommandBuffers(std::size_t i);
-    void initSemaphores(std::size_t i);
 
   public:
     ~SceneView();
 
-    void render(std::size_t i);
+    vk::CommandBuffer render(std::size_t i);
+    vk::CommandBuffer beginRender(std::size_t i);
+    void endRender(std::size_t i);
 
   private:
     void updateUniformBuffer(std::size_t i);
     void updateRenderImages(std::size_t i);
-    void updateSkyViewDescriptorSet(std::size_t i);
+    void updateBloomImages(std::size_t i);
     void updatePrimaryDescriptorSet(std::size_t i);
-    void submitCommands(std::size_t i);
+    void recordCommands(std::size_t i);
     void computeSkyViewImage(std::size_t i);
-    void computeRenderImage(std::size_t i);
-    void computeRenderImageMips(std::size_t i);
-    void renderBloom(Frame &frame) const;
-    void applyBloom(std::size_t i);
+
+    using BloomImages = std::array<RenderGraph::ImageHandle, 4>;
+
+    RenderGraph::PassHandle addPass(
+        GpuRenderGraph &graph,
+        Frame &frame,
+        std::string name,
+        std::function<void()> execute) const;
+    BloomImages
+    importBloomImages(GpuRenderGraph &graph, Frame const &frame) const;
+    void addPrimaryPasses(
+        GpuRenderGraph &graph,
+        Frame &frame,
+        RenderGraph::ImageHandle primaryImage) const;
+    void addBloomPasses(
+        GpuRenderGraph &graph,
+        Frame &frame,
+        RenderGraph::ImageHandle primaryImage,
+        BloomImages const &bloomImages) const;
+    void addApplyBloomPass(
+        GpuRenderGraph &graph,
+        Frame &frame,
+        RenderGraph::ImageHandle primaryImage,
+        BloomImages const &bloomImages) const;
+    void beginRendering(
+        Frame &frame,
+        gsl::span<vk::ImageView const> imageViews,
+        gsl::span<vk::Framebuffer const> framebuffers,
+        std::size_t index,
+        vk::Extent2D const &extent,
+        bool load = false) const;
+    void endRendering(Frame &frame) const;
+    vk::Rect2D getRenderArea(Frame const &frame, unsigned level) const noexcept;
+    void computeRenderImage(Frame &frame) const;
+    void renderRenderImageMip(Frame &frame, unsigned level) const;
+    void dispatchRenderImageMips(Frame &frame) const;
+    void renderBloomBlur(
+        Frame &frame, unsigned level, unsigned iteration, bool vertical) const;
+    void applyBloom(Frame &frame) const;
 
   public:
     gsl::not_null<Flyweight const *> getFlyweight() const noexcept;
     gsl::not_null<std::shared_ptr<Scene>> getScene() const noexcept;
     void setScene(gsl::not_null<std::shared_ptr<Scene>> scene) noexcept;
+    std::string const &getName() const noexcept;
+    void setName(std::string name) noexcept;
     Extent2u const &getExtent() const noexcept;
     void setExtent(Extent2u const &extent) noexcept;
     GpuBuffer const &getUniformBuffer() const noexcept;
-    GpuImage const &getSkyViewImage(std::size_t i) const noexcept;
     GpuImage const &getRenderImage(std::size_t i) const noexcept;
-    vk::ImageView getSkyViewImageView(std::size_t i) const noexcept;
+    Extent2u const &getRenderExtent(std::size_t i) const noexcept;
     vk::ImageView getFullRenderImageView(std::size_t i) const noexcept;
-    vk::Semaphore getSemaphore(std::size_t i) const noexcept;
+    vk::DeviceSize getUnaliasedBloomSize() const;
     Eigen::Matrix4f const &getViewMatrix() const noexcept;
     void setViewMatrix(Eigen::Matrix4f const &m) noexcept;
     Eigen::Matrix4f const &getProjectionMatrix() const noexcept;
@@ -186,6 +240,8 @@ namespace imp {
     void setExposure(float exposure) noexcept;
     bool isAntiAliasingEnabled() const noexcept;
     void setAntiAliasingEnabled(bool antiAliasingEnabled) noexcept;
+    bool isComputeEnabled() const noexcept;
+    void setComputeEnabled(bool computeEnabled) noexcept;
     bool isBloomEnabled() const noexcept;
     void setBloomEnabled(bool bloomEnabled) noexcept;
     unsigned getBloomBlurCount(unsigned level) const noexcept;
@@ -198,6 +254,7 @@ namespace imp {
   private:
     gsl::not_null<Flyweight const *> flyweight_;
     gsl::not_null<std::shared_ptr<Scene>> scene_;
+    std::string name_;
     Extent2u extent_;
     vk::DescriptorPool descriptorPool_;
     GpuBuffer uniformBuffer_;
@@ -207,9 +264,12 @@ namespace imp {
     Eigen::Matrix4f prevViewMatrix_;
     Eigen::Matrix4f prevProjectionMatrix_;
     float exposure_;
+    float altitude_;
+    Eigen::Vector3f skyViewSunDirection_;
     bool antiAliasingEnabled_;
     float antiAliasingAlpha_;
     Eigen::Vector2f antiAliasingJitter_;
+    bool computeEnabled_;
     bool bloomEnabled_;
     std::vector<unsigned> bloomBlurCounts_;
     std::vector<unsigned> bloomBlurSizes_;
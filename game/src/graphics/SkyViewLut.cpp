@@ -1,319 +1,431 @@
-//#include "SkyViewLut.h"
-//
-//#include <cassert>
-//
-//#include <fstream>
-//#include <vector>
-//
-//#include "../system/GpuContext.h"
-//#include "AtmosphereBuffer.h"
-//#include "Scene.h"
-//#include "TransmittanceLut.h"
-//
-//namespace imp {
-//  SkyViewLut::Flyweight::Flyweight(GpuContext *context):
-//      context_{context},
-//      descriptorSetLayout_{createDescriptorSetLayout()},
-//      pipelineLayout_{createPipelineLayout()},
-//      pipeline_{createPipeline()},
-//      sampler_{createSampler()} {}
-//
-//  GpuContext *SkyViewLut::Flyweight::getContext() const noexcept {
-//    return context_;
-//  }
-//
-//  vk::DescriptorSetLayout
-//  SkyViewLut::Flyweight::getDescriptorSetLayout() const noexcept {
-//    return descriptorSetLayout_;
-//  }
-//
-//  vk::PipelineLayout SkyViewLut::Flyweight::getPipelineLayout() const noexcept {
-//    return *pipelineLayout_;
-//  }
-//
-//  vk::Pipeline SkyViewLut::Flyweight::getPipeline() const noexcept {
-//    return *pipeline_;
-//  }
-//
-//  vk::Sampler SkyViewLut::Flyweight::getSampler() const noexcept {
-//    return sampler_;
-//  }
-//
-//  vk::DescriptorSetLayout SkyViewLut::Flyweight::createDescriptorSetLayout() {
-//    auto bufferBinding = GpuDescriptorSetLayoutBinding{};
-//    bufferBinding.descriptorType = vk::DescriptorType::eUniformBuffer;
-//    bufferBinding.descriptorCount = 1;
-//    bufferBinding.stageFlags = vk::ShaderStageFlagBits::eCompute;
-//    auto textureBinding = GpuDescriptorSetLayoutBinding{};
-//    textureBinding.descriptorType = vk::DescriptorType::eCombinedImageSampler;
-//    textureBinding.descriptorCount = 1;
-//    textureBinding.stageFlags = vk::ShaderStageFlagBits::eCompute;
-//    auto imageBinding = GpuDescriptorSetLayoutBinding{};
-//    imageBinding.descriptorType = vk::DescriptorType::eStorageImage;
-//    imageBinding.descriptorCount = 1;
-//    imageBinding.stageFlags = vk::ShaderStageFlagBits::eCompute;
-//    auto bindings = std::array{bufferBinding, textureBinding, imageBinding};
-//    auto createInfo = GpuDescriptorSetLayoutCreateInfo{};
-//    createInfo.bindingCount = static_cast<std::uint32_t>(bindings.size());
-//    createInfo.bindings = bindings.data();
-//    return context_->createDescriptorSetLayout(createInfo);
-//  }
-//
-//  vk::UniquePipelineLayout SkyViewLut::Flyweight::createPipelineLayout() {
-//    auto pushConstantRange = vk::PushConstantRange{};
-//    pushConstantRange.stageFlags = vk::ShaderStageFlagBits::eCompute;
-//    pushConstantRange.offset = 0;
-//    pushConstantRange.size = 32;
-//    auto createInfo = vk::PipelineLayoutCreateInfo{};
-//    createInfo.setLayoutCount = 1;
-//    createInfo.pSetLayouts = &descriptorSetLayout_;
-//    createInfo.pushConstantRangeCount = 1;
-//    createInfo.pPushConstantRanges = &pushConstantRange;
-//    return context_->getDevice().createPipelineLayoutUnique(createInfo);
-//  }
-//
-//  vk::UniquePipeline SkyViewLut::Flyweight::createPipeline() {
-//    auto ifs = std::ifstream{};
-//    ifs.exceptions(std::ios::badbit | std::ios::failbit);
-//    ifs.open("./data/SkyView.spv", std::ios::binary);
-//    ifs.seekg(0, std::ios::end);
-//    auto code = std::vector<char>{};
-//    code.resize(ifs.tellg());
-//    if (code.size() % 4 != 0) {
-//      throw std::runtime_error{"invalid shader module"};
-//    }
-//    ifs.seekg(0, std::ios::beg);
-//    ifs.read(code.data(), code.size());
-//    ifs.close();
-//    auto moduleCreateInfo = vk::ShaderModuleCreateInfo{};
-//    moduleCreateInfo.codeSize = code.size();
-//    moduleCreateInfo.pCode = reinterpret_cast<std::uint32_t *>(code.data());
-//    auto module =
-//        context_->getDevice().createShaderModuleUnique(moduleCreateInfo);
-//    auto createInfo = vk::ComputePipelineCreateInfo{};
-//    createInfo.stage.stage = vk::ShaderStageFlagBits::eCompute;
-//    createInfo.stage.module = *module;
-//    createInfo.stage.pName = "main";
-//    createInfo.layout = *pipelineLayout_;
-//    createInfo.basePipelineIndex = -1;
-//    return context_->getDevice()
-//        .createComputePipelineUnique({}, createInfo)
-//        .value;
-//  }
-//
-//  vk::Sampler SkyViewLut::Flyweight::createSampler() {
-//    auto createInfo = GpuSamplerCreateInfo{};
-//    createInfo.magFilter = vk::Filter::eLinear;
-//    createInfo.minFilter = vk::Filter::eLinear;
-//    createInfo.mipmapMode = vk::SamplerMipmapMode::eNearest;
-//    createInfo.addressModeU = vk::SamplerAddressMode::eRepeat;
-//    createInfo.addressModeV = vk::SamplerAddressMode::eClampToEdge;
-//    createInfo.addressModeW = vk::SamplerAddressMode::eClampToEdge;
-//    return context_->createSampler(createInfo);
-//  }
-//
-//  SkyViewLut::SkyViewLut(
-//      Flyweight const *flyweight,
-//      TransmittanceLut const *transmittanceLut,
-//      Extent2u const &extent):
-//      flyweight_{flyweight},
-//      atmosphereBuffer_{transmittanceLut->getAtmosphereBuffer()},
-//      transmittanceLut_{transmittanceLut},
-//      extent_{extent},
-//      image_{createImage()},
-//      imageViews_{createImageViews()},
-//      descriptorPool_{createDescriptorPool()},
-//      descriptorSets_{allocateDescriptorSets()} {
-//    assert(width % 8 == 0);
-//    assert(height % 8 == 0);
-//    updateDescriptorSets();
-//  }
-//
-//  unsigned SkyViewLut::getFrameCount() const noexcept {
-//    return atmosphereBuffer_->getFrameCount();
-//  }
-//
-//  unsigned SkyViewLut::getFrameIndex() const noexcept {
-//    return atmosphereBuffer_->getFrameIndex();
-//  }
-//
-//  SkyViewLut::Flyweight const *SkyViewLut::getFlyweight() const noexcept {
-//    return flyweight_;
-//  }
-//
-//  AtmosphereBuffer const *SkyViewLut::getAtmosphereBuffer() const noexcept {
-//    return atmosphereBuffer_;
-//  }
-//
-//  TransmittanceLut const *SkyViewLut::getTransmittanceLut() const noexcept {
-//    return transmittanceLut_;
-//  }
-//
-//  Extent2u const &SkyViewLut::getExtent() const noexcept {
-//    return extent_;
-//  }
-//
-//  GpuImage const &SkyViewLut::getImage() const noexcept {
-//    return image_;
-//  }
-//
-//  vk::ImageView SkyViewLut::getImageView() const noexcept {
-//    return *imageViews_[getFrameIndex()];
-//  }
-//
-//  vk::ImageView SkyViewLut::getImageView(unsigned frameIndex) const noexcept {
-//    return *imageViews_[frameIndex];
-//  }
-//
-//  void SkyViewLut::compute(
-//      vk::CommandBuffer cmd, DirectionalLight const &sun, float altitude) {
-//    cmd.bindPipeline(
-//        vk::PipelineBindPoint::eCompute, flyweight_->getPipeline());
-//    cmd.bindDescriptorSets(
-//        vk::PipelineBindPoint::eCompute,
-//        flyweight_->getPipelineLayout(),
-//        0,
-//        {descriptorSets_[getFrameIndex()]},
-//        {});
-//    auto pushConstants = std::array<char, 32>{};
-//    std::memcpy(&pushConstants[0], sun.getIrradiance().data(), 12);
-//    std::memcpy(&pushConstants[16], sun.getDirection().data(), 12);
-//    std::memcpy(&pushConstants[28], &altitude, 4);
-//    cmd.pushConstants(
-//        flyweight_->getPipelineLayout(),
-//        vk::ShaderStageFlagBits::eCompute,
-//        0,
-//        static_cast<std::uint32_t>(pushConstants.size()),
-//        pushConstants.data());
-//    auto barrier = vk::ImageMemoryBarrier{};
-//    barrier.srcAccessMask = {};
-//    barrier.dstAccessMask = vk::AccessFlagBits::eShaderWrite;
-//    barrier.oldLayout = vk::ImageLayout::eUndefined;
-//    barrier.newLayout = vk::ImageLayout::eGeneral;
-//    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-//    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-//    barrier.image = image_.get();
-//    barrier.subresourceRange.aspectMask = vk::ImageAspectFlagBits::eColor;
-//    barrier.subresourceRange.baseMipLevel = 0;
-//    barrier.subresourceRange.levelCount = 1;
-//    barrier.subresourceRange.baseArrayLayer = 0;
-//    barrier.subresourceRange.layerCount = 1;
-//    cmd.pipelineBarrier(
-//        vk::PipelineStageFlagBits::eTopOfPipe,
-//        vk::PipelineStageFlagBits::eComputeShader,
-//        {},
-//        {},
-//        {},
-//        barrier);
-//    cmd.dispatch(extent_.width / 8u, extent_.height / 8u, 1u);
-//  }
-//
-//  GpuImage SkyViewLut::createImage() {
-//    auto image = vk::ImageCreateInfo{};
-//    image.imageType = vk::ImageType::e2D;
-//    image.format = vk::Format::eR16G16B16A16Sfloat;
-//    image.extent = static_cast<vk::Extent3D>(extent_);
-//    image.mipLevels = 1;
-//    image.arrayLayers = getFrameCount();
-//    image.samples = vk::SampleCountFlagBits::e1;
-//    image.tiling = vk::ImageTiling::eOptimal;
-//    image.usage =
-//        vk::ImageUsageFlagBits::eSampled | vk::ImageUsageFlagBits::eStorage;
-//    image.sharingMode = vk::SharingMode::eExclusive;
-//    image.initialLayout = vk::ImageLayout::eUndefined;
-//    auto allocation = VmaAllocationCreateInfo{};
-//    allocation.usage = VMA_MEMORY_USAGE_GPU_ONLY;
-//    return GpuImage{
-//        flyweight_->getContext()->getAllocator(), image, allocation};
-//  }
-//
-//  std::vector<vk::UniqueImageView> SkyViewLut::createImageViews() {
-//    auto createInfo = vk::ImageViewCreateInfo{};
-//    createInfo.image = image_.get();
-//    createInfo.viewType = vk::ImageViewType::e2D;
-//    createInfo.format = vk::Format::eR16G16B16A16Sfloat;
-//    createInfo.components.r = vk::ComponentSwizzle::eIdentity;
-//    createInfo.components.g = vk::ComponentSwizzle::eIdentity;
-//    createInfo.components.b = vk::ComponentSwizzle::eIdentity;
-//    createInfo.components.a = vk::ComponentSwizzle::eIdentity;
-//    createInfo.subresourceRange.aspectMask = vk::ImageAspectFlagBits::eColor;
-//    createInfo.subresourceRange.baseMipLevel = 0;
-//    createInfo.subresourceRange.levelCount = 1;
-//    createInfo.subresourceRange.baseArrayLayer = 0;
-//    createInfo.subresourceRange.layerCount = 1;
-//    auto ret = std::vector<vk::UniqueImageView>{};
-//    ret.reserve(getFrameCount());
-//    for (auto i = 0u; i < getFrameCount(); ++i) {
-//      createInfo.subresourceRange.baseArrayLayer = i;
-//      ret.emplace_back(
-//          flyweight_->getContext()->getDevice().createImageViewUnique(
-//              createInfo));
-//    }
-//    return ret;
-//  }
-//
-//  vk::UniqueDescriptorPool SkyViewLut::createDescriptorPool() {
-//    auto poolSizes = std::vector<vk::DescriptorPoolSize>{
-//        {vk::DescriptorType::eUniformBuffer, getFrameCount()},
-//        {vk::DescriptorType::eStorageImage, getFrameCount()},
-//        {vk::DescriptorType::eCombinedImageSampler, getFrameCount()}};
-//    auto createInfo = vk::DescriptorPoolCreateInfo{};
-//    createInfo.maxSets = getFrameCount();
-//    createInfo.poolSizeCount = static_cast<std::uint32_t>(poolSizes.size());
-//    createInfo.pPoolSizes = poolSizes.data();
-//    return flyweight_->getContext()->getDevice().createDescriptorPoolUnique(
-//        createInfo);
-//  }
-//
-//  std::vector<vk::DescriptorSet> SkyViewLut::allocateDescriptorSets() {
-//    auto setLayouts = std::vector<vk::DescriptorSetLayout>(
-//        getFrameCount(), flyweight_->getDescriptorSetLayout());
-//    auto allocateInfo = vk::DescriptorSetAllocateInfo{};
-//    allocateInfo.descriptorPool = *descriptorPool_;
-//    allocateInfo.descriptorSetCount =
-//        static_cast<std::uint32_t>(setLayouts.size());
-//    allocateInfo.pSetLayouts = setLayouts.data();
-//    return flyweight_->getContext()->getDevice().allocateDescriptorSets(
-//        allocateInfo);
-//  }
-//
-//  void SkyViewLut::updateDescriptorSets() {
-//    auto bufferInfo = vk::DescriptorBufferInfo{};
-//    bufferInfo.buffer = atmosphereBuffer_->getBuffer().get();
-//    bufferInfo.range = AtmosphereBuffer::SIZE;
-//    auto bufferWrite = vk::WriteDescriptorSet{};
-//    bufferWrite.dstBinding = 0;
-//    bufferWrite.dstArrayElement = 0;
-//    bufferWrite.descriptorCount = 1;
-//    bufferWrite.descriptorType = vk::DescriptorType::eUniformBuffer;
-//    bufferWrite.pBufferInfo = &bufferInfo;
-//    auto transmittanceInfo = vk::DescriptorImageInfo{};
-//    transmittanceInfo.sampler = transmittanceLut_->getFlyweight()->getSampler();
-//    transmittanceInfo.imageLayout = vk::ImageLayout::eShaderReadOnlyOptimal;
-//    auto transmittanceWrite = vk::WriteDescriptorSet{};
-//    transmittanceWrite.dstBinding = 1;
-//    transmittanceWrite.dstArrayElement = 0;
-//    transmittanceWrite.descriptorCount = 1;
-//    transmittanceWrite.descriptorType =
-//        vk::DescriptorType::eCombinedImageSampler;
-//    transmittanceWrite.pImageInfo = &transmittanceInfo;
-//    auto skyViewInfo = vk::DescriptorImageInfo{};
-//    skyViewInfo.imageLayout = vk::ImageLayout::eGeneral;
-//    auto skyViewWrite = vk::WriteDescriptorSet{};
-//    skyViewWrite.dstBinding = 2;
-//    skyViewWrite.dstArrayElement = 0;
-//    skyViewWrite.descriptorCount = 1;
-//    skyViewWrite.descriptorType = vk::DescriptorType::eStorageImage;
-//    skyViewWrite.pImageInfo = &skyViewInfo;
-//    for (auto i = 0u; i < getFrameCount(); ++i) {
-//      bufferInfo.offset = atmosphereBuffer_->getOffset(i);
-//      bufferWrite.dstSet = descriptorSets_[i];
-//      transmittanceInfo.imageView = transmittanceLut_->getImageView(i);
-//      transmittanceWrite.dstSet = descriptorSets_[i];
-//      skyViewInfo.imageView = *imageViews_[i];
-//      skyViewWrite.dstSet = descriptorSets_[i];
-//      flyweight_->getContext()->getDevice().updateDescriptorSets(
-//          {bufferWrite, transmittanceWrite, skyViewWrite}, {});
-//    }
-//  }
-//} // namespace imp
\ No newline at end of file
+#include "SkyViewLut.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+#include "../system/GpuContext.h"
+#include "Scene.h"
+
+namespace imp {
+  SkyViewLut::SkyViewLut(gsl::not_null<Scene const *> scene):
+      scene_{scene},
+      quality_{scene->getAtmosphereQuality()},
+      descriptorPool_{createDescriptorPool()},
+      image_{createImage()},
+      imageView_{createImageView()},
+      framebuffer_{createFramebuffer()},
+      descriptorSets_{createDescriptorSets()},
+      layout_{vk::ImageLayout::eUndefined},
+      altitude_{0.0f},
+      sunDirection_{0.0f, 0.0f, 1.0f},
+      band_{0},
+      updatedRowCount_{0},
+      analyticTransmittanceEnabled_{false} {}
+
+  vk::DescriptorPool SkyViewLut::createDescriptorPool() const {
+    auto frameCount32 =
+        static_cast<std::uint32_t>(scene_->getFlyweight()->getFrameCount());
+    auto poolSizes = std::array{
+        vk::DescriptorPoolSize{
+            vk::DescriptorType::eUniformBuffer, frameCount32},
+        vk::DescriptorPoolSize{
+            vk::DescriptorType::eCombinedImageSampler, frameCount32},
+        vk::DescriptorPoolSize{
+            vk::DescriptorType::eStorageImage, frameCount32}};
+    auto createInfo = vk::DescriptorPoolCreateInfo{};
+    createInfo.maxSets = frameCount32;
+    createInfo.poolSizeCount = static_cast<std::uint32_t>(poolSizes.size());
+    createInfo.pPoolSizes = poolSizes.data();
+    auto device = scene_->getFlyweight()->getContext()->getDevice();
+    return device.createDescriptorPool(createInfo);
+  }
+
+  GpuImage SkyViewLut::createImage() const {
+    auto image = vk::ImageCreateInfo{};
+    image.imageType = vk::ImageType::e2D;
+    image.format = scene_->getFlyweight()->getSkyViewFormat();
+    image.extent = getAtmosphereQualitySettings(quality_).skyViewExtent;
+    image.mipLevels = 1;
+    image.arrayLayers = 1;
+    image.samples = vk::SampleCountFlagBits::e1;
+    image.tiling = vk::ImageTiling::eOptimal;
+    image.usage = vk::ImageUsageFlagBits::eSampled |
+                  vk::ImageUsageFlagBits::eColorAttachment |
+                  vk::ImageUsageFlagBits::eStorage;
+    image.sharingMode = vk::SharingMode::eExclusive;
+    auto queueFamilies = std::array{
+        scene_->getFlyweight()->getContext()->getGraphicsFamily(),
+        scene_->getFlyweight()->getContext()->getComputeFamily()};
+    if (queueFamilies[0] != queueFamilies[1]) {
+      image.sharingMode = vk::SharingMode::eConcurrent;
+      image.queueFamilyIndexCount =
+          static_cast<std::uint32_t>(queueFamilies.size());
+      image.pQueueFamilyIndices = queueFamilies.data();
+    }
+    image.initialLayout = vk::ImageLayout::eUndefined;
+    auto allocation = VmaAllocationCreateInfo{};
+    allocation.usage = VMA_MEMORY_USAGE_GPU_ONLY;
+    return GpuImage{
+        scene_->getFlyweight()->getContext()->getAllocator(),
+        image,
+        allocation};
+  }
+
+  vk::ImageView SkyViewLut::createImageView() const {
+    auto createInfo = vk::ImageViewCreateInfo{};
+    createInfo.image = image_.get();
+    createInfo.viewType = vk::ImageViewType::e2D;
+    createInfo.format = image_.getFormat();
+    createInfo.subresourceRange.aspectMask = vk::ImageAspectFlagBits::eColor;
+    createInfo.subresourceRange.levelCount = 1;
+    createInfo.subresourceRange.layerCount = 1;
+    return scene_->getFlyweight()->getContext()->getDevice().createImageView(
+        createInfo);
+  }
+
+  vk::Framebuffer SkyViewLut::createFramebuffer() const {
+    if (scene_->getFlyweight()->getContext()->isDynamicRenderingEnabled()) {
+      return {};
+    }
+    auto createInfo = vk::FramebufferCreateInfo{};
+    createInfo.renderPass = scene_->getFlyweight()->getSkyViewRenderPass();
+    createInfo.attachmentCount = 1;
+    createInfo.pAttachments = &imageView_;
+    createInfo.width = image_.getExtent().width;
+    createInfo.height = image_.getExtent().height;
+    createInfo.layers = 1;
+    return scene_->getFlyweight()->getContext()->getDevice().createFramebuffer(
+        createInfo);
+  }
+
+  std::vector<vk::DescriptorSet> SkyViewLut::createDescriptorSets() const {
+    auto &flyweight = *scene_->getFlyweight();
+    auto device = flyweight.getContext()->getDevice();
+    auto setLayouts = std::vector<vk::DescriptorSetLayout>(
+        flyweight.getFrameCount(), flyweight.getSkyViewDescriptorSetLayout());
+    auto allocateInfo = vk::DescriptorSetAllocateInfo{};
+    allocateInfo.descriptorPool = descriptorPool_;
+    allocateInfo.descriptorSetCount =
+        static_cast<std::uint32_t>(setLayouts.size());
+    allocateInfo.pSetLayouts = setLayouts.data();
+    auto sets = device.allocateDescriptorSets(allocateInfo);
+    for (auto i = std::size_t{}; i < sets.size(); ++i) {
+      auto bufferInfo = vk::DescriptorBufferInfo{};
+      bufferInfo.buffer = scene_->getUniformBuffer().get();
+      bufferInfo.offset = Scene::UNIFORM_BUFFER_STRIDE * i;
+      bufferInfo.range = Scene::UNIFORM_BUFFER_SIZE;
+      auto transmittanceInfo = vk::DescriptorImageInfo{};
+      transmittanceInfo.sampler = flyweight.getTransmittanceSampler();
+      transmittanceInfo.imageView = scene_->getTransmittanceImageView();
+      transmittanceInfo.imageLayout = vk::ImageLayout::eShaderReadOnlyOptimal;
+      auto imageInfo = vk::DescriptorImageInfo{};
+      imageInfo.imageView = imageView_;
+      imageInfo.imageLayout = vk::ImageLayout::eGeneral;
+      auto writes = std::array<vk::WriteDescriptorSet, 3>{};
+      writes[0].dstSet = sets[i];
+      writes[0].dstBinding = 0;
+      writes[0].descriptorCount = 1;
+      writes[0].descriptorType = vk::DescriptorType::eUniformBuffer;
+      writes[0].pBufferInfo = &bufferInfo;
+      writes[1].dstSet = sets[i];
+      writes[1].dstBinding = 1;
+      writes[1].descriptorCount = 1;
+      writes[1].descriptorType = vk::DescriptorType::eCombinedImageSampler;
+      writes[1].pImageInfo = &transmittanceInfo;
+      writes[2].dstSet = sets[i];
+      writes[2].dstBinding = 2;
+      writes[2].descriptorCount = 1;
+      writes[2].descriptorType = vk::DescriptorType::eStorageImage;
+      writes[2].pImageInfo = &imageInfo;
+      device.updateDescriptorSets(writes, {});
+    }
+    return sets;
+  }
+
+  SkyViewLut::~SkyViewLut() {
+    auto device = scene_->getFlyweight()->getContext()->getDevice();
+    device.destroy(framebuffer_);
+    device.destroy(imageView_);
+    device.destroy(descriptorPool_);
+  }
+
+  void SkyViewLut::update(
+      vk::CommandBuffer commandBuffer,
+      std::size_t frameIndex,
+      float altitude,
+      Eigen::Vector3f const &sunDirection,
+      bool asyncComputeEnabled) {
+    altitude_ = altitude;
+    sunDirection_ = sunDirection;
+    auto regions = updateBands();
+    if (asyncComputeEnabled || scene_->isComputeEnabled()) {
+      dispatch(commandBuffer, frameIndex, regions, asyncComputeEnabled);
+    } else {
+      render(commandBuffer, frameIndex, regions);
+    }
+    layout_ = vk::ImageLayout::eShaderReadOnlyOptimal;
+  }
+
+  std::vector<vk::Rect2D> SkyViewLut::updateBands() {
+    auto extent = image_.getExtent();
+    auto bandHeight = scene_->getFlyweight()->getWorkgroupSize().height;
+    auto bandCount = extent.height / bandHeight;
+    auto planetVersion = scene_->getPlanet()->getVersion();
+    auto sampling = scene_->getAtmosphereSampling();
+    auto analyticTransmittanceEnabled =
+        scene_->isAnalyticTransmittanceEnabled();
+    auto refresh =
+        layout_ == vk::ImageLayout::eUndefined ||
+        planetVersion_ != planetVersion || sampling_ != sampling ||
+        analyticTransmittanceEnabled_ != analyticTransmittanceEnabled;
+    auto minSunCosine = std::cos(scene_->getSkyViewSunAngleThreshold());
+    for (auto i = std::size_t{}; !refresh && i < bandAltitudes_.size(); ++i) {
+      refresh = std::abs(altitude_ - bandAltitudes_[i]) >
+                    scene_->getSkyViewAltitudeThreshold() ||
+                sunDirection_.dot(bandSunDirections_[i]) < minSunCosine;
+    }
+    auto updateCount = std::clamp(
+        static_cast<std::uint32_t>(
+            std::ceil(scene_->getSkyViewUpdateFraction() * float(bandCount))),
+        1u,
+        bandCount);
+    if (refresh) {
+      planetVersion_ = planetVersion;
+      sampling_ = sampling;
+      analyticTransmittanceEnabled_ = analyticTransmittanceEnabled;
+      band_ = 0;
+      bandAltitudes_.assign(bandCount, altitude_);
+      bandSunDirections_.assign(bandCount, sunDirection_);
+      updateCount = bandCount;
+    }
+    updatedRowCount_ = updateCount * bandHeight;
+    auto regions = std::vector<vk::Rect2D>{};
+    while (updateCount > 0) {
+      auto count = std::min(updateCount, bandCount - band_);
+      auto &region = regions.emplace_back();
+      region.offset.y = static_cast<std::int32_t>(band_ * bandHeight);
+      region.extent.width = extent.width;
+      region.extent.height = count * bandHeight;
+      for (auto i = band_; i < band_ + count; ++i) {
+        bandAltitudes_[i] = altitude_;
+        bandSunDirections_[i] = sunDirection_;
+      }
+      band_ = (band_ + count) % bandCount;
+      updateCount -= count;
+    }
+    return regions;
+  }
+
+  void SkyViewLut::render(
+      vk::CommandBuffer commandBuffer,
+      std::size_t frameIndex,
+      gsl::span<vk::Rect2D const> regions) {
+    auto &flyweight = *scene_->getFlyweight();
+    if (layout_ == vk::ImageLayout::eUndefined) {
+      auto barrier = vk::ImageMemoryBarrier{};
+      barrier.srcAccessMask = {};
+      barrier.dstAccessMask = {};
+      barrier.oldLayout = vk::ImageLayout::eUndefined;
+      barrier.newLayout = vk::ImageLayout::eShaderReadOnlyOptimal;
+      barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+      barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+      barrier.image = image_.get();
+      barrier.subresourceRange.aspectMask = vk::ImageAspectFlagBits::eColor;
+      barrier.subresourceRange.levelCount = 1;
+      barrier.subresourceRange.layerCount = 1;
+      commandBuffer.pipelineBarrier(
+          vk::PipelineStageFlagBits::eTopOfPipe,
+          vk::PipelineStageFlagBits::eFragmentShader,
+          {},
+          {},
+          {},
+          barrier);
+    }
+    auto context = flyweight.getContext();
+    auto extent =
+        vk::Extent2D{image_.getExtent().width, image_.getExtent().height};
+    auto barrier = vk::ImageMemoryBarrier{};
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.image = image_.get();
+    barrier.subresourceRange.aspectMask = vk::ImageAspectFlagBits::eColor;
+    barrier.subresourceRange.levelCount = 1;
+    barrier.subresourceRange.layerCount = 1;
+    if (context->isDynamicRenderingEnabled()) {
+      barrier.srcAccessMask = vk::AccessFlagBits::eShaderRead;
+      barrier.dstAccessMask = vk::AccessFlagBits::eColorAttachmentWrite;
+      barrier.oldLayout = vk::ImageLayout::eShaderReadOnlyOptimal;
+      barrier.newLayout = vk::ImageLayout::eColorAttachmentOptimal;
+      commandBuffer.pipelineBarrier(
+          vk::PipelineStageFlagBits::eFragmentShader |
+              vk::PipelineStageFlagBits::eComputeShader,
+          vk::PipelineStageFlagBits::eColorAttachmentOutput,
+          {},
+          {},
+          {},
+          barrier);
+      auto attachment = vk::RenderingAttachmentInfoKHR{};
+      attachment.imageView = imageView_;
+      attachment.imageLayout = vk::ImageLayout::eColorAttachmentOptimal;
+      attachment.loadOp = vk::AttachmentLoadOp::eLoad;
+      attachment.storeOp = vk::AttachmentStoreOp::eStore;
+      auto renderingInfo = vk::RenderingInfoKHR{};
+      renderingInfo.renderArea.extent = extent;
+      renderingInfo.layerCount = 1;
+      renderingInfo.colorAttachmentCount = 1;
+      renderingInfo.pColorAttachments = &attachment;
+      context->beginRendering(commandBuffer, renderingInfo);
+    } else {
+      auto renderPassBegin = vk::RenderPassBeginInfo{};
+      renderPassBegin.renderPass = flyweight.getSkyViewRenderPass();
+      renderPassBegin.framebuffer = framebuffer_;
+      renderPassBegin.renderArea.extent = extent;
+      commandBuffer.beginRenderPass(
+          renderPassBegin, vk::SubpassContents::eInline);
+    }
+    commandBuffer.bindPipeline(
+        vk::PipelineBindPoint::eGraphics,
+        flyweight.getSkyViewPipeline(
+            getAtmosphereQualitySettings(quality_).skyViewSteps,
+            *sampling_,
+            analyticTransmittanceEnabled_));
+    auto viewport = vk::Viewport{};
+    viewport.width = extent.width;
+    viewport.height = extent.height;
+    commandBuffer.setViewport(0, viewport);
+    commandBuffer.bindDescriptorSets(
+        vk::PipelineBindPoint::eGraphics,
+        flyweight.getSkyViewPipelineLayout(),
+        0,
+        descriptorSets_[frameIndex],
+        {});
+    auto parameters = std::array{
+        sunDirection_.x(), sunDirection_.y(), sunDirection_.z(), altitude_};
+    commandBuffer.pushConstants(
+        flyweight.getSkyViewPipelineLayout(),
+        vk::ShaderStageFlagBits::eFragment | vk::ShaderStageFlagBits::eCompute,
+        0,
+        sizeof(parameters),
+        parameters.data());
+    for (auto const &region : regions) {
+      commandBuffer.setScissor(0, region);
+      commandBuffer.draw(3, 1, 0, 0);
+    }
+    if (context->isDynamicRenderingEnabled()) {
+      context->endRendering(commandBuffer);
+      barrier.srcAccessMask = vk::AccessFlagBits::eColorAttachmentWrite;
+      barrier.dstAccessMask = vk::AccessFlagBits::eShaderRead;
+      barrier.oldLayout = vk::ImageLayout::eColorAttachmentOptimal;
+      barrier.newLayout = vk::ImageLayout::eShaderReadOnlyOptimal;
+      commandBuffer.pipelineBarrier(
+          vk::PipelineStageFlagBits::eColorAttachmentOutput,
+          vk::PipelineStageFlagBits::eFragmentShader,
+          {},
+          {},
+          {},
+          barrier);
+    } else {
+      commandBuffer.endRenderPass();
+    }
+  }
+
+  void SkyViewLut::dispatch(
+      vk::CommandBuffer commandBuffer,
+      std::size_t frameIndex,
+      gsl::span<vk::Rect2D const> regions,
+      bool asyncComputeEnabled) {
+    auto &flyweight = *scene_->getFlyweight();
+    auto shaderStages = asyncComputeEnabled
+                            ? vk::PipelineStageFlagBits::eComputeShader
+                            : vk::PipelineStageFlagBits::eFragmentShader;
+    auto barrier = vk::ImageMemoryBarrier{};
+    barrier.srcAccessMask = {};
+    barrier.dstAccessMask = vk::AccessFlagBits::eShaderWrite;
+    barrier.oldLayout = layout_;
+    barrier.newLayout = vk::ImageLayout::eGeneral;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.image = image_.get();
+    barrier.subresourceRange.aspectMask = vk::ImageAspectFlagBits::eColor;
+    barrier.subresourceRange.levelCount = 1;
+    barrier.subresourceRange.layerCount = 1;
+    commandBuffer.pipelineBarrier(
+        shaderStages,
+        vk::PipelineStageFlagBits::eComputeShader,
+        {},
+        {},
+        {},
+        barrier);
+    commandBuffer.bindPipeline(
+        vk::PipelineBindPoint::eCompute,
+        flyweight.getSkyViewComputePipeline(
+            getAtmosphereQualitySettings(quality_).skyViewSteps,
+            *sampling_,
+            analyticTransmittanceEnabled_));
+    commandBuffer.bindDescriptorSets(
+        vk::PipelineBindPoint::eCompute,
+        flyweight.getSkyViewPipelineLayout(),
+        0,
+        descriptorSets_[frameIndex],
+        {});
+    auto parameters = std::array{
+        sunDirection_.x(), sunDirection_.y(), sunDirection_.z(), altitude_};
+    commandBuffer.pushConstants(
+        flyweight.getSkyViewPipelineLayout(),
+        vk::ShaderStageFlagBits::eFragment | vk::ShaderStageFlagBits::eCompute,
+        0,
+        sizeof(parameters),
+        parameters.data());
+    auto workgroupSize = flyweight.getWorkgroupSize();
+    for (auto const &region : regions) {
+      commandBuffer.dispatchBase(
+          0,
+          static_cast<std::uint32_t>(region.offset.y) / workgroupSize.height,
+          0,
+          (region.extent.width + workgroupSize.width - 1) /
+              workgroupSize.width,
+          region.extent.height / workgroupSize.height,
+          1);
+    }
+    barrier.srcAccessMask = vk::AccessFlagBits::eShaderWrite;
+    barrier.dstAccessMask = vk::AccessFlagBits::eShaderRead;
+    barrier.oldLayout = vk::ImageLayout::eGeneral;
+    barrier.newLayout = vk::ImageLayout::eShaderReadOnlyOptimal;
+    commandBuffer.pipelineBarrier(
+        vk::PipelineStageFlagBits::eComputeShader,
+        shaderStages,
+        {},
+        {},
+        {},
+        barrier);
+  }
+
+  gsl::not_null<Scene const *> SkyViewLut::getScene() const noexcept {
+    return scene_;
+  }
+
+  AtmosphereQuality SkyViewLut::getQuality() const noexcept {
+    return quality_;
+  }
+
+  GpuImage const &SkyViewLut::getImage() const noexcept {
+    return image_;
+  }
+
+  vk::ImageView SkyViewLut::getImageView() const noexcept {
+    return imageView_;
+  }
+
+  float SkyViewLut::getAltitude() const noexcept {
+    return altitude_;
+  }
+
+  Eigen::Vector3f const &SkyViewLut::getSunDirection() const noexcept {
+    return sunDirection_;
+  }
+
+  std::uint32_t SkyViewLut::getUpdatedRowCount() const noexcept {
+    return updatedRowCount_;
+  }
+} // namespace imp
\ No newline at end of file
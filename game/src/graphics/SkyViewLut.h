@@ -0,0 +1,75 @@
+#pragma once
+
+#include <optional>
+#include <vector>
+
+#include <Eigen/Dense>
+
+#include "../system/GpuImage.h"
+#include "AtmosphereQuality.h"
+
+namespace imp {
+  class Scene;
+
+  class SkyViewLut {
+  public:
+    explicit SkyViewLut(gsl::not_null<Scene const *> scene);
+
+  private:
+    vk::DescriptorPool createDescriptorPool() const;
+    GpuImage createImage() const;
+    vk::ImageView createImageView() const;
+    vk::Framebuffer createFramebuffer() const;
+    std::vector<vk::DescriptorSet> createDescriptorSets() const;
+
+  public:
+    ~SkyViewLut();
+
+    void update(
+        vk::CommandBuffer commandBuffer,
+        std::size_t frameIndex,
+        float altitude,
+        Eigen::Vector3f const &sunDirection,
+        bool asyncComputeEnabled);
+
+  private:
+    std::vector<vk::Rect2D> updateBands();
+    void render(
+        vk::CommandBuffer commandBuffer,
+        std::size_t frameIndex,
+        gsl::span<vk::Rect2D const> regions);
+    void dispatch(
+        vk::CommandBuffer commandBuffer,
+        std::size_t frameIndex,
+        gsl::span<vk::Rect2D const> regions,
+        bool asyncComputeEnabled);
+
+  public:
+    gsl::not_null<Scene const *> getScene() const noexcept;
+    AtmosphereQuality getQuality() const noexcept;
+    GpuImage const &getImage() const noexcept;
+    vk::ImageView getImageView() const noexcept;
+    float getAltitude() const noexcept;
+    Eigen::Vector3f const &getSunDirection() const noexcept;
+    std::uint32_t getUpdatedRowCount() const noexcept;
+
+  private:
+    gsl::not_null<Scene const *> scene_;
+    AtmosphereQuality quality_;
+    vk::DescriptorPool descriptorPool_;
+    GpuImage image_;
+    vk::ImageView imageView_;
+    vk::Framebuffer framebuffer_;
+    std::vector<vk::DescriptorSet> descriptorSets_;
+    vk::ImageLayout layout_;
+    float altitude_;
+    Eigen::Vector3f sunDirection_;
+    std::uint32_t band_;
+    std::uint32_t updatedRowCount_;
+    std::optional<std::uint64_t> planetVersion_;
+    std::optional<AtmosphereSampling> sampling_;
+    bool analyticTransmittanceEnabled_;
+    std::vector<float> bandAltitudes_;
+    std::vector<Eigen::Vector3f> bandSunDirections_;
+  };
+} // namespace imp
\ No newline at end of file
@@ -0,0 +1,114 @@
+#include "BenchmarkReport.h"
+
+#include <sstream>
+#include <stdexcept>
+
+namespace imp {
+  namespace {
+    void checkField(std::string_view field) {
+      if (field.find_first_of(",\n") != std::string_view::npos) {
+        throw std::runtime_error{"benchmark field contains a separator."};
+      }
+    }
+  } // namespace
+
+  BenchmarkReport BenchmarkReport::readCsv(std::istream &is) {
+    auto report = BenchmarkReport{};
+    auto line = std::string{};
+    if (!std::getline(is, line) ||
+        line != "configuration,metric,samples,average,p95,p99") {
+      throw std::runtime_error{"invalid benchmark header."};
+    }
+    while (std::getline(is, line)) {
+      if (line.empty()) {
+        continue;
+      }
+      auto fields = std::vector<std::string>{};
+      auto stream = std::istringstream{line};
+      for (auto field = std::string{}; std::getline(stream, field, ',');) {
+        fields.emplace_back(std::move(field));
+      }
+      if (fields.size() != 6) {
+        throw std::runtime_error{"invalid benchmark row."};
+      }
+      try {
+        report.add(BenchmarkResult{
+            std::move(fields[0]),
+            std::move(fields[1]),
+            std::stoul(fields[2]),
+            std::stod(fields[3]),
+            std::stod(fields[4]),
+            std::stod(fields[5])});
+      } catch (std::logic_error const &) {
+        throw std::runtime_error{"invalid benchmark value."};
+      }
+    }
+    return report;
+  }
+
+  void BenchmarkReport::add(BenchmarkResult result) {
+    checkField(result.configuration);
+    checkField(result.metric);
+    results_.emplace_back(std::move(result));
+  }
+
+  void BenchmarkReport::add(
+      std::string_view configuration,
+      std::string_view metric,
+      TimingStats const &stats) {
+    add(BenchmarkResult{
+        std::string{configuration},
+        std::string{metric},
+        stats.sampleCount,
+        stats.average,
+        stats.p95,
+        stats.p99});
+  }
+
+  std::optional<BenchmarkResult> BenchmarkReport::find(
+      std::string_view configuration, std::string_view metric) const {
+    for (auto &result : results_) {
+      if (result.configuration == configuration && result.metric == metric) {
+        return result;
+      }
+    }
+    return std::nullopt;
+  }
+
+  std::vector<BenchmarkResult> const &
+  BenchmarkReport::getResults() const noexcept {
+    return results_;
+  }
+
+  std::vector<BenchmarkRegression> BenchmarkReport::findRegressions(
+      BenchmarkReport const &baseline,
+      double tolerance,
+      double minDifference) const {
+    auto regressions = std::vector<BenchmarkRegression>{};
+    for (auto &result : results_) {
+      auto baselineResult = baseline.find(result.configuration, result.metric);
+      if (!baselineResult) {
+        continue;
+      }
+      auto difference = result.average - baselineResult->average;
+      if (difference > minDifference &&
+          result.average > baselineResult->average * (1.0 + tolerance)) {
+        regressions.emplace_back(BenchmarkRegression{
+            result.configuration,
+            result.metric,
+            baselineResult->average,
+            result.average});
+      }
+    }
+    return regressions;
+  }
+
+  void BenchmarkReport::writeCsv(std::ostream &os) const {
+    os << "configuration,metric,samples,average,p95,p99\n";
+    for (auto &result : results_) {
+      os << result.configuration << "," << result.metric << ","
+         << result.sampleCount << "," << result.average << "," << result.p95
+         << "," << result.p99 << "\n";
+    }
+  }
+} // namespace imp
\ No newline at end of file
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstddef>
+#include <istream>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "TimingHistory.h"
+
+namespace imp {
+  struct BenchmarkResult {
+    std::string configuration;
+    std::string metric;
+    std::size_t sampleCount;
+    double average;
+    double p95;
+    double p99;
+  };
+
+  struct BenchmarkRegression {
+    std::string configuration;
+    std::string metric;
+    double baseline;
+    double current;
+  };
+
+  class BenchmarkReport {
+  public:
+    static BenchmarkReport readCsv(std::istream &is);
+
+    void add(BenchmarkResult result);
+    void add(
+        std::string_view configuration,
+        std::string_view metric,
+        TimingStats const &stats);
+
+    std::optional<BenchmarkResult>
+    find(std::string_view configuration, std::string_view metric) const;
+    std::vector<BenchmarkResult> const &getResults() const noexcept;
+
+    std::vector<BenchmarkRegression> findRegressions(
+        BenchmarkReport const &baseline,
+        double tolerance,
+        double minDifference) const;
+
+    void writeCsv(std::ostream &os) const;
+
+  private:
+    std::vector<BenchmarkResult> results_;
+  };
+} // namespace imp
\ No newline at end of file
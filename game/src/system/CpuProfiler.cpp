@@ -0,0 +1,180 @@
+#include "CpuProfiler.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <string_view>
+
+namespace imp {
+  std::atomic<bool> CpuProfiler::enabled_{false};
+  std::chrono::steady_clock::time_point const CpuProfiler::epoch_ =
+      std::chrono::steady_clock::now();
+  std::mutex CpuProfiler::mutex_;
+  std::vector<std::unique_ptr<CpuProfiler::ThreadBuffer>>
+      CpuProfiler::buffers_;
+  std::vector<CpuProfiler::ThreadBuffer *> CpuProfiler::freeBuffers_;
+  std::optional<std::chrono::steady_clock::time_point>
+      CpuProfiler::frameTime_;
+  FrameTimeHistogram CpuProfiler::frameTimes_;
+
+  namespace {
+    void writeJsonString(std::ostream &os, std::string_view s) {
+      os << '"';
+      for (auto c : s) {
+        if (c == '"' || c == '\\') {
+          os << '\\';
+        }
+        os << c;
+      }
+      os << '"';
+    }
+  } // namespace
+
+  void CpuProfiler::setEnabled(bool enabled) noexcept {
+    enabled_.store(enabled, std::memory_order_relaxed);
+  }
+
+  void CpuProfiler::setThreadName(std::string name) {
+    auto &buffer = getThreadBuffer();
+    auto lock = std::scoped_lock{mutex_};
+    buffer.name = std::move(name);
+  }
+
+  void CpuProfiler::record(
+      char const *name,
+      std::chrono::steady_clock::time_point begin,
+      std::chrono::steady_clock::time_point end) {
+    auto &buffer = getThreadBuffer();
+    auto count = buffer.count.load(std::memory_order_relaxed);
+    auto &slot = buffer.slots[count % BUFFER_CAPACITY];
+    buffer.reserved.store(count + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.name.store(name, std::memory_order_relaxed);
+    slot.begin.store(getTimestamp(begin), std::memory_order_relaxed);
+    slot.end.store(getTimestamp(end), std::memory_order_relaxed);
+    buffer.count.store(count + 1, std::memory_order_release);
+  }
+
+  void CpuProfiler::markFrame() {
+    auto now = std::chrono::steady_clock::now();
+    if (frameTime_ && isEnabled()) {
+      record("frame", *frameTime_, now);
+      auto lock = std::scoped_lock{mutex_};
+      frameTimes_.record(
+          std::chrono::duration<double, std::milli>{now - *frameTime_}
+              .count());
+    }
+    frameTime_ = now;
+  }
+
+  void CpuProfiler::clear() {
+    auto lock = std::scoped_lock{mutex_};
+    for (auto &buffer : buffers_) {
+      buffer->begin = buffer->count.load(std::memory_order_acquire);
+    }
+    frameTime_.reset();
+    frameTimes_.clear();
+  }
+
+  FrameTimeHistogram CpuProfiler::getFrameTimes() {
+    auto lock = std::scoped_lock{mutex_};
+    return frameTimes_;
+  }
+
+  std::vector<CpuProfiler::Event> CpuProfiler::getEvents() {
+    auto events = std::vector<Event>{};
+    auto lock = std::scoped_lock{mutex_};
+    for (auto &buffer : buffers_) {
+      auto bufferEvents = readEvents(*buffer);
+      events.insert(events.end(), bufferEvents.begin(), bufferEvents.end());
+    }
+    return events;
+  }
+
+  void CpuProfiler::writeChromeTrace(std::ostream &os) {
+    auto lock = std::scoped_lock{mutex_};
+    auto flags = os.flags();
+    auto precision = os.precision();
+    os << std::fixed << std::setprecision(3);
+    os << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [";
+    auto first = true;
+    for (auto i = std::size_t{}; i < buffers_.size(); ++i) {
+      auto &buffer = *buffers_[i];
+      os << (first ? "\n" : ",\n")
+         << "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, "
+            "\"tid\": "
+         << i << ", \"args\": {\"name\": ";
+      writeJsonString(os, buffer.name);
+      os << "}}";
+      first = false;
+      for (auto &event : readEvents(buffer)) {
+        os << ",\n{\"name\": ";
+        writeJsonString(os, event.name);
+        os << ", \"ph\": \"X\", \"pid\": 1, \"tid\": " << i
+           << ", \"ts\": " << double(event.begin) * 1e-3
+           << ", \"dur\": " << double(event.end - event.begin) * 1e-3 << "}";
+      }
+    }
+    os << "\n]}\n";
+    os.flags(flags);
+    os.precision(precision);
+  }
+
+  CpuProfiler::ThreadBufferOwner::~ThreadBufferOwner() {
+    if (buffer) {
+      auto lock = std::scoped_lock{mutex_};
+      freeBuffers_.emplace_back(buffer);
+    }
+  }
+
+  CpuProfiler::ThreadBuffer &CpuProfiler::getThreadBuffer() {
+    thread_local auto owner = ThreadBufferOwner{};
+    if (!owner.buffer) {
+      owner.buffer = acquireThreadBuffer();
+    }
+    return *owner.buffer;
+  }
+
+  CpuProfiler::ThreadBuffer *CpuProfiler::acquireThreadBuffer() {
+    auto lock = std::scoped_lock{mutex_};
+    if (freeBuffers_.empty()) {
+      buffers_.emplace_back(std::make_unique<ThreadBuffer>());
+      buffers_.back()->index = buffers_.size() - 1;
+      freeBuffers_.emplace_back(buffers_.back().get());
+    }
+    auto buffer = freeBuffers_.back();
+    freeBuffers_.pop_back();
+    buffer->name = "thread " + std::to_string(buffer->index);
+    buffer->begin = buffer->count.load(std::memory_order_relaxed);
+    return buffer;
+  }
+
+  std::vector<CpuProfiler::Event>
+  CpuProfiler::readEvents(ThreadBuffer const &buffer) {
+    auto count = buffer.count.load(std::memory_order_acquire);
+    auto first = std::max(
+        buffer.begin, count > BUFFER_CAPACITY ? count - BUFFER_CAPACITY : 0);
+    auto events = std::vector<Event>{};
+    events.reserve(count - first);
+    for (auto i = first; i < count; ++i) {
+      auto &slot = buffer.slots[i % BUFFER_CAPACITY];
+      events.emplace_back(Event{
+          slot.name.load(std::memory_order_relaxed),
+          slot.begin.load(std::memory_order_relaxed),
+          slot.end.load(std::memory_order_relaxed)});
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    auto reserved = buffer.reserved.load(std::memory_order_relaxed);
+    if (reserved > first + BUFFER_CAPACITY) {
+      auto overwritten =
+          std::min(reserved - BUFFER_CAPACITY - first, count - first);
+      events.erase(events.begin(), events.begin() + overwritten);
+    }
+    return events;
+  }
+
+  std::int64_t CpuProfiler::getTimestamp(
+      std::chrono::steady_clock::time_point time) noexcept {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(time - epoch_)
+        .count();
+  }
+} // namespace imp
\ No newline at end of file
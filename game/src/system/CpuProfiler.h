@@ -0,0 +1,118 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "FrameTimeHistogram.h"
+
+namespace imp {
+  class CpuProfiler {
+  public:
+    static constexpr auto BUFFER_CAPACITY = std::size_t{16384};
+
+    struct Event {
+      char const *name;
+      std::int64_t begin;
+      std::int64_t end;
+    };
+
+    static bool isEnabled() noexcept {
+      return enabled_.load(std::memory_order_relaxed);
+    }
+
+    static void setEnabled(bool enabled) noexcept;
+    static void setThreadName(std::string name);
+    static void record(
+        char const *name,
+        std::chrono::steady_clock::time_point begin,
+        std::chrono::steady_clock::time_point end);
+    static void markFrame();
+    static void clear();
+
+    static FrameTimeHistogram getFrameTimes();
+    static std::vector<Event> getEvents();
+    static void writeChromeTrace(std::ostream &os);
+
+  private:
+    struct Slot {
+      std::atomic<char const *> name;
+      std::atomic<std::int64_t> begin;
+      std::atomic<std::int64_t> end;
+    };
+
+    struct ThreadBuffer {
+      std::size_t index;
+      std::string name;
+      std::array<Slot, BUFFER_CAPACITY> slots;
+      std::atomic<std::uint64_t> reserved;
+      std::atomic<std::uint64_t> count;
+      std::uint64_t begin;
+    };
+
+    class ThreadBufferOwner {
+    public:
+      ThreadBufferOwner() noexcept = default;
+      ~ThreadBufferOwner();
+
+      ThreadBufferOwner(ThreadBufferOwner const &) = delete;
+      ThreadBufferOwner &operator=(ThreadBufferOwner const &) = delete;
+
+      ThreadBuffer *buffer = nullptr;
+    };
+
+    static ThreadBuffer &getThreadBuffer();
+    static ThreadBuffer *acquireThreadBuffer();
+    static std::vector<Event> readEvents(ThreadBuffer const &buffer);
+    static std::int64_t
+    getTimestamp(std::chrono::steady_clock::time_point time) noexcept;
+
+    static std::atomic<bool> enabled_;
+    static std::chrono::steady_clock::time_point const epoch_;
+    static std::mutex mutex_;
+    static std::vector<std::unique_ptr<ThreadBuffer>> buffers_;
+    static std::vector<ThreadBuffer *> freeBuffers_;
+    static std::optional<std::chrono::steady_clock::time_point> frameTime_;
+    static FrameTimeHistogram frameTimes_;
+  };
+
+  class CpuZone {
+  public:
+    explicit CpuZone(char const *name) noexcept:
+        name_{CpuProfiler::isEnabled() ? name : nullptr} {
+      if (name_) {
+        begin_ = std::chrono::steady_clock::now();
+      }
+    }
+
+    ~CpuZone() {
+      if (name_) {
+        CpuProfiler::record(name_, begin_, std::chrono::steady_clock::now());
+      }
+    }
+
+    CpuZone(CpuZone const &) = delete;
+    CpuZone &operator=(CpuZone const &) = delete;
+
+  private:
+    char const *name_;
+    std::chrono::steady_clock::time_point begin_;
+  };
+} // namespace imp
+
+#define IMP_CPU_ZONE_CONCAT_INNER(a, b) a##b
+#define IMP_CPU_ZONE_CONCAT(a, b) IMP_CPU_ZONE_CONCAT_INNER(a, b)
+
+#ifdef IMP_CPU_PROFILING_DISABLED
+#define IMP_CPU_ZONE(name)
+#else
+#define IMP_CPU_ZONE(name)                                                     \
+  ::imp::CpuZone IMP_CPU_ZONE_CONCAT(cpuZone, __LINE__) { name }
+#endif
\ No newline at end of file
@@ -3,6 +3,8 @@
 #include <iostream>
 #include <stdexcept>
 
+#include "CpuProfiler.h"
+
 namespace imp {
   void Display::init() {
     if (!glfwInit())
@@ -11,6 +13,7 @@ namespace imp {
   }
 
   void Display::poll() {
+    IMP_CPU_ZONE("Display::poll");
     glfwPollEvents();
   }
 
@@ -105,6 +108,9 @@ namespace imp {
   }
 
   vk::RenderPass Display::createRenderPass() {
+    if (context_->isDynamicRenderingEnabled()) {
+      return {};
+    }
     auto attachmentDesc = GpuAttachmentDescription{};
     attachmentDesc.format = surfaceFormat_.format;
     attachmentDesc.samples = vk::SampleCountFlagBits::e1;
@@ -194,6 +200,9 @@ namespace imp {
       createInfo.subresourceRange.layerCount = 1;
       swapchainImageViews_.emplace_back(device.createImageView(createInfo));
     }
+    if (context_->isDynamicRenderingEnabled()) {
+      return;
+    }
     for (auto imageView : swapchainImageViews_) {
       auto createInfo = vk::FramebufferCreateInfo{};
       createInfo.renderPass = renderPass_;
@@ -262,12 +271,21 @@ namespace imp {
     return swapchainHeight_;
   }
 
+  vk::Format Display::getFormat() const noexcept {
+    return surfaceFormat_.format;
+  }
+
+  vk::ImageLayout Display::getFinalLayout() const noexcept {
+    return vk::ImageLayout::ePresentSrcKHR;
+  }
+
   bool Display::shouldClose() const noexcept {
     return glfwWindowShouldClose(window_);
   }
 
   std::uint32_t
   Display::acquireImage(vk::Semaphore semaphore, vk::Fence fence) {
+    IMP_CPU_ZONE("Display::acquireImage");
     try {
       return context_->getDevice()
           .acquireNextImageKHR(
@@ -285,6 +303,7 @@ namespace imp {
 
   void Display::present(
       gsl::span<vk::Semaphore const> waitSemaphores, std::uint32_t imageIndex) {
+    IMP_CPU_ZONE("Display::present");
     auto info = vk::PresentInfoKHR{};
     info.waitSemaphoreCount = static_cast<std::uint32_t>(waitSemaphores.size());
     info.pWaitSemaphores = waitSemaphores.data();
@@ -306,4 +325,12 @@ namespace imp {
   vk::Framebuffer Display::getFramebuffer(std::uint32_t index) const noexcept {
     return swapchainFramebuffers_[index];
   }
+
+  vk::Image Display::getImage(std::uint32_t index) const noexcept {
+    return swapchainImages_[index];
+  }
+
+  vk::ImageView Display::getImageView(std::uint32_t index) const noexcept {
+    return swapchainImageViews_[index];
+  }
 } // namespace imp
\ No newline at end of file
@@ -4,10 +4,10 @@
 
 #include <GLFW/glfw3.h>
 
-#include "GpuContext.h"
+#include "RenderTarget.h"
 
 namespace imp {
-  class Display {
+  class Display: public RenderTarget {
   public:
     static void init();
     static void poll();
@@ -18,25 +18,31 @@ namespace imp {
         unsigned height,
         char const *title,
         bool fullscreen);
-    ~Display();
+    ~Display() override;
 
-    gsl::not_null<GpuContext *> getContext() const noexcept;
+    gsl::not_null<GpuContext *> getContext() const noexcept override;
     vk::SurfaceFormatKHR const &getSurfaceFormat() const noexcept;
     unsigned getWindowWidth() const noexcept;
     unsigned getWindowHeight() const noexcept;
     unsigned getFramebufferWidth() const noexcept;
     unsigned getFramebufferHeight() const noexcept;
-    unsigned getSwapchainWidth() const noexcept;
-    unsigned getSwapchainHeight() const noexcept;
+    unsigned getSwapchainWidth() const noexcept override;
+    unsigned getSwapchainHeight() const noexcept override;
+    vk::Format getFormat() const noexcept override;
+    vk::ImageLayout getFinalLayout() const noexcept override;
     bool shouldClose() const noexcept;
 
-    std::uint32_t acquireImage(vk::Semaphore semaphore, vk::Fence fence);
+    std::uint32_t
+    acquireImage(vk::Semaphore semaphore, vk::Fence fence) override;
     void present(
         gsl::span<vk::Semaphore const> waitSemaphores,
-        std::uint32_t imageIndex);
+        std::uint32_t imageIndex) override;
 
-    vk::RenderPass getRenderPass() const noexcept;
-    vk::Framebuffer getFramebuffer(std::uint32_t index) const noexcept;
+    vk::RenderPass getRenderPass() const noexcept override;
+    vk::Framebuffer
+    getFramebuffer(std::uint32_t index) const noexcept override;
+    vk::Image getImage(std::uint32_t index) const noexcept override;
+    vk::ImageView getImageView(std::uint32_t index) const noexcept override;
 
   private:
     gsl::not_null<GpuContext *> context_;
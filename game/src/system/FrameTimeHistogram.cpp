@@ -0,0 +1,85 @@
+#include "FrameTimeHistogram.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace imp {
+  FrameTimeHistogram::FrameTimeHistogram(
+      double bucketWidth, std::size_t bucketCount):
+      bucketWidth_{bucketWidth},
+      buckets_(bucketCount),
+      count_{0},
+      sum_{0.0},
+      max_{0.0} {
+    if (bucketWidth_ <= 0.0 || bucketCount == 0) {
+      throw std::runtime_error{"invalid histogram dimensions."};
+    }
+  }
+
+  void FrameTimeHistogram::record(double frameTime) {
+    auto bucket = static_cast<std::size_t>(
+        std::max(frameTime, 0.0) / bucketWidth_);
+    ++buckets_[std::min(bucket, buckets_.size() - 1)];
+    ++count_;
+    sum_ += frameTime;
+    max_ = std::max(max_, frameTime);
+  }
+
+  void FrameTimeHistogram::clear() noexcept {
+    std::fill(buckets_.begin(), buckets_.end(), std::uint64_t{});
+    count_ = 0;
+    sum_ = 0.0;
+    max_ = 0.0;
+  }
+
+  double FrameTimeHistogram::getPercentile(double p) const noexcept {
+    if (count_ == 0) {
+      return 0.0;
+    }
+    auto rank = std::max(
+        static_cast<std::uint64_t>(std::ceil(p * count_)), std::uint64_t{1});
+    auto cumulative = std::uint64_t{};
+    for (auto i = std::size_t{}; i + 1 < buckets_.size(); ++i) {
+      cumulative += buckets_[i];
+      if (cumulative >= rank) {
+        return std::min(bucketWidth_ * (i + 1), max_);
+      }
+    }
+    return max_;
+  }
+
+  double FrameTimeHistogram::getAverage() const noexcept {
+    return count_ != 0 ? sum_ / count_ : 0.0;
+  }
+
+  double FrameTimeHistogram::getMax() const noexcept {
+    return max_;
+  }
+
+  std::uint64_t FrameTimeHistogram::getCount() const noexcept {
+    return count_;
+  }
+
+  double FrameTimeHistogram::getBucketWidth() const noexcept {
+    return bucketWidth_;
+  }
+
+  std::vector<std::uint64_t> const &
+  FrameTimeHistogram::getBuckets() const noexcept {
+    return buckets_;
+  }
+
+  void FrameTimeHistogram::writeCsv(std::ostream &os) const {
+    os << "min,max,count\n";
+    for (auto i = std::size_t{}; i < buckets_.size(); ++i) {
+      if (buckets_[i] != 0) {
+        os << bucketWidth_ * i << ",";
+        if (i + 1 < buckets_.size()) {
+          os << bucketWidth_ * (i + 1);
+        }
+        os << "," << buckets_[i] << "\n";
+      }
+    }
+  }
+} // namespace imp
\ No newline at end of file
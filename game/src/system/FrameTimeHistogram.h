@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+namespace imp {
+  class FrameTimeHistogram {
+  public:
+    explicit FrameTimeHistogram(
+        double bucketWidth = 0.25, std::size_t bucketCount = 400);
+
+    void record(double frameTime);
+    void clear() noexcept;
+
+    double getPercentile(double p) const noexcept;
+    double getAverage() const noexcept;
+    double getMax() const noexcept;
+    std::uint64_t getCount() const noexcept;
+    double getBucketWidth() const noexcept;
+    std::vector<std::uint64_t> const &getBuckets() const noexcept;
+
+    void writeCsv(std::ostream &os) const;
+
+  private:
+    double bucketWidth_;
+    std::vector<std::uint64_t> buckets_;
+    std::uint64_t count_;
+    double sum_;
+    double max_;
+  };
+} // namespace imp
\ No newline at end of file
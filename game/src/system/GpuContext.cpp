@@ -1,7 +1,9 @@
 #include "GpuContext.h"
 
+#include <algorithm>
 #include <optional>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <unordered_set>
 
@@ -13,6 +15,9 @@ namespace imp {
       presentationEnabled_{createInfo.presentation},
       instance_{createInstance()},
       physicalDevice_{selectPhysicalDevice()},
+      subgroupSize_{querySubgroupSize()},
+      dynamicRenderingEnabled_{
+          createInfo.dynamicRendering && queryDynamicRenderingSupport()},
       graphicsFamily_{selectGraphicsFamily()},
       computeFamily_{selectComputeFamily()},
       transferFamily_{selectTransferFamily()},
@@ -22,6 +27,16 @@ namespace imp {
       computeQueue_{selectComputeQueue()},
       transferQueue_{selectTransferQueue()},
       presentQueue_{selectPresentQueue()},
+      cmdBeginRendering_{
+          dynamicRenderingEnabled_
+              ? loadDeviceFunction<PFN_vkCmdBeginRenderingKHR>(
+                    "vkCmdBeginRenderingKHR")
+              : nullptr},
+      cmdEndRendering_{
+          dynamicRenderingEnabled_
+              ? loadDeviceFunction<PFN_vkCmdEndRenderingKHR>(
+                    "vkCmdEndRenderingKHR")
+              : nullptr},
       allocator_{createAllocator()},
       renderPasses_{*device_},
       descriptorSetLayouts_{*device_},
@@ -49,6 +64,10 @@ namespace imp {
     return physicalDevice_;
   }
 
+  std::uint32_t GpuContext::getSubgroupSize() const noexcept {
+    return subgroupSize_;
+  }
+
   std::uint32_t GpuContext::getGraphicsFamily() const noexcept {
     return graphicsFamily_;
   }
@@ -89,6 +108,14 @@ namespace imp {
     return allocator_;
   }
 
+  bool GpuContext::isStorageImageWriteWithoutFormatSupported() const noexcept {
+    return physicalDevice_.getFeatures().shaderStorageImageWriteWithoutFormat;
+  }
+
+  bool GpuContext::isDynamicRenderingEnabled() const noexcept {
+    return dynamicRenderingEnabled_;
+  }
+
   vk::RenderPass
   GpuContext::createRenderPass(GpuRenderPassCreateInfo const &createInfo) {
     return renderPasses_.create(createInfo);
@@ -109,6 +136,24 @@ namespace imp {
     return samplers_.create(createInfo);
   }
 
+  void GpuContext::beginRendering(
+      vk::CommandBuffer commandBuffer,
+      vk::RenderingInfoKHR const &renderingInfo) const {
+    if (!cmdBeginRendering_) {
+      throw std::runtime_error{"dynamic rendering is not enabled."};
+    }
+    cmdBeginRendering_(
+        commandBuffer,
+        reinterpret_cast<VkRenderingInfoKHR const *>(&renderingInfo));
+  }
+
+  void GpuContext::endRendering(vk::CommandBuffer commandBuffer) const {
+    if (!cmdEndRendering_) {
+      throw std::runtime_error{"dynamic rendering is not enabled."};
+    }
+    cmdEndRendering_(commandBuffer);
+  }
+
   vk::UniqueInstance GpuContext::createInstance() {
     auto app_info = vk::ApplicationInfo{};
     app_info.pApplicationName = "dream";
@@ -219,6 +264,30 @@ namespace imp {
     return best_pd;
   }
 
+  std::uint32_t GpuContext::querySubgroupSize() {
+    auto properties = physicalDevice_.getProperties2<
+        vk::PhysicalDeviceProperties2,
+        vk::PhysicalDeviceSubgroupProperties>();
+    return properties.get<vk::PhysicalDeviceSubgroupProperties>()
+        .subgroupSize;
+  }
+
+  bool GpuContext::queryDynamicRenderingSupport() {
+    auto extensions = physicalDevice_.enumerateDeviceExtensionProperties();
+    if (std::none_of(
+            extensions.begin(), extensions.end(), [](auto &extension) {
+              return std::string_view{extension.extensionName} ==
+                     VK_KHR_DYNAMIC_RENDERING_EXTENSION_NAME;
+            })) {
+      return false;
+    }
+    auto features = physicalDevice_.getFeatures2<
+        vk::PhysicalDeviceFeatures2,
+        vk::PhysicalDeviceDynamicRenderingFeaturesKHR>();
+    return features.get<vk::PhysicalDeviceDynamicRenderingFeaturesKHR>()
+        .dynamicRendering;
+  }
+
   std::uint32_t GpuContext::selectGraphicsFamily() {
     auto families = physicalDevice_.getQueueFamilyProperties();
     for (auto i = std::uint32_t{0}; i < families.size(); ++i) {
@@ -300,7 +369,20 @@ namespace imp {
     }
     auto features = vk::PhysicalDeviceFeatures{};
     features.shaderSampledImageArrayDynamicIndexing = true;
+    features.shaderStorageImageWriteWithoutFormat =
+        isStorageImageWriteWithoutFormatSupported();
+    auto features12 = vk::PhysicalDeviceVulkan12Features{};
+    features12.timelineSemaphore = true;
+    features12.hostQueryReset = true;
+    auto dynamicRenderingFeatures =
+        vk::PhysicalDeviceDynamicRenderingFeaturesKHR{};
+    if (dynamicRenderingEnabled_) {
+      extensions.emplace_back(VK_KHR_DYNAMIC_RENDERING_EXTENSION_NAME);
+      dynamicRenderingFeatures.dynamicRendering = true;
+      features12.pNext = &dynamicRenderingFeatures;
+    }
     auto create_info = vk::DeviceCreateInfo{};
+    create_info.pNext = &features12;
     create_info.queueCreateInfoCount =
         static_cast<uint32_t>(queueCreateInfos.size());
     create_info.pQueueCreateInfos = queueCreateInfos.data();
@@ -328,6 +410,15 @@ namespace imp {
     return presentFamily_ ? device_->getQueue(*presentFamily_, 0) : vk::Queue{};
   }
 
+  template<typename F>
+  F GpuContext::loadDeviceFunction(char const *name) {
+    auto function = reinterpret_cast<F>(device_->getProcAddr(name));
+    if (!function) {
+      throw std::runtime_error{"failed to load device function."};
+    }
+    return function;
+  }
+
   gsl::not_null<VmaAllocator> GpuContext::createAllocator() {
     auto info = VmaAllocatorCreateInfo{};
     info.physicalDevice = physicalDevice_;
@@ -15,6 +15,7 @@ namespace imp {
   struct GpuContextCreateInfo {
     bool validation;
     bool presentation;
+    bool dynamicRendering;
   };
 
   class GpuContext {
@@ -26,6 +27,7 @@ namespace imp {
     bool isPresentationEnabled() const noexcept;
     vk::Instance getInstance() const noexcept;
     vk::PhysicalDevice getPhysicalDevice() const noexcept;
+    std::uint32_t getSubgroupSize() const noexcept;
     std::uint32_t getGraphicsFamily() const noexcept;
     std::uint32_t getComputeFamily() const noexcept;
     std::optional<std::uint32_t> getTransferFamily() const noexcept;
@@ -36,6 +38,8 @@ namespace imp {
     vk::Queue getTransferQueue() const noexcept;
     vk::Queue getPresentQueue() const noexcept;
     gsl::not_null<VmaAllocator> getAllocator() const noexcept;
+    bool isStorageImageWriteWithoutFormatSupported() const noexcept;
+    bool isDynamicRenderingEnabled() const noexcept;
 
     vk::RenderPass createRenderPass(GpuRenderPassCreateInfo const &createInfo);
 
@@ -47,11 +51,18 @@ namespace imp {
 
     vk::Sampler createSampler(GpuSamplerCreateInfo const &createInfo);
 
+    void beginRendering(
+        vk::CommandBuffer commandBuffer,
+        vk::RenderingInfoKHR const &renderingInfo) const;
+    void endRendering(vk::CommandBuffer commandBuffer) const;
+
   private:
     bool validationEnabled_;
     bool presentationEnabled_;
     vk::UniqueInstance instance_;
     vk::PhysicalDevice physicalDevice_;
+    std::uint32_t subgroupSize_;
+    bool dynamicRenderingEnabled_;
     std::uint32_t graphicsFamily_;
     std::uint32_t computeFamily_;
     std::optional<std::uint32_t> transferFamily_;
@@ -61,6 +72,8 @@ namespace imp {
     vk::Queue computeQueue_;
     vk::Queue transferQueue_;
     vk::Queue presentQueue_;
+    PFN_vkCmdBeginRenderingKHR cmdBeginRendering_;
+    PFN_vkCmdEndRenderingKHR cmdEndRendering_;
     gsl::not_null<VmaAllocator> allocator_;
     GpuRenderPassCache renderPasses_;
     GpuDescriptorSetLayoutCache descriptorSetLayouts_;
@@ -69,6 +82,8 @@ namespace imp {
 
     vk::UniqueInstance createInstance();
     vk::PhysicalDevice selectPhysicalDevice();
+    std::uint32_t querySubgroupSize();
+    bool queryDynamicRenderingSupport();
     std::uint32_t selectGraphicsFamily();
     std::uint32_t selectComputeFamily();
     std::optional<std::uint32_t> selectTransferFamily();
@@ -78,6 +93,8 @@ namespace imp {
     vk::Queue selectComputeQueue();
     vk::Queue selectTransferQueue();
     vk::Queue selectPresentQueue();
+    template<typename F>
+    F loadDeviceFunction(char const *name);
     gsl::not_null<VmaAllocator> createAllocator();
   };
 } // namespace imp
\ No newline at end of file
@@ -0,0 +1,109 @@
+#include "GpuFrameScheduler.h"
+
+#include <limits>
+#include <stdexcept>
+
+#include "CpuProfiler.h"
+#include "GpuContext.h"
+
+namespace imp {
+  GpuFrameScheduler::GpuFrameScheduler(
+      gsl::not_null<GpuContext *> context, std::size_t frameCount):
+      context_{context},
+      frameCount_{frameCount},
+      frameNumber_{0},
+      graphicsSemaphore_{createTimelineSemaphore()},
+      computeSemaphore_{createTimelineSemaphore()} {
+    if (frameCount_ == 0) {
+      throw std::runtime_error{"frame count must be positive."};
+    }
+  }
+
+  vk::Semaphore GpuFrameScheduler::createTimelineSemaphore() const {
+    auto typeInfo = vk::SemaphoreTypeCreateInfo{};
+    typeInfo.semaphoreType = vk::SemaphoreType::eTimeline;
+    typeInfo.initialValue = 0;
+    auto createInfo = vk::SemaphoreCreateInfo{};
+    createInfo.pNext = &typeInfo;
+    return context_->getDevice().createSemaphore(createInfo);
+  }
+
+  GpuFrameScheduler::~GpuFrameScheduler() {
+    auto device = context_->getDevice();
+    device.waitIdle();
+    device.destroy(computeSemaphore_);
+    device.destroy(graphicsSemaphore_);
+  }
+
+  std::uint64_t GpuFrameScheduler::beginFrame() {
+    ++frameNumber_;
+    if (frameNumber_ > frameCount_) {
+      waitFrame(frameNumber_ - frameCount_);
+    }
+    return frameNumber_;
+  }
+
+  bool GpuFrameScheduler::isFrameComplete(std::uint64_t frameNumber) const {
+    return context_->getDevice().getSemaphoreCounterValue(
+               graphicsSemaphore_) >= getFrameValue(frameNumber);
+  }
+
+  void GpuFrameScheduler::waitFrame(std::uint64_t frameNumber) const {
+    IMP_CPU_ZONE("GpuFrameScheduler::waitFrame");
+    auto value = getFrameValue(frameNumber);
+    auto waitInfo = vk::SemaphoreWaitInfo{};
+    waitInfo.semaphoreCount = 1;
+    waitInfo.pSemaphores = &graphicsSemaphore_;
+    waitInfo.pValues = &value;
+    if (context_->getDevice().waitSemaphores(
+            waitInfo, std::numeric_limits<std::uint64_t>::max()) !=
+        vk::Result::eSuccess) {
+      throw std::runtime_error{"failed to wait for frame."};
+    }
+  }
+
+  gsl::not_null<GpuContext *> GpuFrameScheduler::getContext() const noexcept {
+    return context_;
+  }
+
+  std::size_t GpuFrameScheduler::getFrameCount() const noexcept {
+    return frameCount_;
+  }
+
+  std::uint64_t GpuFrameScheduler::getFrameNumber() const noexcept {
+    return frameNumber_;
+  }
+
+  std::size_t GpuFrameScheduler::getFrameIndex() const noexcept {
+    return static_cast<std::size_t>((frameNumber_ + frameCount_ - 1) %
+                                    frameCount_);
+  }
+
+  std::uint64_t GpuFrameScheduler::getCompletedFrameNumber() const {
+    return context_->getDevice().getSemaphoreCounterValue(graphicsSemaphore_) /
+           2;
+  }
+
+  vk::Semaphore GpuFrameScheduler::getGraphicsSemaphore() const noexcept {
+    return graphicsSemaphore_;
+  }
+
+  vk::Semaphore GpuFrameScheduler::getComputeSemaphore() const noexcept {
+    return computeSemaphore_;
+  }
+
+  std::uint64_t
+  GpuFrameScheduler::getSceneValue(std::uint64_t frameNumber) noexcept {
+    return frameNumber * 2 - 1;
+  }
+
+  std::uint64_t
+  GpuFrameScheduler::getFrameValue(std::uint64_t frameNumber) noexcept {
+    return frameNumber * 2;
+  }
+
+  std::uint64_t
+  GpuFrameScheduler::getComputeValue(std::uint64_t frameNumber) noexcept {
+    return frameNumber;
+  }
+} // namespace imp
\ No newline at end of file
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstdint>
+
+#include <vulkan/vulkan.hpp>
+
+#include "../util/Gsl.h"
+
+namespace imp {
+  class GpuContext;
+
+  class GpuFrameScheduler {
+  public:
+    explicit GpuFrameScheduler(
+        gsl::not_null<GpuContext *> context, std::size_t frameCount);
+    ~GpuFrameScheduler();
+
+    GpuFrameScheduler(GpuFrameScheduler const &) = delete;
+    GpuFrameScheduler &operator=(GpuFrameScheduler const &) = delete;
+
+  private:
+    vk::Semaphore createTimelineSemaphore() const;
+
+  public:
+    std::uint64_t beginFrame();
+    bool isFrameComplete(std::uint64_t frameNumber) const;
+    void waitFrame(std::uint64_t frameNumber) const;
+
+    gsl::not_null<GpuContext *> getContext() const noexcept;
+    std::size_t getFrameCount() const noexcept;
+    std::uint64_t getFrameNumber() const noexcept;
+    std::size_t getFrameIndex() const noexcept;
+    std::uint64_t getCompletedFrameNumber() const;
+    vk::Semaphore getGraphicsSemaphore() const noexcept;
+    vk::Semaphore getComputeSemaphore() const noexcept;
+
+    static std::uint64_t getSceneValue(std::uint64_t frameNumber) noexcept;
+    static std::uint64_t getFrameValue(std::uint64_t frameNumber) noexcept;
+    static std::uint64_t getComputeValue(std::uint64_t frameNumber) noexcept;
+
+  private:
+    gsl::not_null<GpuContext *> context_;
+    std::size_t frameCount_;
+    std::uint64_t frameNumber_;
+    vk::Semaphore graphicsSemaphore_;
+    vk::Semaphore computeSemaphore_;
+  };
+} // namespace imp
\ No newline at end of file
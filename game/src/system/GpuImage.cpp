@@ -29,6 +29,26 @@ namespace imp {
     }
   }
 
+  GpuImage::GpuImage(
+      gsl::not_null<VmaAllocator> allocator,
+      vk::ImageCreateInfo const &imageCreateInfo):
+      allocator_{allocator},
+      flags_{imageCreateInfo.flags},
+      type_{imageCreateInfo.imageType},
+      format_{imageCreateInfo.format},
+      extent_{imageCreateInfo.extent},
+      mipLevels_{imageCreateInfo.mipLevels},
+      arrayLayers_{imageCreateInfo.arrayLayers},
+      samples_{imageCreateInfo.samples},
+      tiling_{imageCreateInfo.tiling},
+      usage_{imageCreateInfo.usage},
+      sharingMode_{imageCreateInfo.sharingMode},
+      allocation_{nullptr} {
+    auto allocatorInfo = VmaAllocatorInfo{};
+    vmaGetAllocatorInfo(allocator_, &allocatorInfo);
+    image_ = vk::Device{allocatorInfo.device}.createImage(imageCreateInfo);
+  }
+
   GpuImage::~GpuImage() {
     vmaDestroyImage(allocator_, image_, allocation_);
   }
@@ -73,6 +93,22 @@ namespace imp {
     return *this;
   }
 
+  vk::MemoryRequirements GpuImage::getMemoryRequirements() const {
+    auto allocatorInfo = VmaAllocatorInfo{};
+    vmaGetAllocatorInfo(allocator_, &allocatorInfo);
+    return vk::Device{allocatorInfo.device}.getImageMemoryRequirements(image_);
+  }
+
+  void GpuImage::bind(GpuMemory const &memory, vk::DeviceSize offset) {
+    if (allocation_) {
+      throw std::runtime_error{"gpu image already owns its memory."};
+    }
+    if (vmaBindImageMemory2(
+            allocator_, memory.get(), offset, image_, nullptr) != VK_SUCCESS) {
+      throw std::runtime_error{"failed to bind gpu image memory."};
+    }
+  }
+
   bool GpuImage::hasValue() const noexcept {
     return image_;
   }
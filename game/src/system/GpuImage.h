@@ -4,6 +4,7 @@
 
 #include "../util/Extent.h"
 #include "../util/Gsl.h"
+#include "GpuMemory.h"
 #include "vk_mem_alloc.h"
 
 namespace imp {
@@ -13,11 +14,17 @@ namespace imp {
         gsl::not_null<VmaAllocator> allocator,
         vk::ImageCreateInfo const &imageCreateInfo,
         VmaAllocationCreateInfo const &allocationCreateInfo);
+    explicit GpuImage(
+        gsl::not_null<VmaAllocator> allocator,
+        vk::ImageCreateInfo const &imageCreateInfo);
     ~GpuImage();
 
     GpuImage(GpuImage &&rhs) noexcept;
     GpuImage &operator=(GpuImage &&rhs) noexcept;
 
+    vk::MemoryRequirements getMemoryRequirements() const;
+    void bind(GpuMemory const &memory, vk::DeviceSize offset = 0);
+
     bool hasValue() const noexcept;
     vk::ImageCreateFlags getFlags() const noexcept;
     vk::ImageType getType() const noexcept;
@@ -0,0 +1,82 @@
+#include "GpuImagePool.h"
+
+#include <algorithm>
+#include <iterator>
+
+#include "../util/Align.h"
+
+namespace imp {
+  GpuImagePool::GpuImagePool(
+      gsl::not_null<VmaAllocator> allocator,
+      VmaAllocationCreateInfo const &allocationCreateInfo,
+      std::size_t capacity,
+      std::uint32_t granularity):
+      allocator_{allocator},
+      allocationCreateInfo_{allocationCreateInfo},
+      capacity_{capacity},
+      granularity_{granularity},
+      allocationCount_{0} {
+    freeImages_.reserve(capacity_ + 1);
+  }
+
+  std::shared_ptr<GpuImage const>
+  GpuImagePool::acquire(vk::ImageCreateInfo const &imageCreateInfo) {
+    auto createInfo = imageCreateInfo;
+    auto sizeClass = getSizeClass(
+        Extent2u{createInfo.extent.width, createInfo.extent.height});
+    createInfo.extent.width = sizeClass.width;
+    createInfo.extent.height = sizeClass.height;
+    auto it = std::find_if(
+        freeImages_.rbegin(), freeImages_.rend(), [&](auto const &image) {
+          return isCompatible(*image, createInfo);
+        });
+    auto image = std::unique_ptr<GpuImage>{};
+    if (it != freeImages_.rend()) {
+      image = std::move(*it);
+      freeImages_.erase(std::next(it).base());
+    } else {
+      image = std::make_unique<GpuImage>(
+          allocator_, createInfo, allocationCreateInfo_);
+      ++allocationCount_;
+    }
+    return std::shared_ptr<GpuImage const>{
+        image.release(), [this](GpuImage *image) {
+          release(std::unique_ptr<GpuImage>{image});
+        }};
+  }
+
+  Extent2u GpuImagePool::getSizeClass(Extent2u const &extent) const noexcept {
+    return Extent2u{
+        align(granularity_, std::max(extent.width, std::uint32_t{1})),
+        align(granularity_, std::max(extent.height, std::uint32_t{1}))};
+  }
+
+  std::size_t GpuImagePool::getFreeImageCount() const noexcept {
+    return freeImages_.size();
+  }
+
+  std::size_t GpuImagePool::getAllocationCount() const noexcept {
+    return allocationCount_;
+  }
+
+  bool GpuImagePool::isCompatible(
+      GpuImage const &image,
+      vk::ImageCreateInfo const &imageCreateInfo) const noexcept {
+    return image.getFlags() == imageCreateInfo.flags &&
+           image.getType() == imageCreateInfo.imageType &&
+           image.getFormat() == imageCreateInfo.format &&
+           image.getExtent() == Extent3u{imageCreateInfo.extent} &&
+           image.getMipLevels() == imageCreateInfo.mipLevels &&
+           image.getArrayLayers() == imageCreateInfo.arrayLayers &&
+           image.getSamples() == imageCreateInfo.samples &&
+           image.getTiling() == imageCreateInfo.tiling &&
+           image.getUsage() == imageCreateInfo.usage;
+  }
+
+  void GpuImagePool::release(std::unique_ptr<GpuImage> image) noexcept {
+    freeImages_.push_back(std::move(image));
+    if (freeImages_.size() > capacity_) {
+      freeImages_.erase(freeImages_.begin());
+    }
+  }
+} // namespace imp
\ No newline at end of file
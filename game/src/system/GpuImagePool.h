@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "GpuImage.h"
+
+namespace imp {
+  class GpuImagePool {
+  public:
+    static constexpr auto DEFAULT_GRANULARITY = std::uint32_t{64};
+
+    explicit GpuImagePool(
+        gsl::not_null<VmaAllocator> allocator,
+        VmaAllocationCreateInfo const &allocationCreateInfo,
+        std::size_t capacity,
+        std::uint32_t granularity = DEFAULT_GRANULARITY);
+
+    std::shared_ptr<GpuImage const>
+    acquire(vk::ImageCreateInfo const &imageCreateInfo);
+    Extent2u getSizeClass(Extent2u const &extent) const noexcept;
+    std::size_t getFreeImageCount() const noexcept;
+    std::size_t getAllocationCount() const noexcept;
+
+  private:
+    bool isCompatible(
+        GpuImage const &image,
+        vk::ImageCreateInfo const &imageCreateInfo) const noexcept;
+    void release(std::unique_ptr<GpuImage> image) noexcept;
+
+    gsl::not_null<VmaAllocator> allocator_;
+    VmaAllocationCreateInfo allocationCreateInfo_;
+    std::size_t capacity_;
+    std::uint32_t granularity_;
+    std::vector<std::unique_ptr<GpuImage>> freeImages_;
+    std::size_t allocationCount_;
+  };
+} // namespace imp
\ No newline at end of file
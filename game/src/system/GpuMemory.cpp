@@ -0,0 +1,64 @@
+#include "GpuMemory.h"
+
+#include <stdexcept>
+
+namespace imp {
+  GpuMemory::GpuMemory(
+      gsl::not_null<VmaAllocator> allocator,
+      vk::MemoryRequirements const &memoryRequirements,
+      VmaAllocationCreateInfo const &allocationCreateInfo):
+      allocator_{allocator}, size_{memoryRequirements.size} {
+    if (vmaAllocateMemory(
+            allocator_,
+            reinterpret_cast<VkMemoryRequirements const *>(
+                &memoryRequirements),
+            &allocationCreateInfo,
+            &allocation_,
+            nullptr) != VK_SUCCESS) {
+      throw std::runtime_error{"failed to allocate gpu memory."};
+    }
+    auto allocationInfo = VmaAllocationInfo{};
+    vmaGetAllocationInfo(allocator_, allocation_, &allocationInfo);
+    memoryType_ = allocationInfo.memoryType;
+  }
+
+  GpuMemory::~GpuMemory() {
+    if (allocation_) {
+      vmaFreeMemory(allocator_, allocation_);
+    }
+  }
+
+  GpuMemory::GpuMemory(GpuMemory &&rhs) noexcept:
+      allocator_{rhs.allocator_},
+      size_{rhs.size_},
+      memoryType_{rhs.memoryType_},
+      allocation_{rhs.allocation_} {
+    rhs.allocation_ = nullptr;
+  }
+
+  GpuMemory &GpuMemory::operator=(GpuMemory &&rhs) noexcept {
+    if (&rhs != this) {
+      if (allocation_) {
+        vmaFreeMemory(allocator_, allocation_);
+      }
+      allocator_ = rhs.allocator_;
+      size_ = rhs.size_;
+      memoryType_ = rhs.memoryType_;
+      allocation_ = rhs.allocation_;
+      rhs.allocation_ = nullptr;
+    }
+    return *this;
+  }
+
+  vk::DeviceSize GpuMemory::getSize() const noexcept {
+    return size_;
+  }
+
+  std::uint32_t GpuMemory::getMemoryType() const noexcept {
+    return memoryType_;
+  }
+
+  VmaAllocation GpuMemory::get() const noexcept {
+    return allocation_;
+  }
+} // namespace imp
\ No newline at end of file
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstdint>
+
+#include <vulkan/vulkan.hpp>
+
+#include "../util/Gsl.h"
+#include "vk_mem_alloc.h"
+
+namespace imp {
+  class GpuMemory {
+  public:
+    explicit GpuMemory(
+        gsl::not_null<VmaAllocator> allocator,
+        vk::MemoryRequirements const &memoryRequirements,
+        VmaAllocationCreateInfo const &allocationCreateInfo);
+    ~GpuMemory();
+
+    GpuMemory(GpuMemory &&rhs) noexcept;
+    GpuMemory &operator=(GpuMemory &&rhs) noexcept;
+
+    vk::DeviceSize getSize() const noexcept;
+    std::uint32_t getMemoryType() const noexcept;
+    VmaAllocation get() const noexcept;
+
+  private:
+    gsl::not_null<VmaAllocator> allocator_;
+    vk::DeviceSize size_;
+    std::uint32_t memoryType_;
+    VmaAllocation allocation_;
+  };
+} // namespace imp
\ No newline at end of file
@@ -0,0 +1,156 @@
+#include "GpuProfiler.h"
+
+#include <algorithm>
+#include <map>
+#include <utility>
+
+#include "GpuContext.h"
+
+namespace imp {
+  GpuProfiler::GpuProfiler(
+      gsl::not_null<GpuContext *> context,
+      std::size_t frameCount,
+      std::size_t windowSize):
+      context_{context},
+      timestampMask_{0},
+      timestampPeriod_{
+          context->getPhysicalDevice().getProperties().limits.timestampPeriod},
+      frames_(frameCount),
+      frameIndex_{0},
+      enabled_{false},
+      timestamps_(2 * MAX_SCOPE_COUNT),
+      history_{windowSize} {
+    auto validBits = queryTimestampValidBits();
+    if (validBits != 0) {
+      timestampMask_ = validBits < 64
+                           ? (std::uint64_t{1} << validBits) - 1
+                           : ~std::uint64_t{};
+      frames_ = createFrames();
+    }
+  }
+
+  std::uint32_t GpuProfiler::queryTimestampValidBits() const {
+    auto properties = context_->getPhysicalDevice().getQueueFamilyProperties();
+    return std::min(
+        properties[context_->getGraphicsFamily()].timestampValidBits,
+        properties[context_->getComputeFamily()].timestampValidBits);
+  }
+
+  std::vector<GpuProfiler::Frame> GpuProfiler::createFrames() const {
+    auto device = context_->getDevice();
+    auto createInfo = vk::QueryPoolCreateInfo{};
+    createInfo.queryType = vk::QueryType::eTimestamp;
+    createInfo.queryCount = 2 * MAX_SCOPE_COUNT;
+    auto frames = std::vector<Frame>(frames_.size());
+    for (auto &frame : frames) {
+      frame.queryPool = device.createQueryPool(createInfo);
+      device.resetQueryPool(frame.queryPool, 0, createInfo.queryCount);
+    }
+    return frames;
+  }
+
+  GpuProfiler::~GpuProfiler() {
+    auto device = context_->getDevice();
+    for (auto &frame : frames_) {
+      device.destroy(frame.queryPool);
+    }
+  }
+
+  void GpuProfiler::beginFrame(std::size_t frameIndex) {
+    frameIndex_ = frameIndex;
+    auto &frame = frames_[frameIndex_];
+    if (!frame.scopes.empty()) {
+      readResults(frame);
+      context_->getDevice().resetQueryPool(
+          frame.queryPool,
+          0,
+          2 * static_cast<std::uint32_t>(frame.scopes.size()));
+      frame.scopes.clear();
+    }
+  }
+
+  void GpuProfiler::readResults(Frame &frame) {
+    auto queryCount = 2 * static_cast<std::uint32_t>(frame.scopes.size());
+    auto result = context_->getDevice().getQueryPoolResults(
+        frame.queryPool,
+        0,
+        queryCount,
+        sizeof(std::uint64_t) * queryCount,
+        timestamps_.data(),
+        sizeof(std::uint64_t),
+        vk::QueryResultFlagBits::e64);
+    if (result != vk::Result::eSuccess) {
+      return;
+    }
+    auto times = std::map<std::pair<std::string, std::string>, double>{};
+    for (auto i = std::size_t{}; i < frame.scopes.size(); ++i) {
+      auto ticks =
+          (timestamps_[2 * i + 1] - timestamps_[2 * i]) & timestampMask_;
+      auto time = double(ticks) * timestampPeriod_ * 1e-6;
+      auto &scope = frame.scopes[i];
+      times[{scope.owner, scope.pass}] += time;
+      times[{scope.owner, "total"}] += time;
+      times[{"all", scope.pass}] += time;
+      times[{"all", "total"}] += time;
+    }
+    for (auto &[key, time] : times) {
+      history_.record(key.first, key.second, time);
+    }
+  }
+
+  std::optional<std::uint32_t> GpuProfiler::begin(
+      vk::CommandBuffer commandBuffer,
+      std::string_view owner,
+      std::string_view pass) {
+    if (!enabled_ || timestampMask_ == 0) {
+      return std::nullopt;
+    }
+    auto &frame = frames_[frameIndex_];
+    auto scope = std::uint32_t{};
+    {
+      auto lock = std::scoped_lock{mutex_};
+      if (frame.scopes.size() == MAX_SCOPE_COUNT) {
+        return std::nullopt;
+      }
+      scope = static_cast<std::uint32_t>(frame.scopes.size());
+      frame.scopes.push_back({std::string{owner}, std::string{pass}});
+    }
+    commandBuffer.writeTimestamp(
+        vk::PipelineStageFlagBits::eTopOfPipe, frame.queryPool, 2 * scope);
+    return scope;
+  }
+
+  void GpuProfiler::end(
+      vk::CommandBuffer commandBuffer, std::optional<std::uint32_t> scope) {
+    if (scope) {
+      commandBuffer.writeTimestamp(
+          vk::PipelineStageFlagBits::eBottomOfPipe,
+          frames_[frameIndex_].queryPool,
+          2 * *scope + 1);
+    }
+  }
+
+  gsl::not_null<GpuContext *> GpuProfiler::getContext() const noexcept {
+    return context_;
+  }
+
+  bool GpuProfiler::isSupported() const noexcept {
+    return timestampMask_ != 0;
+  }
+
+  bool GpuProfiler::isEnabled() const noexcept {
+    return enabled_;
+  }
+
+  void GpuProfiler::setEnabled(bool enabled) noexcept {
+    enabled_ = enabled;
+  }
+
+  TimingHistory const &GpuProfiler::getHistory() const noexcept {
+    return history_;
+  }
+
+  void GpuProfiler::clearHistory() noexcept {
+    history_.clear();
+  }
+} // namespace imp
\ No newline at end of file
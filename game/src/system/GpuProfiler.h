@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <vulkan/vulkan.hpp>
+
+#include "../util/Gsl.h"
+#include "TimingHistory.h"
+
+namespace imp {
+  class GpuContext;
+
+  class GpuProfiler {
+  public:
+    static constexpr auto MAX_SCOPE_COUNT = std::uint32_t{2048};
+
+    explicit GpuProfiler(
+        gsl::not_null<GpuContext *> context,
+        std::size_t frameCount,
+        std::size_t windowSize = 256);
+    ~GpuProfiler();
+
+    GpuProfiler(GpuProfiler const &) = delete;
+    GpuProfiler &operator=(GpuProfiler const &) = delete;
+
+  private:
+    struct Scope {
+      std::string owner;
+      std::string pass;
+    };
+
+    struct Frame {
+      vk::QueryPool queryPool;
+      std::vector<Scope> scopes;
+    };
+
+    std::uint32_t queryTimestampValidBits() const;
+    std::vector<Frame> createFrames() const;
+    void readResults(Frame &frame);
+
+  public:
+    void beginFrame(std::size_t frameIndex);
+
+    std::optional<std::uint32_t> begin(
+        vk::CommandBuffer commandBuffer,
+        std::string_view owner,
+        std::string_view pass);
+    void
+    end(vk::CommandBuffer commandBuffer, std::optional<std::uint32_t> scope);
+
+    gsl::not_null<GpuContext *> getContext() const noexcept;
+    bool isSupported() const noexcept;
+    bool isEnabled() const noexcept;
+    void setEnabled(bool enabled) noexcept;
+    TimingHistory const &getHistory() const noexcept;
+    void clearHistory() noexcept;
+
+  private:
+    gsl::not_null<GpuContext *> context_;
+    std::uint64_t timestampMask_;
+    double timestampPeriod_;
+    std::vector<Frame> frames_;
+    std::size_t frameIndex_;
+    bool enabled_;
+    std::mutex mutex_;
+    std::vector<std::uint64_t> timestamps_;
+    TimingHistory history_;
+  };
+} // namespace imp
\ No newline at end of file
@@ -0,0 +1,177 @@
+#include "GpuRenderGraph.h"
+
+#include <array>
+#include <stdexcept>
+
+namespace imp {
+  namespace {
+    constexpr auto USAGES = std::array{
+        RenderGraph::Usage::COLOR_ATTACHMENT,
+        RenderGraph::Usage::FRAGMENT_SAMPLED,
+        RenderGraph::Usage::COMPUTE_SAMPLED,
+        RenderGraph::Usage::COMPUTE_STORAGE,
+        RenderGraph::Usage::PRESENT};
+
+    vk::PipelineStageFlags getStageMask(RenderGraph::Usage usage) noexcept {
+      switch (usage) {
+      case RenderGraph::Usage::COLOR_ATTACHMENT:
+        return vk::PipelineStageFlagBits::eColorAttachmentOutput;
+      case RenderGraph::Usage::FRAGMENT_SAMPLED:
+        return vk::PipelineStageFlagBits::eFragmentShader;
+      case RenderGraph::Usage::COMPUTE_SAMPLED:
+      case RenderGraph::Usage::COMPUTE_STORAGE:
+        return vk::PipelineStageFlagBits::eComputeShader;
+      case RenderGraph::Usage::PRESENT:
+        // The acquire semaphore is waited on at this stage.
+        return vk::PipelineStageFlagBits::eColorAttachmentOutput;
+      default:
+        return {};
+      }
+    }
+
+    vk::PipelineStageFlags
+    getStageMask(RenderGraph::UsageFlags usages) noexcept {
+      auto stageMask = vk::PipelineStageFlags{};
+      for (auto usage : USAGES) {
+        if (usages & RenderGraph::getFlag(usage)) {
+          stageMask |= getStageMask(usage);
+        }
+      }
+      return stageMask;
+    }
+
+    vk::AccessFlags getReadAccessMask(RenderGraph::Usage usage) noexcept {
+      switch (usage) {
+      case RenderGraph::Usage::COLOR_ATTACHMENT:
+        return vk::AccessFlagBits::eColorAttachmentRead;
+      case RenderGraph::Usage::FRAGMENT_SAMPLED:
+      case RenderGraph::Usage::COMPUTE_SAMPLED:
+      case RenderGraph::Usage::COMPUTE_STORAGE:
+        return vk::AccessFlagBits::eShaderRead;
+      default:
+        return {};
+      }
+    }
+
+    vk::AccessFlags getWriteAccessMask(RenderGraph::Usage usage) noexcept {
+      switch (usage) {
+      case RenderGraph::Usage::COLOR_ATTACHMENT:
+        return vk::AccessFlagBits::eColorAttachmentWrite;
+      case RenderGraph::Usage::COMPUTE_STORAGE:
+        return vk::AccessFlagBits::eShaderWrite;
+      default:
+        return {};
+      }
+    }
+
+    vk::AccessFlags
+    getWriteAccessMask(RenderGraph::UsageFlags usages) noexcept {
+      auto accessMask = vk::AccessFlags{};
+      for (auto usage : USAGES) {
+        if (usages & RenderGraph::getFlag(usage)) {
+          accessMask |= getWriteAccessMask(usage);
+        }
+      }
+      return accessMask;
+    }
+
+    vk::ImageLayout getImageLayout(
+        RenderGraph::Layout layout, vk::ImageLayout presentLayout) noexcept {
+      switch (layout) {
+      case RenderGraph::Layout::COLOR_ATTACHMENT:
+        return vk::ImageLayout::eColorAttachmentOptimal;
+      case RenderGraph::Layout::SHADER_READ_ONLY:
+        return vk::ImageLayout::eShaderReadOnlyOptimal;
+      case RenderGraph::Layout::GENERAL:
+        return vk::ImageLayout::eGeneral;
+      case RenderGraph::Layout::PRESENT:
+        return presentLayout;
+      default:
+        return vk::ImageLayout::eUndefined;
+      }
+    }
+  } // namespace
+
+  RenderGraph::ImageHandle GpuRenderGraph::importImage(
+      std::string name,
+      vk::Image image,
+      unsigned levelCount,
+      unsigned layerCount,
+      Usage initialUsage) {
+    auto handle = RenderGraph::importImage(
+        std::move(name), levelCount, layerCount, initialUsage);
+    images_.emplace_back(image);
+    return handle;
+  }
+
+  RenderGraph::ImageHandle GpuRenderGraph::addTransientImage(
+      std::string name,
+      vk::Image image,
+      unsigned levelCount,
+      unsigned layerCount,
+      vk::DeviceSize size) {
+    auto handle = RenderGraph::addTransientImage(
+        std::move(name),
+        levelCount,
+        layerCount,
+        static_cast<std::size_t>(size));
+    images_.emplace_back(image);
+    return handle;
+  }
+
+  void GpuRenderGraph::setPresentLayout(vk::ImageLayout layout) noexcept {
+    presentLayout_ = layout;
+  }
+
+  void GpuRenderGraph::execute(vk::CommandBuffer commandBuffer) {
+    if (images_.size() != getImageCount()) {
+      throw std::runtime_error{"render graph image has no vulkan image."};
+    }
+    RenderGraph::execute([&](gsl::span<Barrier const> barriers) {
+      recordBarriers(commandBuffer, barriers);
+    });
+  }
+
+  vk::Image GpuRenderGraph::getImage(ImageHandle image) const {
+    return images_.at(image.index);
+  }
+
+  void GpuRenderGraph::recordBarriers(
+      vk::CommandBuffer commandBuffer,
+      gsl::span<Barrier const> barriers) const {
+    auto srcStageMask = vk::PipelineStageFlags{};
+    auto dstStageMask = vk::PipelineStageFlags{};
+    auto imageBarriers = std::vector<vk::ImageMemoryBarrier>{};
+    imageBarriers.reserve(barriers.size());
+    for (auto &barrier : barriers) {
+      auto &imageBarrier = imageBarriers.emplace_back();
+      imageBarrier.srcAccessMask = getWriteAccessMask(barrier.srcWriteUsages);
+      if (barrier.dstRead) {
+        imageBarrier.dstAccessMask |= getReadAccessMask(barrier.dstUsage);
+      }
+      if (barrier.dstWrite) {
+        imageBarrier.dstAccessMask |= getWriteAccessMask(barrier.dstUsage);
+      }
+      imageBarrier.oldLayout =
+          getImageLayout(barrier.oldLayout, presentLayout_);
+      imageBarrier.newLayout =
+          getImageLayout(barrier.newLayout, presentLayout_);
+      imageBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+      imageBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+      imageBarrier.image = images_[barrier.image.index];
+      imageBarrier.subresourceRange.aspectMask =
+          vk::ImageAspectFlagBits::eColor;
+      imageBarrier.subresourceRange.baseMipLevel = barrier.range.baseLevel;
+      imageBarrier.subresourceRange.levelCount = barrier.range.levelCount;
+      imageBarrier.subresourceRange.baseArrayLayer = barrier.range.baseLayer;
+      imageBarrier.subresourceRange.layerCount = barrier.range.layerCount;
+      srcStageMask |= getStageMask(barrier.srcUsages);
+      dstStageMask |= getStageMask(barrier.dstUsage);
+    }
+    if (!srcStageMask) {
+      srcStageMask = vk::PipelineStageFlagBits::eTopOfPipe;
+    }
+    commandBuffer.pipelineBarrier(
+        srcStageMask, dstStageMask, {}, {}, {}, imageBarriers);
+  }
+} // namespace imp
\ No newline at end of file
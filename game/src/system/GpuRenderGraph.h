@@ -0,0 +1,38 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <vulkan/vulkan.hpp>
+
+#include "RenderGraph.h"
+
+namespace imp {
+  class GpuRenderGraph: public RenderGraph {
+  public:
+    ImageHandle importImage(
+        std::string name,
+        vk::Image image,
+        unsigned levelCount,
+        unsigned layerCount,
+        Usage initialUsage = Usage::NONE);
+    ImageHandle addTransientImage(
+        std::string name,
+        vk::Image image,
+        unsigned levelCount,
+        unsigned layerCount,
+        vk::DeviceSize size);
+    void setPresentLayout(vk::ImageLayout layout) noexcept;
+    void execute(vk::CommandBuffer commandBuffer);
+
+    vk::Image getImage(ImageHandle image) const;
+
+  private:
+    void recordBarriers(
+        vk::CommandBuffer commandBuffer,
+        gsl::span<Barrier const> barriers) const;
+
+    std::vector<vk::Image> images_;
+    vk::ImageLayout presentLayout_ = vk::ImageLayout::ePresentSrcKHR;
+  };
+} // namespace imp
\ No newline at end of file
@@ -0,0 +1,50 @@
+#include "GpuTransientHeap.h"
+
+#include <algorithm>
+
+namespace imp {
+  GpuTransientHeap::GpuTransientHeap(
+      gsl::not_null<VmaAllocator> allocator,
+      VmaAllocationCreateInfo const &allocationCreateInfo) noexcept:
+      allocator_{allocator},
+      allocationCreateInfo_{allocationCreateInfo},
+      memoryRequirements_{},
+      allocationCount_{0} {}
+
+  std::shared_ptr<GpuMemory const>
+  GpuTransientHeap::acquire(vk::MemoryRequirements const &memoryRequirements) {
+    if (memory_ && memoryRequirements.size <= memoryRequirements_.size &&
+        memoryRequirements.alignment <= memoryRequirements_.alignment &&
+        (memoryRequirements.memoryTypeBits >> memory_->getMemoryType() & 1)) {
+      return memory_;
+    }
+    auto grownRequirements = memoryRequirements;
+    if (memory_) {
+      grownRequirements.size =
+          std::max(grownRequirements.size, memoryRequirements_.size);
+      grownRequirements.alignment =
+          std::max(grownRequirements.alignment, memoryRequirements_.alignment);
+      if (auto memoryTypeBits = grownRequirements.memoryTypeBits &
+                                memoryRequirements_.memoryTypeBits) {
+        grownRequirements.memoryTypeBits = memoryTypeBits;
+      }
+    }
+    memory_ = std::make_shared<GpuMemory const>(
+        allocator_, grownRequirements, allocationCreateInfo_);
+    memoryRequirements_ = grownRequirements;
+    ++allocationCount_;
+    return memory_;
+  }
+
+  bool GpuTransientHeap::isCurrent(GpuMemory const &memory) const noexcept {
+    return memory_.get() == &memory;
+  }
+
+  vk::DeviceSize GpuTransientHeap::getSize() const noexcept {
+    return memory_ ? memory_->getSize() : 0;
+  }
+
+  std::size_t GpuTransientHeap::getAllocationCount() const noexcept {
+    return allocationCount_;
+  }
+} // namespace imp
\ No newline at end of file
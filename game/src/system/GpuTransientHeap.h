@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+
+#include "GpuMemory.h"
+
+namespace imp {
+  class GpuTransientHeap {
+  public:
+    explicit GpuTransientHeap(
+        gsl::not_null<VmaAllocator> allocator,
+        VmaAllocationCreateInfo const &allocationCreateInfo) noexcept;
+
+    std::shared_ptr<GpuMemory const>
+    acquire(vk::MemoryRequirements const &memoryRequirements);
+    bool isCurrent(GpuMemory const &memory) const noexcept;
+    vk::DeviceSize getSize() const noexcept;
+    std::size_t getAllocationCount() const noexcept;
+
+  private:
+    gsl::not_null<VmaAllocator> allocator_;
+    VmaAllocationCreateInfo allocationCreateInfo_;
+    vk::MemoryRequirements memoryRequirements_;
+    std::shared_ptr<GpuMemory const> memory_;
+    std::size_t allocationCount_;
+  };
+} // namespace imp
\ No newline at end of file
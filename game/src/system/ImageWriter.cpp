@@ -0,0 +1,29 @@
+#include "ImageWriter.h"
+
+#include <stdexcept>
+#include <vector>
+
+namespace imp {
+  void writePpm(
+      std::ostream &os,
+      unsigned width,
+      unsigned height,
+      std::size_t rowPitch,
+      gsl::span<std::uint8_t const> rgba) {
+    if (rowPitch < std::size_t{width} * 4 ||
+        rgba.size() < rowPitch * height) {
+      throw std::runtime_error{"image data is too small."};
+    }
+    os << "P6\n" << width << " " << height << "\n255\n";
+    auto row = std::vector<char>(std::size_t{width} * 3);
+    for (auto y = 0u; y < height; ++y) {
+      auto texels = rgba.data() + rowPitch * y;
+      for (auto x = 0u; x < width; ++x) {
+        row[x * 3 + 0] = static_cast<char>(texels[x * 4 + 0]);
+        row[x * 3 + 1] = static_cast<char>(texels[x * 4 + 1]);
+        row[x * 3 + 2] = static_cast<char>(texels[x * 4 + 2]);
+      }
+      os.write(row.data(), row.size());
+    }
+  }
+} // namespace imp
\ No newline at end of file
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+
+#include "../util/Gsl.h"
+
+namespace imp {
+  void writePpm(
+      std::ostream &os,
+      unsigned width,
+      unsigned height,
+      std::size_t rowPitch,
+      gsl::span<std::uint8_t const> rgba);
+} // namespace imp
\ No newline at end of file
@@ -0,0 +1,271 @@
+#include "JobSystem.h"
+
+#include <algorithm>
+
+namespace imp {
+  namespace {
+    thread_local JobSystem const *currentJobSystem = nullptr;
+    thread_local std::size_t currentWorker = 0;
+  } // namespace
+
+  JobSystem::JobDeque::JobDeque(std::size_t capacity):
+      jobs_(capacity), front_{0}, size_{0} {}
+
+  void JobSystem::JobDeque::reserve(std::size_t capacity) {
+    if (capacity > jobs_.size()) {
+      grow(capacity);
+    }
+  }
+
+  void JobSystem::JobDeque::pushBack(std::shared_ptr<Job> job) {
+    if (size_ == jobs_.size()) {
+      grow(std::max(2 * jobs_.size(), std::size_t{1}));
+    }
+    jobs_[(front_ + size_) % jobs_.size()] = std::move(job);
+    ++size_;
+  }
+
+  std::shared_ptr<JobSystem::Job> JobSystem::JobDeque::popBack() noexcept {
+    if (size_ == 0) {
+      return nullptr;
+    }
+    --size_;
+    return std::move(jobs_[(front_ + size_) % jobs_.size()]);
+  }
+
+  std::shared_ptr<JobSystem::Job> JobSystem::JobDeque::popFront() noexcept {
+    if (size_ == 0) {
+      return nullptr;
+    }
+    auto job = std::move(jobs_[front_]);
+    front_ = (front_ + 1) % jobs_.size();
+    --size_;
+    return job;
+  }
+
+  void JobSystem::JobDeque::grow(std::size_t capacity) {
+    auto jobs = std::vector<std::shared_ptr<Job>>(capacity);
+    for (auto i = std::size_t{}; i < size_; ++i) {
+      jobs[i] = std::move(jobs_[(front_ + i) % jobs_.size()]);
+    }
+    jobs_.swap(jobs);
+    front_ = 0;
+  }
+
+  JobSystem::Handle::Handle(std::shared_ptr<Job> job) noexcept:
+      job_{std::move(job)} {}
+
+  bool JobSystem::Handle::isValid() const noexcept {
+    return job_ != nullptr;
+  }
+
+  bool JobSystem::Handle::isFinished() const {
+    if (!job_) {
+      return true;
+    }
+    auto lock = std::scoped_lock{job_->mutex};
+    return job_->finished;
+  }
+
+  JobSystem::JobSystem(std::size_t workerCount):
+      queuedCount_{0},
+      pendingCount_{0},
+      waiterCount_{0},
+      nextWorker_{0},
+      joining_{false} {
+    workerCount = std::max(workerCount, std::size_t{1});
+    workers_.reserve(workerCount);
+    for (auto i = std::size_t{}; i < workerCount; ++i) {
+      workers_.emplace_back(std::make_unique<Worker>());
+    }
+    for (auto i = std::size_t{}; i < workerCount; ++i) {
+      workers_[i]->thread = std::thread{[this, i]() { work(i); }};
+    }
+  }
+
+  JobSystem::~JobSystem() {
+    join();
+  }
+
+  void JobSystem::wait() {
+    while (pendingCount_ != 0) {
+      if (auto job = acquire()) {
+        run(job);
+        continue;
+      }
+      auto lock = std::unique_lock{mutex_};
+      ++waiterCount_;
+      finishCondvar_.wait(lock, [this]() {
+        return pendingCount_ == 0 || queuedCount_ != 0;
+      });
+      --waiterCount_;
+    }
+  }
+
+  void JobSystem::wait(Handle const &handle) {
+    while (!handle.isFinished()) {
+      if (auto job = acquire()) {
+        run(job);
+        continue;
+      }
+      auto lock = std::unique_lock{mutex_};
+      ++waiterCount_;
+      finishCondvar_.wait(lock, [this, &handle]() {
+        return handle.isFinished() || queuedCount_ != 0;
+      });
+      --waiterCount_;
+    }
+  }
+
+  void JobSystem::join() {
+    wait();
+    {
+      auto lock = std::scoped_lock{mutex_};
+      if (joining_) {
+        return;
+      }
+      joining_ = true;
+    }
+    workCondvar_.notify_all();
+    for (auto &worker : workers_) {
+      worker->thread.join();
+    }
+  }
+
+  void JobSystem::reserve(std::size_t jobCount) {
+    TaskPool::reserve(2 * jobCount);
+    for (auto &worker : workers_) {
+      auto lock = std::scoped_lock{worker->mutex};
+      worker->jobs.reserve(jobCount);
+    }
+  }
+
+  JobSystem::Handle
+  JobSystem::emplaceAfter(gsl::span<Handle const> dependencies, Task work) {
+    auto job = std::allocate_shared<Job>(TaskPoolAllocator<Job>{});
+    job->work = std::move(work);
+    job->dependencyCount = dependencies.size() + 1;
+    job->finished = false;
+    ++pendingCount_;
+    for (auto const &dependency : dependencies) {
+      if (dependency.job_) {
+        auto lock = std::scoped_lock{dependency.job_->mutex};
+        if (!dependency.job_->finished) {
+          dependency.job_->continuations.emplace_back(job);
+          continue;
+        }
+      }
+      --job->dependencyCount;
+    }
+    if (--job->dependencyCount == 0) {
+      schedule(job);
+    }
+    return Handle{std::move(job)};
+  }
+
+  std::size_t JobSystem::getWorkerCount() const noexcept {
+    return workers_.size();
+  }
+
+  std::optional<std::size_t> JobSystem::getCurrentWorker() const noexcept {
+    if (currentJobSystem == this) {
+      return currentWorker;
+    }
+    return std::nullopt;
+  }
+
+  void JobSystem::work(std::size_t index) {
+    currentJobSystem = this;
+    currentWorker = index;
+    for (;;) {
+      if (auto job = acquire()) {
+        run(job);
+        continue;
+      }
+      auto lock = std::unique_lock{mutex_};
+      workCondvar_.wait(
+          lock, [this]() { return joining_ || queuedCount_ != 0; });
+      if (joining_ && queuedCount_ == 0) {
+        return;
+      }
+    }
+  }
+
+  void JobSystem::schedule(std::shared_ptr<Job> job) {
+    auto index = currentJobSystem == this
+                     ? currentWorker
+                     : nextWorker_++ % workers_.size();
+    {
+      auto &worker = *workers_[index];
+      auto lock = std::scoped_lock{worker.mutex};
+      worker.jobs.pushBack(std::move(job));
+    }
+    ++queuedCount_;
+    {
+      auto lock = std::scoped_lock{mutex_};
+    }
+    workCondvar_.notify_one();
+    if (waiterCount_ != 0) {
+      finishCondvar_.notify_all();
+    }
+  }
+
+  std::shared_ptr<JobSystem::Job> JobSystem::pop(std::size_t index) {
+    auto &worker = *workers_[index];
+    auto lock = std::scoped_lock{worker.mutex};
+    auto job = worker.jobs.popBack();
+    if (job) {
+      --queuedCount_;
+    }
+    return job;
+  }
+
+  std::shared_ptr<JobSystem::Job> JobSystem::steal(std::size_t index) {
+    for (auto i = std::size_t{1}; i <= workers_.size(); ++i) {
+      auto &worker = *workers_[(index + i) % workers_.size()];
+      auto lock = std::scoped_lock{worker.mutex};
+      if (auto job = worker.jobs.popFront()) {
+        --queuedCount_;
+        return job;
+      }
+    }
+    return nullptr;
+  }
+
+  std::shared_ptr<JobSystem::Job> JobSystem::acquire() {
+    if (currentJobSystem == this) {
+      if (auto job = pop(currentWorker)) {
+        return job;
+      }
+      return steal(currentWorker);
+    }
+    return steal(nextWorker_ % workers_.size());
+  }
+
+  void JobSystem::run(std::shared_ptr<Job> const &job) {
+    job->work();
+    job->work.reset();
+    finish(*job);
+  }
+
+  void JobSystem::finish(Job &job) {
+    auto continuations = decltype(job.continuations){};
+    {
+      auto lock = std::scoped_lock{job.mutex};
+      job.finished = true;
+      continuations.swap(job.continuations);
+    }
+    for (auto &continuation : continuations) {
+      if (--continuation->dependencyCount == 0) {
+        schedule(std::move(continuation));
+      }
+    }
+    --pendingCount_;
+    if (waiterCount_ != 0) {
+      {
+        auto lock = std::scoped_lock{mutex_};
+      }
+      finishCondvar_.notify_all();
+    }
+  }
+} // namespace imp
\ No newline at end of file
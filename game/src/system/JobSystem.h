@@ -0,0 +1,114 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+#include "../util/Gsl.h"
+#include "Task.h"
+
+namespace imp {
+  class JobSystem {
+    struct Job {
+      Task work;
+      std::atomic<std::size_t> dependencyCount;
+      std::mutex mutex;
+      bool finished;
+      std::vector<
+          std::shared_ptr<Job>,
+          TaskPoolAllocator<std::shared_ptr<Job>>>
+          continuations;
+    };
+
+    class JobDeque {
+    public:
+      explicit JobDeque(std::size_t capacity);
+
+      void reserve(std::size_t capacity);
+      void pushBack(std::shared_ptr<Job> job);
+      std::shared_ptr<Job> popBack() noexcept;
+      std::shared_ptr<Job> popFront() noexcept;
+
+    private:
+      void grow(std::size_t capacity);
+
+      std::vector<std::shared_ptr<Job>> jobs_;
+      std::size_t front_;
+      std::size_t size_;
+    };
+
+    struct Worker {
+      std::mutex mutex;
+      JobDeque jobs{INITIAL_DEQUE_CAPACITY};
+      std::thread thread;
+    };
+
+  public:
+    static constexpr auto INITIAL_DEQUE_CAPACITY = std::size_t{256};
+
+    class Handle {
+    public:
+      Handle() noexcept = default;
+
+      bool isValid() const noexcept;
+      bool isFinished() const;
+
+    private:
+      friend class JobSystem;
+
+      explicit Handle(std::shared_ptr<Job> job) noexcept;
+
+      std::shared_ptr<Job> job_;
+    };
+
+    explicit JobSystem(
+        std::size_t workerCount = std::thread::hardware_concurrency());
+    ~JobSystem();
+
+    JobSystem(JobSystem const &) = delete;
+    JobSystem &operator=(JobSystem const &) = delete;
+
+    void wait();
+    void wait(Handle const &handle);
+    void join();
+    void reserve(std::size_t jobCount);
+
+    template<typename... Args>
+    Handle emplace(Args &&...args) {
+      return emplaceAfter({}, Task{std::forward<Args>(args)...});
+    }
+
+    template<typename F>
+    Handle then(Handle const &handle, F &&f) {
+      return emplaceAfter({&handle, 1}, Task{std::forward<F>(f)});
+    }
+
+    Handle emplaceAfter(gsl::span<Handle const> dependencies, Task work);
+
+    std::size_t getWorkerCount() const noexcept;
+    std::optional<std::size_t> getCurrentWorker() const noexcept;
+
+  private:
+    void work(std::size_t index);
+    void schedule(std::shared_ptr<Job> job);
+    std::shared_ptr<Job> pop(std::size_t index);
+    std::shared_ptr<Job> steal(std::size_t index);
+    std::shared_ptr<Job> acquire();
+    void run(std::shared_ptr<Job> const &job);
+    void finish(Job &job);
+
+    std::vector<std::unique_ptr<Worker>> workers_;
+    std::atomic<std::size_t> queuedCount_;
+    std::atomic<std::size_t> pendingCount_;
+    std::atomic<std::size_t> waiterCount_;
+    std::atomic<std::size_t> nextWorker_;
+    bool joining_;
+    std::mutex mutex_;
+    std::condition_variable workCondvar_;
+    std::condition_variable finishCondvar_;
+  };
+} // namespace imp
\ No newline at end of file
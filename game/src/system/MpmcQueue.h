@@ -0,0 +1,85 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+
+namespace imp {
+  template<typename T>
+  class MpmcQueue {
+  public:
+    explicit MpmcQueue(std::size_t capacity):
+        cells_{std::make_unique<Cell[]>(capacity)},
+        mask_{capacity - 1},
+        enqueuePosition_{0},
+        dequeuePosition_{0} {
+      if (capacity < 2 || (capacity & mask_) != 0) {
+        throw std::runtime_error{"queue capacity must be a power of two."};
+      }
+      for (auto i = std::size_t{}; i < capacity; ++i) {
+        cells_[i].sequence.store(i, std::memory_order_relaxed);
+      }
+    }
+
+    bool tryPush(T &&value) {
+      auto position = enqueuePosition_.load(std::memory_order_relaxed);
+      for (;;) {
+        auto &cell = cells_[position & mask_];
+        auto sequence = cell.sequence.load(std::memory_order_acquire);
+        auto difference = static_cast<std::ptrdiff_t>(sequence) -
+                          static_cast<std::ptrdiff_t>(position);
+        if (difference == 0) {
+          if (enqueuePosition_.compare_exchange_weak(
+                  position, position + 1, std::memory_order_relaxed)) {
+            cell.value = std::move(value);
+            cell.sequence.store(position + 1, std::memory_order_release);
+            return true;
+          }
+        } else if (difference < 0) {
+          return false;
+        } else {
+          position = enqueuePosition_.load(std::memory_order_relaxed);
+        }
+      }
+    }
+
+    bool tryPop(T &value) {
+      auto position = dequeuePosition_.load(std::memory_order_relaxed);
+      for (;;) {
+        auto &cell = cells_[position & mask_];
+        auto sequence = cell.sequence.load(std::memory_order_acquire);
+        auto difference = static_cast<std::ptrdiff_t>(sequence) -
+                          static_cast<std::ptrdiff_t>(position + 1);
+        if (difference == 0) {
+          if (dequeuePosition_.compare_exchange_weak(
+                  position, position + 1, std::memory_order_relaxed)) {
+            value = std::move(cell.value);
+            cell.sequence.store(
+                position + mask_ + 1, std::memory_order_release);
+            return true;
+          }
+        } else if (difference < 0) {
+          return false;
+        } else {
+          position = dequeuePosition_.load(std::memory_order_relaxed);
+        }
+      }
+    }
+
+    std::size_t getCapacity() const noexcept {
+      return mask_ + 1;
+    }
+
+  private:
+    struct Cell {
+      std::atomic<std::size_t> sequence;
+      T value;
+    };
+
+    std::unique_ptr<Cell[]> cells_;
+    std::size_t mask_;
+    alignas(64) std::atomic<std::size_t> enqueuePosition_;
+    alignas(64) std::atomic<std::size_t> dequeuePosition_;
+  };
+} // namespace imp
\ No newline at end of file
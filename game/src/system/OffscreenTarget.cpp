@@ -0,0 +1,336 @@
+#include "OffscreenTarget.h"
+
+#include <array>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+
+#include "CpuProfiler.h"
+#include "ImageWriter.h"
+
+namespace imp {
+  OffscreenTarget::OffscreenTarget(
+      gsl::not_null<GpuContext *> context,
+      unsigned width,
+      unsigned height,
+      std::uint32_t imageCount):
+      context_{context},
+      width_{width},
+      height_{height},
+      renderPass_{createRenderPass()},
+      commandPool_{createCommandPool()},
+      nextImage_{0},
+      presentCount_{0},
+      readbackEnabled_{false},
+      readbackDirectory_{"."} {
+    if (width_ == 0 || height_ == 0) {
+      throw std::runtime_error{"offscreen target extent must be positive."};
+    }
+    if (imageCount == 0) {
+      throw std::runtime_error{
+          "offscreen target image count must be positive."};
+    }
+    initImages(imageCount);
+  }
+
+  OffscreenTarget::~OffscreenTarget() {
+    auto device = context_->getDevice();
+    device.waitIdle();
+    for (auto &image : images_) {
+      device.destroyFence(image.fence);
+      device.destroyFramebuffer(image.framebuffer);
+      device.destroyImageView(image.imageView);
+    }
+    device.destroyCommandPool(commandPool_);
+  }
+
+  vk::RenderPass OffscreenTarget::createRenderPass() {
+    if (context_->isDynamicRenderingEnabled()) {
+      return {};
+    }
+    auto attachmentDesc = GpuAttachmentDescription{};
+    attachmentDesc.format = FORMAT;
+    attachmentDesc.samples = vk::SampleCountFlagBits::e1;
+    attachmentDesc.loadOp = vk::AttachmentLoadOp::eClear;
+    attachmentDesc.storeOp = vk::AttachmentStoreOp::eStore;
+    attachmentDesc.stencilLoadOp = vk::AttachmentLoadOp::eDontCare;
+    attachmentDesc.stencilStoreOp = vk::AttachmentStoreOp::eDontCare;
+    attachmentDesc.initialLayout = vk::ImageLayout::eUndefined;
+    attachmentDesc.finalLayout = vk::ImageLayout::eTransferSrcOptimal;
+    auto attachmentRef = GpuAttachmentReference{};
+    attachmentRef.attachment = 0;
+    attachmentRef.layout = vk::ImageLayout::eColorAttachmentOptimal;
+    auto subpass = GpuSubpassDescription{};
+    subpass.pipelineBindPoint = vk::PipelineBindPoint::eGraphics;
+    subpass.colorAttachments = {&attachmentRef, 1};
+    auto dependency = GpuSubpassDependency{};
+    dependency.srcSubpass = VK_SUBPASS_EXTERNAL;
+    dependency.dstSubpass = 0;
+    dependency.srcStageMask = vk::PipelineStageFlagBits::eColorAttachmentOutput;
+    dependency.srcAccessMask = {};
+    dependency.dstStageMask = vk::PipelineStageFlagBits::eColorAttachmentOutput;
+    dependency.dstAccessMask = vk::AccessFlagBits::eColorAttachmentWrite;
+    auto createInfo = GpuRenderPassCreateInfo{};
+    createInfo.attachments = {&attachmentDesc, 1};
+    createInfo.subpasses = {&subpass, 1};
+    createInfo.dependencies = {&dependency, 1};
+    return context_->createRenderPass(createInfo);
+  }
+
+  vk::CommandPool OffscreenTarget::createCommandPool() {
+    auto createInfo = vk::CommandPoolCreateInfo{};
+    createInfo.flags = vk::CommandPoolCreateFlagBits::eResetCommandBuffer;
+    createInfo.queueFamilyIndex = context_->getGraphicsFamily();
+    return context_->getDevice().createCommandPool(createInfo);
+  }
+
+  void OffscreenTarget::initImages(std::uint32_t imageCount) {
+    auto device = context_->getDevice();
+    images_.reserve(imageCount);
+    for (auto i = std::uint32_t{}; i < imageCount; ++i) {
+      auto &image = images_.emplace_back(Image{createImage()});
+      auto viewCreateInfo = vk::ImageViewCreateInfo{};
+      viewCreateInfo.image = image.image.get();
+      viewCreateInfo.viewType = vk::ImageViewType::e2D;
+      viewCreateInfo.format = FORMAT;
+      viewCreateInfo.subresourceRange.aspectMask =
+          vk::ImageAspectFlagBits::eColor;
+      viewCreateInfo.subresourceRange.baseMipLevel = 0;
+      viewCreateInfo.subresourceRange.levelCount = 1;
+      viewCreateInfo.subresourceRange.baseArrayLayer = 0;
+      viewCreateInfo.subresourceRange.layerCount = 1;
+      image.imageView = device.createImageView(viewCreateInfo);
+      if (!context_->isDynamicRenderingEnabled()) {
+        auto framebufferCreateInfo = vk::FramebufferCreateInfo{};
+        framebufferCreateInfo.renderPass = renderPass_;
+        framebufferCreateInfo.attachmentCount = 1;
+        framebufferCreateInfo.pAttachments = &image.imageView;
+        framebufferCreateInfo.width = width_;
+        framebufferCreateInfo.height = height_;
+        framebufferCreateInfo.layers = 1;
+        image.framebuffer = device.createFramebuffer(framebufferCreateInfo);
+      }
+      auto allocateInfo = vk::CommandBufferAllocateInfo{};
+      allocateInfo.commandPool = commandPool_;
+      allocateInfo.commandBufferCount = 1;
+      device.allocateCommandBuffers(&allocateInfo, &image.commandBuffer);
+      auto fenceCreateInfo = vk::FenceCreateInfo{};
+      fenceCreateInfo.flags = vk::FenceCreateFlagBits::eSignaled;
+      image.fence = device.createFence(fenceCreateInfo);
+    }
+  }
+
+  GpuImage OffscreenTarget::createImage() {
+    auto image = vk::ImageCreateInfo{};
+    image.imageType = vk::ImageType::e2D;
+    image.format = FORMAT;
+    image.extent.width = width_;
+    image.extent.height = height_;
+    image.extent.depth = 1;
+    image.mipLevels = 1;
+    image.arrayLayers = 1;
+    image.usage = vk::ImageUsageFlagBits::eColorAttachment |
+                  vk::ImageUsageFlagBits::eTransferSrc;
+    auto allocation = VmaAllocationCreateInfo{};
+    allocation.usage = VMA_MEMORY_USAGE_GPU_ONLY;
+    return GpuImage{context_->getAllocator(), image, allocation};
+  }
+
+  GpuBuffer OffscreenTarget::createReadbackBuffer() {
+    auto buffer = vk::BufferCreateInfo{};
+    buffer.size = vk::DeviceSize{width_} * height_ * 4;
+    buffer.usage = vk::BufferUsageFlagBits::eTransferDst;
+    auto allocation = VmaAllocationCreateInfo{};
+    allocation.flags = VMA_ALLOCATION_CREATE_MAPPED_BIT;
+    allocation.usage = VMA_MEMORY_USAGE_GPU_TO_CPU;
+    return GpuBuffer{
+        context_->getAllocator(),
+        buffer,
+        allocation,
+        "offscreen readback buffer"};
+  }
+
+  gsl::not_null<GpuContext *> OffscreenTarget::getContext() const noexcept {
+    return context_;
+  }
+
+  unsigned OffscreenTarget::getSwapchainWidth() const noexcept {
+    return width_;
+  }
+
+  unsigned OffscreenTarget::getSwapchainHeight() const noexcept {
+    return height_;
+  }
+
+  vk::Format OffscreenTarget::getFormat() const noexcept {
+    return FORMAT;
+  }
+
+  vk::ImageLayout OffscreenTarget::getFinalLayout() const noexcept {
+    return vk::ImageLayout::eTransferSrcOptimal;
+  }
+
+  std::uint32_t OffscreenTarget::getImageCount() const noexcept {
+    return static_cast<std::uint32_t>(images_.size());
+  }
+
+  std::uint64_t OffscreenTarget::getPresentCount() const noexcept {
+    return presentCount_;
+  }
+
+  bool OffscreenTarget::isReadbackEnabled() const noexcept {
+    return readbackEnabled_;
+  }
+
+  void OffscreenTarget::setReadbackEnabled(bool readbackEnabled) {
+    readbackEnabled_ = readbackEnabled;
+  }
+
+  std::filesystem::path const &
+  OffscreenTarget::getReadbackDirectory() const noexcept {
+    return readbackDirectory_;
+  }
+
+  void OffscreenTarget::setReadbackDirectory(
+      std::filesystem::path const &directory) {
+    std::filesystem::create_directories(directory);
+    readbackDirectory_ = directory;
+  }
+
+  std::uint32_t
+  OffscreenTarget::acquireImage(vk::Semaphore semaphore, vk::Fence fence) {
+    IMP_CPU_ZONE("OffscreenTarget::acquireImage");
+    auto device = context_->getDevice();
+    auto index = nextImage_;
+    nextImage_ = (nextImage_ + 1) % getImageCount();
+    auto &image = images_[index];
+    if (device.waitForFences(
+            image.fence, true, std::numeric_limits<std::uint64_t>::max()) !=
+        vk::Result::eSuccess) {
+      throw std::runtime_error{"failed to wait for offscreen image."};
+    }
+    device.resetFences(image.fence);
+    auto submitInfo = vk::SubmitInfo{};
+    if (semaphore) {
+      submitInfo.signalSemaphoreCount = 1;
+      submitInfo.pSignalSemaphores = &semaphore;
+    }
+    context_->getGraphicsQueue().submit(submitInfo, fence);
+    return index;
+  }
+
+  void OffscreenTarget::present(
+      gsl::span<vk::Semaphore const> waitSemaphores, std::uint32_t imageIndex) {
+    IMP_CPU_ZONE("OffscreenTarget::present");
+    constexpr auto MAX_WAIT_SEMAPHORE_COUNT = std::size_t{8};
+    if (waitSemaphores.size() > MAX_WAIT_SEMAPHORE_COUNT) {
+      throw std::runtime_error{"too many present wait semaphores."};
+    }
+    auto &image = images_[imageIndex];
+    auto waitStages =
+        std::array<vk::PipelineStageFlags, MAX_WAIT_SEMAPHORE_COUNT>{};
+    waitStages.fill(vk::PipelineStageFlagBits::eAllCommands);
+    auto submitInfo = vk::SubmitInfo{};
+    submitInfo.waitSemaphoreCount =
+        static_cast<std::uint32_t>(waitSemaphores.size());
+    submitInfo.pWaitSemaphores = waitSemaphores.data();
+    submitInfo.pWaitDstStageMask = waitStages.data();
+    if (readbackEnabled_) {
+      recordReadback(image);
+      submitInfo.commandBufferCount = 1;
+      submitInfo.pCommandBuffers = &image.commandBuffer;
+    }
+    context_->getGraphicsQueue().submit(submitInfo, image.fence);
+    auto frame = presentCount_++;
+    if (readbackEnabled_) {
+      if (context_->getDevice().waitForFences(
+              image.fence, true, std::numeric_limits<std::uint64_t>::max()) !=
+          vk::Result::eSuccess) {
+        throw std::runtime_error{"failed to wait for offscreen readback."};
+      }
+      writeReadback(image, frame);
+    }
+  }
+
+  vk::RenderPass OffscreenTarget::getRenderPass() const noexcept {
+    return renderPass_;
+  }
+
+  vk::Framebuffer
+  OffscreenTarget::getFramebuffer(std::uint32_t index) const noexcept {
+    return images_[index].framebuffer;
+  }
+
+  vk::Image OffscreenTarget::getImage(std::uint32_t index) const noexcept {
+    return images_[index].image.get();
+  }
+
+  vk::ImageView
+  OffscreenTarget::getImageView(std::uint32_t index) const noexcept {
+    return images_[index].imageView;
+  }
+
+  void OffscreenTarget::recordReadback(Image &image) {
+    if (!image.readbackBuffer) {
+      image.readbackBuffer.emplace(createReadbackBuffer());
+    }
+    auto commandBuffer = image.commandBuffer;
+    commandBuffer.reset();
+    auto beginInfo = vk::CommandBufferBeginInfo{};
+    beginInfo.flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit;
+    commandBuffer.begin(beginInfo);
+    auto region = vk::BufferImageCopy{};
+    region.bufferOffset = 0;
+    region.bufferRowLength = 0;
+    region.bufferImageHeight = 0;
+    region.imageSubresource.aspectMask = vk::ImageAspectFlagBits::eColor;
+    region.imageSubresource.mipLevel = 0;
+    region.imageSubresource.baseArrayLayer = 0;
+    region.imageSubresource.layerCount = 1;
+    region.imageExtent.width = width_;
+    region.imageExtent.height = height_;
+    region.imageExtent.depth = 1;
+    commandBuffer.copyImageToBuffer(
+        image.image.get(),
+        vk::ImageLayout::eTransferSrcOptimal,
+        image.readbackBuffer->get(),
+        region);
+    auto barrier = vk::BufferMemoryBarrier{};
+    barrier.srcAccessMask = vk::AccessFlagBits::eTransferWrite;
+    barrier.dstAccessMask = vk::AccessFlagBits::eHostRead;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.buffer = image.readbackBuffer->get();
+    barrier.offset = 0;
+    barrier.size = VK_WHOLE_SIZE;
+    commandBuffer.pipelineBarrier(
+        vk::PipelineStageFlagBits::eTransfer,
+        vk::PipelineStageFlagBits::eHost,
+        {},
+        {},
+        barrier,
+        {});
+    commandBuffer.end();
+  }
+
+  void OffscreenTarget::writeReadback(Image &image, std::uint64_t frame) {
+    auto &buffer = *image.readbackBuffer;
+    buffer.invalidate();
+    auto name = std::ostringstream{};
+    name << "frame-" << std::setw(5) << std::setfill('0') << frame << ".ppm";
+    auto file =
+        std::ofstream{readbackDirectory_ / name.str(), std::ios::binary};
+    if (!file) {
+      throw std::runtime_error{"failed to open readback file."};
+    }
+    writePpm(
+        file,
+        width_,
+        height_,
+        std::size_t{width_} * 4,
+        {reinterpret_cast<std::uint8_t const *>(buffer.getMappedData()),
+         static_cast<std::size_t>(buffer.getSize())});
+  }
+} // namespace imp
\ No newline at end of file
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <filesystem>
+#include <optional>
+#include <vector>
+
+#include "GpuBuffer.h"
+#include "GpuImage.h"
+#include "RenderTarget.h"
+
+namespace imp {
+  class OffscreenTarget: public RenderTarget {
+  public:
+    static constexpr auto FORMAT = vk::Format::eR8G8B8A8Unorm;
+
+    OffscreenTarget(
+        gsl::not_null<GpuContext *> context,
+        unsigned width,
+        unsigned height,
+        std::uint32_t imageCount = 3);
+    ~OffscreenTarget() override;
+
+    OffscreenTarget(OffscreenTarget const &) = delete;
+    OffscreenTarget &operator=(OffscreenTarget const &) = delete;
+
+    gsl::not_null<GpuContext *> getContext() const noexcept override;
+    unsigned getSwapchainWidth() const noexcept override;
+    unsigned getSwapchainHeight() const noexcept override;
+    vk::Format getFormat() const noexcept override;
+    vk::ImageLayout getFinalLayout() const noexcept override;
+    std::uint32_t getImageCount() const noexcept;
+    std::uint64_t getPresentCount() const noexcept;
+
+    bool isReadbackEnabled() const noexcept;
+    void setReadbackEnabled(bool readbackEnabled);
+    std::filesystem::path const &getReadbackDirectory() const noexcept;
+    void setReadbackDirectory(std::filesystem::path const &directory);
+
+    std::uint32_t
+    acquireImage(vk::Semaphore semaphore, vk::Fence fence) override;
+    void present(
+        gsl::span<vk::Semaphore const> waitSemaphores,
+        std::uint32_t imageIndex) override;
+
+    vk::RenderPass getRenderPass() const noexcept override;
+    vk::Framebuffer
+    getFramebuffer(std::uint32_t index) const noexcept override;
+    vk::Image getImage(std::uint32_t index) const noexcept override;
+    vk::ImageView getImageView(std::uint32_t index) const noexcept override;
+
+  private:
+    struct Image {
+      GpuImage image;
+      vk::ImageView imageView;
+      vk::Framebuffer framebuffer;
+      vk::CommandBuffer commandBuffer;
+      vk::Fence fence;
+      std::optional<GpuBuffer> readbackBuffer;
+    };
+
+    gsl::not_null<GpuContext *> context_;
+    unsigned width_;
+    unsigned height_;
+    vk::RenderPass renderPass_;
+    vk::CommandPool commandPool_;
+    std::vector<Image> images_;
+    std::uint32_t nextImage_;
+    std::uint64_t presentCount_;
+    bool readbackEnabled_;
+    std::filesystem::path readbackDirectory_;
+
+    vk::RenderPass createRenderPass();
+    vk::CommandPool createCommandPool();
+    void initImages(std::uint32_t imageCount);
+    GpuImage createImage();
+    GpuBuffer createReadbackBuffer();
+    void recordReadback(Image &image);
+    void writeReadback(Image &image, std::uint64_t frame);
+  };
+} // namespace imp
\ No newline at end of file
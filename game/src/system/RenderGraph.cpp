@@ -0,0 +1,504 @@
+#include "RenderGraph.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <tuple>
+
+namespace imp {
+  namespace {
+    bool isSameTransition(
+        RenderGraph::Barrier const &a, RenderGraph::Barrier const &b) {
+      return a.image.index == b.image.index && a.srcUsages == b.srcUsages &&
+             a.srcWriteUsages == b.srcWriteUsages &&
+             a.dstUsage == b.dstUsage && a.dstRead == b.dstRead &&
+             a.dstWrite == b.dstWrite && a.oldLayout == b.oldLayout &&
+             a.newLayout == b.newLayout;
+    }
+
+    void appendBarrier(
+        std::vector<RenderGraph::Barrier> &barriers,
+        RenderGraph::Barrier const &barrier) {
+      if (!barriers.empty() && isSameTransition(barriers.back(), barrier)) {
+        auto &last = barriers.back().range;
+        auto &next = barrier.range;
+        if (last.baseLayer == next.baseLayer &&
+            last.layerCount == next.layerCount &&
+            last.baseLevel + last.levelCount == next.baseLevel) {
+          last.levelCount += next.levelCount;
+          return;
+        }
+        if (last.baseLevel == next.baseLevel &&
+            last.levelCount == next.levelCount &&
+            last.baseLayer + last.layerCount == next.baseLayer) {
+          last.layerCount += next.layerCount;
+          return;
+        }
+      }
+      barriers.emplace_back(barrier);
+    }
+  } // namespace
+
+  RenderGraph::ImageHandle RenderGraph::importImage(
+      std::string name,
+      unsigned levelCount,
+      unsigned layerCount,
+      Usage initialUsage) {
+    if (levelCount == 0 || layerCount == 0) {
+      throw std::runtime_error{"render graph image is empty."};
+    }
+    images_.emplace_back(Image{
+        std::move(name),
+        levelCount,
+        layerCount,
+        initialUsage,
+        std::nullopt,
+        false,
+        0,
+        std::nullopt});
+    compiled_ = false;
+    return {images_.size() - 1};
+  }
+
+  RenderGraph::ImageHandle RenderGraph::addTransientImage(
+      std::string name,
+      unsigned levelCount,
+      unsigned layerCount,
+      std::size_t size) {
+    auto image = importImage(std::move(name), levelCount, layerCount);
+    images_.back().transient = true;
+    images_.back().size = size;
+    return image;
+  }
+
+  RenderGraph::PassHandle
+  RenderGraph::addPass(std::string name, std::function<void()> execute) {
+    passes_.emplace_back(
+        Pass{std::move(name), std::move(execute), {}, false, false, {}});
+    compiled_ = false;
+    return {passes_.size() - 1};
+  }
+
+  void RenderGraph::read(
+      PassHandle pass, ImageHandle image, Range const &range, Usage usage) {
+    addAccess(pass, image, range, usage, true, false);
+  }
+
+  void RenderGraph::write(
+      PassHandle pass, ImageHandle image, Range const &range, Usage usage) {
+    addAccess(pass, image, range, usage, false, true);
+  }
+
+  void RenderGraph::markOutput(PassHandle pass) {
+    if (pass.index >= passes_.size()) {
+      throw std::runtime_error{"invalid render graph pass."};
+    }
+    passes_[pass.index].output = true;
+    compiled_ = false;
+  }
+
+  void RenderGraph::exportImage(ImageHandle image, Usage finalUsage) {
+    if (image.index >= images_.size()) {
+      throw std::runtime_error{"invalid render graph image."};
+    }
+    if (images_[image.index].transient) {
+      throw std::runtime_error{"transient images cannot be exported."};
+    }
+    images_[image.index].finalUsage = finalUsage;
+    compiled_ = false;
+  }
+
+  void RenderGraph::setExternalTransientUsages(UsageFlags usages) {
+    externalTransientUsages_ = usages;
+    compiled_ = false;
+  }
+
+  void RenderGraph::compile() {
+    cullPasses();
+    assignSlots();
+    computeBarriers();
+    compiled_ = true;
+  }
+
+  void RenderGraph::execute(
+      std::function<void(gsl::span<Barrier const>)> const &recordBarriers) {
+    if (!compiled_) {
+      compile();
+    }
+    for (auto &pass : passes_) {
+      if (!pass.culled) {
+        if (!pass.barriers.empty()) {
+          recordBarriers(pass.barriers);
+        }
+        if (pass.execute) {
+          pass.execute();
+        }
+      }
+    }
+    if (!finalBarriers_.empty()) {
+      recordBarriers(finalBarriers_);
+    }
+  }
+
+  bool RenderGraph::isCompiled() const noexcept {
+    return compiled_;
+  }
+
+  std::size_t RenderGraph::getImageCount() const noexcept {
+    return images_.size();
+  }
+
+  std::string const &RenderGraph::getImageName(ImageHandle image) const {
+    return images_.at(image.index).name;
+  }
+
+  std::size_t RenderGraph::getPassCount() const noexcept {
+    return passes_.size();
+  }
+
+  std::string const &RenderGraph::getPassName(PassHandle pass) const {
+    return passes_.at(pass.index).name;
+  }
+
+  bool RenderGraph::isPassCulled(PassHandle pass) const {
+    if (!compiled_) {
+      throw std::runtime_error{"render graph is not compiled."};
+    }
+    return passes_.at(pass.index).culled;
+  }
+
+  std::size_t RenderGraph::getCulledPassCount() const {
+    if (!compiled_) {
+      throw std::runtime_error{"render graph is not compiled."};
+    }
+    return std::count_if(passes_.begin(), passes_.end(), [](auto &pass) {
+      return pass.culled;
+    });
+  }
+
+  gsl::span<RenderGraph::Barrier const>
+  RenderGraph::getBarriers(PassHandle pass) const {
+    if (!compiled_) {
+      throw std::runtime_error{"render graph is not compiled."};
+    }
+    return passes_.at(pass.index).barriers;
+  }
+
+  gsl::span<RenderGraph::Barrier const> RenderGraph::getFinalBarriers() const {
+    if (!compiled_) {
+      throw std::runtime_error{"render graph is not compiled."};
+    }
+    return finalBarriers_;
+  }
+
+  std::size_t RenderGraph::getBarrierCount() const {
+    auto count = getFinalBarriers().size();
+    for (auto &pass : passes_) {
+      count += pass.barriers.size();
+    }
+    return count;
+  }
+
+  std::optional<std::size_t>
+  RenderGraph::getImageSlot(ImageHandle image) const {
+    if (!compiled_) {
+      throw std::runtime_error{"render graph is not compiled."};
+    }
+    return images_.at(image.index).slot;
+  }
+
+  std::size_t RenderGraph::getSlotCount() const {
+    if (!compiled_) {
+      throw std::runtime_error{"render graph is not compiled."};
+    }
+    return slots_.size();
+  }
+
+  std::size_t RenderGraph::getSlotSize(std::size_t slot) const {
+    if (!compiled_) {
+      throw std::runtime_error{"render graph is not compiled."};
+    }
+    return slots_.at(slot).size;
+  }
+
+  std::size_t RenderGraph::getTransientSize() const {
+    if (!compiled_) {
+      throw std::runtime_error{"render graph is not compiled."};
+    }
+    auto size = std::size_t{};
+    for (auto &image : images_) {
+      if (image.slot) {
+        size += image.size;
+      }
+    }
+    return size;
+  }
+
+  std::size_t RenderGraph::getAliasedTransientSize() const {
+    if (!compiled_) {
+      throw std::runtime_error{"render graph is not compiled."};
+    }
+    auto size = std::size_t{};
+    for (auto &slot : slots_) {
+      size += slot.size;
+    }
+    return size;
+  }
+
+  void RenderGraph::addAccess(
+      PassHandle pass,
+      ImageHandle image,
+      Range const &range,
+      Usage usage,
+      bool read,
+      bool write) {
+    if (pass.index >= passes_.size()) {
+      throw std::runtime_error{"invalid render graph pass."};
+    }
+    if (image.index >= images_.size()) {
+      throw std::runtime_error{"invalid render graph image."};
+    }
+    if (usage == Usage::NONE) {
+      throw std::runtime_error{"render graph access has no usage."};
+    }
+    auto &info = images_[image.index];
+    if (range.levelCount == 0 || range.layerCount == 0 ||
+        range.baseLevel + range.levelCount > info.levelCount ||
+        range.baseLayer + range.layerCount > info.layerCount) {
+      throw std::runtime_error{"render graph range is out of bounds."};
+    }
+    passes_[pass.index].accesses.emplace_back(
+        Access{image, range, usage, read, write});
+    compiled_ = false;
+  }
+
+  void RenderGraph::cullPasses() {
+    auto needed = std::vector<std::vector<bool>>{};
+    needed.reserve(images_.size());
+    for (auto &image : images_) {
+      needed.emplace_back(
+          image.levelCount * image.layerCount, image.finalUsage.has_value());
+    }
+    auto forEachSubresource = [&](Access const &access, auto &&f) {
+      auto &range = access.range;
+      auto levelCount = images_[access.image.index].levelCount;
+      for (auto layer = range.baseLayer;
+           layer < range.baseLayer + range.layerCount;
+           ++layer) {
+        for (auto level = range.baseLevel;
+             level < range.baseLevel + range.levelCount;
+             ++level) {
+          f(needed[access.image.index][layer * levelCount + level]);
+        }
+      }
+    };
+    for (auto pass = passes_.rbegin(); pass != passes_.rend(); ++pass) {
+      auto live = pass->output;
+      for (auto &access : pass->accesses) {
+        if (access.write) {
+          forEachSubresource(access, [&](auto subresource) {
+            live = live || subresource;
+          });
+        }
+      }
+      pass->culled = !live;
+      if (live) {
+        for (auto &access : pass->accesses) {
+          if (access.write && !access.read) {
+            forEachSubresource(
+                access, [](auto subresource) { subresource = false; });
+          }
+        }
+        for (auto &access : pass->accesses) {
+          if (access.read) {
+            forEachSubresource(
+                access, [](auto subresource) { subresource = true; });
+          }
+        }
+      }
+    }
+  }
+
+  void RenderGraph::assignSlots() {
+    slots_.clear();
+    auto lifetimes =
+        std::vector<std::optional<std::pair<std::size_t, std::size_t>>>(
+            images_.size());
+    auto order = std::size_t{};
+    for (auto &pass : passes_) {
+      if (!pass.culled) {
+        for (auto &access : pass.accesses) {
+          auto &lifetime = lifetimes[access.image.index];
+          if (lifetime) {
+            lifetime->second = order;
+          } else {
+            lifetime = std::pair{order, order};
+          }
+        }
+        ++order;
+      }
+    }
+    auto transients = std::vector<std::size_t>{};
+    for (auto i = std::size_t{}; i < images_.size(); ++i) {
+      images_[i].slot = std::nullopt;
+      if (images_[i].transient && lifetimes[i]) {
+        transients.emplace_back(i);
+      }
+    }
+    std::stable_sort(
+        transients.begin(), transients.end(), [&](auto lhs, auto rhs) {
+          return images_[lhs].size > images_[rhs].size;
+        });
+    for (auto i : transients) {
+      auto &lifetime = *lifetimes[i];
+      auto slot = std::find_if(slots_.begin(), slots_.end(), [&](auto &slot) {
+        return std::none_of(
+            slot.lifetimes.begin(), slot.lifetimes.end(), [&](auto &other) {
+              return lifetime.first <= other.second &&
+                     other.first <= lifetime.second;
+            });
+      });
+      if (slot == slots_.end()) {
+        slot = slots_.emplace(slots_.end(), Slot{0, {}});
+      }
+      slot->size = std::max(slot->size, images_[i].size);
+      slot->lifetimes.emplace_back(lifetime);
+      images_[i].slot = static_cast<std::size_t>(slot - slots_.begin());
+    }
+  }
+
+  void RenderGraph::computeBarriers() {
+    auto states = std::vector<std::vector<SubresourceState>>{};
+    states.reserve(images_.size());
+    for (auto &image : images_) {
+      auto flag = getFlag(image.initialUsage);
+      states.emplace_back(
+          image.levelCount * image.layerCount,
+          SubresourceState{getLayout(image.initialUsage), 0, 0, flag, true});
+    }
+    auto slotUsages =
+        std::vector<UsageFlags>(slots_.size(), externalTransientUsages_);
+    auto requests = std::vector<Access>{};
+    for (auto &pass : passes_) {
+      pass.barriers.clear();
+      if (pass.culled) {
+        continue;
+      }
+      requests.clear();
+      for (auto &access : pass.accesses) {
+        auto &range = access.range;
+        for (auto layer = range.baseLayer;
+             layer < range.baseLayer + range.layerCount;
+             ++layer) {
+          for (auto level = range.baseLevel;
+               level < range.baseLevel + range.levelCount;
+               ++level) {
+            auto request = std::find_if(
+                requests.begin(), requests.end(), [&](auto &request) {
+                  return request.image.index == access.image.index &&
+                         request.range.baseLevel == level &&
+                         request.range.baseLayer == layer;
+                });
+            if (request == requests.end()) {
+              requests.emplace_back(Access{
+                  access.image,
+                  {level, 1, layer, 1},
+                  access.usage,
+                  access.read,
+                  access.write});
+            } else if (request->usage != access.usage) {
+              throw std::runtime_error{
+                  "render graph pass has conflicting image usages."};
+            } else {
+              request->read = request->read || access.read;
+              request->write = request->write || access.write;
+            }
+          }
+        }
+      }
+      std::sort(requests.begin(), requests.end(), [](auto &lhs, auto &rhs) {
+        return std::tuple{
+                   lhs.image.index, lhs.range.baseLayer, lhs.range.baseLevel} <
+               std::tuple{
+                   rhs.image.index, rhs.range.baseLayer, rhs.range.baseLevel};
+      });
+      for (auto &request : requests) {
+        transition(pass.barriers, states, slotUsages, request);
+      }
+    }
+    finalBarriers_.clear();
+    for (auto i = std::size_t{}; i < images_.size(); ++i) {
+      auto &image = images_[i];
+      if (image.finalUsage) {
+        for (auto layer = 0u; layer < image.layerCount; ++layer) {
+          for (auto level = 0u; level < image.levelCount; ++level) {
+            transition(
+                finalBarriers_,
+                states,
+                slotUsages,
+                Access{
+                    {i}, {level, 1, layer, 1}, *image.finalUsage, true, false});
+          }
+        }
+      }
+    }
+  }
+
+  void RenderGraph::transition(
+      std::vector<Barrier> &barriers,
+      std::vector<std::vector<SubresourceState>> &states,
+      std::vector<UsageFlags> &slotUsages,
+      Access const &request) {
+    auto &image = images_[request.image.index];
+    auto &state = states[request.image.index][request.range.baseLayer *
+                                                  image.levelCount +
+                                              request.range.baseLevel];
+    auto flag = getFlag(request.usage);
+    auto layout = getLayout(request.usage);
+    constexpr auto WRITABLE_USAGES = getFlag(Usage::COLOR_ATTACHMENT) |
+                                     getFlag(Usage::COMPUTE_STORAGE);
+    auto aliasUsages = UsageFlags{};
+    if (image.slot) {
+      if (state.fresh) {
+        aliasUsages = slotUsages[*image.slot];
+      }
+      slotUsages[*image.slot] |= flag;
+    }
+    state.fresh = false;
+    auto barrier = Barrier{
+        request.image,
+        request.range,
+        0,
+        0,
+        request.usage,
+        request.read,
+        request.write,
+        state.layout,
+        layout};
+    if (request.write) {
+      if (!request.read && state.layout != layout) {
+        barrier.oldLayout = Layout::UNDEFINED;
+      }
+      barrier.srcUsages =
+          state.pendingUsages | state.readerUsages | aliasUsages;
+      barrier.srcWriteUsages =
+          state.pendingWriteUsages | (aliasUsages & WRITABLE_USAGES);
+      state = {layout, flag, flag, 0, false};
+    } else if (state.layout != layout) {
+      barrier.srcUsages =
+          state.pendingUsages | state.readerUsages | aliasUsages;
+      barrier.srcWriteUsages =
+          state.pendingWriteUsages | (aliasUsages & WRITABLE_USAGES);
+      state = {layout, flag, 0, flag, false};
+    } else if (
+        (state.pendingUsages == 0 || (state.readerUsages & flag) != 0) &&
+        aliasUsages == 0) {
+      return;
+    } else {
+      barrier.srcUsages = state.pendingUsages | aliasUsages;
+      barrier.srcWriteUsages =
+          state.pendingWriteUsages | (aliasUsages & WRITABLE_USAGES);
+      state.readerUsages |= flag;
+    }
+    appendBarrier(barriers, barrier);
+  }
+} // namespace imp
\ No newline at end of file
@@ -0,0 +1,185 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "../util/Gsl.h"
+
+namespace imp {
+  class RenderGraph {
+  public:
+    enum class Usage : std::uint8_t {
+      NONE,
+      COLOR_ATTACHMENT,
+      FRAGMENT_SAMPLED,
+      COMPUTE_SAMPLED,
+      COMPUTE_STORAGE,
+      PRESENT
+    };
+
+    enum class Layout : std::uint8_t {
+      UNDEFINED,
+      COLOR_ATTACHMENT,
+      SHADER_READ_ONLY,
+      GENERAL,
+      PRESENT
+    };
+
+    using UsageFlags = std::uint32_t;
+
+    struct ImageHandle {
+      std::size_t index;
+    };
+
+    struct PassHandle {
+      std::size_t index;
+    };
+
+    struct Range {
+      unsigned baseLevel;
+      unsigned levelCount;
+      unsigned baseLayer;
+      unsigned layerCount;
+    };
+
+    struct Barrier {
+      ImageHandle image;
+      Range range;
+      UsageFlags srcUsages;
+      UsageFlags srcWriteUsages;
+      Usage dstUsage;
+      bool dstRead;
+      bool dstWrite;
+      Layout oldLayout;
+      Layout newLayout;
+    };
+
+    static constexpr UsageFlags getFlag(Usage usage) noexcept {
+      return usage == Usage::NONE ? 0 : UsageFlags{1} << unsigned(usage);
+    }
+
+    static constexpr Layout getLayout(Usage usage) noexcept {
+      switch (usage) {
+      case Usage::COLOR_ATTACHMENT:
+        return Layout::COLOR_ATTACHMENT;
+      case Usage::FRAGMENT_SAMPLED:
+      case Usage::COMPUTE_SAMPLED:
+        return Layout::SHADER_READ_ONLY;
+      case Usage::COMPUTE_STORAGE:
+        return Layout::GENERAL;
+      case Usage::PRESENT:
+        return Layout::PRESENT;
+      default:
+        return Layout::UNDEFINED;
+      }
+    }
+
+    ImageHandle importImage(
+        std::string name,
+        unsigned levelCount,
+        unsigned layerCount,
+        Usage initialUsage = Usage::NONE);
+    ImageHandle addTransientImage(
+        std::string name,
+        unsigned levelCount,
+        unsigned layerCount,
+        std::size_t size);
+    PassHandle addPass(std::string name, std::function<void()> execute);
+    void read(
+        PassHandle pass, ImageHandle image, Range const &range, Usage usage);
+    void write(
+        PassHandle pass, ImageHandle image, Range const &range, Usage usage);
+    void markOutput(PassHandle pass);
+    void exportImage(ImageHandle image, Usage finalUsage);
+    void setExternalTransientUsages(UsageFlags usages);
+
+    void compile();
+    void execute(
+        std::function<void(gsl::span<Barrier const>)> const &recordBarriers);
+
+    bool isCompiled() const noexcept;
+    std::size_t getImageCount() const noexcept;
+    std::string const &getImageName(ImageHandle image) const;
+    std::size_t getPassCount() const noexcept;
+    std::string const &getPassName(PassHandle pass) const;
+    bool isPassCulled(PassHandle pass) const;
+    std::size_t getCulledPassCount() const;
+    gsl::span<Barrier const> getBarriers(PassHandle pass) const;
+    gsl::span<Barrier const> getFinalBarriers() const;
+    std::size_t getBarrierCount() const;
+    std::optional<std::size_t> getImageSlot(ImageHandle image) const;
+    std::size_t getSlotCount() const;
+    std::size_t getSlotSize(std::size_t slot) const;
+    std::size_t getTransientSize() const;
+    std::size_t getAliasedTransientSize() const;
+
+  private:
+    struct Image {
+      std::string name;
+      unsigned levelCount;
+      unsigned layerCount;
+      Usage initialUsage;
+      std::optional<Usage> finalUsage;
+      bool transient;
+      std::size_t size;
+      std::optional<std::size_t> slot;
+    };
+
+    struct Access {
+      ImageHandle image;
+      Range range;
+      Usage usage;
+      bool read;
+      bool write;
+    };
+
+    struct Pass {
+      std::string name;
+      std::function<void()> execute;
+      std::vector<Access> accesses;
+      bool output;
+      bool culled;
+      std::vector<Barrier> barriers;
+    };
+
+    struct SubresourceState {
+      Layout layout;
+      UsageFlags pendingUsages;
+      UsageFlags pendingWriteUsages;
+      UsageFlags readerUsages;
+      bool fresh;
+    };
+
+    struct Slot {
+      std::size_t size;
+      std::vector<std::pair<std::size_t, std::size_t>> lifetimes;
+    };
+
+    void addAccess(
+        PassHandle pass,
+        ImageHandle image,
+        Range const &range,
+        Usage usage,
+        bool read,
+        bool write);
+    void cullPasses();
+    void assignSlots();
+    void computeBarriers();
+    void transition(
+        std::vector<Barrier> &barriers,
+        std::vector<std::vector<SubresourceState>> &states,
+        std::vector<UsageFlags> &slotUsages,
+        Access const &request);
+
+    std::vector<Image> images_;
+    std::vector<Pass> passes_;
+    std::vector<Barrier> finalBarriers_;
+    std::vector<Slot> slots_;
+    UsageFlags externalTransientUsages_ = 0;
+    bool compiled_ = false;
+  };
+} // namespace imp
\ No newline at end of file
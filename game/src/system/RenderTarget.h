@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstdint>
+
+#include <vulkan/vulkan.hpp>
+
+#include "GpuContext.h"
+
+namespace imp {
+  class RenderTarget {
+  public:
+    virtual ~RenderTarget() = default;
+
+    virtual gsl::not_null<GpuContext *> getContext() const noexcept = 0;
+    virtual unsigned getSwapchainWidth() const noexcept = 0;
+    virtual unsigned getSwapchainHeight() const noexcept = 0;
+    virtual vk::Format getFormat() const noexcept = 0;
+    virtual vk::ImageLayout getFinalLayout() const noexcept = 0;
+
+    virtual std::uint32_t
+    acquireImage(vk::Semaphore semaphore, vk::Fence fence) = 0;
+    virtual void present(
+        gsl::span<vk::Semaphore const> waitSemaphores,
+        std::uint32_t imageIndex) = 0;
+
+    virtual vk::RenderPass getRenderPass() const noexcept = 0;
+    virtual vk::Framebuffer
+    getFramebuffer(std::uint32_t index) const noexcept = 0;
+    virtual vk::Image getImage(std::uint32_t index) const noexcept = 0;
+    virtual vk::ImageView
+    getImageView(std::uint32_t index) const noexcept = 0;
+  };
+} // namespace imp
\ No newline at end of file
@@ -0,0 +1,47 @@
+#include "Task.h"
+
+namespace imp {
+  std::mutex TaskPool::mutex_;
+  TaskPool::Block *TaskPool::freeBlocks_ = nullptr;
+  std::size_t TaskPool::freeBlockCount_ = 0;
+
+  void TaskPool::reserve(std::size_t blockCount) {
+    auto lock = std::scoped_lock{mutex_};
+    while (freeBlockCount_ < blockCount) {
+      grow();
+    }
+  }
+
+  void *TaskPool::allocate(std::size_t size) {
+    if (size > BLOCK_SIZE) {
+      return ::operator new(size);
+    }
+    auto lock = std::scoped_lock{mutex_};
+    if (!freeBlocks_) {
+      grow();
+    }
+    auto block = freeBlocks_;
+    freeBlocks_ = block->next;
+    --freeBlockCount_;
+    return block;
+  }
+
+  void TaskPool::deallocate(void *block, std::size_t size) noexcept {
+    if (size > BLOCK_SIZE) {
+      ::operator delete(block);
+      return;
+    }
+    auto lock = std::scoped_lock{mutex_};
+    freeBlocks_ = new (block) Block{freeBlocks_};
+    ++freeBlockCount_;
+  }
+
+  void TaskPool::grow() {
+    auto chunk = static_cast<std::byte *>(
+        ::operator new(BLOCK_SIZE * CHUNK_BLOCK_COUNT));
+    for (auto i = std::size_t{}; i < CHUNK_BLOCK_COUNT; ++i) {
+      freeBlocks_ = new (chunk + BLOCK_SIZE * i) Block{freeBlocks_};
+    }
+    freeBlockCount_ += CHUNK_BLOCK_COUNT;
+  }
+} // namespace imp
\ No newline at end of file
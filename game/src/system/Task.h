@@ -0,0 +1,158 @@
+#pragma once
+
+#include <cstddef>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace imp {
+  class TaskPool {
+  public:
+    static constexpr auto BLOCK_SIZE = std::size_t{256};
+    static constexpr auto CHUNK_BLOCK_COUNT = std::size_t{64};
+
+    static void reserve(std::size_t blockCount);
+    static void *allocate(std::size_t size);
+    static void deallocate(void *block, std::size_t size) noexcept;
+
+  private:
+    struct Block {
+      Block *next;
+    };
+
+    static void grow();
+
+    static std::mutex mutex_;
+    static Block *freeBlocks_;
+    static std::size_t freeBlockCount_;
+  };
+
+  template<typename T>
+  class TaskPoolAllocator {
+  public:
+    using value_type = T;
+
+    TaskPoolAllocator() noexcept = default;
+
+    template<typename U>
+    TaskPoolAllocator(TaskPoolAllocator<U> const &) noexcept {}
+
+    T *allocate(std::size_t n) {
+      return static_cast<T *>(TaskPool::allocate(sizeof(T) * n));
+    }
+
+    void deallocate(T *p, std::size_t n) noexcept {
+      TaskPool::deallocate(p, sizeof(T) * n);
+    }
+
+    template<typename U>
+    bool operator==(TaskPoolAllocator<U> const &) const noexcept {
+      return true;
+    }
+  };
+
+  class Task {
+  public:
+    static constexpr auto INLINE_SIZE = 6 * sizeof(void *);
+
+    Task() noexcept: operations_{nullptr} {}
+
+    template<
+        typename F,
+        typename = std::enable_if_t<!std::is_same_v<std::decay_t<F>, Task>>>
+    Task(F &&f) {
+      using Function = std::decay_t<F>;
+      if constexpr (isInline<Function>()) {
+        new (&storage_) Function{std::forward<F>(f)};
+        operations_ = &INLINE_OPERATIONS<Function>;
+      } else {
+        auto object = TaskPool::allocate(sizeof(Function));
+        try {
+          new (object) Function{std::forward<F>(f)};
+        } catch (...) {
+          TaskPool::deallocate(object, sizeof(Function));
+          throw;
+        }
+        new (&storage_) void *{object};
+        operations_ = &POOLED_OPERATIONS<Function>;
+      }
+    }
+
+    Task(Task &&rhs) noexcept: operations_{rhs.operations_} {
+      if (operations_) {
+        operations_->move(&storage_, &rhs.storage_);
+        rhs.operations_ = nullptr;
+      }
+    }
+
+    Task &operator=(Task &&rhs) noexcept {
+      if (&rhs != this) {
+        reset();
+        operations_ = rhs.operations_;
+        if (operations_) {
+          operations_->move(&storage_, &rhs.storage_);
+          rhs.operations_ = nullptr;
+        }
+      }
+      return *this;
+    }
+
+    ~Task() {
+      reset();
+    }
+
+    void operator()() {
+      operations_->invoke(&storage_);
+    }
+
+    explicit operator bool() const noexcept {
+      return operations_ != nullptr;
+    }
+
+    void reset() noexcept {
+      if (operations_) {
+        operations_->destroy(&storage_);
+        operations_ = nullptr;
+      }
+    }
+
+    template<typename F>
+    static constexpr bool isInline() noexcept {
+      return sizeof(F) <= INLINE_SIZE &&
+             alignof(F) <= alignof(std::max_align_t) &&
+             std::is_nothrow_move_constructible_v<F>;
+    }
+
+  private:
+    struct Operations {
+      void (*invoke)(void *storage);
+      void (*move)(void *dst, void *src) noexcept;
+      void (*destroy)(void *storage) noexcept;
+    };
+
+    template<typename F>
+    static constexpr auto INLINE_OPERATIONS = Operations{
+        [](void *storage) { (*static_cast<F *>(storage))(); },
+        [](void *dst, void *src) noexcept {
+          new (dst) F{std::move(*static_cast<F *>(src))};
+          static_cast<F *>(src)->~F();
+        },
+        [](void *storage) noexcept { static_cast<F *>(storage)->~F(); }};
+
+    template<typename F>
+    static constexpr auto POOLED_OPERATIONS = Operations{
+        [](void *storage) { (**static_cast<F **>(storage))(); },
+        [](void *dst, void *src) noexcept {
+          new (dst) void *{*static_cast<void **>(src)};
+        },
+        [](void *storage) noexcept {
+          auto object = *static_cast<F **>(storage);
+          object->~F();
+          TaskPool::deallocate(object, sizeof(F));
+        }};
+
+    alignas(std::max_align_t) std::byte storage_[INLINE_SIZE];
+    Operations const *operations_;
+  };
+} // namespace imp
\ No newline at end of file
@@ -0,0 +1,124 @@
+#include "TimingHistory.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <stdexcept>
+
+namespace imp {
+  namespace {
+    void writeJsonString(std::ostream &os, std::string_view s) {
+      os << '"';
+      for (auto c : s) {
+        if (c == '"' || c == '\\') {
+          os << '\\';
+        }
+        os << c;
+      }
+      os << '"';
+    }
+
+    double getPercentile(std::vector<double> const &sorted, double p) {
+      auto rank = static_cast<std::size_t>(std::ceil(p * sorted.size()));
+      return sorted[std::clamp(rank, std::size_t{1}, sorted.size()) - 1];
+    }
+  } // namespace
+
+  TimingHistory::TimingHistory(std::size_t windowSize):
+      windowSize_{windowSize} {
+    if (windowSize_ == 0) {
+      throw std::runtime_error{"window size must be positive."};
+    }
+  }
+
+  void TimingHistory::record(
+      std::string_view owner, std::string_view pass, double time) {
+    auto ownerIt = samples_.find(owner);
+    if (ownerIt == samples_.end()) {
+      ownerIt = samples_.emplace(std::string{owner}, PassSamples{}).first;
+    }
+    auto passIt = ownerIt->second.find(pass);
+    if (passIt == ownerIt->second.end()) {
+      passIt = ownerIt->second.emplace(std::string{pass}, Samples{}).first;
+    }
+    auto &samples = passIt->second;
+    if (samples.values.size() < windowSize_) {
+      samples.values.emplace_back(time);
+    } else {
+      samples.values[samples.next] = time;
+    }
+    samples.next = (samples.next + 1) % windowSize_;
+  }
+
+  void TimingHistory::clear() noexcept {
+    samples_.clear();
+  }
+
+  std::optional<TimingStats> TimingHistory::getStats(
+      std::string_view owner, std::string_view pass) const {
+    auto ownerIt = samples_.find(owner);
+    if (ownerIt == samples_.end()) {
+      return std::nullopt;
+    }
+    auto passIt = ownerIt->second.find(pass);
+    if (passIt == ownerIt->second.end()) {
+      return std::nullopt;
+    }
+    return computeStats(owner, pass, passIt->second);
+  }
+
+  std::vector<TimingStats> TimingHistory::getStats() const {
+    auto stats = std::vector<TimingStats>{};
+    for (auto &[owner, passes] : samples_) {
+      for (auto &[pass, samples] : passes) {
+        stats.emplace_back(computeStats(owner, pass, samples));
+      }
+    }
+    return stats;
+  }
+
+  std::size_t TimingHistory::getWindowSize() const noexcept {
+    return windowSize_;
+  }
+
+  void TimingHistory::writeJson(std::ostream &os) const {
+    os << "[";
+    auto first = true;
+    for (auto &stats : getStats()) {
+      os << (first ? "\n" : ",\n") << "  {\"owner\": ";
+      writeJsonString(os, stats.owner);
+      os << ", \"pass\": ";
+      writeJsonString(os, stats.pass);
+      os << ", \"samples\": " << stats.sampleCount
+         << ", \"min\": " << stats.min << ", \"avg\": " << stats.average
+         << ", \"p95\": " << stats.p95 << ", \"p99\": " << stats.p99 << "}";
+      first = false;
+    }
+    os << "\n]\n";
+  }
+
+  void TimingHistory::writeCsv(std::ostream &os) const {
+    os << "owner,pass,samples,min,avg,p95,p99\n";
+    for (auto &stats : getStats()) {
+      os << stats.owner << "," << stats.pass << "," << stats.sampleCount
+         << "," << stats.min << "," << stats.average << "," << stats.p95
+         << "," << stats.p99 << "\n";
+    }
+  }
+
+  TimingStats TimingHistory::computeStats(
+      std::string_view owner, std::string_view pass, Samples const &samples) {
+    auto sorted = samples.values;
+    std::sort(sorted.begin(), sorted.end());
+    auto stats = TimingStats{};
+    stats.owner = owner;
+    stats.pass = pass;
+    stats.sampleCount = sorted.size();
+    stats.min = sorted.front();
+    stats.average =
+        std::accumulate(sorted.begin(), sorted.end(), 0.0) / sorted.size();
+    stats.p95 = getPercentile(sorted, 0.95);
+    stats.p99 = getPercentile(sorted, 0.99);
+    return stats;
+  }
+} // namespace imp
\ No newline at end of file
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstddef>
+#include <map>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace imp {
+  struct TimingStats {
+    std::string owner;
+    std::string pass;
+    std::size_t sampleCount;
+    double min;
+    double average;
+    double p95;
+    double p99;
+  };
+
+  class TimingHistory {
+  public:
+    explicit TimingHistory(std::size_t windowSize = 256);
+
+    void record(std::string_view owner, std::string_view pass, double time);
+    void clear() noexcept;
+
+    std::optional<TimingStats>
+    getStats(std::string_view owner, std::string_view pass) const;
+    std::vector<TimingStats> getStats() const;
+    std::size_t getWindowSize() const noexcept;
+
+    void writeJson(std::ostream &os) const;
+    void writeCsv(std::ostream &os) const;
+
+  private:
+    struct Samples {
+      std::vector<double> values;
+      std::size_t next;
+    };
+
+    using PassSamples = std::map<std::string, Samples, std::less<>>;
+
+    static TimingStats computeStats(
+        std::string_view owner, std::string_view pass, Samples const &samples);
+
+    std::size_t windowSize_;
+    std::map<std::string, PassSamples, std::less<>> samples_;
+  };
+} // namespace imp
\ No newline at end of file
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace imp {
+  template<typename T>
+  class TripleBuffer {
+  public:
+    TripleBuffer(): middle_{1}, writeIndex_{0}, readIndex_{2} {}
+
+    T &getWriteBuffer() noexcept {
+      return buffers_[writeIndex_];
+    }
+
+    void publish() noexcept {
+      writeIndex_ =
+          middle_.exchange(writeIndex_ | DIRTY, std::memory_order_acq_rel) &
+          INDEX_MASK;
+    }
+
+    bool acquire() noexcept {
+      if ((middle_.load(std::memory_order_relaxed) & DIRTY) == 0) {
+        return false;
+      }
+      readIndex_ =
+          middle_.exchange(readIndex_, std::memory_order_acq_rel) & INDEX_MASK;
+      return true;
+    }
+
+    T const &getReadBuffer() const noexcept {
+      return buffers_[readIndex_];
+    }
+
+  private:
+    static constexpr auto DIRTY = std::uint8_t{4};
+    static constexpr auto INDEX_MASK = std::uint8_t{3};
+
+    std::array<T, 3> buffers_;
+    alignas(64) std::atomic<std::uint8_t> middle_;
+    alignas(64) std::uint8_t writeIndex_;
+    alignas(64) std::uint8_t readIndex_;
+  };
+} // namespace imp
\ No newline at end of file
@@ -2,25 +2,23 @@
 
 namespace imp {
   WorkerThread::WorkerThread():
-      joining_{false}, thread_{[this]() {
-        for (;;) {
-          auto lock = std::unique_lock{mutex_};
-          condvar_.wait(lock, [this]() { return joining_ || !queue_.empty(); });
-          if (!queue_.empty()) {
-            auto work = std::move(queue_.front());
-            queue_.pop();
-            lock.unlock();
-            work();
-            condvar_.notify_all();
-          } else {
-            return;
-          }
-        }
-      }} {}
+      queue_{QUEUE_CAPACITY},
+      pushedCount_{0},
+      queuedCount_{0},
+      completedCount_{0},
+      waiterCount_{0},
+      sleeping_{false},
+      joining_{false},
+      thread_{[this]() { work(); }} {
+    TaskPool::reserve(QUEUE_CAPACITY);
+  }
 
   void WorkerThread::wait() {
     auto lock = std::unique_lock{mutex_};
-    condvar_.wait(lock, [this]() { return queue_.empty(); });
+    ++waiterCount_;
+    finishCondvar_.wait(
+        lock, [this]() { return completedCount_ == pushedCount_; });
+    --waiterCount_;
   }
 
   void WorkerThread::join() {
@@ -28,7 +26,34 @@ namespace imp {
       auto lock = std::scoped_lock{mutex_};
       joining_ = true;
     }
-    condvar_.notify_one();
+    workCondvar_.notify_one();
     thread_.join();
   }
+
+  void WorkerThread::work() {
+    auto task = Task{};
+    for (;;) {
+      if (queue_.tryPop(task)) {
+        --queuedCount_;
+        task();
+        task.reset();
+        ++completedCount_;
+        if (waiterCount_ != 0) {
+          {
+            auto lock = std::scoped_lock{mutex_};
+          }
+          finishCondvar_.notify_all();
+        }
+      } else {
+        auto lock = std::unique_lock{mutex_};
+        sleeping_ = true;
+        workCondvar_.wait(
+            lock, [this]() { return joining_ || queuedCount_ != 0; });
+        sleeping_ = false;
+        if (queuedCount_ == 0) {
+          return;
+        }
+      }
+    }
+  }
 } // namespace imp
\ No newline at end of file
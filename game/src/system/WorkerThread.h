@@ -1,14 +1,18 @@
 #pragma once
 
+#include <atomic>
 #include <condition_variable>
-#include <functional>
 #include <mutex>
-#include <queue>
 #include <thread>
 
+#include "MpmcQueue.h"
+#include "Task.h"
+
 namespace imp {
   class WorkerThread {
   public:
+    static constexpr auto QUEUE_CAPACITY = std::size_t{4096};
+
     WorkerThread();
 
     void wait();
@@ -16,18 +20,33 @@ namespace imp {
 
     template<typename... Args>
     void emplace(Args &&...args) {
-      {
-        auto lock = std::scoped_lock{mutex_};
-        queue_.emplace(std::forward<Args>(args)...);
+      auto task = Task{std::forward<Args>(args)...};
+      ++pushedCount_;
+      while (!queue_.tryPush(std::move(task))) {
+        std::this_thread::yield();
+      }
+      ++queuedCount_;
+      if (sleeping_) {
+        {
+          auto lock = std::scoped_lock{mutex_};
+        }
+        workCondvar_.notify_one();
       }
-      condvar_.notify_all();
     }
 
   private:
+    void work();
+
+    MpmcQueue<Task> queue_;
+    std::atomic<std::size_t> pushedCount_;
+    std::atomic<std::size_t> queuedCount_;
+    std::atomic<std::size_t> completedCount_;
+    std::atomic<std::size_t> waiterCount_;
+    std::atomic<bool> sleeping_;
     bool joining_;
-    std::queue<std::function<void()>> queue_;
     std::mutex mutex_;
-    std::condition_variable condvar_;
+    std::condition_variable workCondvar_;
+    std::condition_variable finishCondvar_;
     std::thread thread_;
   };
 } // namespace imp
\ No newline at end of file